@@ -21,7 +21,9 @@
 #include "profiler.h"
 #include "profiler_command_buffer.h"
 #include "profiler_helpers.h"
+#include "profiler_region_builder.h"
 #include <farmhash.h>
+#include <algorithm>
 #include <sstream>
 #include <fstream>
 
@@ -124,15 +126,25 @@ namespace Profiler
         , m_PresentMutex()
         , m_SubmitMutex()
         , m_Data()
+        , m_NextFrameSequenceNumber( 0 )
+        , m_FrameHistory()
+        , m_FrameCallbackMutex()
+        , m_pfnFrameCallback( nullptr )
+        , m_pFrameCallbackUserData( nullptr )
+        , m_FrameCallbackEnabled( false )
+        , m_FrameCallbackRegionsMutex()
+        , m_FrameCallbackRegions()
         , m_MemoryManager()
         , m_DataAggregator()
         , m_CurrentFrame( 0 )
         , m_CpuTimestampCounter()
         , m_CpuFpsCounter()
-        , m_Allocations()
+        , m_CpuMarkers()
+        , m_RollingStatistics()
+        , m_MemoryTracker()
         , m_pCommandBuffers()
         , m_pCommandPools()
-        , m_PerformanceConfigurationINTEL( VK_NULL_HANDLE )
+        , m_QueueSubmitStates()
     {
     }
 
@@ -225,10 +237,33 @@ namespace Profiler
     {
         m_pDevice = pDevice;
         m_CurrentFrame = 0;
+        m_NextFrameSequenceNumber = 0;
+        m_FrameHistory.clear();
 
         // Configure the profiler.
         DeviceProfiler::LoadConfiguration( pCreateInfo, &m_Config );
 
+        // Check if application registered frame callback
+        m_pfnFrameCallback = nullptr;
+        m_pFrameCallbackUserData = nullptr;
+
+        if( pCreateInfo )
+        {
+            for( const auto& it : PNextIterator( pCreateInfo->pNext ) )
+            {
+                if( it.sType == VK_STRUCTURE_TYPE_PROFILER_FRAME_CALLBACK_CREATE_INFO_EXT )
+                {
+                    const VkProfilerFrameCallbackCreateInfoEXT* pCallbackCreateInfo =
+                        reinterpret_cast<const VkProfilerFrameCallbackCreateInfoEXT*>(&it);
+
+                    m_pfnFrameCallback = pCallbackCreateInfo->pfnCallback;
+                    m_pFrameCallbackUserData = pCallbackCreateInfo->pUserData;
+                    m_FrameCallbackEnabled = (m_pfnFrameCallback != nullptr);
+                    break;
+                }
+            }
+        }
+
         // Check if preemption is enabled
         // It may break the results
         if( ProfilerPlatformFunctions::IsPreemptionEnabled() )
@@ -241,16 +276,20 @@ namespace Profiler
             #endif
         }
 
-        // Create submit fence
+        // Create submit state and fence for each queue
         VkFenceCreateInfo fenceCreateInfo;
         ClearStructure( &fenceCreateInfo, VK_STRUCTURE_TYPE_FENCE_CREATE_INFO );
 
-        DESTROYANDRETURNONFAIL( m_pDevice->Callbacks.CreateFence(
-            m_pDevice->Handle, &fenceCreateInfo, nullptr, &m_SubmitFence ) );
+        for( const auto& [queue, queueObject] : m_pDevice->Queues )
+        {
+            DeviceProfilerQueueSubmitState& queueSubmitState = m_QueueSubmitStates[ queue ];
+
+            DESTROYANDRETURNONFAIL( m_pDevice->Callbacks.CreateFence(
+                m_pDevice->Handle, &fenceCreateInfo, nullptr, &queueSubmitState.m_SubmitFence ) );
+        }
 
         // Prepare for memory usage tracking
-        m_MemoryData.m_Heaps.resize( m_pDevice->pPhysicalDevice->MemoryProperties.memoryHeapCount );
-        m_MemoryData.m_Types.resize( m_pDevice->pPhysicalDevice->MemoryProperties.memoryTypeCount );
+        DESTROYANDRETURNONFAIL( m_MemoryTracker.Initialize( m_pDevice ) );
 
         // Enable vendor-specific extensions
         if( m_pDevice->EnabledExtensions.count( VK_INTEL_PERFORMANCE_QUERY_EXTENSION_NAME ) )
@@ -267,6 +306,8 @@ namespace Profiler
         // Initialize aggregator
         DESTROYANDRETURNONFAIL( m_DataAggregator.Initialize( this ) );
 
+        m_RollingStatistics.Initialize( m_Config.m_RollingStatisticsWindowSize );
+
         // Initialize internal pipelines
         CreateInternalPipeline( DeviceProfilerPipelineType::eCopyBuffer, "CopyBuffer" );
         CreateInternalPipeline( DeviceProfilerPipelineType::eCopyBufferToImage, "CopyBufferToImage" );
@@ -366,16 +407,20 @@ namespace Profiler
         m_pCommandBuffers.clear();
         m_pCommandPools.clear();
 
-        m_Allocations.clear();
+        m_MemoryTracker.Destroy();
 
         m_Synchronization.Destroy();
         m_MemoryManager.Destroy();
 
-        if( m_SubmitFence != VK_NULL_HANDLE )
+        for( auto& [queue, queueSubmitState] : m_QueueSubmitStates )
         {
-            m_pDevice->Callbacks.DestroyFence( m_pDevice->Handle, m_SubmitFence, nullptr );
-            m_SubmitFence = VK_NULL_HANDLE;
+            if( queueSubmitState.m_SubmitFence != VK_NULL_HANDLE )
+            {
+                m_pDevice->Callbacks.DestroyFence( m_pDevice->Handle, queueSubmitState.m_SubmitFence, nullptr );
+            }
         }
+
+        m_QueueSubmitStates.clear();
         
         if( m_pStablePowerStateHandle != nullptr )
         {
@@ -383,6 +428,14 @@ namespace Profiler
         }
 
         m_CurrentFrame = 0;
+        m_FrameHistory.clear();
+        m_CpuMarkers.Destroy();
+        m_RollingStatistics.Reset();
+        m_DataAggregator.Reset();
+        m_pfnFrameCallback = nullptr;
+        m_pFrameCallbackUserData = nullptr;
+        m_FrameCallbackEnabled = false;
+        m_FrameCallbackRegions.clear();
         m_pDevice = nullptr;
     }
 
@@ -432,6 +485,134 @@ namespace Profiler
         return m_Data;
     }
 
+    /***********************************************************************************\
+
+    Function:
+        GetRollingStatistics
+
+    Description:
+        Compute distribution of GPU times of the objects used in the last frames.
+        The statistics are not computed in FinishFrame, so the cost is paid only by
+        the callers that actually read them.
+
+    \***********************************************************************************/
+    void DeviceProfiler::GetRollingStatistics( ContainerType<DeviceProfilerRollingStatisticsData>& statistics ) const
+    {
+        // Hold FinishFrame to keep the windows consistent
+        std::scoped_lock lk( m_DataMutex );
+        m_RollingStatistics.GetStatistics( statistics );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        GetFrameHistory
+
+    Description:
+        Copy summaries of the frames with sequence number equal or greater than
+        firstSequenceNumber. Frames that are no longer kept in the bounded history
+        are reported in pDroppedFrameCount.
+
+    \***********************************************************************************/
+    VkResult DeviceProfiler::GetFrameHistory( uint64_t firstSequenceNumber, uint32_t* pFrameCount, VkProfilerFrameSummaryEXT* pFrames, uint64_t* pDroppedFrameCount ) const
+    {
+        std::scoped_lock lk( m_DataMutex );
+
+        const uint64_t oldestSequenceNumber = m_FrameHistory.empty()
+            ? m_NextFrameSequenceNumber
+            : m_FrameHistory.front().sequenceNumber;
+
+        uint64_t droppedFrameCount = 0;
+
+        if( firstSequenceNumber < oldestSequenceNumber )
+        {
+            // Requested frames have already been removed from the history
+            droppedFrameCount = oldestSequenceNumber - firstSequenceNumber;
+            firstSequenceNumber = oldestSequenceNumber;
+        }
+
+        if( pDroppedFrameCount )
+        {
+            (*pDroppedFrameCount) = droppedFrameCount;
+        }
+
+        const size_t firstIndex = static_cast<size_t>( std::min<uint64_t>(
+            firstSequenceNumber - oldestSequenceNumber, m_FrameHistory.size() ) );
+
+        const uint32_t availableFrameCount = static_cast<uint32_t>( m_FrameHistory.size() - firstIndex );
+
+        if( !pFrames )
+        {
+            (*pFrameCount) = availableFrameCount;
+            return VK_SUCCESS;
+        }
+
+        // Return the oldest frames first, so that the application can continue from the last returned one
+        const uint32_t frameCount = std::min( *pFrameCount, availableFrameCount );
+        std::copy_n( m_FrameHistory.begin() + firstIndex, frameCount, pFrames );
+
+        (*pFrameCount) = frameCount;
+
+        return (frameCount < availableFrameCount) ? VK_INCOMPLETE : VK_SUCCESS;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        SetFrameCallback
+
+    Description:
+        Register function called when data of a frame is fully resolved.
+        Pass null to unregister the current callback.
+
+    \***********************************************************************************/
+    VkResult DeviceProfiler::SetFrameCallback( PFN_vkProfilerFrameCallbackEXT pfnCallback, void* pUserData )
+    {
+        // Wait until the current callback returns
+        std::scoped_lock lk( m_FrameCallbackMutex );
+
+        m_pfnFrameCallback = pfnCallback;
+        m_pFrameCallbackUserData = pUserData;
+        m_FrameCallbackEnabled = (pfnCallback != nullptr);
+
+        if( !pfnCallback )
+        {
+            // Release the region buffer
+            std::scoped_lock regionsLock( m_FrameCallbackRegionsMutex );
+            m_FrameCallbackRegions = {};
+        }
+
+        return VK_SUCCESS;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        BeginCpuRegion
+
+    Description:
+        Mark beginning of the application's CPU region in the calling thread.
+
+    \***********************************************************************************/
+    void DeviceProfiler::BeginCpuRegion( const char* pName, const float color[ 4 ] )
+    {
+        m_CpuMarkers.BeginRegion( pName, color );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        EndCpuRegion
+
+    Description:
+        Mark end of the last CPU region began in the calling thread.
+
+    \***********************************************************************************/
+    void DeviceProfiler::EndCpuRegion()
+    {
+        m_CpuMarkers.EndRegion();
+    }
+
     /***********************************************************************************\
     \***********************************************************************************/
     ProfilerCommandBuffer& DeviceProfiler::GetCommandBuffer( VkCommandBuffer commandBuffer )
@@ -518,8 +699,6 @@ namespace Profiler
         {
             VkCommandBuffer commandBuffer = pCommandBuffers[ i ];
 
-            SetDefaultObjectName( commandBuffer );
-
             m_pCommandBuffers.unsafe_insert( commandBuffer,
                 std::make_unique<ProfilerCommandBuffer>( *this, profilerCommandPool, commandBuffer, level ) );
         }
@@ -565,7 +744,6 @@ namespace Profiler
             const VkGraphicsPipelineCreateInfo& createInfo = pCreateInfos[i];
 
             SetPipelineShaderProperties( profilerPipeline, createInfo.stageCount, createInfo.pStages );
-            SetDefaultObjectName( profilerPipeline );
 
             m_Pipelines.insert( pPipelines[i], profilerPipeline );
         }
@@ -590,7 +768,6 @@ namespace Profiler
             profilerPipeline.m_Type = DeviceProfilerPipelineType::eCompute;
             
             SetPipelineShaderProperties( profilerPipeline, 1, &pCreateInfos[i].stage );
-            SetDefaultObjectName( profilerPipeline );
 
             m_Pipelines.insert( pPipelines[ i ], profilerPipeline );
         }
@@ -617,7 +794,6 @@ namespace Profiler
             const VkRayTracingPipelineCreateInfoKHR& createInfo = pCreateInfos[i];
 
             SetPipelineShaderProperties( profilerPipeline, createInfo.stageCount, createInfo.pStages );
-            SetDefaultObjectName( profilerPipeline );
 
             m_Pipelines.insert( pPipelines[ i ], profilerPipeline );
         }
@@ -710,9 +886,6 @@ namespace Profiler
         // Count clear attachments
         CountRenderPassAttachmentClears( deviceProfilerRenderPass, pCreateInfo );
 
-        // Assign default debug name for the render pass
-        SetDefaultObjectName( renderPass );
-
         // Store render pass
         m_RenderPasses.insert( renderPass, deviceProfilerRenderPass );
     }
@@ -776,9 +949,6 @@ namespace Profiler
         // Count clear attachments
         CountRenderPassAttachmentClears( deviceProfilerRenderPass, pCreateInfo );
 
-        // Assign default debug name for the render pass
-        SetDefaultObjectName( renderPass );
-
         // Store render pass
         m_RenderPasses.insert( renderPass, deviceProfilerRenderPass );
     }
@@ -806,10 +976,15 @@ namespace Profiler
     \***********************************************************************************/
     void DeviceProfiler::PreSubmitCommandBuffers( VkQueue queue, uint32_t, const VkSubmitInfo*, VkFence )
     {
-        assert( m_PerformanceConfigurationINTEL == VK_NULL_HANDLE );
+        auto queueSubmitStateIt = m_QueueSubmitStates.find( queue );
 
-        if( m_MetricsApiINTEL.IsAvailable() )
+        // Queues not reported at device creation are submitted without the performance configuration
+        if( m_MetricsApiINTEL.IsAvailable() &&
+            (queueSubmitStateIt != m_QueueSubmitStates.end()) )
         {
+            DeviceProfilerQueueSubmitState& queueSubmitState = queueSubmitStateIt->second;
+            assert( queueSubmitState.m_PerformanceConfigurationINTEL == VK_NULL_HANDLE );
+
             VkResult result;
 
             // Acquire performance configuration
@@ -821,14 +996,14 @@ namespace Profiler
                 result = m_pDevice->Callbacks.AcquirePerformanceConfigurationINTEL(
                     m_pDevice->Handle,
                     &acquireInfo,
-                    &m_PerformanceConfigurationINTEL );
+                    &queueSubmitState.m_PerformanceConfigurationINTEL );
             }
 
             // Set performance configuration for the queue
             if( result == VK_SUCCESS )
             {
                 result = m_pDevice->Callbacks.QueueSetPerformanceConfigurationINTEL(
-                    queue, m_PerformanceConfigurationINTEL );
+                    queue, queueSubmitState.m_PerformanceConfigurationINTEL );
             }
 
             assert( result == VK_SUCCESS );
@@ -837,6 +1012,40 @@ namespace Profiler
 
     /***********************************************************************************\
 
+    Function:
+        WaitForSubmittedCommandBuffers
+
+    Description:
+        Wait until the command buffers submitted to the queue complete.
+
+        Used in VK_PROFILER_SYNC_MODE_SUBMIT_EXT. Must be called without m_SubmitMutex
+        held, so the wait doesn't block allocation and freeing of the command buffers
+        on the other threads. The submit is registered after the wait, so aggregation
+        triggered by submits to the other queues never reads incomplete results.
+
+    \***********************************************************************************/
+    void DeviceProfiler::WaitForSubmittedCommandBuffers( VkQueue queue )
+    {
+        // Submits to the same queue are externally synchronized by the application,
+        // so no lock is needed to access the state of the queue.
+        auto queueSubmitStateIt = m_QueueSubmitStates.find( queue );
+        if( queueSubmitStateIt != m_QueueSubmitStates.end() )
+        {
+            DeviceProfilerQueueSubmitState& queueSubmitState = queueSubmitStateIt->second;
+
+            m_pDevice->Callbacks.QueueSubmit( queue, 0, nullptr, queueSubmitState.m_SubmitFence );
+            m_pDevice->Callbacks.WaitForFences( m_pDevice->Handle, 1, &queueSubmitState.m_SubmitFence, true, std::numeric_limits<uint64_t>::max() );
+            m_pDevice->Callbacks.ResetFences( m_pDevice->Handle, 1, &queueSubmitState.m_SubmitFence );
+        }
+        else
+        {
+            // Queues not reported at device creation don't have a submit fence
+            m_pDevice->Callbacks.QueueWaitIdle( queue );
+        }
+    }
+
+    /***********************************************************************************\
+
     Function:
         PostSubmitCommandBuffers
 
@@ -845,18 +1054,14 @@ namespace Profiler
     \***********************************************************************************/
     void DeviceProfiler::PostSubmitCommandBuffers( VkQueue queue, uint32_t count, const VkSubmitInfo* pSubmitInfo, VkFence fence )
     {
-        #if PROFILER_DISABLE_CRITICAL_SECTION_OPTIMIZATION
-        std::scoped_lock lk( m_CommandBuffers );
-        #else
-        std::scoped_lock lk( m_SubmitMutex );
-        #endif
+        // The caller holds m_SubmitMutex shared. Submits to the same queue are externally
+        // synchronized by the application, so no lock is needed to access the state of the queue.
+        DeviceProfilerQueueSubmitState* pQueueSubmitState = nullptr;
 
-        // Wait for the submitted command buffers to execute
-        if( m_Config.m_SyncMode == VK_PROFILER_SYNC_MODE_SUBMIT_EXT )
+        auto queueSubmitStateIt = m_QueueSubmitStates.find( queue );
+        if( queueSubmitStateIt != m_QueueSubmitStates.end() )
         {
-            m_pDevice->Callbacks.QueueSubmit( queue, 0, nullptr, m_SubmitFence );
-            m_pDevice->Callbacks.WaitForFences( m_pDevice->Handle, 1, &m_SubmitFence, true, std::numeric_limits<uint64_t>::max() );
-            m_pDevice->Callbacks.ResetFences( m_pDevice->Handle, 1, &m_SubmitFence );
+            pQueueSubmitState = &queueSubmitStateIt->second;
         }
 
         // Store submitted command buffers and get results
@@ -879,7 +1084,16 @@ namespace Profiler
             {
                 // Get command buffer handle
                 VkCommandBuffer commandBuffer = submitInfo.pCommandBuffers[commandBufferIdx];
-                auto& profilerCommandBuffer = GetCommandBuffer( commandBuffer );
+
+                // The command buffer may be freed by the application after it completes, while
+                // m_SubmitMutex is released for WaitForSubmittedCommandBuffers
+                auto it = m_pCommandBuffers.unsafe_find( commandBuffer );
+                if( it == m_pCommandBuffers.end() )
+                {
+                    continue;
+                }
+
+                auto& profilerCommandBuffer = *it->second;
 
                 // Dirty command buffer profiling data
                 profilerCommandBuffer.Submit();
@@ -899,27 +1113,31 @@ namespace Profiler
             }
 
             // Store the submit wrapper
-            submitBatch.m_Submits.push_back( submit );
+            submitBatch.m_Submits.push_back( std::move( submit ) );
         }
 
-        m_DataAggregator.AppendSubmit( submitBatch );
+        m_DataAggregator.AppendSubmit( std::move( submitBatch ) );
 
         // Release performance configuration
-        if( m_PerformanceConfigurationINTEL )
+        if( (pQueueSubmitState != nullptr) &&
+            (pQueueSubmitState->m_PerformanceConfigurationINTEL != VK_NULL_HANDLE) )
         {
             assert( m_pDevice->Callbacks.ReleasePerformanceConfigurationINTEL );
 
             VkResult result = m_pDevice->Callbacks.ReleasePerformanceConfigurationINTEL(
-                m_pDevice->Handle, m_PerformanceConfigurationINTEL );
+                m_pDevice->Handle, pQueueSubmitState->m_PerformanceConfigurationINTEL );
 
             assert( result == VK_SUCCESS );
 
             // Reset object handle for the next submit
-            m_PerformanceConfigurationINTEL = VK_NULL_HANDLE;
+            pQueueSubmitState->m_PerformanceConfigurationINTEL = VK_NULL_HANDLE;
         }
 
         if( m_Config.m_SyncMode == VK_PROFILER_SYNC_MODE_SUBMIT_EXT )
         {
+            // Aggregated data is also accessed in FinishFrame
+            std::scoped_lock lk( m_PresentMutex );
+
             // Collect data from the submitted command buffers
             m_DataAggregator.Aggregate();
         }
@@ -931,11 +1149,15 @@ namespace Profiler
         FinishFrame
 
     Description:
+        Collect data of the current frame.
+
+        The outputs are given a read-only view of the collected data, so they can
+        copy only the parts they need. The view is valid only during the call.
 
     \***********************************************************************************/
-    void DeviceProfiler::FinishFrame()
+    void DeviceProfiler::FinishFrame( const FrameOutputFn& outputFn )
     {
-        std::scoped_lock lk( m_PresentMutex );
+        std::unique_lock lk( m_PresentMutex );
 
         // Update FPS counter
         const bool updatePerfCounters = m_CpuFpsCounter.Update();
@@ -956,96 +1178,293 @@ namespace Profiler
 
             // Get data captured during the last frame
             m_Data = m_DataAggregator.GetAggregatedData();
-        }
+            m_Data.m_SequenceNumber = m_NextFrameSequenceNumber++;
 
-        m_Data.m_SyncTimestamps = m_Synchronization.GetSynchronizationTimestamps();
+            m_Data.m_SyncTimestamps = m_Synchronization.GetSynchronizationTimestamps();
 
-        // TODO: Move to memory tracker
-        m_Data.m_Memory = m_MemoryData;
+            m_Data.m_Memory = m_MemoryTracker.GetFrameMemoryData();
 
-        m_CpuTimestampCounter.End();
+            m_CpuTimestampCounter.End();
 
-        // TODO: Move to CPU tracker
-        m_Data.m_CPU.m_BeginTimestamp = m_CpuTimestampCounter.GetBeginValue();
-        m_Data.m_CPU.m_EndTimestamp = m_CpuTimestampCounter.GetCurrentValue();
-        m_Data.m_CPU.m_FramesPerSec = m_CpuFpsCounter.GetValue();
-        m_Data.m_CPU.m_ThreadId = ProfilerPlatformFunctions::GetCurrentThreadId();
+            // TODO: Move to CPU tracker
+            m_Data.m_CPU.m_BeginTimestamp = m_CpuTimestampCounter.GetBeginValue();
+            m_Data.m_CPU.m_EndTimestamp = m_CpuTimestampCounter.GetCurrentValue();
+            m_Data.m_CPU.m_FramesPerSec = m_CpuFpsCounter.GetValue();
+            m_Data.m_CPU.m_ThreadId = ProfilerPlatformFunctions::GetCurrentThreadId();
 
-        m_CpuTimestampCounter.Begin();
+            // Get CPU regions marked by the application
+            m_CpuMarkers.CollectRegions( m_Data.m_CPU.m_EndTimestamp, m_Data.m_CpuRegions );
+
+            // Update distribution of GPU times over the last frames
+            // The statistics are computed only when requested in GetRollingStatistics
+            m_RollingStatistics.AppendFrame( m_Data );
+
+            m_CpuTimestampCounter.Begin();
+
+            // Keep summary of the frame for the history queries
+            AppendFrameHistory( m_Data );
+        }
 
         // Prepare aggregator for the next frame
-        m_DataAggregator.Reset();
+        m_DataAggregator.ResetFrame();
 
         // Send synchronization timestamps
         m_Synchronization.SendSynchronizationTimestamps();
+
+        // m_Data is modified only with both mutexes locked, so it can be passed without
+        // a copy while m_DataMutex is held. m_PresentMutex is released to not block the
+        // submits and command buffer allocations until the outputs and callback return.
+        std::unique_lock dataLock( m_DataMutex );
+        lk.unlock();
+
+        if( outputFn )
+        {
+            outputFn( m_Data );
+        }
+
+        InvokeFrameCallback( m_Data, dataLock );
     }
 
     /***********************************************************************************\
 
     Function:
-        Destroy
+        GetFrameSummary
 
     Description:
+        Fill public summary structure of the frame.
 
     \***********************************************************************************/
-    void DeviceProfiler::AllocateMemory( VkDeviceMemory allocatedMemory, const VkMemoryAllocateInfo* pAllocateInfo )
+    VkProfilerFrameSummaryEXT DeviceProfiler::GetFrameSummary( const DeviceProfilerFrameData& data ) const
     {
-        std::scoped_lock lk( m_Allocations );
+        const float timestampPeriodMs = m_pDevice->pPhysicalDevice->Properties.limits.timestampPeriod / 1000000.f;
+
+        VkProfilerFrameSummaryEXT summary = {};
+        summary.sequenceNumber = data.m_SequenceNumber;
+        summary.gpuDuration = data.m_Ticks * timestampPeriodMs;
+        summary.cpuDuration = std::chrono::duration<float, std::milli>( data.m_CPU.m_EndTimestamp - data.m_CPU.m_BeginTimestamp ).count();
+        summary.framesPerSec = data.m_CPU.m_FramesPerSec;
+        summary.submitCount = static_cast<uint32_t>( data.m_Submits.size() );
+        summary.drawCount = data.m_Stats.m_DrawCount + data.m_Stats.m_DrawIndirectCount;
+        summary.dispatchCount = data.m_Stats.m_DispatchCount + data.m_Stats.m_DispatchIndirectCount;
+        summary.totalAllocationSize = data.m_Memory.m_TotalAllocationSize;
+        summary.totalAllocationCount = data.m_Memory.m_TotalAllocationCount;
+        return summary;
+    }
 
-        // Insert allocation info to the map, it will be needed during deallocation.
-        m_Allocations.unsafe_insert( allocatedMemory, *pAllocateInfo );
+    /***********************************************************************************\
+
+    Function:
+        AppendFrameHistory
+
+    Description:
+        Store summary of the frame in the bounded frame history.
+        Must be called with m_DataMutex locked.
 
-        const VkMemoryType& memoryType =
-            m_pDevice->pPhysicalDevice->MemoryProperties.memoryTypes[ pAllocateInfo->memoryTypeIndex ];
+    \***********************************************************************************/
+    void DeviceProfiler::AppendFrameHistory( const DeviceProfilerFrameData& data )
+    {
+        if( m_Config.m_FrameHistorySize == 0 )
+        {
+            return;
+        }
 
-        auto& heap = m_MemoryData.m_Heaps[ memoryType.heapIndex ];
-        heap.m_AllocationCount++;
-        heap.m_AllocationSize += pAllocateInfo->allocationSize;
+        const VkProfilerFrameSummaryEXT summary = GetFrameSummary( data );
 
-        auto& type = m_MemoryData.m_Types[ pAllocateInfo->memoryTypeIndex ];
-        type.m_AllocationCount++;
-        type.m_AllocationSize += pAllocateInfo->allocationSize;
+        while( m_FrameHistory.size() >= m_Config.m_FrameHistorySize )
+        {
+            m_FrameHistory.pop_front();
+        }
 
-        m_MemoryData.m_TotalAllocationCount++;
-        m_MemoryData.m_TotalAllocationSize += pAllocateInfo->allocationSize;
+        m_FrameHistory.push_back( summary );
     }
 
     /***********************************************************************************\
 
     Function:
-        Destroy
+        InvokeFrameCallback
 
     Description:
+        Pass read-only view of the frame to the application's callback.
+        The regions are serialized into a buffer reused between the frames.
+
+        Must be called with m_DataMutex locked. The lock is released before the
+        callback is called, so the callback can read the data of the frame.
 
     \***********************************************************************************/
-    void DeviceProfiler::FreeMemory( VkDeviceMemory allocatedMemory )
+    void DeviceProfiler::InvokeFrameCallback( const DeviceProfilerFrameData& data, std::unique_lock<std::mutex>& dataLock )
     {
-        std::scoped_lock lk( m_Allocations );
+        if( !m_FrameCallbackEnabled.load( std::memory_order_relaxed ) )
+        {
+            return;
+        }
+
+        // Take the buffer, other threads finishing frames at the same time allocate a new one
+        std::vector<VkProfilerFlatRegionDataEXT> regions;
+        {
+            std::scoped_lock regionsLock( m_FrameCallbackRegionsMutex );
+            regions.swap( m_FrameCallbackRegions );
+        }
+
+        const float timestampPeriod = m_pDevice->pPhysicalDevice->Properties.limits.timestampPeriod;
 
-        auto it = m_Allocations.unsafe_find( allocatedMemory );
-        if( it != m_Allocations.end() )
+        // Count the regions to grow the buffer only when needed
+        FlatRegionBuilder counter( timestampPeriod, nullptr );
+        counter.SerializeFrame( data );
+
+        if( regions.size() < counter.GetRegionCount() )
         {
-            const VkMemoryType& memoryType =
-                m_pDevice->pPhysicalDevice->MemoryProperties.memoryTypes[ it->second.memoryTypeIndex ];
+            regions.resize( counter.GetRegionCount() );
+        }
 
-            auto& heap = m_MemoryData.m_Heaps[ memoryType.heapIndex ];
-            heap.m_AllocationCount--;
-            heap.m_AllocationSize -= it->second.allocationSize;
+        FlatRegionBuilder builder( timestampPeriod, regions.data() );
+        builder.SerializeFrame( data );
+
+        VkProfilerFrameCallbackDataEXT callbackData = {};
+        callbackData.sType = VK_STRUCTURE_TYPE_PROFILER_FRAME_CALLBACK_DATA_EXT;
+        callbackData.pNext = nullptr;
+        callbackData.summary = GetFrameSummary( data );
+        callbackData.regionCount = builder.GetRegionCount();
+        callbackData.pRegions = regions.data();
+
+        // The callback gets only the serialized copy of the frame
+        dataLock.unlock();
+
+        {
+            std::scoped_lock lk( m_FrameCallbackMutex );
 
-            auto& type = m_MemoryData.m_Types[ it->second.memoryTypeIndex ];
-            type.m_AllocationCount--;
-            type.m_AllocationSize -= it->second.allocationSize;
+            // The callback may have been unregistered in the meantime
+            if( m_pfnFrameCallback )
+            {
+                m_pfnFrameCallback( m_pDevice->Handle, &callbackData, m_pFrameCallbackUserData );
+            }
+        }
 
-            m_MemoryData.m_TotalAllocationCount--;
-            m_MemoryData.m_TotalAllocationSize -= it->second.allocationSize;
+        // Return the buffer for the next frame
+        std::scoped_lock regionsLock( m_FrameCallbackRegionsMutex );
 
-            // Remove allocation entry from the map
-            m_Allocations.unsafe_remove( it );
+        if( m_FrameCallbackEnabled.load( std::memory_order_relaxed ) &&
+            (regions.capacity() > m_FrameCallbackRegions.capacity()) )
+        {
+            m_FrameCallbackRegions.swap( regions );
         }
     }
 
     /***********************************************************************************\
 
+    Function:
+        AllocateMemory
+
+    Description:
+        Register the VkDeviceMemory allocation.
+
+    \***********************************************************************************/
+    void DeviceProfiler::AllocateMemory( VkDeviceMemory allocatedMemory, const VkMemoryAllocateInfo* pAllocateInfo )
+    {
+        m_MemoryTracker.RegisterAllocation( allocatedMemory, pAllocateInfo );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        FreeMemory
+
+    Description:
+        Unregister the VkDeviceMemory allocation.
+
+    \***********************************************************************************/
+    void DeviceProfiler::FreeMemory( VkDeviceMemory allocatedMemory )
+    {
+        m_MemoryTracker.UnregisterAllocation( allocatedMemory );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        CreateBuffer
+
+    Description:
+        Register the buffer in the memory tracker.
+
+    \***********************************************************************************/
+    void DeviceProfiler::CreateBuffer( VkBuffer buffer, const VkBufferCreateInfo* pCreateInfo )
+    {
+        m_MemoryTracker.RegisterBuffer( buffer, pCreateInfo );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        DestroyBuffer
+
+    Description:
+        Unregister the buffer from the memory tracker.
+        The debug name is removed, so it is not inherited by a new buffer with the same handle.
+
+    \***********************************************************************************/
+    void DeviceProfiler::DestroyBuffer( VkBuffer buffer )
+    {
+        m_MemoryTracker.UnregisterBuffer( buffer );
+        SetDefaultObjectName( buffer );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        BindBufferMemory
+
+    Description:
+
+    \***********************************************************************************/
+    void DeviceProfiler::BindBufferMemory( VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize offset )
+    {
+        m_MemoryTracker.BindBufferMemory( buffer, memory, offset );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        CreateImage
+
+    Description:
+        Register the image in the memory tracker.
+
+    \***********************************************************************************/
+    void DeviceProfiler::CreateImage( VkImage image, const VkImageCreateInfo* pCreateInfo )
+    {
+        m_MemoryTracker.RegisterImage( image, pCreateInfo );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        DestroyImage
+
+    Description:
+        Unregister the image from the memory tracker.
+        The debug name is removed, so it is not inherited by a new image with the same handle.
+
+    \***********************************************************************************/
+    void DeviceProfiler::DestroyImage( VkImage image )
+    {
+        m_MemoryTracker.UnregisterImage( image );
+        SetDefaultObjectName( image );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        BindImageMemory
+
+    Description:
+
+    \***********************************************************************************/
+    void DeviceProfiler::BindImageMemory( VkImage image, VkDeviceMemory memory, VkDeviceSize offset )
+    {
+        m_MemoryTracker.BindImageMemory( image, memory, offset );
+    }
+
+    /***********************************************************************************\
+
     Function:
         CreateShaderTuple
 
@@ -1100,7 +1519,7 @@ namespace Profiler
     \***********************************************************************************/
     void DeviceProfiler::SetObjectName( VkObject object, const char* pName )
     {
-        m_pDevice->Debug.ObjectNames.insert( object, pName );
+        m_pDevice->Debug.ObjectNames.insert_or_assign( object, ProfilerStringTable::Get().Intern( pName ) );
     }
 
     /***********************************************************************************\
@@ -1109,77 +1528,14 @@ namespace Profiler
         SetDefaultObjectName
 
     Description:
-        Set default object name.
+        Restore default object name.
+        Default names are not stored, DeviceProfilerStringSerializer formats them on
+        demand from the object handle (or the shader tuple in case of pipelines).
 
     \***********************************************************************************/
     void DeviceProfiler::SetDefaultObjectName( VkObject object )
     {
-        // There is special function for VkPipeline objects
-        if( object.m_Type == VK_OBJECT_TYPE_PIPELINE )
-        {
-            SetDefaultObjectName( VkObject_Traits<VkPipeline>::GetObjectHandleAsVulkanHandle( object.m_Handle ) );
-        }
-
-        char pObjectDebugName[ 64 ] = {};
-        ProfilerStringFunctions::Format( pObjectDebugName, "%s 0x%016llx", object.m_pTypeName, object.m_Handle );
-
-        m_pDevice->Debug.ObjectNames.insert( object, pObjectDebugName );
-    }
-
-    /***********************************************************************************\
-
-    Function:
-        SetDefaultObjectName
-
-    Description:
-        Set default pipeline name consisting of shader tuple hashes.
-
-    \***********************************************************************************/
-    void DeviceProfiler::SetDefaultObjectName( VkPipeline object )
-    {
-        SetDefaultObjectName( GetPipeline( object ) );
-    }
-
-    /***********************************************************************************\
-
-    Function:
-        SetDefaultObjectName
-
-    Description:
-        Set default pipeline name consisting of shader tuple hashes.
-
-    \***********************************************************************************/
-    void DeviceProfiler::SetDefaultObjectName( const DeviceProfilerPipeline& pipeline )
-    {
-        if( pipeline.m_BindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS )
-        {
-            // Vertex and pixel shader hashes
-            char pPipelineDebugName[ 25 ] = "VS=XXXXXXXX, PS=XXXXXXXX";
-            u32tohex( pPipelineDebugName + 3, pipeline.m_ShaderTuple.m_Stages[VK_SHADER_STAGE_VERTEX_BIT] );
-            u32tohex( pPipelineDebugName + 16, pipeline.m_ShaderTuple.m_Stages[VK_SHADER_STAGE_FRAGMENT_BIT] );
-
-            m_pDevice->Debug.ObjectNames.insert( pipeline.m_Handle, pPipelineDebugName );
-        }
-
-        if( pipeline.m_BindPoint == VK_PIPELINE_BIND_POINT_COMPUTE )
-        {
-            // Compute shader hash
-            char pPipelineDebugName[ 12 ] = "CS=XXXXXXXX";
-            u32tohex( pPipelineDebugName + 3, pipeline.m_ShaderTuple.m_Stages[VK_SHADER_STAGE_COMPUTE_BIT] );
-
-            m_pDevice->Debug.ObjectNames.insert( pipeline.m_Handle, pPipelineDebugName );
-        }
-
-        if( pipeline.m_BindPoint == VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR )
-        {
-            // Ray tracing shader hash
-            char pPipelineDebugName[ 75 ] = "RGEN=XXXXXXXX, aHIT=XXXXXXXX, cHIT=XXXXXXXX";
-            u32tohex( pPipelineDebugName + 5, pipeline.m_ShaderTuple.m_Stages[VK_SHADER_STAGE_RAYGEN_BIT_KHR] );
-            u32tohex( pPipelineDebugName + 20, pipeline.m_ShaderTuple.m_Stages[VK_SHADER_STAGE_ANY_HIT_BIT_KHR] );
-            u32tohex( pPipelineDebugName + 35, pipeline.m_ShaderTuple.m_Stages[VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR] );
-
-            m_pDevice->Debug.ObjectNames.insert( pipeline.m_Handle, pPipelineDebugName );
-        }
+        m_pDevice->Debug.ObjectNames.remove( object );
     }
 
     /***********************************************************************************\
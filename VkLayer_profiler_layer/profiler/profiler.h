@@ -22,19 +22,27 @@
 #include "profiler_counters.h"
 #include "profiler_command_pool.h"
 #include "profiler_config.h"
+#include "profiler_cpu_markers.h"
 #include "profiler_data_aggregator.h"
 #include "profiler_helpers.h"
 #include "profiler_memory_manager.h"
+#include "profiler_memory_tracker.h"
 #include "profiler_data.h"
+#include "profiler_rolling_statistics.h"
 #include "profiler_sync.h"
 #include "profiler_layer_objects/VkObject.h"
 #include "profiler_layer_objects/VkDevice_object.h"
 #include "profiler_layer_objects/VkQueue_object.h"
+#include <atomic>
+#include <functional>
+#include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <sstream>
 #include <string>
 
+#include <deque>
+
 #include "lockable_unordered_map.h"
 
 // Vendor APIs
@@ -49,6 +57,23 @@ namespace Profiler
 
     /***********************************************************************************\
 
+    Structure:
+        DeviceProfilerQueueSubmitState
+
+    Description:
+        Submit bookkeeping of a single queue. Accessed only by the threads submitting
+        to the queue, which are externally synchronized by the application, so submits
+        to different queues don't contend.
+
+    \***********************************************************************************/
+    struct DeviceProfilerQueueSubmitState
+    {
+        VkFence m_SubmitFence = VK_NULL_HANDLE;
+        VkPerformanceConfigurationINTEL m_PerformanceConfigurationINTEL = VK_NULL_HANDLE;
+    };
+
+    /***********************************************************************************\
+
     Class:
         DeviceProfiler
 
@@ -73,6 +98,11 @@ namespace Profiler
         VkResult SetMode( VkProfilerModeEXT );
         VkResult SetSyncMode( VkProfilerSyncModeEXT );
         DeviceProfilerFrameData GetData() const;
+        void GetRollingStatistics( ContainerType<DeviceProfilerRollingStatisticsData>& ) const;
+        VkResult GetFrameHistory( uint64_t, uint32_t*, VkProfilerFrameSummaryEXT*, uint64_t* ) const;
+        VkResult SetFrameCallback( PFN_vkProfilerFrameCallbackEXT, void* );
+        void BeginCpuRegion( const char*, const float[ 4 ] );
+        void EndCpuRegion();
 
         ProfilerCommandBuffer& GetCommandBuffer( VkCommandBuffer commandBuffer );
         DeviceProfilerCommandPool& GetCommandPool( VkCommandPool commandPool );
@@ -98,16 +128,27 @@ namespace Profiler
         void DestroyRenderPass( VkRenderPass );
 
         void PreSubmitCommandBuffers( VkQueue, uint32_t, const VkSubmitInfo*, VkFence );
+        void WaitForSubmittedCommandBuffers( VkQueue );
         void PostSubmitCommandBuffers( VkQueue, uint32_t, const VkSubmitInfo*, VkFence );
 
-        void FinishFrame();
+        // Called with read-only view of the frame data after the frame is finished
+        using FrameOutputFn = std::function<void( const DeviceProfilerFrameData& )>;
+
+        void FinishFrame( const FrameOutputFn& outputFn = nullptr );
 
         void AllocateMemory( VkDeviceMemory, const VkMemoryAllocateInfo* );
         void FreeMemory( VkDeviceMemory );
 
+        void CreateBuffer( VkBuffer, const VkBufferCreateInfo* );
+        void DestroyBuffer( VkBuffer );
+        void BindBufferMemory( VkBuffer, VkDeviceMemory, VkDeviceSize );
+
+        void CreateImage( VkImage, const VkImageCreateInfo* );
+        void DestroyImage( VkImage );
+        void BindImageMemory( VkImage, VkDeviceMemory, VkDeviceSize );
+
         void SetObjectName( VkObject, const char* );
         void SetDefaultObjectName( VkObject );
-        void SetDefaultObjectName( VkPipeline );
 
         template<typename VkObjectTypeEnumT>
         void SetObjectName( uint64_t, VkObjectTypeEnumT, const char* );
@@ -117,11 +158,29 @@ namespace Profiler
 
         DeviceProfilerConfig    m_Config;
 
-        mutable std::mutex      m_SubmitMutex;
+        // Held shared by vkQueueSubmit from before the driver call until the submit is
+        // passed to the aggregator, except while waiting for the submit to complete in
+        // VK_PROFILER_SYNC_MODE_SUBMIT_EXT, and exclusively when the command buffers are
+        // allocated or freed, so a command buffer found in the submit can't be freed
+        // before its data can be found by the aggregator.
+        mutable std::shared_mutex m_SubmitMutex;
         mutable std::mutex      m_PresentMutex;
         mutable std::mutex      m_DataMutex;
         DeviceProfilerFrameData m_Data;
 
+        uint64_t                m_NextFrameSequenceNumber;
+        std::deque<VkProfilerFrameSummaryEXT> m_FrameHistory;
+
+        // Held while the callback is running
+        std::mutex              m_FrameCallbackMutex;
+        PFN_vkProfilerFrameCallbackEXT m_pfnFrameCallback;
+        void*                   m_pFrameCallbackUserData;
+        std::atomic<bool>       m_FrameCallbackEnabled;
+
+        // Region buffer reused between the frames, never held while waiting for other locks
+        std::mutex              m_FrameCallbackRegionsMutex;
+        std::vector<VkProfilerFlatRegionDataEXT> m_FrameCallbackRegions;
+
         DeviceProfilerMemoryManager m_MemoryManager;
         ProfilerDataAggregator  m_DataAggregator;
 
@@ -131,8 +190,10 @@ namespace Profiler
         CpuTimestampCounter     m_CpuTimestampCounter;
         CpuEventFrequencyCounter m_CpuFpsCounter;
 
-        ConcurrentMap<VkDeviceMemory, VkMemoryAllocateInfo> m_Allocations;
-        DeviceProfilerMemoryData m_MemoryData;
+        DeviceProfilerCpuMarkers m_CpuMarkers;
+        DeviceProfilerRollingStatistics m_RollingStatistics;
+
+        DeviceProfilerMemoryTracker m_MemoryTracker;
 
         ConcurrentMap<VkCommandBuffer, std::unique_ptr<ProfilerCommandBuffer>> m_pCommandBuffers;
         ConcurrentMap<VkCommandPool, std::unique_ptr<DeviceProfilerCommandPool>> m_pCommandPools;
@@ -142,9 +203,9 @@ namespace Profiler
 
         ConcurrentMap<VkRenderPass, DeviceProfilerRenderPass> m_RenderPasses;
 
-        VkFence                 m_SubmitFence;
-
-        VkPerformanceConfigurationINTEL m_PerformanceConfigurationINTEL;
+        // Created in Initialize for all queues of the device and not modified later,
+        // so the lookups don't have to be synchronized
+        std::unordered_map<VkQueue, DeviceProfilerQueueSubmitState> m_QueueSubmitStates;
 
         ProfilerMetricsApi_INTEL m_MetricsApiINTEL;
 
@@ -158,7 +219,10 @@ namespace Profiler
         void CreateInternalPipeline( DeviceProfilerPipelineType, const char* );
         
         void SetPipelineShaderProperties( DeviceProfilerPipeline& pipeline, uint32_t stageCount, const VkPipelineShaderStageCreateInfo* pStages );
-        void SetDefaultObjectName( const DeviceProfilerPipeline& pipeline );
+
+        VkProfilerFrameSummaryEXT GetFrameSummary( const DeviceProfilerFrameData& data ) const;
+        void AppendFrameHistory( const DeviceProfilerFrameData& data );
+        void InvokeFrameCallback( const DeviceProfilerFrameData& data, std::unique_lock<std::mutex>& dataLock );
 
         decltype(m_pCommandBuffers)::iterator FreeCommandBuffer( VkCommandBuffer );
         decltype(m_pCommandBuffers)::iterator FreeCommandBuffer( decltype(m_pCommandBuffers)::iterator );
@@ -30,6 +30,17 @@
 #define VKPROF_SET_STABLE_POWER_STATE "set_stable_power_state"
 #define VKPROF_SAMPLING_MODE_CVAR_NAME "sampling_mode"
 #define VKPROF_SYNC_MODE_CVAR_NAME "sync_mode"
+#define VKPROF_OVERLAY_UPDATE_RATE_CVAR_NAME "overlay_update_rate"
+#define VKPROF_TRACE_CAPTURE_FRAME_COUNT_CVAR_NAME "trace_capture_frame_count"
+#define VKPROF_PIPELINE_STATISTICS_FILE_CVAR_NAME "pipeline_statistics_file"
+#define VKPROF_STATISTICS_DUMP_FILE_CVAR_NAME "statistics_dump_file"
+#define VKPROF_STATISTICS_DUMP_FRAME_INTERVAL_CVAR_NAME "statistics_dump_frame_interval"
+#define VKPROF_STATISTICS_DUMP_TIME_INTERVAL_CVAR_NAME "statistics_dump_time_interval"
+#define VKPROF_STREAM_SERVER_PORT_CVAR_NAME "stream_server_port"
+#define VKPROF_SHARED_MEMORY_RING_NAME_CVAR_NAME "shared_memory_ring_name"
+#define VKPROF_SHARED_MEMORY_RING_SLOT_COUNT_CVAR_NAME "shared_memory_ring_slot_count"
+#define VKPROF_FRAME_HISTORY_SIZE_CVAR_NAME "frame_history_size"
+#define VKPROF_ROLLING_STATISTICS_WINDOW_SIZE_CVAR_NAME "rolling_statistics_window_size"
 
 #define VKPROF_GET_ENV_CVAR_NAME(cvar) "VKPROF_" cvar
 
@@ -44,6 +55,31 @@ namespace Profiler
         out << VKPROF_SET_STABLE_POWER_STATE " " << m_SetStablePowerState << "\n";
         out << VKPROF_SAMPLING_MODE_CVAR_NAME " " << static_cast<int>( m_SamplingMode ) << "\n";
         out << VKPROF_SYNC_MODE_CVAR_NAME " " << static_cast<int>( m_SyncMode ) << "\n";
+        out << VKPROF_OVERLAY_UPDATE_RATE_CVAR_NAME " " << m_OverlayUpdateRate << "\n";
+        out << VKPROF_TRACE_CAPTURE_FRAME_COUNT_CVAR_NAME " " << m_TraceCaptureFrameCount << "\n";
+
+        if( !m_PipelineStatisticsFile.empty() )
+        {
+            out << VKPROF_PIPELINE_STATISTICS_FILE_CVAR_NAME " " << m_PipelineStatisticsFile.string() << "\n";
+        }
+
+        if( !m_StatisticsDumpFile.empty() )
+        {
+            out << VKPROF_STATISTICS_DUMP_FILE_CVAR_NAME " " << m_StatisticsDumpFile.string() << "\n";
+        }
+
+        out << VKPROF_STATISTICS_DUMP_FRAME_INTERVAL_CVAR_NAME " " << m_StatisticsDumpFrameInterval << "\n";
+        out << VKPROF_STATISTICS_DUMP_TIME_INTERVAL_CVAR_NAME " " << m_StatisticsDumpTimeInterval << "\n";
+        out << VKPROF_STREAM_SERVER_PORT_CVAR_NAME " " << m_StreamServerPort << "\n";
+
+        if( !m_SharedMemoryRingName.empty() )
+        {
+            out << VKPROF_SHARED_MEMORY_RING_NAME_CVAR_NAME " " << m_SharedMemoryRingName << "\n";
+        }
+
+        out << VKPROF_SHARED_MEMORY_RING_SLOT_COUNT_CVAR_NAME " " << m_SharedMemoryRingSlotCount << "\n";
+        out << VKPROF_FRAME_HISTORY_SIZE_CVAR_NAME " " << m_FrameHistorySize << "\n";
+        out << VKPROF_ROLLING_STATISTICS_WINDOW_SIZE_CVAR_NAME " " << m_RollingStatisticsWindowSize << "\n";
     }
 
     void DeviceProfilerConfig::LoadFromFile( const std::filesystem::path& filename )
@@ -92,6 +128,72 @@ namespace Profiler
                     m_SyncMode = static_cast<VkProfilerSyncModeEXT>( atoi( value.c_str() ) );
                     continue;
                 }
+
+                if( strcmp( name.c_str(), VKPROF_OVERLAY_UPDATE_RATE_CVAR_NAME ) == 0 )
+                {
+                    m_OverlayUpdateRate = static_cast<uint32_t>( atoi( value.c_str() ) );
+                    continue;
+                }
+
+                if( strcmp( name.c_str(), VKPROF_TRACE_CAPTURE_FRAME_COUNT_CVAR_NAME ) == 0 )
+                {
+                    m_TraceCaptureFrameCount = static_cast<uint32_t>( atoi( value.c_str() ) );
+                    continue;
+                }
+
+                if( strcmp( name.c_str(), VKPROF_PIPELINE_STATISTICS_FILE_CVAR_NAME ) == 0 )
+                {
+                    m_PipelineStatisticsFile = value;
+                    continue;
+                }
+
+                if( strcmp( name.c_str(), VKPROF_STATISTICS_DUMP_FILE_CVAR_NAME ) == 0 )
+                {
+                    m_StatisticsDumpFile = value;
+                    continue;
+                }
+
+                if( strcmp( name.c_str(), VKPROF_STATISTICS_DUMP_FRAME_INTERVAL_CVAR_NAME ) == 0 )
+                {
+                    m_StatisticsDumpFrameInterval = static_cast<uint32_t>( atoi( value.c_str() ) );
+                    continue;
+                }
+
+                if( strcmp( name.c_str(), VKPROF_STATISTICS_DUMP_TIME_INTERVAL_CVAR_NAME ) == 0 )
+                {
+                    m_StatisticsDumpTimeInterval = static_cast<uint32_t>( atoi( value.c_str() ) );
+                    continue;
+                }
+
+                if( strcmp( name.c_str(), VKPROF_STREAM_SERVER_PORT_CVAR_NAME ) == 0 )
+                {
+                    m_StreamServerPort = static_cast<uint32_t>( atoi( value.c_str() ) );
+                    continue;
+                }
+
+                if( strcmp( name.c_str(), VKPROF_SHARED_MEMORY_RING_NAME_CVAR_NAME ) == 0 )
+                {
+                    m_SharedMemoryRingName = value;
+                    continue;
+                }
+
+                if( strcmp( name.c_str(), VKPROF_SHARED_MEMORY_RING_SLOT_COUNT_CVAR_NAME ) == 0 )
+                {
+                    m_SharedMemoryRingSlotCount = static_cast<uint32_t>( atoi( value.c_str() ) );
+                    continue;
+                }
+
+                if( strcmp( name.c_str(), VKPROF_FRAME_HISTORY_SIZE_CVAR_NAME ) == 0 )
+                {
+                    m_FrameHistorySize = static_cast<uint32_t>( atoi( value.c_str() ) );
+                    continue;
+                }
+
+                if( strcmp( name.c_str(), VKPROF_ROLLING_STATISTICS_WINDOW_SIZE_CVAR_NAME ) == 0 )
+                {
+                    m_RollingStatisticsWindowSize = static_cast<uint32_t>( atoi( value.c_str() ) );
+                    continue;
+                }
             }
         }
     }
@@ -137,5 +239,60 @@ namespace Profiler
         {
             m_SyncMode = static_cast<VkProfilerSyncModeEXT>( std::stoi( syncMode.value() ) );
         }
+
+        if( auto overlayUpdateRate = ProfilerPlatformFunctions::GetEnvironmentVar( VKPROF_GET_ENV_CVAR_NAME( VKPROF_OVERLAY_UPDATE_RATE_CVAR_NAME ) ) )
+        {
+            m_OverlayUpdateRate = static_cast<uint32_t>( std::stoi( overlayUpdateRate.value() ) );
+        }
+
+        if( auto traceCaptureFrameCount = ProfilerPlatformFunctions::GetEnvironmentVar( VKPROF_GET_ENV_CVAR_NAME( VKPROF_TRACE_CAPTURE_FRAME_COUNT_CVAR_NAME ) ) )
+        {
+            m_TraceCaptureFrameCount = static_cast<uint32_t>( std::stoi( traceCaptureFrameCount.value() ) );
+        }
+
+        if( auto pipelineStatisticsFile = ProfilerPlatformFunctions::GetEnvironmentVar( VKPROF_GET_ENV_CVAR_NAME( VKPROF_PIPELINE_STATISTICS_FILE_CVAR_NAME ) ) )
+        {
+            m_PipelineStatisticsFile = pipelineStatisticsFile.value();
+        }
+
+        if( auto statisticsDumpFile = ProfilerPlatformFunctions::GetEnvironmentVar( VKPROF_GET_ENV_CVAR_NAME( VKPROF_STATISTICS_DUMP_FILE_CVAR_NAME ) ) )
+        {
+            m_StatisticsDumpFile = statisticsDumpFile.value();
+        }
+
+        if( auto statisticsDumpFrameInterval = ProfilerPlatformFunctions::GetEnvironmentVar( VKPROF_GET_ENV_CVAR_NAME( VKPROF_STATISTICS_DUMP_FRAME_INTERVAL_CVAR_NAME ) ) )
+        {
+            m_StatisticsDumpFrameInterval = static_cast<uint32_t>( std::stoi( statisticsDumpFrameInterval.value() ) );
+        }
+
+        if( auto statisticsDumpTimeInterval = ProfilerPlatformFunctions::GetEnvironmentVar( VKPROF_GET_ENV_CVAR_NAME( VKPROF_STATISTICS_DUMP_TIME_INTERVAL_CVAR_NAME ) ) )
+        {
+            m_StatisticsDumpTimeInterval = static_cast<uint32_t>( std::stoi( statisticsDumpTimeInterval.value() ) );
+        }
+
+        if( auto streamServerPort = ProfilerPlatformFunctions::GetEnvironmentVar( VKPROF_GET_ENV_CVAR_NAME( VKPROF_STREAM_SERVER_PORT_CVAR_NAME ) ) )
+        {
+            m_StreamServerPort = static_cast<uint32_t>( std::stoi( streamServerPort.value() ) );
+        }
+
+        if( auto sharedMemoryRingName = ProfilerPlatformFunctions::GetEnvironmentVar( VKPROF_GET_ENV_CVAR_NAME( VKPROF_SHARED_MEMORY_RING_NAME_CVAR_NAME ) ) )
+        {
+            m_SharedMemoryRingName = sharedMemoryRingName.value();
+        }
+
+        if( auto sharedMemoryRingSlotCount = ProfilerPlatformFunctions::GetEnvironmentVar( VKPROF_GET_ENV_CVAR_NAME( VKPROF_SHARED_MEMORY_RING_SLOT_COUNT_CVAR_NAME ) ) )
+        {
+            m_SharedMemoryRingSlotCount = static_cast<uint32_t>( std::stoi( sharedMemoryRingSlotCount.value() ) );
+        }
+
+        if( auto frameHistorySize = ProfilerPlatformFunctions::GetEnvironmentVar( VKPROF_GET_ENV_CVAR_NAME( VKPROF_FRAME_HISTORY_SIZE_CVAR_NAME ) ) )
+        {
+            m_FrameHistorySize = static_cast<uint32_t>( std::stoi( frameHistorySize.value() ) );
+        }
+
+        if( auto rollingStatisticsWindowSize = ProfilerPlatformFunctions::GetEnvironmentVar( VKPROF_GET_ENV_CVAR_NAME( VKPROF_ROLLING_STATISTICS_WINDOW_SIZE_CVAR_NAME ) ) )
+        {
+            m_RollingStatisticsWindowSize = static_cast<uint32_t>( std::stoi( rollingStatisticsWindowSize.value() ) );
+        }
     }
 }
@@ -22,6 +22,7 @@
 #include "profiler_ext/VkProfilerEXT.h"
 
 #include <filesystem>
+#include <string>
 
 namespace Profiler
 {
@@ -46,6 +47,39 @@ namespace Profiler
         // Frequency of reading the timestamp queries.
         VkProfilerSyncModeEXT m_SyncMode = VK_PROFILER_SYNC_MODE_PRESENT_EXT;
 
+        // Number of overlay interface updates per second (0 - update on every present).
+        uint32_t m_OverlayUpdateRate = 0;
+
+        // Number of frames written to a single trace file after the overlay is created (0 - disabled).
+        uint32_t m_TraceCaptureFrameCount = 0;
+
+        // Path to the CSV file with per-frame pipeline statistics (empty - disabled).
+        std::filesystem::path m_PipelineStatisticsFile = {};
+
+        // Path to the file with periodically written aggregated statistics (empty - disabled).
+        std::filesystem::path m_StatisticsDumpFile = {};
+
+        // Number of frames aggregated in each statistics dump (0 - not limited by frame count).
+        uint32_t m_StatisticsDumpFrameInterval = 0;
+
+        // Time in milliseconds aggregated in each statistics dump (0 - not limited by time).
+        uint32_t m_StatisticsDumpTimeInterval = 1000;
+
+        // TCP port on the loopback interface on which the frame snapshots are streamed (0 - disabled).
+        uint32_t m_StreamServerPort = 0;
+
+        // Name of the shared memory object in which the frame snapshots are published (empty - disabled).
+        std::string m_SharedMemoryRingName = {};
+
+        // Number of frames kept in the shared memory ring.
+        uint32_t m_SharedMemoryRingSlotCount = 16;
+
+        // Number of frame summaries kept for vkGetProfilerFrameHistoryEXT.
+        uint32_t m_FrameHistorySize = 256;
+
+        // Number of frames covered by the rolling GPU time statistics.
+        uint32_t m_RollingStatisticsWindowSize = 120;
+
     public:
         void SaveToFile( const std::filesystem::path& filename ) const;
         void LoadFromFile( const std::filesystem::path& filename );
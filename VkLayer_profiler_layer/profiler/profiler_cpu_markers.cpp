@@ -0,0 +1,291 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "profiler_cpu_markers.h"
+#include "profiler_helpers.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Profiler
+{
+    // Identifies the instances in the per-thread buffer caches
+    static std::atomic<uint64_t> g_NextCpuMarkersInstanceId( 1 );
+
+    // Incremented when any instance is destroyed, so the threads drop the stale cache entries
+    static std::atomic<uint64_t> g_CpuMarkersDestroyCount( 0 );
+
+    /***********************************************************************************\
+
+    Function:
+        DeviceProfilerCpuMarkers
+
+    Description:
+        Constructor.
+
+    \***********************************************************************************/
+    DeviceProfilerCpuMarkers::DeviceProfilerCpuMarkers()
+        : m_InstanceId( g_NextCpuMarkersInstanceId.fetch_add( 1 ) )
+        , m_ThreadBuffersMutex()
+        , m_pThreadBuffers()
+    {
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        ~DeviceProfilerCpuMarkers
+
+    Description:
+        Destructor.
+
+    \***********************************************************************************/
+    DeviceProfilerCpuMarkers::~DeviceProfilerCpuMarkers()
+    {
+        Destroy();
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        Destroy
+
+    Description:
+        Release the per-thread buffers.
+
+    \***********************************************************************************/
+    void DeviceProfilerCpuMarkers::Destroy()
+    {
+        std::scoped_lock lk( m_ThreadBuffersMutex );
+
+        m_pThreadBuffers.clear();
+
+        // Invalidate buffers cached by the threads
+        m_InstanceId.store( g_NextCpuMarkersInstanceId.fetch_add( 1 ), std::memory_order_release );
+        g_CpuMarkersDestroyCount.fetch_add( 1, std::memory_order_release );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        BeginRegion
+
+    Description:
+        Record beginning of the CPU region in the calling thread's buffer.
+
+    \***********************************************************************************/
+    void DeviceProfilerCpuMarkers::BeginRegion( const char* pName, const float color[ 4 ] )
+    {
+        ThreadBuffer* pBuffer = GetThreadBuffer();
+
+        const uint32_t writeIndex = pBuffer->m_WriteIndex.load( std::memory_order_relaxed );
+        const uint32_t readIndex = pBuffer->m_ReadIndex.load( std::memory_order_acquire );
+
+        // Keep space for the end markers of all open regions, so that they are never dropped.
+        // Regions nested in a dropped region are dropped as well.
+        if( (pBuffer->m_SkippedDepth > 0) ||
+            ((writeIndex - readIndex) + pBuffer->m_RecordedDepth + 2 > ThreadBufferSize) )
+        {
+            pBuffer->m_SkippedDepth++;
+            return;
+        }
+
+        Marker& marker = pBuffer->m_pMarkers[ writeIndex % ThreadBufferSize ];
+        marker.m_Timestamp = std::chrono::high_resolution_clock::now();
+        marker.m_Begin = true;
+
+        if( color )
+        {
+            std::memcpy( marker.m_Color, color, sizeof( marker.m_Color ) );
+        }
+        else
+        {
+            std::memset( marker.m_Color, 0, sizeof( marker.m_Color ) );
+        }
+
+        ProfilerStringFunctions::CopyString( marker.m_Name, pName ? pName : "", SIZE_MAX );
+
+        pBuffer->m_RecordedDepth++;
+        pBuffer->m_WriteIndex.store( writeIndex + 1, std::memory_order_release );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        EndRegion
+
+    Description:
+        Record end of the last CPU region began in the calling thread.
+
+    \***********************************************************************************/
+    void DeviceProfilerCpuMarkers::EndRegion()
+    {
+        ThreadBuffer* pBuffer = GetThreadBuffer();
+
+        if( pBuffer->m_SkippedDepth > 0 )
+        {
+            // Begin marker of the region was dropped
+            pBuffer->m_SkippedDepth--;
+            return;
+        }
+
+        if( pBuffer->m_RecordedDepth == 0 )
+        {
+            // Unbalanced end marker
+            return;
+        }
+
+        const uint32_t writeIndex = pBuffer->m_WriteIndex.load( std::memory_order_relaxed );
+
+        // Space for the end marker has been reserved in BeginRegion
+        assert( writeIndex - pBuffer->m_ReadIndex.load( std::memory_order_acquire ) < ThreadBufferSize );
+
+        Marker& marker = pBuffer->m_pMarkers[ writeIndex % ThreadBufferSize ];
+        marker.m_Timestamp = std::chrono::high_resolution_clock::now();
+        marker.m_Begin = false;
+
+        pBuffer->m_RecordedDepth--;
+        pBuffer->m_WriteIndex.store( writeIndex + 1, std::memory_order_release );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        CollectRegions
+
+    Description:
+        Drain the per-thread buffers and return the regions that ended before
+        endTimestamp, sorted by the begin timestamp. Regions that are still open
+        are returned in the frame in which they end.
+
+    \***********************************************************************************/
+    void DeviceProfilerCpuMarkers::CollectRegions( std::chrono::high_resolution_clock::time_point endTimestamp, ContainerType<DeviceProfilerCpuRegionData>& regions )
+    {
+        std::scoped_lock lk( m_ThreadBuffersMutex );
+
+        regions.clear();
+
+        for( const auto& pBuffer : m_pThreadBuffers )
+        {
+            const uint32_t writeIndex = pBuffer->m_WriteIndex.load( std::memory_order_acquire );
+            uint32_t readIndex = pBuffer->m_ReadIndex.load( std::memory_order_relaxed );
+
+            while( readIndex != writeIndex )
+            {
+                const Marker& marker = pBuffer->m_pMarkers[ readIndex % ThreadBufferSize ];
+
+                if( marker.m_Timestamp > endTimestamp )
+                {
+                    // Marker belongs to the next frame
+                    break;
+                }
+
+                if( marker.m_Begin )
+                {
+                    DeviceProfilerCpuRegionData& region = pBuffer->m_OpenRegions.emplace_back();
+                    region.m_Name = marker.m_Name;
+                    region.m_ThreadId = pBuffer->m_ThreadId;
+                    region.m_Depth = static_cast<uint32_t>( pBuffer->m_OpenRegions.size() - 1 );
+                    region.m_BeginTimestamp = marker.m_Timestamp;
+                    std::memcpy( region.m_Color, marker.m_Color, sizeof( region.m_Color ) );
+                }
+                else if( !pBuffer->m_OpenRegions.empty() )
+                {
+                    DeviceProfilerCpuRegionData& region = regions.emplace_back( std::move( pBuffer->m_OpenRegions.back() ) );
+                    region.m_EndTimestamp = marker.m_Timestamp;
+                    pBuffer->m_OpenRegions.pop_back();
+                }
+
+                readIndex++;
+            }
+
+            pBuffer->m_ReadIndex.store( readIndex, std::memory_order_release );
+        }
+
+        // Parent regions first
+        std::sort( regions.begin(), regions.end(),
+            []( const DeviceProfilerCpuRegionData& a, const DeviceProfilerCpuRegionData& b )
+            {
+                return (a.m_BeginTimestamp < b.m_BeginTimestamp) ||
+                       ((a.m_BeginTimestamp == b.m_BeginTimestamp) && (a.m_Depth < b.m_Depth));
+            } );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        GetThreadBuffer
+
+    Description:
+        Get buffer of the calling thread. The buffer is created on the first call
+        from the thread.
+
+        Buffers are cached per thread to avoid taking the lock. The cache is
+        cleared after any instance is destroyed, so it holds only the buffers of
+        the live instances; the buffers of the live instances are found again
+        in m_pThreadBuffers.
+
+    \***********************************************************************************/
+    DeviceProfilerCpuMarkers::ThreadBuffer* DeviceProfilerCpuMarkers::GetThreadBuffer()
+    {
+        // Buffers used by the thread, the application may create more devices
+        static thread_local std::vector<std::pair<uint64_t, ThreadBuffer*>> s_pThreadBuffers;
+        static thread_local uint64_t s_DestroyCount = 0;
+
+        const uint64_t destroyCount = g_CpuMarkersDestroyCount.load( std::memory_order_acquire );
+        if( s_DestroyCount != destroyCount )
+        {
+            s_pThreadBuffers.clear();
+            s_DestroyCount = destroyCount;
+        }
+
+        const uint64_t currentInstanceId = m_InstanceId.load( std::memory_order_acquire );
+
+        for( const auto& [instanceId, pBuffer] : s_pThreadBuffers )
+        {
+            if( instanceId == currentInstanceId )
+            {
+                return pBuffer;
+            }
+        }
+
+        std::scoped_lock lk( m_ThreadBuffersMutex );
+
+        const uint32_t threadId = ProfilerPlatformFunctions::GetCurrentThreadId();
+
+        // Buffer may have been created before the cache was cleared
+        for( const auto& pBuffer : m_pThreadBuffers )
+        {
+            if( pBuffer->m_ThreadId == threadId )
+            {
+                s_pThreadBuffers.emplace_back( currentInstanceId, pBuffer.get() );
+                return pBuffer.get();
+            }
+        }
+
+        std::unique_ptr<ThreadBuffer> pBuffer = std::make_unique<ThreadBuffer>();
+        pBuffer->m_ThreadId = threadId;
+        pBuffer->m_pMarkers = std::make_unique<Marker[]>( ThreadBufferSize );
+
+        s_pThreadBuffers.emplace_back( currentInstanceId, pBuffer.get() );
+        m_pThreadBuffers.push_back( std::move( pBuffer ) );
+
+        return m_pThreadBuffers.back().get();
+    }
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "profiler_data.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Profiler
+{
+    /***********************************************************************************\
+
+    Class:
+        DeviceProfilerCpuMarkers
+
+    Description:
+        Collects CPU regions marked by the application with vkBeginProfilerCpuRegionEXT
+        and vkEndProfilerCpuRegionEXT.
+
+        Each thread records the markers into its own single-producer single-consumer
+        ring buffer, so no locks are taken when the markers are recorded (except for
+        the first marker recorded by the thread). The buffers are drained once per
+        frame by CollectRegions.
+
+    \***********************************************************************************/
+    class DeviceProfilerCpuMarkers
+    {
+    public:
+        // Maximum length of the region name, including null-terminator
+        static constexpr uint32_t MaxNameLength = 64;
+
+        // Number of markers that can be recorded by a thread during a frame
+        static constexpr uint32_t ThreadBufferSize = 4096;
+
+        DeviceProfilerCpuMarkers();
+        ~DeviceProfilerCpuMarkers();
+
+        void Destroy();
+
+        void BeginRegion( const char* pName, const float color[ 4 ] );
+        void EndRegion();
+
+        void CollectRegions( std::chrono::high_resolution_clock::time_point endTimestamp, ContainerType<DeviceProfilerCpuRegionData>& regions );
+
+    private:
+        struct Marker
+        {
+            std::chrono::high_resolution_clock::time_point m_Timestamp;
+            bool m_Begin;
+            float m_Color[ 4 ];
+            char m_Name[ MaxNameLength ];
+        };
+
+        struct ThreadBuffer
+        {
+            uint32_t m_ThreadId = 0;
+
+            // Written by the producer thread, read by the consumer
+            std::atomic<uint32_t> m_WriteIndex = 0;
+            // Written by the consumer, read by the producer thread
+            std::atomic<uint32_t> m_ReadIndex = 0;
+
+            std::unique_ptr<Marker[]> m_pMarkers;
+
+            // Accessed only by the producer thread
+            uint32_t m_RecordedDepth = 0;
+            uint32_t m_SkippedDepth = 0;
+
+            // Accessed only by the consumer
+            std::vector<DeviceProfilerCpuRegionData> m_OpenRegions;
+        };
+
+        // Changed in Destroy, read by the recording threads
+        std::atomic<uint64_t> m_InstanceId;
+
+        std::mutex m_ThreadBuffersMutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> m_pThreadBuffers;
+
+        ThreadBuffer* GetThreadBuffer();
+    };
+}
@@ -20,13 +20,16 @@
 
 #pragma once
 #include "profiler_shader.h"
+#include "profiler_string_table.h"
 #include <assert.h>
+#include <array>
 #include <chrono>
 #include <vector>
 #include <list>
 #include <deque>
 #include <unordered_map>
 #include <cstring>
+#include <string>
 #include <vulkan/vulkan.h>
 // Import extension structures
 #include "profiler_ext/VkProfilerEXT.h"
@@ -153,8 +156,14 @@ namespace Profiler
     \***********************************************************************************/
     struct DeviceProfilerDrawcallDebugLabelPayload
     {
-        char* m_pName;
+        // Id of the name in ProfilerStringTable
+        uint32_t m_NameId;
         float m_Color[ 4 ];
+
+        inline const char* GetName() const
+        {
+            return ProfilerStringTable::Get().GetString( m_NameId );
+        }
     };
 
     struct DeviceProfilerDrawcallDrawPayload
@@ -508,20 +517,14 @@ namespace Profiler
 
         inline DeviceProfilerDrawcall() = default;
 
-        // Debug labels must be handled here - library needs to extend lifetime of the
-        // string passed by the application to be able to print it later.
+        // Acceleration structure builds must be handled here - library needs to extend
+        // lifetime of the structures passed by the application to be able to print them later.
         inline DeviceProfilerDrawcall( const DeviceProfilerDrawcall& dc )
             : m_Type( dc.m_Type )
             , m_Payload( dc.m_Payload )
             , m_BeginTimestamp( dc.m_BeginTimestamp )
             , m_EndTimestamp( dc.m_EndTimestamp )
         {
-            if( dc.GetPipelineType() == DeviceProfilerPipelineType::eDebug )
-            {
-                // Create copy of already stored string
-                m_Payload.m_DebugLabel.m_pName = ProfilerStringFunctions::DuplicateString( dc.m_Payload.m_DebugLabel.m_pName );
-            }
-
             if( dc.m_Type == DeviceProfilerDrawcallType::eBuildAccelerationStructuresKHR )
             {
                 // Create copy of build infos
@@ -556,19 +559,14 @@ namespace Profiler
         inline DeviceProfilerDrawcall( DeviceProfilerDrawcall&& dc )
             : DeviceProfilerDrawcall()
         {
-            // No need to copy debug label string if we're moving from other drawcall
-            // Just make sure the original one is invalidated and won't be freed
+            // No need to copy build infos if we're moving from other drawcall
+            // Just make sure the original ones are invalidated and won't be freed
             Swap( dc );
         }
 
-        // Destroy drawcall - in case of debug labels free its name
+        // Destroy drawcall - in case of acceleration structure builds free its infos
         inline ~DeviceProfilerDrawcall()
         {
-            if( GetPipelineType() == DeviceProfilerPipelineType::eDebug )
-            {
-                free( m_Payload.m_DebugLabel.m_pName );
-            }
-
             if( m_Type == DeviceProfilerDrawcallType::eBuildAccelerationStructuresKHR )
             {
                 for( uint32_t i = 0; i < m_Payload.m_BuildAccelerationStructures.m_InfoCount; ++i )
@@ -948,6 +946,110 @@ namespace Profiler
 
     /***********************************************************************************\
 
+    Structure:
+        DeviceProfilerResourceMemoryData
+
+    Description:
+        Memory requirements and binding of a buffer or an image created by the
+        application. Exactly one of m_Buffer and m_Image is set.
+
+    \***********************************************************************************/
+    struct DeviceProfilerResourceMemoryData
+    {
+        VkBuffer m_Buffer = {};
+        VkImage m_Image = {};
+        VkDeviceMemory m_Memory = {};
+        VkDeviceSize m_MemoryOffset = {};
+        VkDeviceSize m_Size = {};
+        uint32_t m_Usage = {};
+        VkFormat m_Format = {};
+        VkExtent3D m_Extent = {};
+        bool m_Aliased = {};
+    };
+
+    /***********************************************************************************\
+
+    Structure:
+        DeviceProfilerAllocationMemoryData
+
+    Description:
+        Occupancy of a VkDeviceMemory allocation by the bound resources.
+        Fragmentation is 1 - (largest free range / total free size), so it is 0 when
+        the free space is contiguous.
+
+    \***********************************************************************************/
+    struct DeviceProfilerAllocationMemoryData
+    {
+        VkDeviceMemory m_Memory = {};
+        VkDeviceSize m_Size = {};
+        uint32_t m_MemoryTypeIndex = {};
+        uint32_t m_ResourceCount = {};
+        VkDeviceSize m_BoundSize = {};
+        VkDeviceSize m_AliasedSize = {};
+        VkDeviceSize m_LargestFreeRangeSize = {};
+        uint32_t m_FreeRangeCount = {};
+        float m_Fragmentation = {};
+    };
+
+    /***********************************************************************************\
+
+    Structure:
+        DeviceProfilerMemoryHeapChurnData
+
+    Description:
+        Allocations and frees on a memory heap during a single frame.
+
+    \***********************************************************************************/
+    struct DeviceProfilerMemoryHeapChurnData
+    {
+        uint32_t m_AllocationCount = {};
+        uint64_t m_AllocationSize = {};
+        uint32_t m_FreeCount = {};
+        uint64_t m_FreeSize = {};
+    };
+
+    /***********************************************************************************\
+
+    Structure:
+        DeviceProfilerMemoryChurnData
+
+    Description:
+        vkAllocateMemory and vkFreeMemory calls during a single frame.
+        Sizes of the allocations are counted in power-of-2 buckets, from below 8 kB
+        to 128 MB and above. Frames with significantly more allocations than the
+        previous frames are flagged as bursts.
+
+    \***********************************************************************************/
+    struct DeviceProfilerMemoryChurnData
+    {
+        static constexpr uint32_t SizeHistogramBucketCount = 16;
+        static constexpr uint32_t SizeHistogramFirstBucketBits = 13;
+
+        uint32_t m_AllocationCount = {};
+        uint64_t m_AllocationSize = {};
+        uint32_t m_FreeCount = {};
+        uint64_t m_FreeSize = {};
+        bool m_Burst = {};
+
+        std::array<uint32_t, SizeHistogramBucketCount> m_AllocationSizeHistogram = {};
+        std::vector<struct DeviceProfilerMemoryHeapChurnData> m_Heaps = {};
+
+        inline static uint32_t GetSizeHistogramBucketIndex( uint64_t size )
+        {
+            uint32_t bucketIndex = 0;
+
+            // Find the most significant bit above the first bucket
+            for( size >>= SizeHistogramFirstBucketBits; (size != 0) && (bucketIndex < SizeHistogramBucketCount - 1); size >>= 1 )
+            {
+                bucketIndex++;
+            }
+
+            return bucketIndex;
+        }
+    };
+
+    /***********************************************************************************\
+
     Structure:
         DeviceProfilerMemoryData
 
@@ -961,6 +1063,11 @@ namespace Profiler
 
         std::vector<struct DeviceProfilerMemoryHeapData> m_Heaps = {};
         std::vector<struct DeviceProfilerMemoryTypeData> m_Types = {};
+
+        std::vector<struct DeviceProfilerResourceMemoryData> m_LargestResources = {};
+        std::vector<struct DeviceProfilerAllocationMemoryData> m_FragmentedAllocations = {};
+
+        DeviceProfilerMemoryChurnData m_Churn = {};
     };
 
     /***********************************************************************************\
@@ -981,6 +1088,112 @@ namespace Profiler
 
     /***********************************************************************************\
 
+    Structure:
+        DeviceProfilerCpuRegionData
+
+    Description:
+        CPU region marked by the application with vkBeginProfilerCpuRegionEXT and
+        vkEndProfilerCpuRegionEXT.
+
+    \***********************************************************************************/
+    struct DeviceProfilerCpuRegionData
+    {
+        std::string                                         m_Name = {};
+        float                                               m_Color[ 4 ] = {};
+        uint32_t                                            m_ThreadId = {};
+        uint32_t                                            m_Depth = {};
+        std::chrono::high_resolution_clock::time_point      m_BeginTimestamp = {};
+        std::chrono::high_resolution_clock::time_point      m_EndTimestamp = {};
+    };
+
+    /***********************************************************************************\
+
+    Structure:
+        DeviceProfilerDebugLabelData
+
+    Description:
+        Node of the tree of debug labels used in the frame. Labels with the same path
+        (names of the label and all its parents) are merged into a single node.
+        Nodes are stored in depth-first order, so the subtree of a node immediately
+        follows the node.
+
+    \***********************************************************************************/
+    struct DeviceProfilerDebugLabelData
+    {
+        // Hash of the label path, stable across frames
+        uint64_t                                            m_PathId = {};
+
+        std::string                                         m_Name = {};
+        float                                               m_Color[ 4 ] = {};
+
+        uint32_t                                            m_ParentIndex = UINT32_MAX;
+        uint32_t                                            m_Depth = {};
+        uint32_t                                            m_ChildCount = {};
+        uint32_t                                            m_DescendantCount = {};
+
+        // Number of times the label was begun in the frame
+        uint32_t                                            m_InstanceCount = {};
+
+        // GPU time of the commands in the label, with and without the nested labels
+        uint64_t                                            m_InclusiveTicks = {};
+        uint64_t                                            m_ExclusiveTicks = {};
+
+        uint32_t                                            m_InclusiveDrawCount = {};
+        uint32_t                                            m_ExclusiveDrawCount = {};
+    };
+
+    /***********************************************************************************\
+
+    Enumeration:
+        DeviceProfilerRollingStatisticsType
+
+    Description:
+        Type of the object for which the rolling statistics are collected.
+
+    \***********************************************************************************/
+    enum class DeviceProfilerRollingStatisticsType : uint32_t
+    {
+        ePipeline,
+        eRenderPass,
+        eDebugLabel
+    };
+
+    /***********************************************************************************\
+
+    Structure:
+        DeviceProfilerRollingStatisticsData
+
+    Description:
+        Distribution of per-frame GPU time of a pipeline, render pass or debug label
+        over the last frames.
+
+    \***********************************************************************************/
+    struct DeviceProfilerRollingStatisticsData
+    {
+        DeviceProfilerRollingStatisticsType                 m_Type = {};
+
+        // Shader tuple hash, render pass handle or debug label path hash
+        uint64_t                                            m_Key = {};
+
+        // Object for which the statistics were collected
+        struct DeviceProfilerPipelineData                   m_Pipeline = {};
+        struct DeviceProfilerRenderPassData                 m_RenderPass = {};
+        std::string                                         m_DebugLabelPath = {};
+
+        // Number of frames in which the object was used
+        uint32_t                                            m_SampleCount = {};
+
+        uint64_t                                            m_MinTicks = {};
+        uint64_t                                            m_MaxTicks = {};
+        double                                              m_MeanTicks = {};
+        double                                              m_StdDevTicks = {};
+        uint64_t                                            m_P50Ticks = {};
+        uint64_t                                            m_P95Ticks = {};
+        uint64_t                                            m_P99Ticks = {};
+    };
+
+    /***********************************************************************************\
+
     Structure:
         DeviceProfilerFrameData
 
@@ -989,8 +1202,11 @@ namespace Profiler
     \***********************************************************************************/
     struct DeviceProfilerFrameData
     {
+        uint64_t                                            m_SequenceNumber = {};
+
         ContainerType<struct DeviceProfilerSubmitBatchData> m_Submits = {};
         ContainerType<struct DeviceProfilerPipelineData>    m_TopPipelines = {};
+        ContainerType<struct DeviceProfilerDebugLabelData>  m_DebugLabels = {};
 
         DeviceProfilerDrawcallStats                         m_Stats = {};
 
@@ -998,6 +1214,7 @@ namespace Profiler
 
         DeviceProfilerMemoryData                            m_Memory = {};
         DeviceProfilerCPUData                               m_CPU = {};
+        ContainerType<struct DeviceProfilerCpuRegionData>   m_CpuRegions = {};
 
         std::vector<VkProfilerPerformanceCounterResultEXT>  m_VendorMetrics = {};
 
@@ -110,6 +110,298 @@ namespace Profiler
 
     /***********************************************************************************\
 
+    Class:
+        DebugLabelTreeBuilder
+
+    Description:
+        Merges debug labels used in the frame into a tree of label paths.
+
+    \***********************************************************************************/
+    class DebugLabelTreeBuilder
+    {
+    public:
+        /*******************************************************************************\
+
+        Function:
+            AppendSubmitBatch
+
+        Description:
+            Add labels used in the submitted command buffers. Labels are tracked
+            separately for each queue, and labels left open at the end of the previous
+            frame are continued in this frame.
+
+        \*******************************************************************************/
+        void AppendSubmitBatch(
+            const DeviceProfilerSubmitBatchData& submitBatch,
+            ProfilerDataAggregator::QueueDebugLabels& queueLabels )
+        {
+            auto [it, inserted] = m_Stacks.try_emplace( submitBatch.m_Handle );
+            std::vector<uint32_t>& stack = it->second;
+
+            if( inserted )
+            {
+                for( const auto& openLabel : queueLabels.m_OpenLabels )
+                {
+                    BeginLabel( stack, openLabel );
+                }
+            }
+
+            for( const auto& submit : submitBatch.m_Submits )
+            {
+                for( const auto& commandBuffer : submit.m_CommandBuffers )
+                {
+                    AppendCommandBuffer( commandBuffer, queueLabels, stack );
+                }
+            }
+        }
+
+        /*******************************************************************************\
+
+        Function:
+            AppendCommandBuffer
+
+        Description:
+            Add labels and commands recorded in the command buffer.
+
+        \*******************************************************************************/
+        void AppendCommandBuffer(
+            const DeviceProfilerCommandBufferData& commandBuffer,
+            ProfilerDataAggregator::QueueDebugLabels& queueLabels,
+            std::vector<uint32_t>& stack )
+        {
+            for( const auto& renderPass : commandBuffer.m_RenderPasses )
+            {
+                for( const auto& subpass : renderPass.m_Subpasses )
+                {
+                    if( subpass.m_Contents == VK_SUBPASS_CONTENTS_INLINE )
+                    {
+                        for( const auto& pipeline : subpass.m_Pipelines )
+                        {
+                            for( const auto& drawcall : pipeline.m_Drawcalls )
+                            {
+                                AppendDrawcall( drawcall, queueLabels, stack );
+                            }
+                        }
+                    }
+
+                    else if( subpass.m_Contents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS )
+                    {
+                        for( const auto& secondaryCommandBuffer : subpass.m_SecondaryCommandBuffers )
+                        {
+                            AppendCommandBuffer( secondaryCommandBuffer, queueLabels, stack );
+                        }
+                    }
+                }
+            }
+        }
+
+        /*******************************************************************************\
+
+        Function:
+            AppendDrawcall
+
+        Description:
+            Begin or end the label, or add the command to the innermost label.
+
+        \*******************************************************************************/
+        void AppendDrawcall(
+            const DeviceProfilerDrawcall& drawcall,
+            ProfilerDataAggregator::QueueDebugLabels& queueLabels,
+            std::vector<uint32_t>& stack )
+        {
+            switch( drawcall.m_Type )
+            {
+            case DeviceProfilerDrawcallType::eBeginDebugLabel:
+            {
+                if( queueLabels.m_OpenLabels.size() >= ProfilerDataAggregator::MaxDebugLabelDepth )
+                {
+                    queueLabels.m_SkippedLabelCount++;
+                    break;
+                }
+
+                BeginLabel( stack, drawcall.m_Payload.m_DebugLabel );
+                queueLabels.m_OpenLabels.push_back( drawcall.m_Payload.m_DebugLabel );
+                break;
+            }
+
+            case DeviceProfilerDrawcallType::eEndDebugLabel:
+            {
+                if( queueLabels.m_SkippedLabelCount > 0 )
+                {
+                    queueLabels.m_SkippedLabelCount--;
+                }
+                else if( !stack.empty() )
+                {
+                    stack.pop_back();
+                    queueLabels.m_OpenLabels.pop_back();
+                }
+                break;
+            }
+
+            case DeviceProfilerDrawcallType::eInsertDebugLabel:
+                break;
+
+            default:
+                AppendCommand( stack, drawcall );
+                break;
+            }
+        }
+
+        /*******************************************************************************\
+
+        Function:
+            BeginLabel
+
+        Description:
+            Push the label's node on the stack.
+
+        \*******************************************************************************/
+        void BeginLabel( std::vector<uint32_t>& stack, const DeviceProfilerDrawcallDebugLabelPayload& label )
+        {
+            const char* pName = label.GetName();
+            if( pName == nullptr )
+            {
+                pName = "";
+            }
+
+            const uint32_t parentIndex = stack.empty() ? UINT32_MAX : stack.back();
+
+            // FNV-1a hash of the label path
+            uint64_t pathId = 0xcbf29ce484222325ULL;
+
+            if( parentIndex != UINT32_MAX )
+            {
+                // Separate the path components with a byte which can't appear in the names,
+                // so a flat label "a/b" doesn't collide with label "b" nested in label "a"
+                pathId = (m_Nodes[ parentIndex ].m_PathId ^ '\0') * 0x100000001b3ULL;
+            }
+
+            for( const char* pChar = pName; *pChar; ++pChar )
+            {
+                pathId = (pathId ^ static_cast<uint8_t>( *pChar )) * 0x100000001b3ULL;
+            }
+
+            auto [it, inserted] = m_NodeIndices.try_emplace( pathId, static_cast<uint32_t>( m_Nodes.size() ) );
+
+            if( inserted )
+            {
+                DeviceProfilerDebugLabelData& node = m_Nodes.emplace_back();
+                node.m_PathId = pathId;
+                node.m_Name = pName;
+                node.m_ParentIndex = parentIndex;
+                node.m_Depth = static_cast<uint32_t>( stack.size() );
+                std::copy( label.m_Color, label.m_Color + 4, node.m_Color );
+            }
+
+            m_Nodes[ it->second ].m_InstanceCount++;
+            stack.push_back( it->second );
+        }
+
+        /*******************************************************************************\
+
+        Function:
+            AppendCommand
+
+        Description:
+            Add the command to the innermost label.
+
+        \*******************************************************************************/
+        void AppendCommand( const std::vector<uint32_t>& stack, const DeviceProfilerDrawcall& drawcall )
+        {
+            if( stack.empty() )
+            {
+                // Commands outside of the labels are not included in the tree
+                return;
+            }
+
+            DeviceProfilerDebugLabelData& node = m_Nodes[ stack.back() ];
+
+            if( (drawcall.m_BeginTimestamp.m_Value != UINT64_MAX) &&
+                (drawcall.m_EndTimestamp.m_Value != UINT64_MAX) )
+            {
+                node.m_ExclusiveTicks += (drawcall.m_EndTimestamp.m_Value - drawcall.m_BeginTimestamp.m_Value);
+            }
+
+            if( drawcall.GetPipelineType() == DeviceProfilerPipelineType::eGraphics )
+            {
+                node.m_ExclusiveDrawCount++;
+            }
+        }
+
+        /*******************************************************************************\
+
+        Function:
+            GetTree
+
+        Description:
+            Compute inclusive values and sort the nodes in depth-first order.
+
+        \*******************************************************************************/
+        ContainerType<DeviceProfilerDebugLabelData> GetTree()
+        {
+            const uint32_t nodeCount = static_cast<uint32_t>( m_Nodes.size() );
+
+            // Parents are always created before their children
+            std::vector<std::vector<uint32_t>> children( nodeCount );
+            std::vector<uint32_t> roots;
+
+            for( uint32_t i = nodeCount; i-- > 0; )
+            {
+                DeviceProfilerDebugLabelData& node = m_Nodes[ i ];
+                node.m_InclusiveTicks += node.m_ExclusiveTicks;
+                node.m_InclusiveDrawCount += node.m_ExclusiveDrawCount;
+
+                if( node.m_ParentIndex != UINT32_MAX )
+                {
+                    DeviceProfilerDebugLabelData& parent = m_Nodes[ node.m_ParentIndex ];
+                    parent.m_InclusiveTicks += node.m_InclusiveTicks;
+                    parent.m_InclusiveDrawCount += node.m_InclusiveDrawCount;
+                    parent.m_DescendantCount += node.m_DescendantCount + 1;
+                    parent.m_ChildCount++;
+                    children[ node.m_ParentIndex ].push_back( i );
+                }
+                else
+                {
+                    roots.push_back( i );
+                }
+            }
+
+            ContainerType<DeviceProfilerDebugLabelData> tree;
+
+            // Visit the nodes in order of creation, the lists were filled in reverse order
+            std::vector<std::pair<uint32_t, uint32_t>> pendingNodes;
+
+            for( uint32_t root : roots )
+            {
+                pendingNodes.push_back( { root, UINT32_MAX } );
+            }
+
+            while( !pendingNodes.empty() )
+            {
+                const auto [nodeIndex, parentIndex] = pendingNodes.back();
+                pendingNodes.pop_back();
+
+                const uint32_t treeIndex = static_cast<uint32_t>( tree.size() );
+                DeviceProfilerDebugLabelData& node = tree.emplace_back( std::move( m_Nodes[ nodeIndex ] ) );
+                node.m_ParentIndex = parentIndex;
+
+                for( uint32_t child : children[ nodeIndex ] )
+                {
+                    pendingNodes.push_back( { child, treeIndex } );
+                }
+            }
+
+            return tree;
+        }
+
+    private:
+        std::vector<DeviceProfilerDebugLabelData> m_Nodes;
+        std::unordered_map<uint64_t, uint32_t> m_NodeIndices;
+        std::unordered_map<VkQueue, std::vector<uint32_t>> m_Stacks;
+    };
+
+    /***********************************************************************************\
+
     Function:
         Initialize
 
@@ -130,13 +422,13 @@ namespace Profiler
         AppendSubmit
 
     Description:
-        Add submit data to the aggregator.
+        Add submit data to the aggregator. Can be called concurrently from multiple
+        queues without blocking.
 
     \***********************************************************************************/
-    void ProfilerDataAggregator::AppendSubmit( const DeviceProfilerSubmitBatch& submit )
+    void ProfilerDataAggregator::AppendSubmit( DeviceProfilerSubmitBatch&& submit )
     {
-        std::scoped_lock lk( m_Mutex );
-        m_Submits.push_back( submit );
+        m_Submits.push( std::move( submit ) );
     }
 
     /***********************************************************************************\
@@ -165,13 +457,15 @@ namespace Profiler
     \***********************************************************************************/
     void ProfilerDataAggregator::Aggregate()
     {
-        decltype(m_Submits) submits;
+        ContainerType<DeviceProfilerSubmitBatch> submits;
         decltype(m_Data) data;
 
-        // Copy submits and data to local memory
+        // Move submits and data to local memory
+        // Data of the command buffers freed after the submits must be taken together with them
         {
             std::scoped_lock lk( m_Mutex );
-            std::swap( m_Submits, submits );
+            m_Submits.consume_all( [&]( DeviceProfilerSubmitBatch&& submitBatch ) {
+                submits.push_back( std::move( submitBatch ) ); } );
             std::swap( m_Data, data );
         }
 
@@ -218,13 +512,13 @@ namespace Profiler
     /***********************************************************************************\
 
     Function:
-        Reset
+        ResetFrame
 
     Description:
-        Clear results map.
+        Clear results map. Debug labels left open are kept for the next frame.
 
     \***********************************************************************************/
-    void ProfilerDataAggregator::Reset()
+    void ProfilerDataAggregator::ResetFrame()
     {
         std::scoped_lock lk( m_Mutex );
         m_Submits.clear();
@@ -234,6 +528,22 @@ namespace Profiler
 
     /***********************************************************************************\
 
+    Function:
+        Reset
+
+    Description:
+        Clear results map and debug labels left open, so the next data set starts
+        with an empty label stack on each queue.
+
+    \***********************************************************************************/
+    void ProfilerDataAggregator::Reset()
+    {
+        ResetFrame();
+        m_DebugLabels.clear();
+    }
+
+    /***********************************************************************************\
+
     Function:
         GetAggregatedData
 
@@ -248,6 +558,7 @@ namespace Profiler
 
         DeviceProfilerFrameData frameData;
         frameData.m_TopPipelines = CollectTopPipelines();
+        frameData.m_DebugLabels = CollectDebugLabels();
         frameData.m_VendorMetrics = AggregateVendorMetrics();
 
         // Collect per-frame stats
@@ -458,6 +769,28 @@ namespace Profiler
 
     /***********************************************************************************\
 
+    Function:
+        CollectDebugLabels
+
+    Description:
+        Build tree of debug labels used in the frame, with GPU time and number of
+        draws in each label.
+
+    \***********************************************************************************/
+    ContainerType<DeviceProfilerDebugLabelData> ProfilerDataAggregator::CollectDebugLabels()
+    {
+        DebugLabelTreeBuilder builder;
+
+        for( const auto& submitBatch : m_AggregatedData )
+        {
+            builder.AppendSubmitBatch( submitBatch, m_DebugLabels[ submitBatch.m_Handle ] );
+        }
+
+        return builder.GetTree();
+    }
+
+    /***********************************************************************************\
+
     Function:
         CollectPipelinesFromCommandBuffer
 
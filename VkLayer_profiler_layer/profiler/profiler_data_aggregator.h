@@ -21,6 +21,7 @@
 #pragma once
 #include "profiler_data.h"
 #include "profiler_command_buffer.h"
+#include "lockfree_mpsc_queue.h"
 #include <list>
 #include <map>
 #include <mutex>
@@ -32,6 +33,7 @@
 namespace Profiler
 {
     class DeviceProfiler;
+    class DebugLabelTreeBuilder;
 
     struct DeviceProfilerSubmit
     {
@@ -59,13 +61,16 @@ namespace Profiler
     \***********************************************************************************/
     class ProfilerDataAggregator
     {
+        friend class DebugLabelTreeBuilder;
+
     public:
         VkResult Initialize( DeviceProfiler* );
 
-        void AppendSubmit( const DeviceProfilerSubmitBatch& );
+        void AppendSubmit( DeviceProfilerSubmitBatch&& );
         void AppendData( ProfilerCommandBuffer*, const DeviceProfilerCommandBufferData& );
         
         void Aggregate();
+        void ResetFrame();
         void Reset();
 
         DeviceProfilerFrameData GetAggregatedData();
@@ -73,13 +78,26 @@ namespace Profiler
     private:
         DeviceProfiler* m_pProfiler;
 
-        ContainerType<DeviceProfilerSubmitBatch> m_Submits;
+        // Submits are appended concurrently from all queues without locking
+        MpscQueue<DeviceProfilerSubmitBatch> m_Submits;
         ContainerType<DeviceProfilerSubmitBatchData> m_AggregatedData;
 
         std::unordered_map<ProfilerCommandBuffer*, DeviceProfilerCommandBufferData> m_Data;
 
         std::mutex m_Mutex;
 
+        // Debug labels left open at the end of the previous frames
+        struct QueueDebugLabels
+        {
+            std::vector<DeviceProfilerDrawcallDebugLabelPayload> m_OpenLabels;
+            uint32_t m_SkippedLabelCount = 0;
+        };
+
+        // Limits memory used by applications which don't end the labels
+        static constexpr uint32_t MaxDebugLabelDepth = 64;
+
+        std::unordered_map<VkQueue, QueueDebugLabels> m_DebugLabels;
+
         // Vendor-specific metric properties
         std::vector<VkProfilerPerformanceCounterPropertiesEXT> m_VendorMetricProperties;
         uint32_t                                               m_VendorMetricsSetIndex;
@@ -88,6 +106,7 @@ namespace Profiler
         std::vector<VkProfilerPerformanceCounterResultEXT> AggregateVendorMetrics() const;
 
         ContainerType<DeviceProfilerPipelineData> CollectTopPipelines() const;
+        ContainerType<DeviceProfilerDebugLabelData> CollectDebugLabels();
 
         void CollectPipelinesFromCommandBuffer(
             const DeviceProfilerCommandBufferData&,
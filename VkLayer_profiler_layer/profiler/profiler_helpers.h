@@ -544,6 +544,7 @@ namespace Profiler
 
         static uint32_t GetCurrentThreadId();
         static uint32_t GetCurrentProcessId();
+        static bool IsProcessRunning( uint32_t processId );
 
         static void GetLocalTime( tm*, const time_t& );
 
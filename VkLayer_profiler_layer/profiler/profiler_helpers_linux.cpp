@@ -23,6 +23,8 @@
 
 #include <assert.h>
 
+#include <errno.h>
+#include <signal.h>
 #include <unistd.h>
 #include <limits.h>
 #include <sys/types.h>
@@ -172,6 +174,21 @@ namespace Profiler
     {
         return static_cast<uint32_t>(getpid());
     }
+
+    /***********************************************************************************\
+
+    Function:
+        IsProcessRunning
+
+    Description:
+        Check if the process with the given identifier exists.
+
+    \***********************************************************************************/
+    bool ProfilerPlatformFunctions::IsProcessRunning( uint32_t processId )
+    {
+        // Signal 0 only checks if the signal could be sent
+        return (kill( static_cast<pid_t>(processId), 0 ) == 0) || (errno != ESRCH);
+    }
     
     /***********************************************************************************\
 
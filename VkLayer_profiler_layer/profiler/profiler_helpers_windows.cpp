@@ -356,6 +356,30 @@ namespace Profiler
 
     /***********************************************************************************\
 
+    Function:
+        IsProcessRunning
+
+    Description:
+        Check if the process with the given identifier exists.
+
+    \***********************************************************************************/
+    bool ProfilerPlatformFunctions::IsProcessRunning( uint32_t processId )
+    {
+        HANDLE hProcess = OpenProcess( SYNCHRONIZE, FALSE, processId );
+
+        if( hProcess == nullptr )
+        {
+            // The process may exist but can't be opened by the caller
+            return GetLastError() != ERROR_INVALID_PARAMETER;
+        }
+
+        const bool running = (WaitForSingleObject( hProcess, 0 ) == WAIT_TIMEOUT);
+        CloseHandle( hProcess );
+        return running;
+    }
+
+    /***********************************************************************************\
+
     Function:
         GetLocalTime
 
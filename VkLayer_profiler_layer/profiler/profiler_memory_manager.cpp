@@ -21,17 +21,31 @@
 #include "profiler_memory_manager.h"
 #include "profiler_layer_objects/VkDevice_object.h"
 
+#include <algorithm>
 #include <assert.h>
 
 namespace Profiler
 {
+    static constexpr uint32_t InvalidBlockIndex = UINT32_MAX;
+
+    // Pools are limited to 2^31 blocks, so the block indices and the free order mask fit in 32 bits.
+    static constexpr uint32_t MaxBlockOrder = 31;
+
+    // Returns the smallest order N such that 2^N >= blockCount.
+    static uint32_t GetBlockOrder( VkDeviceSize blockCount )
+    {
+        uint32_t order = 0;
+        while( (order <= MaxBlockOrder) && ((VkDeviceSize( 1 ) << order) < blockCount) )
+            ++order;
+        return order;
+    }
+
     DeviceProfilerMemoryManager::DeviceProfilerMemoryManager()
         : m_pDevice( nullptr )
-        , m_MemoryAllocationMutex()
         , m_DefaultMemoryPoolSize( 16 * 1024 * 1024 )
         , m_DefaultMemoryBlockSize( 4 * 1024 )
         , m_DeviceMemoryProperties()
-        , m_MemoryPools()
+        , m_MemoryTypes()
     {
     }
 
@@ -43,21 +57,27 @@ namespace Profiler
         // Get device memory properties.
         m_DeviceMemoryProperties = m_pDevice->pPhysicalDevice->MemoryProperties;
 
+        // Mutexes can't be moved, so the vector is created with the final size.
+        m_MemoryTypes = std::vector<MemoryTypePools>( m_DeviceMemoryProperties.memoryTypeCount );
+
         return VK_SUCCESS;
     }
 
     void DeviceProfilerMemoryManager::Destroy()
     {
         // Free all device memory allocations.
-        for( auto& memoryPool : m_MemoryPools )
+        for( auto& memoryType : m_MemoryTypes )
         {
-            m_pDevice->Callbacks.FreeMemory(
-                m_pDevice->Handle,
-                memoryPool.m_DeviceMemory,
-                nullptr );
+            for( auto& memoryPool : memoryType.m_Pools )
+            {
+                m_pDevice->Callbacks.FreeMemory(
+                    m_pDevice->Handle,
+                    memoryPool.m_DeviceMemory,
+                    nullptr );
+            }
         }
 
-        m_MemoryPools.clear();
+        m_MemoryTypes.clear();
 
         // Invalidate pointer to the device object.
         m_pDevice = nullptr;
@@ -68,111 +88,79 @@ namespace Profiler
         VkMemoryPropertyFlags requiredFlags,
         DeviceProfilerMemoryAllocation* pAllocation )
     {
-        std::scoped_lock lk( m_MemoryAllocationMutex );
+        // Find suitable memory type index.
+        uint32_t memoryTypeIndex = UINT32_MAX;
+        for( uint32_t i = 0; i < m_DeviceMemoryProperties.memoryTypeCount; ++i )
+        {
+            const auto& memoryProperties = m_DeviceMemoryProperties.memoryTypes[ i ];
+            if( ((memoryRequirements.memoryTypeBits & (1U << i)) != 0) &&
+                ((memoryProperties.propertyFlags & requiredFlags) == requiredFlags) )
+            {
+                memoryTypeIndex = i;
+                break;
+            }
+        }
+
+        if( memoryTypeIndex == UINT32_MAX )
+        {
+            // Required memory type not found.
+            return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+        }
+
+        // Compute order of the allocation. Ranges of 2^N blocks are aligned to their size,
+        // so the order is also increased to satisfy the alignment requirement.
+        const VkDeviceSize requiredBlockCount = std::max<VkDeviceSize>( 1,
+            (memoryRequirements.size + m_DefaultMemoryBlockSize - 1) / m_DefaultMemoryBlockSize );
+        const VkDeviceSize alignmentBlockCount =
+            (memoryRequirements.alignment + m_DefaultMemoryBlockSize - 1) / m_DefaultMemoryBlockSize;
+
+        const uint32_t order = GetBlockOrder( std::max( requiredBlockCount, alignmentBlockCount ) );
 
-        VkResult result = VK_ERROR_FRAGMENTED_POOL;
+        if( order > MaxBlockOrder )
+        {
+            return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+        }
+
+        MemoryTypePools& memoryType = m_MemoryTypes[ memoryTypeIndex ];
+        std::scoped_lock lk( memoryType.m_Mutex );
 
-        // Compute number of blocks that have to be allocated.
-        const size_t requiredBlockCount = (memoryRequirements.size + m_DefaultMemoryBlockSize - 1) / m_DefaultMemoryBlockSize; 
+        VkResult result = VK_SUCCESS;
+        DeviceProfilerMemoryPool* pMemoryPool = nullptr;
 
-        // Try to suballocate from an existing pool.
-        for( auto& memoryPool : m_MemoryPools )
+        // Try to suballocate from an existing pool with a free range large enough.
+        for( auto& memoryPool : memoryType.m_Pools )
         {
-            if( (memoryPool.m_FreeSize >= memoryRequirements.size) &&
-                ((memoryPool.m_Flags & requiredFlags) == requiredFlags) &&
-                ((memoryRequirements.memoryTypeBits & (1U << memoryPool.m_MemoryTypeIndex)) != 0) )
+            if( (order <= memoryPool.m_MaxOrder) &&
+                ((memoryPool.m_FreeOrderMask >> order) != 0) )
             {
-                size_t firstFreeBlockIndex = 0;
-                size_t freeBlockCount = 0;
-
-                const size_t memoryPoolBlockCount = memoryPool.m_Allocations.size();
-                for( size_t i = 0; i < memoryPoolBlockCount; ++i )
-                {
-                    // Skip allocated blocks.
-                    while( (i < memoryPoolBlockCount) &&
-                           (memoryPool.m_Allocations[i]) )
-                        ++i;
-
-                    // Find first free block with the required alignment.
-                    while( (i < memoryPoolBlockCount) &&
-                            !(memoryPool.m_Allocations[i]) &&
-                            (((i * m_DefaultMemoryBlockSize) & (memoryRequirements.alignment - 1)) != 0) )
-                        ++i;
-
-                    firstFreeBlockIndex = i;
-                    freeBlockCount = 0;
-
-                    // Count free blocks.
-                    while( (i < memoryPoolBlockCount) &&
-                           (freeBlockCount < requiredBlockCount) &&
-                           !(memoryPool.m_Allocations[i]) )
-                        ++i, ++freeBlockCount;
-
-                    if( freeBlockCount == requiredBlockCount )
-                        break;
-                }
-
-                // Check if memory can be suballocated.
-                if( freeBlockCount == requiredBlockCount )
-                {
-                    // Mark blocks as allocated.
-                    const size_t lastBlockIndex = firstFreeBlockIndex + freeBlockCount;
-                    for( size_t i = firstFreeBlockIndex; i < lastBlockIndex; ++i )
-                    {
-                        memoryPool.m_Allocations[ i ] = true;
-                    }
-
-                    // Create allocation struct.
-                    pAllocation->m_pPool = &memoryPool;
-                    pAllocation->m_Offset = firstFreeBlockIndex * m_DefaultMemoryBlockSize;
-                    pAllocation->m_Size = freeBlockCount * m_DefaultMemoryBlockSize;
-                    pAllocation->m_pMappedMemory = nullptr;
-
-                    if( memoryPool.m_pMappedMemory != nullptr )
-                    {
-                        pAllocation->m_pMappedMemory =
-                            reinterpret_cast<std::byte*>( memoryPool.m_pMappedMemory ) + pAllocation->m_Offset;
-                    }
-
-                    result = VK_SUCCESS;
-                }
+                pMemoryPool = &memoryPool;
+                break;
             }
         }
 
-        if( result != VK_SUCCESS )
+        if( pMemoryPool == nullptr )
         {
             // Create new memory pool.
-            DeviceProfilerMemoryPool* pMemoryPool = nullptr;
-            result = AllocatePool(
-                std::max( memoryRequirements.size, m_DefaultMemoryPoolSize ),
-                memoryRequirements.memoryTypeBits,
-                requiredFlags,
-                &pMemoryPool );
-
-            if( result == VK_SUCCESS )
-            {
-                // Mark blocks as allocated.
-                for( size_t i = 0; i < requiredBlockCount; ++i )
-                {
-                    pMemoryPool->m_Allocations[ i ] = true;
-                }
-
-                // Create allocation struct.
-                pAllocation->m_pPool = pMemoryPool;
-                pAllocation->m_Offset = 0;
-                pAllocation->m_Size = requiredBlockCount * m_DefaultMemoryBlockSize;
-
-                if( pAllocation->m_pPool->m_pMappedMemory != nullptr )
-                {
-                    pAllocation->m_pMappedMemory =
-                        reinterpret_cast<std::byte*>( pMemoryPool->m_pMappedMemory ) + pAllocation->m_Offset;
-                }
-            }
+            result = AllocatePool( memoryTypeIndex, order, &pMemoryPool );
         }
 
         if( result == VK_SUCCESS )
         {
-            pAllocation->m_pPool->m_FreeSize -= pAllocation->m_Size;
+            const uint32_t blockIndex = AllocateBlocks( pMemoryPool, order );
+
+            // Create allocation struct.
+            pAllocation->m_pPool = pMemoryPool;
+            pAllocation->m_Offset = blockIndex * m_DefaultMemoryBlockSize;
+            pAllocation->m_Size = m_DefaultMemoryBlockSize << order;
+            pAllocation->m_pMappedMemory = nullptr;
+
+            if( pMemoryPool->m_pMappedMemory != nullptr )
+            {
+                pAllocation->m_pMappedMemory =
+                    reinterpret_cast<std::byte*>( pMemoryPool->m_pMappedMemory ) + pAllocation->m_Offset;
+            }
+
+            pMemoryPool->m_FreeSize -= pAllocation->m_Size;
         }
 
         return result;
@@ -181,88 +169,77 @@ namespace Profiler
     void DeviceProfilerMemoryManager::FreeMemory(
         DeviceProfilerMemoryAllocation* pAllocation )
     {
-        std::scoped_lock lk( m_MemoryAllocationMutex );
-
         auto* pMemoryPool = pAllocation->m_pPool;
 
-        const size_t firstBlockIndex = pAllocation->m_Offset / m_DefaultMemoryBlockSize;
-        const size_t blockCount = pAllocation->m_Size / m_DefaultMemoryBlockSize;
+        std::scoped_lock lk( m_MemoryTypes[ pMemoryPool->m_MemoryTypeIndex ].m_Mutex );
 
-        // Mark blocks as free.
-        const size_t lastBlockIndex = firstBlockIndex + blockCount;
-        for( size_t i = firstBlockIndex; i < lastBlockIndex; ++i )
-        {
-            pMemoryPool->m_Allocations[ i ] = false;
-        }
+        FreeBlocks( pMemoryPool, static_cast<uint32_t>( pAllocation->m_Offset / m_DefaultMemoryBlockSize ) );
 
         pMemoryPool->m_FreeSize += pAllocation->m_Size;
     }
 
     VkResult DeviceProfilerMemoryManager::AllocatePool(
-        VkDeviceSize size,
-        uint32_t requiredTypeBits,
-        VkMemoryPropertyFlags requiredFlags,
+        uint32_t memoryTypeIndex,
+        uint32_t order,
         DeviceProfilerMemoryPool** ppPool )
     {
         VkResult result = VK_SUCCESS;
         try
         {
-            const size_t blockCount = ((size + m_DefaultMemoryBlockSize - 1) / m_DefaultMemoryBlockSize);
-
-            auto* pMemoryPool = &m_MemoryPools.emplace_back();
-            pMemoryPool->m_Allocations.resize( blockCount );
-            pMemoryPool->m_Size = blockCount * m_DefaultMemoryBlockSize;
-            pMemoryPool->m_FreeSize = pMemoryPool->m_Size;
-
-            // Find suitable memory type index.
-            pMemoryPool->m_MemoryTypeIndex = UINT32_MAX;
-            for( uint32_t i = 0; i < m_DeviceMemoryProperties.memoryTypeCount; ++i )
-            {
-                const auto& memoryProperties = m_DeviceMemoryProperties.memoryTypes[ i ];
-                if( ((requiredTypeBits & (1U << i)) != 0) &&
-                    ((memoryProperties.propertyFlags & requiredFlags) == requiredFlags) )
-                {
-                    pMemoryPool->m_MemoryTypeIndex = i;
-                    pMemoryPool->m_Flags = memoryProperties.propertyFlags;
-                    break;
-                }
-            }
-
-            if( pMemoryPool->m_MemoryTypeIndex == UINT32_MAX )
-            {
-                // Required memory type not found.
-                result = VK_ERROR_OUT_OF_DEVICE_MEMORY;
-            }
-
-            if( result == VK_SUCCESS )
-            {
-                // Allocate device memory.
-                VkMemoryAllocateInfo memoryAllocateInfo = {};
-                memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-                memoryAllocateInfo.allocationSize = pMemoryPool->m_Size;
-                memoryAllocateInfo.memoryTypeIndex = pMemoryPool->m_MemoryTypeIndex;
-
-                result = m_pDevice->Callbacks.AllocateMemory(
-                    m_pDevice->Handle,
-                    &memoryAllocateInfo,
-                    nullptr,
-                    &pMemoryPool->m_DeviceMemory );
-            }
+            const uint32_t maxOrder = std::max( order,
+                GetBlockOrder( m_DefaultMemoryPoolSize / m_DefaultMemoryBlockSize ) );
+
+            const uint32_t blockCount = 1U << maxOrder;
+
+            DeviceProfilerMemoryPool memoryPool = {};
+            memoryPool.m_DeviceMemory = VK_NULL_HANDLE;
+            memoryPool.m_Size = blockCount * m_DefaultMemoryBlockSize;
+            memoryPool.m_FreeSize = memoryPool.m_Size;
+            memoryPool.m_MemoryTypeIndex = memoryTypeIndex;
+            memoryPool.m_Flags = m_DeviceMemoryProperties.memoryTypes[ memoryTypeIndex ].propertyFlags;
+            memoryPool.m_pMappedMemory = nullptr;
+            memoryPool.m_MaxOrder = maxOrder;
+            memoryPool.m_FreeOrderMask = 0;
+            memoryPool.m_FreeListHeads.resize( maxOrder + 1, InvalidBlockIndex );
+            memoryPool.m_Blocks.resize( blockCount, { InvalidBlockIndex, InvalidBlockIndex, 0, false } );
+
+            // The whole pool is a single free range.
+            PushFreeBlocks( &memoryPool, 0, maxOrder );
+
+            // Allocate device memory.
+            VkMemoryAllocateInfo memoryAllocateInfo = {};
+            memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            memoryAllocateInfo.allocationSize = memoryPool.m_Size;
+            memoryAllocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+            result = m_pDevice->Callbacks.AllocateMemory(
+                m_pDevice->Handle,
+                &memoryAllocateInfo,
+                nullptr,
+                &memoryPool.m_DeviceMemory );
 
             if( (result == VK_SUCCESS) &&
-                ((pMemoryPool->m_Flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0) )
+                ((memoryPool.m_Flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0) )
             {
                 // Map host-visible memory.
                 result = m_pDevice->Callbacks.MapMemory(
                     m_pDevice->Handle,
-                    pMemoryPool->m_DeviceMemory, 0,
-                    pMemoryPool->m_Size, 0,
-                    &pMemoryPool->m_pMappedMemory );
+                    memoryPool.m_DeviceMemory, 0,
+                    memoryPool.m_Size, 0,
+                    &memoryPool.m_pMappedMemory );
             }
 
             if( result == VK_SUCCESS )
             {
-                *ppPool = pMemoryPool;
+                *ppPool = &m_MemoryTypes[ memoryTypeIndex ].m_Pools.emplace_back( std::move( memoryPool ) );
+            }
+            else if( memoryPool.m_DeviceMemory != VK_NULL_HANDLE )
+            {
+                // Don't leak the memory if it could not be mapped.
+                m_pDevice->Callbacks.FreeMemory(
+                    m_pDevice->Handle,
+                    memoryPool.m_DeviceMemory,
+                    nullptr );
             }
         }
         catch( std::bad_alloc& )
@@ -276,4 +253,113 @@ namespace Profiler
 
         return result;
     }
+
+    uint32_t DeviceProfilerMemoryManager::AllocateBlocks(
+        DeviceProfilerMemoryPool* pPool,
+        uint32_t order )
+    {
+        assert( (pPool->m_FreeOrderMask >> order) != 0 );
+
+        // Take the smallest free range that fits the allocation.
+        uint32_t freeOrder = order;
+        while( (pPool->m_FreeOrderMask & (1U << freeOrder)) == 0 )
+            ++freeOrder;
+
+        const uint32_t blockIndex = pPool->m_FreeListHeads[ freeOrder ];
+        RemoveFreeBlocks( pPool, blockIndex );
+
+        // Split the range and return the upper halves to the free lists.
+        while( freeOrder > order )
+        {
+            --freeOrder;
+            PushFreeBlocks( pPool, blockIndex + (1U << freeOrder), freeOrder );
+        }
+
+        DeviceProfilerMemoryBlock& block = pPool->m_Blocks[ blockIndex ];
+        block.m_Order = order;
+        block.m_Free = false;
+
+        return blockIndex;
+    }
+
+    void DeviceProfilerMemoryManager::FreeBlocks(
+        DeviceProfilerMemoryPool* pPool,
+        uint32_t blockIndex )
+    {
+        assert( !pPool->m_Blocks[ blockIndex ].m_Free );
+
+        uint32_t order = pPool->m_Blocks[ blockIndex ].m_Order;
+
+        // Merge the range with its buddies as long as they are free.
+        while( order < pPool->m_MaxOrder )
+        {
+            const uint32_t buddyIndex = blockIndex ^ (1U << order);
+            const DeviceProfilerMemoryBlock& buddy = pPool->m_Blocks[ buddyIndex ];
+
+            if( !buddy.m_Free || (buddy.m_Order != order) )
+                break;
+
+            RemoveFreeBlocks( pPool, buddyIndex );
+
+            blockIndex = std::min( blockIndex, buddyIndex );
+            ++order;
+        }
+
+        PushFreeBlocks( pPool, blockIndex, order );
+    }
+
+    void DeviceProfilerMemoryManager::PushFreeBlocks(
+        DeviceProfilerMemoryPool* pPool,
+        uint32_t blockIndex,
+        uint32_t order )
+    {
+        const uint32_t nextBlockIndex = pPool->m_FreeListHeads[ order ];
+
+        DeviceProfilerMemoryBlock& block = pPool->m_Blocks[ blockIndex ];
+        block.m_PrevFreeBlockIndex = InvalidBlockIndex;
+        block.m_NextFreeBlockIndex = nextBlockIndex;
+        block.m_Order = order;
+        block.m_Free = true;
+
+        if( nextBlockIndex != InvalidBlockIndex )
+        {
+            pPool->m_Blocks[ nextBlockIndex ].m_PrevFreeBlockIndex = blockIndex;
+        }
+
+        pPool->m_FreeListHeads[ order ] = blockIndex;
+        pPool->m_FreeOrderMask |= (1U << order);
+    }
+
+    void DeviceProfilerMemoryManager::RemoveFreeBlocks(
+        DeviceProfilerMemoryPool* pPool,
+        uint32_t blockIndex )
+    {
+        DeviceProfilerMemoryBlock& block = pPool->m_Blocks[ blockIndex ];
+        assert( block.m_Free );
+
+        const uint32_t order = block.m_Order;
+
+        if( block.m_PrevFreeBlockIndex != InvalidBlockIndex )
+        {
+            pPool->m_Blocks[ block.m_PrevFreeBlockIndex ].m_NextFreeBlockIndex = block.m_NextFreeBlockIndex;
+        }
+        else
+        {
+            pPool->m_FreeListHeads[ order ] = block.m_NextFreeBlockIndex;
+        }
+
+        if( block.m_NextFreeBlockIndex != InvalidBlockIndex )
+        {
+            pPool->m_Blocks[ block.m_NextFreeBlockIndex ].m_PrevFreeBlockIndex = block.m_PrevFreeBlockIndex;
+        }
+
+        if( pPool->m_FreeListHeads[ order ] == InvalidBlockIndex )
+        {
+            pPool->m_FreeOrderMask &= ~(1U << order);
+        }
+
+        block.m_PrevFreeBlockIndex = InvalidBlockIndex;
+        block.m_NextFreeBlockIndex = InvalidBlockIndex;
+        block.m_Free = false;
+    }
 }
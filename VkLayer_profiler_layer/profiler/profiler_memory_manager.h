@@ -28,6 +28,16 @@ namespace Profiler
 {
     struct VkDevice_Object;
 
+    // Buddy allocator state of a single block. Valid only for the first block of
+    // each free or allocated range.
+    struct DeviceProfilerMemoryBlock
+    {
+        uint32_t m_PrevFreeBlockIndex;
+        uint32_t m_NextFreeBlockIndex;
+        uint32_t m_Order;
+        bool m_Free;
+    };
+
     struct DeviceProfilerMemoryPool
     {
         VkDeviceMemory m_DeviceMemory;
@@ -36,7 +46,14 @@ namespace Profiler
         uint32_t m_MemoryTypeIndex;
         VkMemoryPropertyFlags m_Flags;
         void* m_pMappedMemory;
-        std::vector<bool> m_Allocations;
+
+        // Pool consists of (1 << m_MaxOrder) blocks. Free ranges of 2^N blocks are
+        // linked in per-order free lists, bit N of m_FreeOrderMask is set when the
+        // list of order N is not empty.
+        uint32_t m_MaxOrder;
+        uint32_t m_FreeOrderMask;
+        std::vector<uint32_t> m_FreeListHeads;
+        std::vector<DeviceProfilerMemoryBlock> m_Blocks;
     };
 
     struct DeviceProfilerMemoryAllocation
@@ -64,21 +81,42 @@ namespace Profiler
             DeviceProfilerMemoryAllocation* pAllocation );
 
     private:
-        VkDevice_Object* m_pDevice;
+        // Pools of each memory type are guarded by a separate mutex.
+        struct MemoryTypePools
+        {
+            std::mutex m_Mutex;
+            std::list<DeviceProfilerMemoryPool> m_Pools;
+        };
 
-        std::mutex m_MemoryAllocationMutex;
+        VkDevice_Object* m_pDevice;
 
         VkDeviceSize m_DefaultMemoryPoolSize;
         VkDeviceSize m_DefaultMemoryBlockSize;
 
         VkPhysicalDeviceMemoryProperties m_DeviceMemoryProperties;
 
-        std::list<DeviceProfilerMemoryPool> m_MemoryPools;
+        std::vector<MemoryTypePools> m_MemoryTypes;
 
         VkResult AllocatePool(
-            VkDeviceSize size,
-            uint32_t requiredTypeBits,
-            VkMemoryPropertyFlags requiredFlags,
+            uint32_t memoryTypeIndex,
+            uint32_t order,
             DeviceProfilerMemoryPool** ppPool );
+
+        uint32_t AllocateBlocks(
+            DeviceProfilerMemoryPool* pPool,
+            uint32_t order );
+
+        void FreeBlocks(
+            DeviceProfilerMemoryPool* pPool,
+            uint32_t blockIndex );
+
+        void PushFreeBlocks(
+            DeviceProfilerMemoryPool* pPool,
+            uint32_t blockIndex,
+            uint32_t order );
+
+        void RemoveFreeBlocks(
+            DeviceProfilerMemoryPool* pPool,
+            uint32_t blockIndex );
     };
 }
@@ -0,0 +1,979 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "profiler_memory_tracker.h"
+#include "profiler_layer_objects/VkDevice_object.h"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace Profiler
+{
+    // Number of entries in the lists returned in DeviceProfilerMemoryData.
+    static constexpr size_t LargestResourceCount = 32;
+    static constexpr size_t FragmentedAllocationCount = 16;
+
+    // Frames with at least BurstMinAllocationCount allocations and BurstFactor times more
+    // allocations than the mean of the last BurstHistorySize frames are flagged as bursts.
+    static constexpr uint32_t BurstMinAllocationCount = 4;
+    static constexpr uint32_t BurstFactor = 4;
+    static constexpr uint32_t BurstHistorySize = 64;
+
+    /***********************************************************************************\
+
+    Function:
+        IsMoreFragmented
+
+    Description:
+        Order allocations by fragmentation, then by the free space.
+
+    \***********************************************************************************/
+    static bool IsMoreFragmented( const DeviceProfilerAllocationMemoryData& a, const DeviceProfilerAllocationMemoryData& b )
+    {
+        return (a.m_Fragmentation != b.m_Fragmentation)
+            ? (a.m_Fragmentation > b.m_Fragmentation)
+            : ((a.m_Size - a.m_BoundSize) > (b.m_Size - b.m_BoundSize));
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        DeviceProfilerMemoryTracker
+
+    Description:
+        Constructor.
+
+    \***********************************************************************************/
+    DeviceProfilerMemoryTracker::DeviceProfilerMemoryTracker()
+        : m_pDevice( nullptr )
+        , m_TotalCounters()
+        , m_HeapCounters()
+        , m_TypeCounters()
+        , m_ChurnCounters()
+        , m_HeapChurnCounters()
+        , m_AllocationSizeHistogram()
+        , m_AllocationShards()
+        , m_ResourceShards()
+        , m_Dirty( false )
+        , m_LargestResources()
+        , m_FragmentedAllocations()
+        , m_AllocationCountHistory()
+        , m_AllocationCountHistoryOffset( 0 )
+        , m_AllocationCountHistorySize( 0 )
+        , m_AllocationCountHistorySum( 0 )
+    {
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        Initialize
+
+    Description:
+        Prepare for memory usage tracking.
+
+    \***********************************************************************************/
+    VkResult DeviceProfilerMemoryTracker::Initialize( VkDevice_Object* pDevice )
+    {
+        assert( !m_pDevice );
+        m_pDevice = pDevice;
+
+        const VkPhysicalDeviceMemoryProperties& memoryProperties =
+            m_pDevice->pPhysicalDevice->MemoryProperties;
+
+        // Atomic counters can't be moved, so the vectors are created with the final size
+        m_HeapCounters = std::vector<MemoryCounters>( memoryProperties.memoryHeapCount );
+        m_TypeCounters = std::vector<MemoryCounters>( memoryProperties.memoryTypeCount );
+        m_HeapChurnCounters = std::vector<ChurnCounters>( memoryProperties.memoryHeapCount );
+
+        m_AllocationCountHistory.resize( BurstHistorySize );
+
+        return VK_SUCCESS;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        Destroy
+
+    Description:
+        Clear the registry.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::Destroy()
+    {
+        for( auto& shard : m_AllocationShards )
+        {
+            shard.m_Objects.clear();
+            shard.m_FragmentedAllocations.clear();
+            shard.m_Dirty = false;
+        }
+
+        for( auto& shard : m_ResourceShards )
+        {
+            shard.m_Objects.clear();
+            shard.m_LargestResources.clear();
+            shard.m_LargestResourcesIncomplete = false;
+        }
+
+        m_TotalCounters.m_AllocationSize = 0;
+        m_TotalCounters.m_AllocationCount = 0;
+        m_HeapCounters.clear();
+        m_TypeCounters.clear();
+
+        m_ChurnCounters.m_AllocationCount = 0;
+        m_ChurnCounters.m_AllocationSize = 0;
+        m_ChurnCounters.m_FreeCount = 0;
+        m_ChurnCounters.m_FreeSize = 0;
+        m_HeapChurnCounters.clear();
+
+        for( auto& bucket : m_AllocationSizeHistogram )
+        {
+            bucket = 0;
+        }
+
+        m_Dirty = false;
+        m_LargestResources.clear();
+        m_FragmentedAllocations.clear();
+
+        m_AllocationCountHistory.clear();
+        m_AllocationCountHistoryOffset = 0;
+        m_AllocationCountHistorySize = 0;
+        m_AllocationCountHistorySum = 0;
+
+        m_pDevice = nullptr;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        RegisterAllocation
+
+    Description:
+        Add the allocation to the registry and update memory usage of its heap and type.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::RegisterAllocation( VkDeviceMemory memory, const VkMemoryAllocateInfo* pAllocateInfo )
+    {
+        const VkDeviceSize size = pAllocateInfo->allocationSize;
+        const uint32_t typeIndex = pAllocateInfo->memoryTypeIndex;
+        const uint32_t heapIndex = m_pDevice->pPhysicalDevice->MemoryProperties.memoryTypes[ typeIndex ].heapIndex;
+
+        m_HeapCounters[ heapIndex ].m_AllocationCount.fetch_add( 1, std::memory_order_relaxed );
+        m_HeapCounters[ heapIndex ].m_AllocationSize.fetch_add( size, std::memory_order_relaxed );
+        m_TypeCounters[ typeIndex ].m_AllocationCount.fetch_add( 1, std::memory_order_relaxed );
+        m_TypeCounters[ typeIndex ].m_AllocationSize.fetch_add( size, std::memory_order_relaxed );
+        m_TotalCounters.m_AllocationCount.fetch_add( 1, std::memory_order_relaxed );
+        m_TotalCounters.m_AllocationSize.fetch_add( size, std::memory_order_relaxed );
+
+        m_ChurnCounters.m_AllocationCount.fetch_add( 1, std::memory_order_relaxed );
+        m_ChurnCounters.m_AllocationSize.fetch_add( size, std::memory_order_relaxed );
+        m_HeapChurnCounters[ heapIndex ].m_AllocationCount.fetch_add( 1, std::memory_order_relaxed );
+        m_HeapChurnCounters[ heapIndex ].m_AllocationSize.fetch_add( size, std::memory_order_relaxed );
+        m_AllocationSizeHistogram[ DeviceProfilerMemoryChurnData::GetSizeHistogramBucketIndex( size ) ].fetch_add( 1, std::memory_order_relaxed );
+
+        Allocation allocation;
+        allocation.m_Data.m_Memory = memory;
+        allocation.m_Data.m_Size = size;
+        allocation.m_Data.m_MemoryTypeIndex = typeIndex;
+        allocation.m_Dirty = true;
+
+        auto& shard = GetAllocationShard( memory );
+        {
+            std::scoped_lock lk( shard.m_Mutex );
+            shard.m_Objects.insert_or_assign( memory, std::move( allocation ) );
+            shard.m_Dirty = true;
+        }
+
+        m_Dirty = true;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        UnregisterAllocation
+
+    Description:
+        Remove the allocation from the registry. Resources still bound to it are
+        marked as unbound.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::UnregisterAllocation( VkDeviceMemory memory )
+    {
+        Allocation allocation;
+
+        auto& shard = GetAllocationShard( memory );
+        {
+            std::scoped_lock lk( shard.m_Mutex );
+
+            auto it = shard.m_Objects.find( memory );
+            if( it == shard.m_Objects.end() )
+            {
+                return;
+            }
+
+            allocation = std::move( it->second );
+            shard.m_Objects.erase( it );
+            shard.m_Dirty = true;
+        }
+
+        const VkDeviceSize size = allocation.m_Data.m_Size;
+        const uint32_t typeIndex = allocation.m_Data.m_MemoryTypeIndex;
+        const uint32_t heapIndex = m_pDevice->pPhysicalDevice->MemoryProperties.memoryTypes[ typeIndex ].heapIndex;
+
+        m_HeapCounters[ heapIndex ].m_AllocationCount.fetch_sub( 1, std::memory_order_relaxed );
+        m_HeapCounters[ heapIndex ].m_AllocationSize.fetch_sub( size, std::memory_order_relaxed );
+        m_TypeCounters[ typeIndex ].m_AllocationCount.fetch_sub( 1, std::memory_order_relaxed );
+        m_TypeCounters[ typeIndex ].m_AllocationSize.fetch_sub( size, std::memory_order_relaxed );
+        m_TotalCounters.m_AllocationCount.fetch_sub( 1, std::memory_order_relaxed );
+        m_TotalCounters.m_AllocationSize.fetch_sub( size, std::memory_order_relaxed );
+
+        m_ChurnCounters.m_FreeCount.fetch_add( 1, std::memory_order_relaxed );
+        m_ChurnCounters.m_FreeSize.fetch_add( size, std::memory_order_relaxed );
+        m_HeapChurnCounters[ heapIndex ].m_FreeCount.fetch_add( 1, std::memory_order_relaxed );
+        m_HeapChurnCounters[ heapIndex ].m_FreeSize.fetch_add( size, std::memory_order_relaxed );
+
+        // The application may free the memory before destroying the resources
+        for( const VkObject& resource : allocation.m_Resources )
+        {
+            auto& resourceShard = GetResourceShard( resource );
+            std::scoped_lock lk( resourceShard.m_Mutex );
+
+            auto it = resourceShard.m_Objects.find( resource );
+            if( (it != resourceShard.m_Objects.end()) && (it->second.m_Memory == memory) )
+            {
+                it->second.m_Memory = VK_NULL_HANDLE;
+                it->second.m_MemoryOffset = 0;
+                it->second.m_Aliased = false;
+            }
+        }
+
+        m_Dirty = true;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        RegisterBuffer
+
+    Description:
+        Add the buffer to the registry.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::RegisterBuffer( VkBuffer buffer, const VkBufferCreateInfo* pCreateInfo )
+    {
+        DeviceProfilerResourceMemoryData data;
+        data.m_Buffer = buffer;
+        data.m_Usage = pCreateInfo->usage;
+        data.m_Format = VK_FORMAT_UNDEFINED;
+
+        VkMemoryRequirements memoryRequirements = {};
+        m_pDevice->Callbacks.GetBufferMemoryRequirements( m_pDevice->Handle, buffer, &memoryRequirements );
+        data.m_Size = memoryRequirements.size;
+
+        RegisterResource( buffer, data );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        UnregisterBuffer
+
+    Description:
+        Remove the buffer from the registry.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::UnregisterBuffer( VkBuffer buffer )
+    {
+        UnregisterResource( buffer );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        BindBufferMemory
+
+    Description:
+        Associate the buffer with the memory range.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::BindBufferMemory( VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize offset )
+    {
+        BindResourceMemory( buffer, memory, offset );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        RegisterImage
+
+    Description:
+        Add the image to the registry.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::RegisterImage( VkImage image, const VkImageCreateInfo* pCreateInfo )
+    {
+        DeviceProfilerResourceMemoryData data;
+        data.m_Image = image;
+        data.m_Usage = pCreateInfo->usage;
+        data.m_Format = pCreateInfo->format;
+        data.m_Extent = pCreateInfo->extent;
+
+        // Requirements of disjoint images must be queried per plane with vkGetImageMemoryRequirements2
+        if( !(pCreateInfo->flags & VK_IMAGE_CREATE_DISJOINT_BIT) )
+        {
+            VkMemoryRequirements memoryRequirements = {};
+            m_pDevice->Callbacks.GetImageMemoryRequirements( m_pDevice->Handle, image, &memoryRequirements );
+            data.m_Size = memoryRequirements.size;
+        }
+
+        RegisterResource( image, data );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        UnregisterImage
+
+    Description:
+        Remove the image from the registry.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::UnregisterImage( VkImage image )
+    {
+        UnregisterResource( image );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        BindImageMemory
+
+    Description:
+        Associate the image with the memory range.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::BindImageMemory( VkImage image, VkDeviceMemory memory, VkDeviceSize offset )
+    {
+        BindResourceMemory( image, memory, offset );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        GetFrameMemoryData
+
+    Description:
+        Return memory usage with the statistics of the allocations updated, and the
+        allocations and frees since the previous call. Should be called once per frame.
+
+        Events recorded concurrently with this call may be split between 2 frames,
+        e.g. the allocation may be counted in one frame and its size in the next one.
+
+    \***********************************************************************************/
+    DeviceProfilerMemoryData DeviceProfilerMemoryTracker::GetFrameMemoryData()
+    {
+        DeviceProfilerMemoryData data;
+
+        data.m_TotalAllocationCount = m_TotalCounters.m_AllocationCount.load( std::memory_order_relaxed );
+        data.m_TotalAllocationSize = m_TotalCounters.m_AllocationSize.load( std::memory_order_relaxed );
+
+        data.m_Heaps.resize( m_HeapCounters.size() );
+        for( size_t i = 0; i < m_HeapCounters.size(); ++i )
+        {
+            data.m_Heaps[ i ].m_AllocationCount = m_HeapCounters[ i ].m_AllocationCount.load( std::memory_order_relaxed );
+            data.m_Heaps[ i ].m_AllocationSize = m_HeapCounters[ i ].m_AllocationSize.load( std::memory_order_relaxed );
+        }
+
+        data.m_Types.resize( m_TypeCounters.size() );
+        for( size_t i = 0; i < m_TypeCounters.size(); ++i )
+        {
+            data.m_Types[ i ].m_AllocationCount = m_TypeCounters[ i ].m_AllocationCount.load( std::memory_order_relaxed );
+            data.m_Types[ i ].m_AllocationSize = m_TypeCounters[ i ].m_AllocationSize.load( std::memory_order_relaxed );
+        }
+
+        if( m_Dirty.exchange( false ) )
+        {
+            // Shards are locked one at a time and only the shards that changed are
+            // scanned, so the threads creating resources are not blocked for long.
+            // Allocations are updated first, as they set the aliasing of the resources.
+            UpdateFragmentedAllocations();
+            UpdateLargestResources();
+        }
+
+        data.m_LargestResources = m_LargestResources;
+        data.m_FragmentedAllocations = m_FragmentedAllocations;
+
+        // Take the allocations and frees of the frame and start counting the next one
+        DeviceProfilerMemoryChurnData& churn = data.m_Churn;
+        churn.m_AllocationCount = m_ChurnCounters.m_AllocationCount.exchange( 0, std::memory_order_relaxed );
+        churn.m_AllocationSize = m_ChurnCounters.m_AllocationSize.exchange( 0, std::memory_order_relaxed );
+        churn.m_FreeCount = m_ChurnCounters.m_FreeCount.exchange( 0, std::memory_order_relaxed );
+        churn.m_FreeSize = m_ChurnCounters.m_FreeSize.exchange( 0, std::memory_order_relaxed );
+
+        for( uint32_t i = 0; i < DeviceProfilerMemoryChurnData::SizeHistogramBucketCount; ++i )
+        {
+            churn.m_AllocationSizeHistogram[ i ] = m_AllocationSizeHistogram[ i ].exchange( 0, std::memory_order_relaxed );
+        }
+
+        churn.m_Heaps.resize( m_HeapChurnCounters.size() );
+        for( size_t i = 0; i < m_HeapChurnCounters.size(); ++i )
+        {
+            churn.m_Heaps[ i ].m_AllocationCount = m_HeapChurnCounters[ i ].m_AllocationCount.exchange( 0, std::memory_order_relaxed );
+            churn.m_Heaps[ i ].m_AllocationSize = m_HeapChurnCounters[ i ].m_AllocationSize.exchange( 0, std::memory_order_relaxed );
+            churn.m_Heaps[ i ].m_FreeCount = m_HeapChurnCounters[ i ].m_FreeCount.exchange( 0, std::memory_order_relaxed );
+            churn.m_Heaps[ i ].m_FreeSize = m_HeapChurnCounters[ i ].m_FreeSize.exchange( 0, std::memory_order_relaxed );
+        }
+
+        UpdateChurnHistory( churn );
+
+        return data;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        GetShardIndex
+
+    Description:
+        Select the registry shard of the object. Handles are often aligned pointers,
+        so the bits are mixed with Fibonacci hashing before selecting the shard.
+
+    \***********************************************************************************/
+    uint32_t DeviceProfilerMemoryTracker::GetShardIndex( uint64_t handle )
+    {
+        return static_cast<uint32_t>( (handle * 0x9e3779b97f4a7c15ULL) >> (64 - ShardBits) );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        GetAllocationShard
+
+    \***********************************************************************************/
+    DeviceProfilerMemoryTracker::AllocationShard& DeviceProfilerMemoryTracker::GetAllocationShard( VkDeviceMemory memory )
+    {
+        return m_AllocationShards[ GetShardIndex( VkObject( memory ).m_Handle ) ];
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        GetResourceShard
+
+    \***********************************************************************************/
+    DeviceProfilerMemoryTracker::ResourceShard& DeviceProfilerMemoryTracker::GetResourceShard( const VkObject& resource )
+    {
+        return m_ResourceShards[ GetShardIndex( resource.m_Handle ) ];
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        RegisterResource
+
+    Description:
+        Add the resource to the registry.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::RegisterResource( const VkObject& resource, const DeviceProfilerResourceMemoryData& data )
+    {
+        auto& shard = GetResourceShard( resource );
+        {
+            std::scoped_lock lk( shard.m_Mutex );
+
+            if( !shard.m_Objects.insert_or_assign( resource, data ).second )
+            {
+                // The handle has been registered again
+                RemoveLargestResource( shard, resource );
+            }
+
+            InsertLargestResource( shard, resource, data.m_Size );
+        }
+
+        m_Dirty = true;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        UnregisterResource
+
+    Description:
+        Remove the resource from the registry and from the allocation it is bound to.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::UnregisterResource( const VkObject& resource )
+    {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+
+        auto& shard = GetResourceShard( resource );
+        {
+            std::scoped_lock lk( shard.m_Mutex );
+
+            auto it = shard.m_Objects.find( resource );
+            if( it == shard.m_Objects.end() )
+            {
+                return;
+            }
+
+            memory = it->second.m_Memory;
+            shard.m_Objects.erase( it );
+
+            RemoveLargestResource( shard, resource );
+        }
+
+        if( memory != VK_NULL_HANDLE )
+        {
+            auto& allocationShard = GetAllocationShard( memory );
+            std::scoped_lock lk( allocationShard.m_Mutex );
+
+            auto allocationIt = allocationShard.m_Objects.find( memory );
+            if( allocationIt != allocationShard.m_Objects.end() )
+            {
+                Allocation& allocation = allocationIt->second;
+
+                auto resourceIt = std::find( allocation.m_Resources.begin(), allocation.m_Resources.end(), resource );
+                if( resourceIt != allocation.m_Resources.end() )
+                {
+                    // Order of the resources is not important
+                    *resourceIt = allocation.m_Resources.back();
+                    allocation.m_Resources.pop_back();
+                }
+
+                allocation.m_Dirty = true;
+                allocationShard.m_Dirty = true;
+            }
+        }
+
+        m_Dirty = true;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        BindResourceMemory
+
+    Description:
+        Associate the resource with the memory range.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::BindResourceMemory( const VkObject& resource, VkDeviceMemory memory, VkDeviceSize offset )
+    {
+        auto& shard = GetResourceShard( resource );
+        auto& allocationShard = GetAllocationShard( memory );
+
+        {
+            std::scoped_lock lk( shard.m_Mutex, allocationShard.m_Mutex );
+
+            auto it = shard.m_Objects.find( resource );
+            auto allocationIt = allocationShard.m_Objects.find( memory );
+
+            if( (it == shard.m_Objects.end()) || (allocationIt == allocationShard.m_Objects.end()) )
+            {
+                return;
+            }
+
+            // Resources can be bound only once
+            if( it->second.m_Memory != VK_NULL_HANDLE )
+            {
+                return;
+            }
+
+            it->second.m_Memory = memory;
+            it->second.m_MemoryOffset = offset;
+
+            allocationIt->second.m_Resources.push_back( resource );
+            allocationIt->second.m_Dirty = true;
+            allocationShard.m_Dirty = true;
+        }
+
+        m_Dirty = true;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        UpdateAllocation
+
+    Description:
+        Compute occupancy, aliasing and fragmentation of the allocation by sweeping
+        the bound memory ranges sorted by offset. Resources overlapping with any other
+        resource bound to the allocation are marked as aliased.
+
+        Must be called with the allocation shard locked. The resource shards are
+        locked one at a time.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::UpdateAllocation( Allocation& allocation )
+    {
+        struct MemoryRange
+        {
+            VkDeviceSize m_Begin;
+            VkDeviceSize m_End;
+            size_t m_ResourceIndex;
+        };
+
+        DeviceProfilerAllocationMemoryData& data = allocation.m_Data;
+
+        const size_t resourceCount = allocation.m_Resources.size();
+
+        std::vector<MemoryRange> ranges;
+        ranges.reserve( resourceCount );
+
+        for( size_t i = 0; i < resourceCount; ++i )
+        {
+            const VkObject& resource = allocation.m_Resources[ i ];
+
+            // The resource may be already removed from its shard by UnregisterResource
+            // that hasn't reached the allocation shard yet.
+            auto& resourceShard = GetResourceShard( resource );
+            std::scoped_lock lk( resourceShard.m_Mutex );
+
+            auto it = resourceShard.m_Objects.find( resource );
+            if( it == resourceShard.m_Objects.end() )
+            {
+                continue;
+            }
+
+            const DeviceProfilerResourceMemoryData& resourceData = it->second;
+
+            if( (resourceData.m_Size > 0) && (resourceData.m_MemoryOffset < data.m_Size) )
+            {
+                ranges.push_back( {
+                    resourceData.m_MemoryOffset,
+                    std::min( resourceData.m_MemoryOffset + resourceData.m_Size, data.m_Size ),
+                    i } );
+            }
+        }
+
+        std::sort( ranges.begin(), ranges.end(),
+            []( const MemoryRange& a, const MemoryRange& b ) { return a.m_Begin < b.m_Begin; } );
+
+        std::vector<bool> aliased( resourceCount, false );
+
+        VkDeviceSize coveredEnd = 0;
+        VkDeviceSize freeSize = 0;
+        const MemoryRange* pCoveringRange = nullptr;
+
+        data.m_ResourceCount = static_cast<uint32_t>( resourceCount );
+        data.m_BoundSize = 0;
+        data.m_AliasedSize = 0;
+        data.m_LargestFreeRangeSize = 0;
+        data.m_FreeRangeCount = 0;
+
+        for( const MemoryRange& range : ranges )
+        {
+            if( range.m_Begin > coveredEnd )
+            {
+                const VkDeviceSize freeRangeSize = range.m_Begin - coveredEnd;
+                data.m_LargestFreeRangeSize = std::max( data.m_LargestFreeRangeSize, freeRangeSize );
+                data.m_FreeRangeCount++;
+                freeSize += freeRangeSize;
+            }
+            else if( (range.m_Begin < coveredEnd) && (pCoveringRange != nullptr) )
+            {
+                // The range overlaps at least with the range that reaches furthest
+                data.m_AliasedSize += std::min( range.m_End, coveredEnd ) - range.m_Begin;
+                aliased[ range.m_ResourceIndex ] = true;
+                aliased[ pCoveringRange->m_ResourceIndex ] = true;
+            }
+
+            if( range.m_End > coveredEnd )
+            {
+                data.m_BoundSize += range.m_End - std::max( range.m_Begin, coveredEnd );
+                coveredEnd = range.m_End;
+                pCoveringRange = &range;
+            }
+        }
+
+        if( data.m_Size > coveredEnd )
+        {
+            const VkDeviceSize freeRangeSize = data.m_Size - coveredEnd;
+            data.m_LargestFreeRangeSize = std::max( data.m_LargestFreeRangeSize, freeRangeSize );
+            data.m_FreeRangeCount++;
+            freeSize += freeRangeSize;
+        }
+
+        data.m_Fragmentation = (freeSize > 0)
+            ? 1.0f - (static_cast<float>( data.m_LargestFreeRangeSize ) / freeSize)
+            : 0.0f;
+
+        // Store aliasing of the resources still bound to the allocation
+        for( size_t i = 0; i < resourceCount; ++i )
+        {
+            const VkObject& resource = allocation.m_Resources[ i ];
+
+            auto& resourceShard = GetResourceShard( resource );
+            std::scoped_lock lk( resourceShard.m_Mutex );
+
+            auto it = resourceShard.m_Objects.find( resource );
+            if( (it != resourceShard.m_Objects.end()) && (it->second.m_Memory == data.m_Memory) )
+            {
+                it->second.m_Aliased = aliased[ i ];
+            }
+        }
+
+        allocation.m_Dirty = false;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        UpdateLargestResources
+
+    Description:
+        Merge the lists of the largest resources of all shards.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::UpdateLargestResources()
+    {
+        std::vector<DeviceProfilerResourceMemoryData> resources;
+
+        for( auto& shard : m_ResourceShards )
+        {
+            std::scoped_lock lk( shard.m_Mutex );
+
+            if( shard.m_LargestResourcesIncomplete )
+            {
+                RebuildLargestResources( shard );
+            }
+
+            // Copy the current bindings of the resources
+            for( const LargestResource& largestResource : shard.m_LargestResources )
+            {
+                auto it = shard.m_Objects.find( largestResource.m_Resource );
+                if( it != shard.m_Objects.end() )
+                {
+                    resources.push_back( it->second );
+                }
+            }
+        }
+
+        const size_t count = std::min( resources.size(), LargestResourceCount );
+
+        std::partial_sort( resources.begin(), resources.begin() + count, resources.end(),
+            []( const DeviceProfilerResourceMemoryData& a, const DeviceProfilerResourceMemoryData& b ) { return a.m_Size > b.m_Size; } );
+
+        resources.resize( count );
+        m_LargestResources = std::move( resources );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        UpdateFragmentedAllocations
+
+    Description:
+        Update statistics of the changed allocations and merge the lists of the most
+        fragmented allocations of all shards.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::UpdateFragmentedAllocations()
+    {
+        std::vector<DeviceProfilerAllocationMemoryData> allocations;
+
+        for( auto& shard : m_AllocationShards )
+        {
+            std::scoped_lock lk( shard.m_Mutex );
+
+            if( shard.m_Dirty )
+            {
+                for( auto& [memory, allocation] : shard.m_Objects )
+                {
+                    if( allocation.m_Dirty )
+                    {
+                        UpdateAllocation( allocation );
+                    }
+                }
+
+                RebuildFragmentedAllocations( shard );
+                shard.m_Dirty = false;
+            }
+
+            allocations.insert( allocations.end(),
+                shard.m_FragmentedAllocations.begin(),
+                shard.m_FragmentedAllocations.end() );
+        }
+
+        const size_t count = std::min( allocations.size(), FragmentedAllocationCount );
+
+        std::partial_sort( allocations.begin(), allocations.begin() + count, allocations.end(),
+            []( const DeviceProfilerAllocationMemoryData& a, const DeviceProfilerAllocationMemoryData& b ) { return IsMoreFragmented( a, b ); } );
+
+        allocations.resize( count );
+        m_FragmentedAllocations = std::move( allocations );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        InsertLargestResource
+
+    Description:
+        Add the resource to the largest resources of the shard if it is large enough.
+        Must be called with the shard locked.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::InsertLargestResource( ResourceShard& shard, const VkObject& resource, VkDeviceSize size )
+    {
+        auto& largestResources = shard.m_LargestResources;
+
+        if( (largestResources.size() == LargestResourceCount) && (largestResources.back().m_Size >= size) )
+        {
+            return;
+        }
+
+        auto it = std::upper_bound( largestResources.begin(), largestResources.end(), size,
+            []( VkDeviceSize value, const LargestResource& largestResource ) { return value > largestResource.m_Size; } );
+
+        largestResources.insert( it, { size, resource } );
+
+        if( largestResources.size() > LargestResourceCount )
+        {
+            largestResources.pop_back();
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        RemoveLargestResource
+
+    Description:
+        Remove the resource from the largest resources of the shard.
+        Must be called with the shard locked.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::RemoveLargestResource( ResourceShard& shard, const VkObject& resource )
+    {
+        auto& largestResources = shard.m_LargestResources;
+
+        auto it = std::find_if( largestResources.begin(), largestResources.end(),
+            [&resource]( const LargestResource& largestResource ) { return largestResource.m_Resource == resource; } );
+
+        if( it != largestResources.end() )
+        {
+            largestResources.erase( it );
+
+            // The next largest resource is not known
+            if( shard.m_Objects.size() > largestResources.size() )
+            {
+                shard.m_LargestResourcesIncomplete = true;
+            }
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        RebuildLargestResources
+
+    Description:
+        Select resources of the shard with the largest memory requirements.
+        Must be called with the shard locked.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::RebuildLargestResources( ResourceShard& shard )
+    {
+        auto& largestResources = shard.m_LargestResources;
+        largestResources.clear();
+
+        for( const auto& [resource, data] : shard.m_Objects )
+        {
+            largestResources.push_back( { data.m_Size, resource } );
+        }
+
+        const size_t count = std::min( largestResources.size(), LargestResourceCount );
+
+        std::partial_sort( largestResources.begin(), largestResources.begin() + count, largestResources.end(),
+            []( const LargestResource& a, const LargestResource& b ) { return a.m_Size > b.m_Size; } );
+
+        largestResources.resize( count );
+        shard.m_LargestResourcesIncomplete = false;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        RebuildFragmentedAllocations
+
+    Description:
+        Select allocations of the shard with the most fragmented free space.
+        Must be called with the shard locked.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::RebuildFragmentedAllocations( AllocationShard& shard )
+    {
+        std::vector<const DeviceProfilerAllocationMemoryData*> pAllocations;
+
+        for( const auto& [memory, allocation] : shard.m_Objects )
+        {
+            if( allocation.m_Data.m_Fragmentation > 0.0f )
+            {
+                pAllocations.push_back( &allocation.m_Data );
+            }
+        }
+
+        const size_t count = std::min( pAllocations.size(), FragmentedAllocationCount );
+
+        std::partial_sort( pAllocations.begin(), pAllocations.begin() + count, pAllocations.end(),
+            []( const DeviceProfilerAllocationMemoryData* a, const DeviceProfilerAllocationMemoryData* b ) { return IsMoreFragmented( *a, *b ); } );
+
+        shard.m_FragmentedAllocations.clear();
+
+        for( size_t i = 0; i < count; ++i )
+        {
+            shard.m_FragmentedAllocations.push_back( *pAllocations[ i ] );
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        UpdateChurnHistory
+
+    Description:
+        Flag the current frame as a burst if it allocates much more often than the
+        previous frames, and append its allocation count to the history.
+
+    \***********************************************************************************/
+    void DeviceProfilerMemoryTracker::UpdateChurnHistory( DeviceProfilerMemoryChurnData& churn )
+    {
+        // Compare count * history size with sum to avoid division
+        churn.m_Burst =
+            (churn.m_AllocationCount >= BurstMinAllocationCount) &&
+            (static_cast<uint64_t>( churn.m_AllocationCount ) * m_AllocationCountHistorySize >=
+                BurstFactor * m_AllocationCountHistorySum);
+
+        if( m_AllocationCountHistorySize == BurstHistorySize )
+        {
+            m_AllocationCountHistorySum -= m_AllocationCountHistory[ m_AllocationCountHistoryOffset ];
+        }
+        else
+        {
+            m_AllocationCountHistorySize++;
+        }
+
+        m_AllocationCountHistory[ m_AllocationCountHistoryOffset ] = churn.m_AllocationCount;
+        m_AllocationCountHistorySum += churn.m_AllocationCount;
+        m_AllocationCountHistoryOffset = (m_AllocationCountHistoryOffset + 1) % BurstHistorySize;
+    }
+}
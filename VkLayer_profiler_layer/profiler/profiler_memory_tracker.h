@@ -0,0 +1,182 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "profiler_data.h"
+#include "profiler_layer_objects/VkObject.h"
+#include <vulkan/vk_layer.h>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Profiler
+{
+    struct VkDevice_Object;
+
+    /***********************************************************************************\
+
+    Class:
+        DeviceProfilerMemoryTracker
+
+    Description:
+        Tracks VkDeviceMemory allocations and the buffers and images bound to them.
+
+        Applications usually sub-allocate large memory blocks, so the totals per heap
+        and memory type don't tell which resources consume the memory. The tracker
+        keeps a registry of the resources and their bindings, and computes occupancy,
+        aliasing and fragmentation of each allocation.
+
+        Statistics of an allocation are recomputed only after the set of resources
+        bound to it changes. Each shard keeps its own list of the largest resources,
+        updated when the resources are registered, and of the most fragmented
+        allocations, rebuilt only after the shard changes. The lists returned for
+        the frame are merged from the shards locked one at a time.
+
+        Allocations and frees are also counted per frame, to find frames which call
+        vkAllocateMemory excessively.
+
+        Memory usage is accounted with atomic counters and the registries are split
+        into shards with separate locks, so threads allocating memory or creating
+        resources concurrently don't serialize on a single lock.
+
+    \***********************************************************************************/
+    class DeviceProfilerMemoryTracker
+    {
+    public:
+        DeviceProfilerMemoryTracker();
+
+        VkResult Initialize( VkDevice_Object* pDevice );
+        void Destroy();
+
+        void RegisterAllocation( VkDeviceMemory memory, const VkMemoryAllocateInfo* pAllocateInfo );
+        void UnregisterAllocation( VkDeviceMemory memory );
+
+        void RegisterBuffer( VkBuffer buffer, const VkBufferCreateInfo* pCreateInfo );
+        void UnregisterBuffer( VkBuffer buffer );
+        void BindBufferMemory( VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize offset );
+
+        void RegisterImage( VkImage image, const VkImageCreateInfo* pCreateInfo );
+        void UnregisterImage( VkImage image );
+        void BindImageMemory( VkImage image, VkDeviceMemory memory, VkDeviceSize offset );
+
+        DeviceProfilerMemoryData GetFrameMemoryData();
+
+    private:
+        // Counters are only read to report them, so relaxed memory order is sufficient.
+        struct MemoryCounters
+        {
+            std::atomic<uint64_t> m_AllocationSize{ 0 };
+            std::atomic<uint64_t> m_AllocationCount{ 0 };
+        };
+
+        struct ChurnCounters
+        {
+            std::atomic<uint32_t> m_AllocationCount{ 0 };
+            std::atomic<uint64_t> m_AllocationSize{ 0 };
+            std::atomic<uint32_t> m_FreeCount{ 0 };
+            std::atomic<uint64_t> m_FreeSize{ 0 };
+        };
+
+        struct Allocation
+        {
+            DeviceProfilerAllocationMemoryData m_Data = {};
+            std::vector<VkObject> m_Resources = {};
+            bool m_Dirty = false;
+        };
+
+        template<typename KeyT, typename ValueT>
+        struct Shard
+        {
+            std::mutex m_Mutex;
+            std::unordered_map<KeyT, ValueT> m_Objects;
+        };
+
+        struct AllocationShard : Shard<VkDeviceMemory, Allocation>
+        {
+            // Most fragmented allocations of the shard, rebuilt when m_Dirty is set
+            std::vector<DeviceProfilerAllocationMemoryData> m_FragmentedAllocations;
+            bool m_Dirty = false;
+        };
+
+        struct LargestResource
+        {
+            VkDeviceSize m_Size;
+            VkObject m_Resource;
+        };
+
+        struct ResourceShard : Shard<VkObject, DeviceProfilerResourceMemoryData>
+        {
+            // Largest resources of the shard sorted by size in descending order.
+            // Rebuilt only if one of them is removed and the shard has more resources.
+            std::vector<LargestResource> m_LargestResources;
+            bool m_LargestResourcesIncomplete = false;
+        };
+
+        static constexpr uint32_t ShardBits = 4;
+        static constexpr uint32_t ShardCount = 1U << ShardBits;
+
+        VkDevice_Object* m_pDevice;
+
+        MemoryCounters m_TotalCounters;
+        std::vector<MemoryCounters> m_HeapCounters;
+        std::vector<MemoryCounters> m_TypeCounters;
+
+        ChurnCounters m_ChurnCounters;
+        std::vector<ChurnCounters> m_HeapChurnCounters;
+        std::array<std::atomic<uint32_t>, DeviceProfilerMemoryChurnData::SizeHistogramBucketCount> m_AllocationSizeHistogram;
+
+        std::array<AllocationShard, ShardCount> m_AllocationShards;
+        std::array<ResourceShard, ShardCount> m_ResourceShards;
+
+        // Set when the registry changes, the lists are merged in the next GetFrameMemoryData call
+        std::atomic<bool> m_Dirty;
+
+        // Accessed only in GetFrameMemoryData
+        std::vector<DeviceProfilerResourceMemoryData> m_LargestResources;
+        std::vector<DeviceProfilerAllocationMemoryData> m_FragmentedAllocations;
+
+        // Allocation counts of the last frames, used to detect bursts
+        std::vector<uint32_t> m_AllocationCountHistory;
+        uint32_t m_AllocationCountHistoryOffset;
+        uint32_t m_AllocationCountHistorySize;
+        uint64_t m_AllocationCountHistorySum;
+
+        static uint32_t GetShardIndex( uint64_t handle );
+
+        AllocationShard& GetAllocationShard( VkDeviceMemory memory );
+        ResourceShard& GetResourceShard( const VkObject& resource );
+
+        void RegisterResource( const VkObject& resource, const DeviceProfilerResourceMemoryData& data );
+        void UnregisterResource( const VkObject& resource );
+        void BindResourceMemory( const VkObject& resource, VkDeviceMemory memory, VkDeviceSize offset );
+
+        void UpdateAllocation( Allocation& allocation );
+        void UpdateLargestResources();
+        void UpdateFragmentedAllocations();
+
+        static void InsertLargestResource( ResourceShard& shard, const VkObject& resource, VkDeviceSize size );
+        static void RemoveLargestResource( ResourceShard& shard, const VkObject& resource );
+        static void RebuildLargestResources( ResourceShard& shard );
+        static void RebuildFragmentedAllocations( AllocationShard& shard );
+        void UpdateChurnHistory( DeviceProfilerMemoryChurnData& churn );
+    };
+}
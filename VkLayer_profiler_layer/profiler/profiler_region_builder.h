@@ -0,0 +1,264 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "profiler_data.h"
+#include "profiler_ext/VkProfilerEXT.h"
+#include <cassert>
+#include <limits>
+#include <unordered_map>
+
+namespace Profiler
+{
+    /***********************************************************************************\
+
+    Function:
+        DrawcallTypeToCommandType
+
+    Description:
+        Convert internal drawcall type to public command type enumeration.
+
+    \***********************************************************************************/
+    inline VkProfilerCommandTypeEXT DrawcallTypeToCommandType( DeviceProfilerDrawcallType type )
+    {
+        static const std::unordered_map<DeviceProfilerDrawcallType, VkProfilerCommandTypeEXT> commandTypes =
+        {
+            { DeviceProfilerDrawcallType::eDraw,                        VK_PROFILER_COMMAND_DRAW_EXT },
+            { DeviceProfilerDrawcallType::eDrawIndexed,                 VK_PROFILER_COMMAND_DRAW_INDEXED_EXT },
+            { DeviceProfilerDrawcallType::eDrawIndirect,                VK_PROFILER_COMMAND_DRAW_INDIRECT_EXT },
+            { DeviceProfilerDrawcallType::eDrawIndexedIndirect,         VK_PROFILER_COMMAND_DRAW_INDEXED_INDIRECT_EXT },
+            { DeviceProfilerDrawcallType::eDrawIndirectCount,           VK_PROFILER_COMMAND_DRAW_INDIRECT_COUNT_EXT },
+            { DeviceProfilerDrawcallType::eDrawIndexedIndirectCount,    VK_PROFILER_COMMAND_DRAW_INDEXED_INDIRECT_COUNT_EXT },
+            { DeviceProfilerDrawcallType::eDispatch,                    VK_PROFILER_COMMAND_DISPATCH_EXT },
+            { DeviceProfilerDrawcallType::eDispatchIndirect,            VK_PROFILER_COMMAND_DISPATCH_INDIRECT_EXT },
+            { DeviceProfilerDrawcallType::eCopyBuffer,                  VK_PROFILER_COMMAND_COPY_BUFFER_EXT },
+            { DeviceProfilerDrawcallType::eCopyBufferToImage,           VK_PROFILER_COMMAND_COPY_BUFFER_TO_IMAGE_EXT },
+            { DeviceProfilerDrawcallType::eCopyImage,                   VK_PROFILER_COMMAND_COPY_IMAGE_EXT },
+            { DeviceProfilerDrawcallType::eCopyImageToBuffer,           VK_PROFILER_COMMAND_COPY_IMAGE_TO_BUFFER_EXT },
+            { DeviceProfilerDrawcallType::eClearAttachments,            VK_PROFILER_COMMAND_CLEAR_ATTACHMENTS_EXT },
+            { DeviceProfilerDrawcallType::eClearColorImage,             VK_PROFILER_COMMAND_CLEAR_COLOR_IMAGE_EXT },
+            { DeviceProfilerDrawcallType::eClearDepthStencilImage,      VK_PROFILER_COMMAND_CLEAR_DEPTH_STENCIL_IMAGE_EXT },
+            { DeviceProfilerDrawcallType::eResolveImage,                VK_PROFILER_COMMAND_RESOLVE_IMAGE_EXT },
+            { DeviceProfilerDrawcallType::eBlitImage,                   VK_PROFILER_COMMAND_BLIT_IMAGE_EXT },
+            { DeviceProfilerDrawcallType::eFillBuffer,                  VK_PROFILER_COMMAND_FILL_BUFFER_EXT },
+            { DeviceProfilerDrawcallType::eUpdateBuffer,                VK_PROFILER_COMMAND_UPDATE_BUFFER_EXT }
+        };
+
+        auto it = commandTypes.find( type );
+        if( it != commandTypes.end() )
+        {
+            return it->second;
+        }
+
+        return VK_PROFILER_COMMAND_UNKNOWN_EXT;
+    }
+
+    /***********************************************************************************\
+
+    Class:
+        FlatRegionBuilder
+
+    Description:
+        Helper class for filling contiguous array of VkProfilerFlatRegionDataEXT structures.
+
+        Direct subregions of each region are stored in a contiguous range of the array,
+        reserved when the parent region is visited. The frame region is always at index 0.
+        When no output array is provided, the builder only counts the regions.
+
+    \***********************************************************************************/
+    class FlatRegionBuilder
+    {
+    private:
+        template<typename T>
+        inline static T safe_cast( size_t value )
+        {
+            assert( value <= std::numeric_limits<T>::max() );
+            return static_cast<T>(value);
+        }
+
+        template<typename DataContainer, typename CallbackType>
+        inline void SerializeSubregions(
+            const DataContainer& data,
+            CallbackType callback,
+            uint32_t index )
+        {
+            const uint32_t firstSubregionIndex = m_RegionCount;
+            const uint32_t subregionCount = safe_cast<uint32_t>( data.size() );
+
+            VkProfilerFlatRegionDataEXT& out = GetRegion( index );
+            out.firstSubregionIndex = firstSubregionIndex;
+            out.subregionCount = subregionCount;
+
+            // Reserve space for direct subregions before descending into them
+            m_RegionCount += subregionCount;
+
+            uint32_t subregionIndex = firstSubregionIndex;
+
+            for( const auto& subregion : data )
+            {
+                (this->*callback)( subregion, subregionIndex++, index );
+            }
+        }
+
+        inline VkProfilerFlatRegionDataEXT& GetRegion( uint32_t index )
+        {
+            // Writes are discarded when counting the regions
+            return m_pRegions ? m_pRegions[ index ] : m_Scratch;
+        }
+
+        inline VkProfilerFlatRegionDataEXT& InitRegion( uint32_t index, uint32_t parentIndex, VkProfilerRegionTypeEXT regionType, float duration )
+        {
+            VkProfilerFlatRegionDataEXT& out = GetRegion( index );
+            out.regionType = regionType;
+            out.properties = {};
+            out.duration = duration;
+            out.beginDuration = 0;
+            out.endDuration = 0;
+            out.parentIndex = parentIndex;
+            out.firstSubregionIndex = 0;
+            out.subregionCount = 0;
+            return out;
+        }
+
+    private:
+        const float m_TimestampPeriodMs;
+
+        VkProfilerFlatRegionDataEXT* m_pRegions;
+        VkProfilerFlatRegionDataEXT m_Scratch;
+        uint32_t m_RegionCount;
+
+    public:
+        FlatRegionBuilder( float timestampPeriod, VkProfilerFlatRegionDataEXT* pRegions )
+            : m_TimestampPeriodMs( timestampPeriod / 1000000.f )
+            , m_pRegions( pRegions )
+            , m_Scratch()
+            , m_RegionCount( 0 )
+        {
+        }
+
+        // Number of regions serialized so far
+        inline uint32_t GetRegionCount() const
+        {
+            return m_RegionCount;
+        }
+
+        // Drawcall serialization helper
+        inline void SerializeDrawcall( const DeviceProfilerDrawcall& data, uint32_t index, uint32_t parentIndex )
+        {
+            VkProfilerFlatRegionDataEXT& out = InitRegion( index, parentIndex,
+                VK_PROFILER_REGION_TYPE_COMMAND_EXT,
+                (data.m_EndTimestamp.m_Value - data.m_BeginTimestamp.m_Value) * m_TimestampPeriodMs );
+
+            out.properties.command.type = DrawcallTypeToCommandType( data.m_Type );
+        }
+
+        // Pipeline serialization helper
+        inline void SerializePipeline( const DeviceProfilerPipelineData& data, uint32_t index, uint32_t parentIndex )
+        {
+            VkProfilerFlatRegionDataEXT& out = InitRegion( index, parentIndex,
+                VK_PROFILER_REGION_TYPE_PIPELINE_EXT,
+                (data.m_EndTimestamp.m_Value - data.m_BeginTimestamp.m_Value) * m_TimestampPeriodMs );
+
+            out.properties.pipeline.handle = data.m_Handle;
+            SerializeSubregions( data.m_Drawcalls, &FlatRegionBuilder::SerializeDrawcall, index );
+        }
+
+        // Subpass serialization helper
+        inline void SerializeSubpass( const DeviceProfilerSubpassData& data, uint32_t index, uint32_t parentIndex )
+        {
+            VkProfilerFlatRegionDataEXT& out = InitRegion( index, parentIndex,
+                VK_PROFILER_REGION_TYPE_SUBPASS_EXT,
+                (data.m_EndTimestamp.m_Value - data.m_BeginTimestamp.m_Value) * m_TimestampPeriodMs );
+
+            out.properties.subpass.index = data.m_Index;
+            out.properties.subpass.contents = data.m_Contents;
+
+            switch( data.m_Contents )
+            {
+            case VK_SUBPASS_CONTENTS_INLINE:
+                SerializeSubregions( data.m_Pipelines, &FlatRegionBuilder::SerializePipeline, index );
+                break;
+
+            case VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS:
+                SerializeSubregions( data.m_SecondaryCommandBuffers, &FlatRegionBuilder::SerializeCommandBuffer, index );
+                break;
+
+            default:
+                assert( !"Invalid subpass contents" );
+                break;
+            }
+        }
+
+        // VkRenderPass serialization helper
+        inline void SerializeRenderPass( const DeviceProfilerRenderPassData& data, uint32_t index, uint32_t parentIndex )
+        {
+            VkProfilerFlatRegionDataEXT& out = InitRegion( index, parentIndex,
+                VK_PROFILER_REGION_TYPE_RENDER_PASS_EXT,
+                (data.m_EndTimestamp.m_Value - data.m_BeginTimestamp.m_Value) * m_TimestampPeriodMs );
+
+            out.properties.renderPass.handle = data.m_Handle;
+            out.beginDuration = (data.m_Begin.m_EndTimestamp.m_Value - data.m_Begin.m_BeginTimestamp.m_Value) * m_TimestampPeriodMs;
+            out.endDuration = (data.m_End.m_EndTimestamp.m_Value - data.m_End.m_BeginTimestamp.m_Value) * m_TimestampPeriodMs;
+            SerializeSubregions( data.m_Subpasses, &FlatRegionBuilder::SerializeSubpass, index );
+        }
+
+        // VkCommandBuffer serialization helper
+        inline void SerializeCommandBuffer( const DeviceProfilerCommandBufferData& data, uint32_t index, uint32_t parentIndex )
+        {
+            VkProfilerFlatRegionDataEXT& out = InitRegion( index, parentIndex,
+                VK_PROFILER_REGION_TYPE_COMMAND_BUFFER_EXT,
+                (data.m_EndTimestamp.m_Value - data.m_BeginTimestamp.m_Value) * m_TimestampPeriodMs );
+
+            out.properties.commandBuffer.handle = data.m_Handle;
+            out.properties.commandBuffer.level = data.m_Level;
+            SerializeSubregions( data.m_RenderPasses, &FlatRegionBuilder::SerializeRenderPass, index );
+        }
+
+        // VkSubmitInfo serialization helper
+        inline void SerializeSubmitInfo( const DeviceProfilerSubmitData& data, uint32_t index, uint32_t parentIndex )
+        {
+            InitRegion( index, parentIndex, VK_PROFILER_REGION_TYPE_SUBMIT_INFO_EXT, 0 );
+            SerializeSubregions( data.m_CommandBuffers, &FlatRegionBuilder::SerializeCommandBuffer, index );
+        }
+
+        // vkQueueSubmit serialization helper
+        inline void SerializeSubmit( const DeviceProfilerSubmitBatchData& data, uint32_t index, uint32_t parentIndex )
+        {
+            VkProfilerFlatRegionDataEXT& out = InitRegion( index, parentIndex,
+                VK_PROFILER_REGION_TYPE_SUBMIT_EXT, 0 );
+
+            out.properties.submit.queue = data.m_Handle;
+            SerializeSubregions( data.m_Submits, &FlatRegionBuilder::SerializeSubmitInfo, index );
+        }
+
+        // Frame serialization helper
+        inline void SerializeFrame( const DeviceProfilerFrameData& data )
+        {
+            // Frame is the root region
+            m_RegionCount = 1;
+
+            InitRegion( 0, VK_PROFILER_REGION_INDEX_NONE_EXT,
+                VK_PROFILER_REGION_TYPE_FRAME_EXT,
+                data.m_Ticks * m_TimestampPeriodMs );
+
+            SerializeSubregions( data.m_Submits, &FlatRegionBuilder::SerializeSubmit, 0 );
+        }
+    };
+}
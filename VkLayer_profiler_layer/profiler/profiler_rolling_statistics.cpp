@@ -0,0 +1,558 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "profiler_rolling_statistics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Profiler
+{
+    /***********************************************************************************\
+
+    Function:
+        IsValidTimestampRange
+
+    Description:
+        Check if both timestamps were collected in the current sampling mode.
+
+    \***********************************************************************************/
+    static inline bool IsValidTimestampRange( const DeviceProfilerTimestamp& begin, const DeviceProfilerTimestamp& end )
+    {
+        return (begin.m_Value != UINT64_MAX) && (end.m_Value != UINT64_MAX) && (end.m_Value >= begin.m_Value);
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        DeviceProfilerRollingStatistics
+
+    Description:
+        Constructor.
+
+    \***********************************************************************************/
+    DeviceProfilerRollingStatistics::DeviceProfilerRollingStatistics()
+        : m_HalfWindowSize( 1 )
+        , m_FrameCount( 0 )
+        , m_CurrentWindowIndex( 0 )
+        , m_Entries()
+        , m_pFrameEntries()
+    {
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        Initialize
+
+    Description:
+        Set number of frames covered by the statistics.
+
+    \***********************************************************************************/
+    void DeviceProfilerRollingStatistics::Initialize( uint32_t windowSize )
+    {
+        Reset();
+
+        // Each window gets at most one sample of each object per frame
+        m_HalfWindowSize = std::clamp<uint32_t>( windowSize / 2, 1, Histogram::MaxCount );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        Reset
+
+    Description:
+        Remove all collected samples.
+
+    \***********************************************************************************/
+    void DeviceProfilerRollingStatistics::Reset()
+    {
+        for( auto& entries : m_Entries )
+        {
+            entries.clear();
+        }
+
+        m_pFrameEntries.clear();
+        m_FrameCount = 0;
+        m_CurrentWindowIndex = 0;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        AppendFrame
+
+    Description:
+        Add one sample of GPU time of each object used in the frame.
+
+    \***********************************************************************************/
+    void DeviceProfilerRollingStatistics::AppendFrame( const DeviceProfilerFrameData& data )
+    {
+        for( const auto& submitBatch : data.m_Submits )
+        {
+            for( const auto& submit : submitBatch.m_Submits )
+            {
+                for( const auto& commandBuffer : submit.m_CommandBuffers )
+                {
+                    AppendCommandBuffer( commandBuffer );
+                }
+            }
+        }
+
+        AppendDebugLabels( data.m_DebugLabels );
+
+        // Objects used multiple times in the frame are reported as a single sample
+        for( Entry* pEntry : m_pFrameEntries )
+        {
+            pEntry->m_Windows[ m_CurrentWindowIndex ].Add( pEntry->m_FrameTicks );
+            pEntry->m_FrameTicks = 0;
+            pEntry->m_UsedInFrame = false;
+        }
+
+        m_pFrameEntries.clear();
+
+        if( (++m_FrameCount) >= m_HalfWindowSize )
+        {
+            RotateWindows();
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        GetStatistics
+
+    Description:
+        Compute statistics of all objects used in the last frames, sorted by type and
+        mean GPU time descending.
+
+    \***********************************************************************************/
+    void DeviceProfilerRollingStatistics::GetStatistics( ContainerType<DeviceProfilerRollingStatisticsData>& statistics ) const
+    {
+        statistics.clear();
+
+        for( const auto& entries : m_Entries )
+        {
+            const size_t firstIndex = statistics.size();
+
+            for( const auto& [_, entry] : entries )
+            {
+                const Window& a = entry.m_Windows[ 0 ];
+                const Window& b = entry.m_Windows[ 1 ];
+
+                const uint32_t count = a.m_Count + b.m_Count;
+                if( count == 0 )
+                {
+                    continue;
+                }
+
+                DeviceProfilerRollingStatisticsData& data = statistics.emplace_back( entry.m_Data );
+                data.m_SampleCount = count;
+                data.m_MinTicks = std::min( a.m_Min, b.m_Min );
+                data.m_MaxTicks = std::max( a.m_Max, b.m_Max );
+
+                // Merge mean and variance of both windows
+                const double delta = b.m_Mean - a.m_Mean;
+                data.m_MeanTicks = (a.m_Mean * a.m_Count + b.m_Mean * b.m_Count) / count;
+                data.m_StdDevTicks = std::sqrt(
+                    (a.m_M2 + b.m_M2 + delta * delta * a.m_Count * b.m_Count / count) / count );
+
+                // Find the quantiles in the merged histogram
+                const uint64_t p50Rank = std::max<uint64_t>( 1, (count * 50 + 99) / 100 );
+                const uint64_t p95Rank = std::max<uint64_t>( 1, (count * 95 + 99) / 100 );
+                const uint64_t p99Rank = std::max<uint64_t>( 1, (count * 99 + 99) / 100 );
+
+                uint64_t* pQuantiles[] = { &data.m_P50Ticks, &data.m_P95Ticks, &data.m_P99Ticks };
+                const uint64_t ranks[] = { p50Rank, p95Rank, p99Rank };
+
+                uint64_t cumulativeCount = 0;
+                uint32_t quantileIndex = 0;
+
+                for( uint32_t i = 0; (i < Histogram::BucketCount) && (quantileIndex < 3); ++i )
+                {
+                    cumulativeCount += a.m_Histogram.GetCount( i ) + b.m_Histogram.GetCount( i );
+
+                    while( (quantileIndex < 3) && (cumulativeCount >= ranks[ quantileIndex ]) )
+                    {
+                        // Bucket value is approximate, keep it in range of the exact values
+                        *pQuantiles[ quantileIndex++ ] = std::clamp(
+                            Histogram::GetBucketValue( i ), data.m_MinTicks, data.m_MaxTicks );
+                    }
+                }
+            }
+
+            std::sort( statistics.begin() + firstIndex, statistics.end(),
+                []( const DeviceProfilerRollingStatisticsData& a, const DeviceProfilerRollingStatisticsData& b )
+                {
+                    return a.m_MeanTicks > b.m_MeanTicks;
+                } );
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        GetEntry
+
+    Description:
+        Find or create entry for the object.
+
+    \***********************************************************************************/
+    DeviceProfilerRollingStatistics::Entry& DeviceProfilerRollingStatistics::GetEntry(
+        DeviceProfilerRollingStatisticsType type,
+        uint64_t key,
+        bool& inserted )
+    {
+        auto [it, emplaced] = m_Entries[ static_cast<uint32_t>( type ) ].try_emplace( key );
+
+        if( emplaced )
+        {
+            it->second.m_Data.m_Type = type;
+            it->second.m_Data.m_Key = key;
+        }
+
+        inserted = emplaced;
+        return it->second;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        AddFrameTicks
+
+    Description:
+        Accumulate GPU time of the object in the current frame.
+
+    \***********************************************************************************/
+    void DeviceProfilerRollingStatistics::AddFrameTicks( Entry& entry, uint64_t ticks )
+    {
+        if( !entry.m_UsedInFrame )
+        {
+            entry.m_UsedInFrame = true;
+            m_pFrameEntries.push_back( &entry );
+        }
+
+        entry.m_FrameTicks += ticks;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        AppendCommandBuffer
+
+    Description:
+        Accumulate GPU time of the objects used in the command buffer.
+
+    \***********************************************************************************/
+    void DeviceProfilerRollingStatistics::AppendCommandBuffer( const DeviceProfilerCommandBufferData& commandBuffer )
+    {
+        for( const auto& renderPass : commandBuffer.m_RenderPasses )
+        {
+            AppendRenderPass( renderPass );
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        AppendRenderPass
+
+    Description:
+        Accumulate GPU time of the render pass and the objects used in it.
+
+    \***********************************************************************************/
+    void DeviceProfilerRollingStatistics::AppendRenderPass( const DeviceProfilerRenderPassData& renderPass )
+    {
+        if( IsValidTimestampRange( renderPass.m_BeginTimestamp, renderPass.m_EndTimestamp ) )
+        {
+            // Commands outside of render passes and dynamic rendering passes don't have a handle,
+            // identify them by type instead
+            const uint64_t key = (renderPass.m_Handle != VK_NULL_HANDLE)
+                ? (uint64_t)renderPass.m_Handle
+                : ((static_cast<uint64_t>( renderPass.m_Type ) << 1) | renderPass.m_Dynamic);
+
+            bool inserted = false;
+            Entry& entry = GetEntry( DeviceProfilerRollingStatisticsType::eRenderPass, key, inserted );
+
+            if( inserted )
+            {
+                entry.m_Data.m_RenderPass.m_Handle = renderPass.m_Handle;
+                entry.m_Data.m_RenderPass.m_Type = renderPass.m_Type;
+                entry.m_Data.m_RenderPass.m_Dynamic = renderPass.m_Dynamic;
+            }
+
+            AddFrameTicks( entry, renderPass.m_EndTimestamp.m_Value - renderPass.m_BeginTimestamp.m_Value );
+        }
+
+        for( const auto& subpass : renderPass.m_Subpasses )
+        {
+            if( subpass.m_Contents == VK_SUBPASS_CONTENTS_INLINE )
+            {
+                for( const auto& pipeline : subpass.m_Pipelines )
+                {
+                    AppendPipeline( pipeline );
+                }
+            }
+
+            else if( subpass.m_Contents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS )
+            {
+                for( const auto& secondaryCommandBuffer : subpass.m_SecondaryCommandBuffers )
+                {
+                    AppendCommandBuffer( secondaryCommandBuffer );
+                }
+            }
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        AppendPipeline
+
+    Description:
+        Accumulate GPU time of the pipeline.
+
+    \***********************************************************************************/
+    void DeviceProfilerRollingStatistics::AppendPipeline( const DeviceProfilerPipelineData& pipeline )
+    {
+        if( (pipeline.m_Handle != VK_NULL_HANDLE) &&
+            (pipeline.m_Type != DeviceProfilerPipelineType::eDebug) &&
+            IsValidTimestampRange( pipeline.m_BeginTimestamp, pipeline.m_EndTimestamp ) )
+        {
+            bool inserted = false;
+            Entry& entry = GetEntry( DeviceProfilerRollingStatisticsType::ePipeline, pipeline.m_ShaderTuple.m_Hash, inserted );
+
+            if( inserted )
+            {
+                entry.m_Data.m_Pipeline.m_Handle = pipeline.m_Handle;
+                entry.m_Data.m_Pipeline.m_BindPoint = pipeline.m_BindPoint;
+                entry.m_Data.m_Pipeline.m_ShaderTuple = pipeline.m_ShaderTuple;
+                entry.m_Data.m_Pipeline.m_Type = pipeline.m_Type;
+            }
+
+            AddFrameTicks( entry, pipeline.m_EndTimestamp.m_Value - pipeline.m_BeginTimestamp.m_Value );
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        AppendDebugLabels
+
+    Description:
+        Accumulate inclusive GPU time of the debug labels. Labels are identified by
+        their path, so the same label used in different scopes is reported separately.
+
+    \***********************************************************************************/
+    void DeviceProfilerRollingStatistics::AppendDebugLabels( const ContainerType<DeviceProfilerDebugLabelData>& debugLabels )
+    {
+        for( const auto& debugLabel : debugLabels )
+        {
+            // Commands are not timestamped in less detailed sampling modes
+            if( debugLabel.m_InclusiveTicks == 0 )
+            {
+                continue;
+            }
+
+            bool inserted = false;
+            Entry& entry = GetEntry( DeviceProfilerRollingStatisticsType::eDebugLabel, debugLabel.m_PathId, inserted );
+
+            if( inserted )
+            {
+                // Parents precede their children in the tree
+                std::string path = debugLabel.m_Name;
+
+                for( uint32_t parentIndex = debugLabel.m_ParentIndex; parentIndex != UINT32_MAX; )
+                {
+                    const DeviceProfilerDebugLabelData& parent = debugLabels[ parentIndex ];
+                    path = parent.m_Name + " / " + path;
+                    parentIndex = parent.m_ParentIndex;
+                }
+
+                entry.m_Data.m_DebugLabelPath = std::move( path );
+            }
+
+            AddFrameTicks( entry, debugLabel.m_InclusiveTicks );
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        RotateWindows
+
+    Description:
+        Drop the older window and start collecting samples into it.
+
+    \***********************************************************************************/
+    void DeviceProfilerRollingStatistics::RotateWindows()
+    {
+        m_FrameCount = 0;
+        m_CurrentWindowIndex ^= 1;
+
+        for( auto& entries : m_Entries )
+        {
+            for( auto it = entries.begin(); it != entries.end(); )
+            {
+                Entry& entry = it->second;
+                entry.m_Windows[ m_CurrentWindowIndex ].Clear();
+
+                // Remove objects not used in any of the windows
+                if( entry.m_Windows[ m_CurrentWindowIndex ^ 1 ].m_Count == 0 )
+                {
+                    it = entries.erase( it );
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        Add
+
+    Description:
+        Add sample to the window.
+
+    \***********************************************************************************/
+    void DeviceProfilerRollingStatistics::Window::Add( uint64_t value )
+    {
+        m_Count++;
+        m_Min = std::min( m_Min, value );
+        m_Max = std::max( m_Max, value );
+
+        // Welford's online algorithm
+        const double delta = static_cast<double>( value ) - m_Mean;
+        m_Mean += delta / m_Count;
+        m_M2 += delta * (static_cast<double>( value ) - m_Mean);
+
+        m_Histogram.Add( value );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        Clear
+
+    Description:
+        Remove all samples from the window.
+
+    \***********************************************************************************/
+    void DeviceProfilerRollingStatistics::Window::Clear()
+    {
+        m_Count = 0;
+        m_Min = UINT64_MAX;
+        m_Max = 0;
+        m_Mean = 0;
+        m_M2 = 0;
+        m_Histogram.Clear();
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        Add
+
+    Description:
+        Count the value in the histogram.
+
+    \***********************************************************************************/
+    void DeviceProfilerRollingStatistics::Histogram::Add( uint64_t value )
+    {
+        uint16_t& count = m_Counts[ GetBucketIndex( value ) ];
+
+        if( count < MaxCount )
+        {
+            count++;
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        Clear
+
+    Description:
+        Reset all buckets.
+
+    \***********************************************************************************/
+    void DeviceProfilerRollingStatistics::Histogram::Clear()
+    {
+        m_Counts.fill( 0 );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        GetBucketIndex
+
+    Description:
+        Get index of the bucket in which the value is counted.
+
+    \***********************************************************************************/
+    uint32_t DeviceProfilerRollingStatistics::Histogram::GetBucketIndex( uint64_t value )
+    {
+        if( value < SubBucketCount )
+        {
+            return static_cast<uint32_t>( value );
+        }
+
+        if( value >= (1ULL << MaxValueBits) )
+        {
+            return BucketCount - 1;
+        }
+
+        // Find the power of 2 range of the value
+        uint32_t shift = 0;
+        while( (value >> shift) >= (2 * SubBucketCount) )
+        {
+            shift++;
+        }
+
+        const uint32_t subBucketIndex = static_cast<uint32_t>( value >> shift ) - SubBucketCount;
+        return SubBucketCount * (shift + 1) + subBucketIndex;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        GetBucketValue
+
+    Description:
+        Get value in the middle of the bucket.
+
+    \***********************************************************************************/
+    uint64_t DeviceProfilerRollingStatistics::Histogram::GetBucketValue( uint32_t bucketIndex )
+    {
+        if( bucketIndex < SubBucketCount )
+        {
+            return bucketIndex;
+        }
+
+        const uint32_t shift = (bucketIndex / SubBucketCount) - 1;
+        const uint64_t subBucketValue = SubBucketCount + (bucketIndex % SubBucketCount);
+
+        return (subBucketValue << shift) + ((1ULL << shift) >> 1);
+    }
+}
@@ -0,0 +1,137 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "profiler_data.h"
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Profiler
+{
+    /***********************************************************************************\
+
+    Class:
+        DeviceProfilerRollingStatistics
+
+    Description:
+        Maintains distribution of per-frame GPU time of each pipeline (identified by
+        the shader tuple hash), render pass and debug label path over the last frames.
+
+        Samples are accumulated in 2 alternating windows of half of the configured
+        size, so the statistics cover between half and full window of the most recent
+        frames. Each window keeps running min/max/mean/variance and a log-linear
+        histogram with fixed number of buckets, so the memory used by each object
+        and the cost of adding a sample do not depend on the window size.
+
+    \***********************************************************************************/
+    class DeviceProfilerRollingStatistics
+    {
+    public:
+        DeviceProfilerRollingStatistics();
+
+        void Initialize( uint32_t windowSize );
+        void Reset();
+
+        void AppendFrame( const DeviceProfilerFrameData& data );
+
+        void GetStatistics( ContainerType<DeviceProfilerRollingStatisticsData>& statistics ) const;
+
+    private:
+        /*******************************************************************************\
+
+        Class:
+            Histogram
+
+        Description:
+            Log-linear histogram of GPU ticks. Values below 16 are counted exactly,
+            greater values are counted in 16 linear buckets per power of 2, which keeps
+            the relative error of the quantiles below 6.25%.
+
+        \*******************************************************************************/
+        class Histogram
+        {
+        public:
+            static constexpr uint32_t SubBucketBits = 4;
+            static constexpr uint32_t SubBucketCount = 1U << SubBucketBits;
+            static constexpr uint32_t MaxValueBits = 40;
+            static constexpr uint32_t BucketCount = SubBucketCount * (MaxValueBits - SubBucketBits + 1);
+
+            // Counts are limited by the window size
+            static constexpr uint32_t MaxCount = UINT16_MAX;
+
+            void Add( uint64_t value );
+            void Clear();
+
+            uint32_t GetCount( uint32_t bucketIndex ) const { return m_Counts[ bucketIndex ]; }
+
+            static uint32_t GetBucketIndex( uint64_t value );
+            static uint64_t GetBucketValue( uint32_t bucketIndex );
+
+        private:
+            std::array<uint16_t, BucketCount> m_Counts = {};
+        };
+
+        struct Window
+        {
+            uint32_t  m_Count = 0;
+            uint64_t  m_Min = UINT64_MAX;
+            uint64_t  m_Max = 0;
+            double    m_Mean = 0;
+            double    m_M2 = 0;
+            Histogram m_Histogram = {};
+
+            void Add( uint64_t value );
+            void Clear();
+        };
+
+        struct Entry
+        {
+            DeviceProfilerRollingStatisticsData m_Data = {};
+            Window    m_Windows[ 2 ] = {};
+
+            // Accumulated during AppendFrame
+            uint64_t  m_FrameTicks = 0;
+            bool      m_UsedInFrame = false;
+        };
+
+        static constexpr uint32_t TypeCount = 3;
+
+        uint32_t m_HalfWindowSize;
+        uint32_t m_FrameCount;
+        uint32_t m_CurrentWindowIndex;
+
+        std::unordered_map<uint64_t, Entry> m_Entries[ TypeCount ];
+
+        // Temporary state of AppendFrame, kept to avoid reallocations
+        std::vector<Entry*> m_pFrameEntries;
+
+        Entry& GetEntry( DeviceProfilerRollingStatisticsType type, uint64_t key, bool& inserted );
+        void AddFrameTicks( Entry& entry, uint64_t ticks );
+
+        void AppendCommandBuffer( const DeviceProfilerCommandBufferData& commandBuffer );
+        void AppendRenderPass( const DeviceProfilerRenderPassData& renderPass );
+        void AppendPipeline( const DeviceProfilerPipelineData& pipeline );
+        void AppendDebugLabels( const ContainerType<DeviceProfilerDebugLabelData>& debugLabels );
+
+        void RotateWindows();
+    };
+}
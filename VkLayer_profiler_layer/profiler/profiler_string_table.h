@@ -0,0 +1,292 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "profiler_helpers.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <string.h>
+
+namespace Profiler
+{
+    /***********************************************************************************\
+
+    Class:
+        ProfilerStringTable
+
+    Description:
+        Global table of interned strings, identified by stable 32-bit ids.
+
+        Each unique string is stored only once for the lifetime of the process, so
+        the ids can be freely copied between the frames and the strings returned by
+        GetString never move. Looking up the string by its id does not take any locks.
+
+        Strings are never evicted, so the number of strings and the memory used to
+        store them are capped. Applications that generate unique names every frame
+        fill the table eventually, then new strings are not recorded and a message
+        is written to the debug output once.
+
+    \***********************************************************************************/
+    class ProfilerStringTable
+    {
+    public:
+        // Id of the null string
+        static constexpr uint32_t InvalidId = 0;
+
+        // Default limit of the memory used by the stored strings
+        static constexpr size_t DefaultMaxStorageSize = 64 * 1024 * 1024;
+
+        /*******************************************************************************\
+
+        Function:
+            ProfilerStringTable
+
+        Description:
+            Constructor. The global table uses the default limits, tables with lower
+            limits are created only in the tests.
+
+        \*******************************************************************************/
+        inline explicit ProfilerStringTable(
+            uint32_t maxStringCount = PageSize * MaxPageCount,
+            size_t maxStorageSize = DefaultMaxStorageSize )
+            : m_Mutex()
+            , m_Ids()
+            , m_pPages()
+            , m_StringCount( InvalidId + 1 )
+            , m_MaxStringCount( std::min( maxStringCount, PageSize * MaxPageCount ) )
+            , m_pStorageBlocks()
+            , m_pStorage( nullptr )
+            , m_StorageSize( 0 )
+            , m_StoredSize( 0 )
+            , m_MaxStorageSize( maxStorageSize )
+            , m_Full( false )
+        {
+        }
+
+        /*******************************************************************************\
+
+        Function:
+            Get
+
+        Description:
+            Returns the global string table.
+
+        \*******************************************************************************/
+        inline static ProfilerStringTable& Get()
+        {
+            static ProfilerStringTable table;
+            return table;
+        }
+
+        /*******************************************************************************\
+
+        Function:
+            Intern
+
+        Description:
+            Returns id of the string, adding it to the table if it is not there yet.
+            Returns InvalidId for null string or when the table is full (see
+            ProfilerStringTable).
+
+        \*******************************************************************************/
+        inline uint32_t Intern( const char* pString )
+        {
+            if( pString == nullptr )
+            {
+                return InvalidId;
+            }
+
+            const std::string_view string( pString );
+
+            // Most strings (e.g. debug labels) are recorded repeatedly every frame
+            {
+                std::shared_lock lk( m_Mutex );
+
+                auto it = m_Ids.find( string );
+                if( it != m_Ids.end() )
+                {
+                    return it->second;
+                }
+            }
+
+            std::unique_lock lk( m_Mutex );
+
+            auto it = m_Ids.find( string );
+            if( it != m_Ids.end() )
+            {
+                // String has been added by other thread
+                return it->second;
+            }
+
+            if( (m_StringCount == m_MaxStringCount) ||
+                (m_StoredSize + string.size() + 1 > m_MaxStorageSize) )
+            {
+                if( !m_Full )
+                {
+                    ProfilerPlatformFunctions::WriteDebug(
+                        "String table is full (%u strings, %llu bytes), new strings will not be recorded\n",
+                        m_StringCount - 1,
+                        static_cast<unsigned long long>( m_StoredSize ) );
+
+                    m_Full = true;
+                }
+
+                return InvalidId;
+            }
+
+            const uint32_t id = m_StringCount++;
+            const uint32_t pageIndex = id >> PageSizeBits;
+
+            if( pageIndex == m_pPages.size() )
+            {
+                m_pPages.push_back( std::make_unique<Page>() );
+                m_pPageTable[ pageIndex ].store( m_pPages.back().get(), std::memory_order_release );
+            }
+
+            const char* pStoredString = StoreString( string );
+            m_pPages[ pageIndex ]->m_pStrings[ id & (PageSize - 1) ].store( pStoredString, std::memory_order_release );
+
+            m_Ids.emplace( std::string_view( pStoredString, string.size() ), id );
+            return id;
+        }
+
+        /*******************************************************************************\
+
+        Function:
+            IsFull
+
+        Description:
+            Returns true if any string has been rejected because the table is full.
+
+        \*******************************************************************************/
+        inline bool IsFull() const
+        {
+            std::shared_lock lk( m_Mutex );
+            return m_Full;
+        }
+
+        /*******************************************************************************\
+
+        Function:
+            GetString
+
+        Description:
+            Returns the interned string. Returns nullptr for InvalidId.
+
+        \*******************************************************************************/
+        inline const char* GetString( uint32_t id ) const
+        {
+            if( id == InvalidId || id >= m_MaxStringCount )
+            {
+                return nullptr;
+            }
+
+            const Page* pPage = m_pPageTable[ id >> PageSizeBits ].load( std::memory_order_acquire );
+            if( pPage == nullptr )
+            {
+                return nullptr;
+            }
+
+            return pPage->m_pStrings[ id & (PageSize - 1) ].load( std::memory_order_acquire );
+        }
+
+    private:
+        static constexpr uint32_t PageSizeBits = 12;
+        static constexpr uint32_t PageSize = 1U << PageSizeBits;
+        static constexpr uint32_t MaxPageCount = 4096;
+
+        // Strings are stored in large blocks to avoid allocating memory for each string
+        static constexpr size_t StorageBlockSize = 64 * 1024;
+
+        struct Page
+        {
+            std::atomic<const char*> m_pStrings[ PageSize ] = {};
+        };
+
+        mutable std::shared_mutex m_Mutex;
+        std::unordered_map<std::string_view, uint32_t> m_Ids;
+
+        // Pages are published to the readers only after they are fully initialized
+        std::atomic<const Page*> m_pPageTable[ MaxPageCount ] = {};
+        std::vector<std::unique_ptr<Page>> m_pPages;
+        uint32_t m_StringCount;
+        const uint32_t m_MaxStringCount;
+
+        std::vector<std::unique_ptr<char[]>> m_pStorageBlocks;
+        char* m_pStorage;
+        size_t m_StorageSize;
+
+        // Total size of the stored strings, including the terminators
+        size_t m_StoredSize;
+        const size_t m_MaxStorageSize;
+
+        // Set when the first string is rejected, to report it only once
+        bool m_Full;
+
+        /*******************************************************************************\
+
+        Function:
+            StoreString
+
+        Description:
+            Copy the null-terminated string to the storage.
+
+        \*******************************************************************************/
+        inline const char* StoreString( std::string_view string )
+        {
+            const size_t size = string.size() + 1;
+            m_StoredSize += size;
+
+            if( size > m_StorageSize )
+            {
+                // Long strings get their own blocks
+                const size_t blockSize = std::max( size, StorageBlockSize );
+                m_pStorageBlocks.push_back( std::make_unique<char[]>( blockSize ) );
+
+                if( blockSize != size )
+                {
+                    m_pStorage = m_pStorageBlocks.back().get();
+                    m_StorageSize = blockSize;
+                }
+                else
+                {
+                    memcpy( m_pStorageBlocks.back().get(), string.data(), string.size() );
+                    m_pStorageBlocks.back()[ string.size() ] = '\0';
+                    return m_pStorageBlocks.back().get();
+                }
+            }
+
+            char* pStoredString = m_pStorage;
+            memcpy( pStoredString, string.data(), string.size() );
+            pStoredString[ string.size() ] = '\0';
+
+            m_pStorage += size;
+            m_StorageSize -= size;
+
+            return pStoredString;
+        }
+    };
+}
@@ -0,0 +1,593 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "profiler_capture.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace Profiler
+{
+    /***********************************************************************************\
+
+    Class:
+        ProfilerCaptureJsonHandler
+
+    Description:
+        SAX handler reading events from the Chrome JSON trace.
+
+        Only top-level fields of each event in the "traceEvents" array are read.
+        Duration events are matched per track ("tid") with a stack, frames are
+        separated by the vkQueuePresentKHR instant events.
+
+        Timestamps and durations in the trace are in microseconds and are converted
+        to milliseconds, the unit used by the pipeline statistics files.
+
+    \***********************************************************************************/
+    class ProfilerCaptureJsonHandler : public nlohmann::json_sax<nlohmann::json>
+    {
+    public:
+        ProfilerCaptureJsonHandler( ProfilerCapture& capture )
+            : m_Capture( capture )
+            , m_Depth( 0 )
+            , m_EventsDepth( 0 )
+            , m_ExpectEventsArray( false )
+            , m_CurrentFrame( 0 )
+            , m_LastPresentTimestamp( 0 )
+        {
+        }
+
+        bool null() override { return true; }
+        bool boolean( bool ) override { return true; }
+        bool number_integer( number_integer_t value ) override { return SetNumber( static_cast<double>( value ) ); }
+        bool number_unsigned( number_unsigned_t value ) override { return SetNumber( static_cast<double>( value ) ); }
+        bool number_float( number_float_t value, const string_t& ) override { return SetNumber( value ); }
+        bool binary( binary_t& ) override { return true; }
+
+        bool string( string_t& value ) override
+        {
+            if( IsEventField() )
+            {
+                if( m_Key == "name" ) m_Event.m_Name = std::move( value );
+                else if( m_Key == "cat" ) m_Event.m_Category = std::move( value );
+                else if( m_Key == "ph" ) m_Event.m_Phase = value.empty() ? '\0' : value[ 0 ];
+                else if( m_Key == "tid" ) m_Event.m_Track = std::move( value );
+            }
+            return true;
+        }
+
+        bool key( string_t& value ) override
+        {
+            m_Key = std::move( value );
+            m_ExpectEventsArray = (m_Depth == 1) && (m_Key == "traceEvents");
+            return true;
+        }
+
+        bool start_object( std::size_t ) override
+        {
+            m_Depth++;
+
+            if( (m_EventsDepth != 0) && (m_Depth == m_EventsDepth + 1) )
+            {
+                // Beginning of the next event
+                m_Event = {};
+            }
+
+            m_ExpectEventsArray = false;
+            return true;
+        }
+
+        bool end_object() override
+        {
+            if( (m_EventsDepth != 0) && (m_Depth == m_EventsDepth + 1) )
+            {
+                ProcessEvent();
+            }
+
+            m_Depth--;
+            return true;
+        }
+
+        bool start_array( std::size_t ) override
+        {
+            m_Depth++;
+
+            // Both JSON Object Format and JSON Array Format are accepted
+            if( (m_EventsDepth == 0) && ((m_Depth == 1) || m_ExpectEventsArray) )
+            {
+                m_EventsDepth = m_Depth;
+            }
+
+            m_ExpectEventsArray = false;
+            return true;
+        }
+
+        bool end_array() override
+        {
+            m_Depth--;
+            return true;
+        }
+
+        bool parse_error( std::size_t position, const std::string&, const nlohmann::detail::exception& ex ) override
+        {
+            m_ErrorMessage = "Parse error at byte " + std::to_string( position ) + ": " + ex.what();
+            return false;
+        }
+
+        uint32_t GetFrameCount() const
+        {
+            return m_CurrentFrame;
+        }
+
+        const std::string& GetErrorMessage() const
+        {
+            return m_ErrorMessage;
+        }
+
+    private:
+        struct Event
+        {
+            std::string m_Name;
+            std::string m_Category;
+            std::string m_Track;
+            char        m_Phase = '\0';
+            double      m_Timestamp = 0;
+            double      m_Duration = 0;
+        };
+
+        struct OpenRegion
+        {
+            std::string m_Name;
+            std::string m_Category;
+            double      m_Timestamp;
+        };
+
+        ProfilerCapture& m_Capture;
+
+        uint32_t    m_Depth;
+        uint32_t    m_EventsDepth;
+        bool        m_ExpectEventsArray;
+        std::string m_Key;
+        std::string m_ErrorMessage;
+
+        Event       m_Event;
+
+        uint32_t    m_CurrentFrame;
+        double      m_LastPresentTimestamp;
+
+        std::unordered_map<std::string, std::vector<OpenRegion>> m_OpenRegions;
+
+        bool IsEventField() const
+        {
+            return (m_EventsDepth != 0) && (m_Depth == m_EventsDepth + 1);
+        }
+
+        bool SetNumber( double value )
+        {
+            if( IsEventField() )
+            {
+                if( m_Key == "ts" ) m_Event.m_Timestamp = value;
+                else if( m_Key == "dur" ) m_Event.m_Duration = value;
+            }
+            return true;
+        }
+
+        void ProcessEvent()
+        {
+            switch( m_Event.m_Phase )
+            {
+            case 'B':
+                m_OpenRegions[ m_Event.m_Track ].push_back( {
+                    std::move( m_Event.m_Name ),
+                    std::move( m_Event.m_Category ),
+                    m_Event.m_Timestamp } );
+                break;
+
+            case 'E':
+            {
+                auto& stack = m_OpenRegions[ m_Event.m_Track ];
+                if( !stack.empty() )
+                {
+                    const OpenRegion& region = stack.back();
+                    AddRegion( region.m_Category, region.m_Name, ToMilliseconds( m_Event.m_Timestamp - region.m_Timestamp ) );
+                    stack.pop_back();
+                }
+                break;
+            }
+
+            case 'X':
+                AddRegion( m_Event.m_Category, m_Event.m_Name, ToMilliseconds( m_Event.m_Duration ) );
+                break;
+
+            case 'i':
+            case 'I':
+                if( m_Event.m_Name == "vkQueuePresentKHR" )
+                {
+                    // Timestamps are relative to the beginning of the capture
+                    m_Capture.AddFrameDuration( m_CurrentFrame,
+                        static_cast<float>( ToMilliseconds( m_Event.m_Timestamp - m_LastPresentTimestamp ) ) );
+
+                    m_LastPresentTimestamp = m_Event.m_Timestamp;
+                    m_CurrentFrame++;
+                }
+                break;
+            }
+        }
+
+        static double ToMilliseconds( double microseconds )
+        {
+            return microseconds / 1000.0;
+        }
+
+        void AddRegion( const std::string& category, const std::string& name, double duration )
+        {
+            ProfilerCaptureRegionType type;
+
+            if( category == "Pipelines" ) type = ProfilerCaptureRegionType::ePipeline;
+            else if( category == "Render passes" ) type = ProfilerCaptureRegionType::eRenderPass;
+            else if( category == "Command buffers" ) type = ProfilerCaptureRegionType::eCommandBuffer;
+            else return;
+
+            // Only names are available in the trace
+            m_Capture.AddRegionDuration( type, name, name, m_CurrentFrame, static_cast<float>( duration ) );
+        }
+    };
+
+    /***********************************************************************************\
+
+    Function:
+        SplitCsvLine
+
+    Description:
+        Split a line of the CSV file into fields, removing quotes.
+
+    \***********************************************************************************/
+    static std::vector<std::string> SplitCsvLine( const std::string& line )
+    {
+        std::vector<std::string> fields( 1 );
+        bool quoted = false;
+
+        for( size_t i = 0; i < line.length(); ++i )
+        {
+            const char c = line[ i ];
+
+            if( quoted )
+            {
+                if( c == '"' )
+                {
+                    if( (i + 1 < line.length()) && (line[ i + 1 ] == '"') )
+                    {
+                        // Escaped quote
+                        fields.back() += '"';
+                        ++i;
+                    }
+                    else
+                    {
+                        quoted = false;
+                    }
+                }
+                else
+                {
+                    fields.back() += c;
+                }
+            }
+            else if( c == '"' ) quoted = true;
+            else if( c == ',' ) fields.emplace_back();
+            else if( c != '\r' ) fields.back() += c;
+        }
+
+        return fields;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        Load
+
+    Description:
+        Load the capture file. The format is selected by the file extension.
+
+    \***********************************************************************************/
+    bool ProfilerCapture::Load( const std::filesystem::path& filename )
+    {
+        m_Filename = filename;
+
+        std::ifstream file( filename, std::ios::in | std::ios::binary );
+
+        if( !file.is_open() )
+        {
+            m_ErrorMessage = "Failed to open " + filename.string();
+            return false;
+        }
+
+        if( filename.extension() == ".csv" )
+        {
+            return LoadCsv( file );
+        }
+
+        return LoadJson( file );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        GetRegions
+
+    \***********************************************************************************/
+    const std::unordered_map<std::string, ProfilerCaptureRegion>& ProfilerCapture::GetRegions( ProfilerCaptureRegionType type ) const
+    {
+        return m_Regions[ static_cast<size_t>( type ) ];
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        GetRegionStats
+
+    Description:
+        Compute statistics of all regions of the given type.
+        Regions are sorted by mean duration, in descending order.
+
+    \***********************************************************************************/
+    std::vector<ProfilerCaptureRegionStats> ProfilerCapture::GetRegionStats( ProfilerCaptureRegionType type ) const
+    {
+        std::vector<ProfilerCaptureRegionStats> stats;
+
+        for( const auto& [key, region] : GetRegions( type ) )
+        {
+            ProfilerCaptureRegionStats regionStats = GetStats( region.m_FrameDurations );
+            regionStats.m_Key = key;
+            regionStats.m_Name = region.m_Name;
+            stats.push_back( std::move( regionStats ) );
+        }
+
+        std::sort( stats.begin(), stats.end(),
+            []( const ProfilerCaptureRegionStats& a, const ProfilerCaptureRegionStats& b )
+            {
+                return a.m_Mean > b.m_Mean;
+            } );
+
+        return stats;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        GetStats
+
+    Description:
+        Compute mean, max and nearest-rank percentiles of non-zero durations.
+
+    \***********************************************************************************/
+    ProfilerCaptureRegionStats ProfilerCapture::GetStats( const std::vector<float>& durations )
+    {
+        ProfilerCaptureRegionStats stats = {};
+
+        std::vector<float> samples;
+        samples.reserve( durations.size() );
+
+        for( const float duration : durations )
+        {
+            if( duration > 0 )
+            {
+                samples.push_back( duration );
+                stats.m_Mean += duration;
+                stats.m_Max = std::max( stats.m_Max, duration );
+            }
+        }
+
+        if( !samples.empty() )
+        {
+            stats.m_FrameCount = static_cast<uint32_t>( samples.size() );
+            stats.m_Mean /= samples.size();
+
+            auto percentile = [&samples]( float p )
+            {
+                const size_t rank = static_cast<size_t>( std::ceil( p * samples.size() ) );
+                const auto it = samples.begin() + std::min( std::max<size_t>( rank, 1 ), samples.size() ) - 1;
+                std::nth_element( samples.begin(), it, samples.end() );
+                return *it;
+            };
+
+            stats.m_P50 = percentile( 0.50f );
+            stats.m_P95 = percentile( 0.95f );
+            stats.m_P99 = percentile( 0.99f );
+        }
+
+        return stats;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        AddRegionDuration
+
+    Description:
+        Accumulate GPU time of the region in the frame.
+
+    \***********************************************************************************/
+    void ProfilerCapture::AddRegionDuration( ProfilerCaptureRegionType type, const std::string& key, const std::string& name, uint32_t frameIndex, float duration )
+    {
+        ProfilerCaptureRegion& region = m_Regions[ static_cast<size_t>( type ) ][ key ];
+
+        if( region.m_Name.empty() )
+        {
+            region.m_Name = name;
+        }
+
+        if( region.m_FrameDurations.size() <= frameIndex )
+        {
+            region.m_FrameDurations.resize( frameIndex + 1, 0.f );
+        }
+
+        region.m_FrameDurations[ frameIndex ] += duration;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        AddFrameDuration
+
+    \***********************************************************************************/
+    void ProfilerCapture::AddFrameDuration( uint32_t frameIndex, float duration )
+    {
+        if( m_FrameDurations.size() <= frameIndex )
+        {
+            m_FrameDurations.resize( frameIndex + 1, 0.f );
+        }
+
+        m_FrameDurations[ frameIndex ] = duration;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        SetFrameCount
+
+    Description:
+        Set number of frames in the capture and pad per-frame arrays.
+
+    \***********************************************************************************/
+    void ProfilerCapture::SetFrameCount( uint32_t frameCount )
+    {
+        m_FrameCount = frameCount;
+        m_FrameDurations.resize( frameCount, 0.f );
+
+        for( auto& regions : m_Regions )
+        {
+            for( auto& [key, region] : regions )
+            {
+                region.m_FrameDurations.resize( frameCount, 0.f );
+            }
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        LoadJson
+
+    Description:
+        Load Chrome JSON trace saved by DeviceProfilerTraceSerializer.
+
+    \***********************************************************************************/
+    bool ProfilerCapture::LoadJson( std::istream& file )
+    {
+        ProfilerCaptureJsonHandler handler( *this );
+
+        if( !nlohmann::json::sax_parse( file, &handler ) )
+        {
+            m_ErrorMessage = handler.GetErrorMessage();
+            return false;
+        }
+
+        // Regions after the last present belong to an incomplete frame
+        SetFrameCount( handler.GetFrameCount() );
+        return true;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        LoadCsv
+
+    Description:
+        Load pipeline statistics saved by DeviceProfilerCsvSerializer.
+
+    \***********************************************************************************/
+    bool ProfilerCapture::LoadCsv( std::istream& file )
+    {
+        std::string line;
+
+        if( !std::getline( file, line ) )
+        {
+            m_ErrorMessage = "Empty file";
+            return false;
+        }
+
+        // Find required columns
+        const std::vector<std::string> header = SplitCsvLine( line );
+
+        auto column = [&header]( const char* pName ) -> size_t
+        {
+            return std::find( header.begin(), header.end(), pName ) - header.begin();
+        };
+
+        const size_t frameColumn = column( "frame" );
+        const size_t hashColumn = column( "pipeline_hash" );
+        const size_t nameColumn = column( "pipeline_name" );
+        const size_t pipelineTimeColumn = column( "pipeline_gpu_time_ms" );
+        // Same metric as the time between the presents in the traces
+        const size_t frameTimeColumn = column( "frame_cpu_time_ms" );
+
+        const size_t columnCount = std::max( { frameColumn, hashColumn, nameColumn, pipelineTimeColumn, frameTimeColumn } ) + 1;
+
+        if( columnCount > header.size() )
+        {
+            m_ErrorMessage = "Not a pipeline statistics file";
+            return false;
+        }
+
+        uint32_t frameCount = 0;
+        uint32_t lineNumber = 1;
+
+        while( std::getline( file, line ) )
+        {
+            lineNumber++;
+
+            if( line.empty() )
+            {
+                continue;
+            }
+
+            const std::vector<std::string> fields = SplitCsvLine( line );
+
+            try
+            {
+                if( fields.size() < columnCount )
+                {
+                    throw std::invalid_argument( "missing columns" );
+                }
+
+                const uint32_t frameIndex = static_cast<uint32_t>( std::stoul( fields[ frameColumn ] ) );
+
+                AddRegionDuration( ProfilerCaptureRegionType::ePipeline,
+                    fields[ hashColumn ],
+                    fields[ nameColumn ],
+                    frameIndex,
+                    std::stof( fields[ pipelineTimeColumn ] ) );
+
+                AddFrameDuration( frameIndex, std::stof( fields[ frameTimeColumn ] ) );
+
+                frameCount = std::max( frameCount, frameIndex + 1 );
+            }
+            catch( const std::exception& )
+            {
+                m_ErrorMessage = "Invalid data at line " + std::to_string( lineNumber );
+                return false;
+            }
+        }
+
+        SetFrameCount( frameCount );
+        return true;
+    }
+}
@@ -0,0 +1,142 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <array>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Profiler
+{
+    /***********************************************************************************\
+
+    Enumeration:
+        ProfilerCaptureRegionType
+
+    Description:
+        Types of regions aggregated from the capture files.
+
+    \***********************************************************************************/
+    enum class ProfilerCaptureRegionType
+    {
+        ePipeline,
+        eRenderPass,
+        eCommandBuffer,
+        eCount
+    };
+
+    /***********************************************************************************\
+
+    Structure:
+        ProfilerCaptureRegion
+
+    Description:
+        GPU time of one region (pipeline, render pass or command buffer) in each
+        frame of the capture. Frames in which the region was not used have 0 duration.
+
+    \***********************************************************************************/
+    struct ProfilerCaptureRegion
+    {
+        std::string        m_Name;
+        std::vector<float> m_FrameDurations;
+    };
+
+    /***********************************************************************************\
+
+    Structure:
+        ProfilerCaptureRegionStats
+
+    Description:
+        Multi-frame statistics of a region, in milliseconds.
+        Only frames in which the region was used are included.
+
+    \***********************************************************************************/
+    struct ProfilerCaptureRegionStats
+    {
+        std::string m_Key;
+        std::string m_Name;
+        uint32_t    m_FrameCount = 0;
+        float       m_Mean = 0;
+        float       m_P50 = 0;
+        float       m_P95 = 0;
+        float       m_P99 = 0;
+        float       m_Max = 0;
+    };
+
+    /***********************************************************************************\
+
+    Class:
+        ProfilerCapture
+
+    Description:
+        Loads data saved by the profiler layer for offline analysis.
+
+        Supported inputs:
+         - Chrome JSON traces (*.json) written by DeviceProfilerTraceSerializer.
+           Frames are separated by vkQueuePresentKHR events. The file is parsed
+           with a SAX parser, so the whole document is never kept in memory.
+         - Pipeline statistics (*.csv) written by DeviceProfilerCsvSerializer.
+           Contain only pipeline regions, identified by the shader tuple hash.
+
+        Region names were produced by DeviceProfilerStringSerializer when
+        the capture was saved and are used as-is.
+
+        Frame durations are CPU times between the presents in both formats,
+        so captures saved in different formats can be compared.
+
+    \***********************************************************************************/
+    class ProfilerCapture
+    {
+    public:
+        bool Load( const std::filesystem::path& filename );
+
+        const std::filesystem::path& GetFilename() const { return m_Filename; }
+        const std::string& GetErrorMessage() const { return m_ErrorMessage; }
+
+        uint32_t GetFrameCount() const { return m_FrameCount; }
+        const std::vector<float>& GetFrameDurations() const { return m_FrameDurations; }
+
+        const std::unordered_map<std::string, ProfilerCaptureRegion>& GetRegions( ProfilerCaptureRegionType type ) const;
+
+        std::vector<ProfilerCaptureRegionStats> GetRegionStats( ProfilerCaptureRegionType type ) const;
+
+        static ProfilerCaptureRegionStats GetStats( const std::vector<float>& durations );
+
+        // Used by the file loaders
+        void AddRegionDuration( ProfilerCaptureRegionType type, const std::string& key, const std::string& name, uint32_t frameIndex, float duration );
+        void AddFrameDuration( uint32_t frameIndex, float duration );
+        void SetFrameCount( uint32_t frameCount );
+
+    private:
+        std::filesystem::path m_Filename;
+        std::string           m_ErrorMessage;
+
+        uint32_t              m_FrameCount = 0;
+        std::vector<float>    m_FrameDurations;
+
+        std::array<std::unordered_map<std::string, ProfilerCaptureRegion>,
+            static_cast<size_t>( ProfilerCaptureRegionType::eCount )> m_Regions;
+
+        bool LoadJson( std::istream& );
+        bool LoadCsv( std::istream& );
+    };
+}
@@ -0,0 +1,416 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "profiler_capture.h"
+#include "profiler_shared_memory_reader.h"
+#include "profiler_stream_client.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <unordered_set>
+
+using namespace Profiler;
+
+namespace
+{
+    struct RegionTypeInfo
+    {
+        ProfilerCaptureRegionType m_Type;
+        const char* m_pOption;
+        const char* m_pTitle;
+    };
+
+    constexpr RegionTypeInfo g_RegionTypes[] = {
+        { ProfilerCaptureRegionType::ePipeline, "pipelines", "Pipelines" },
+        { ProfilerCaptureRegionType::eRenderPass, "renderpasses", "Render passes" },
+        { ProfilerCaptureRegionType::eCommandBuffer, "commandbuffers", "Command buffers" } };
+
+    struct Options
+    {
+        std::vector<std::filesystem::path> m_Captures;
+        std::unordered_set<ProfilerCaptureRegionType> m_Types;
+        size_t m_Top = 10;
+        bool m_Diff = false;
+        uint16_t m_ConnectPort = 0;
+        std::string m_SharedMemoryName;
+        uint32_t m_FrameCount = 0;
+    };
+
+    /***********************************************************************************\
+
+    Function:
+        PrintUsage
+
+    \***********************************************************************************/
+    void PrintUsage( const char* pProgramName )
+    {
+        std::printf(
+            "Usage:\n"
+            "  %s [options] <capture>\n"
+            "  %s [options] --diff <baseline> <capture>\n"
+            "  %s [options] --connect <port>\n"
+            "  %s [options] --shared-memory <name>\n"
+            "\n"
+            "Captures are trace files (*.json) or pipeline statistics files (*.csv)\n"
+            "saved by the profiling layer. With --connect, the frames are received live\n"
+            "from an application running with stream_server_port set to <port>.\n"
+            "With --shared-memory, the frames are read from the ring published by\n"
+            "an application running with shared_memory_ring_name set to <name>.\n"
+            "\n"
+            "Options:\n"
+            "  --top <N>       Number of regions listed in each table (default: 10, 0 = all)\n"
+            "  --type <type>   Report only pipelines, renderpasses or commandbuffers\n"
+            "                  (may be specified multiple times)\n"
+            "  --diff          Compare the capture with the baseline\n"
+            "  --connect <port> Print frames streamed by the layer\n"
+            "  --shared-memory <name> Print frames published in the shared memory\n"
+            "  --frames <N>    Number of live frames to print (default: 0 = all)\n"
+            "  --help          Show this message\n",
+            pProgramName, pProgramName, pProgramName, pProgramName );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        ParseOptions
+
+    \***********************************************************************************/
+    bool ParseOptions( int argc, char** argv, Options& options )
+    {
+        for( int i = 1; i < argc; ++i )
+        {
+            const char* pArg = argv[ i ];
+
+            if( std::strcmp( pArg, "--diff" ) == 0 )
+            {
+                options.m_Diff = true;
+            }
+            else if( (std::strcmp( pArg, "--top" ) == 0) && (i + 1 < argc) )
+            {
+                options.m_Top = std::strtoul( argv[ ++i ], nullptr, 10 );
+            }
+            else if( (std::strcmp( pArg, "--connect" ) == 0) && (i + 1 < argc) )
+            {
+                options.m_ConnectPort = static_cast<uint16_t>( std::strtoul( argv[ ++i ], nullptr, 10 ) );
+            }
+            else if( (std::strcmp( pArg, "--shared-memory" ) == 0) && (i + 1 < argc) )
+            {
+                options.m_SharedMemoryName = argv[ ++i ];
+            }
+            else if( (std::strcmp( pArg, "--frames" ) == 0) && (i + 1 < argc) )
+            {
+                options.m_FrameCount = static_cast<uint32_t>( std::strtoul( argv[ ++i ], nullptr, 10 ) );
+            }
+            else if( (std::strcmp( pArg, "--type" ) == 0) && (i + 1 < argc) )
+            {
+                const char* pType = argv[ ++i ];
+                const auto it = std::find_if( std::begin( g_RegionTypes ), std::end( g_RegionTypes ),
+                    [pType]( const RegionTypeInfo& info ) { return std::strcmp( info.m_pOption, pType ) == 0; } );
+
+                if( it == std::end( g_RegionTypes ) )
+                {
+                    std::fprintf( stderr, "Unknown region type: %s\n", pType );
+                    return false;
+                }
+
+                options.m_Types.insert( it->m_Type );
+            }
+            else if( pArg[ 0 ] == '-' )
+            {
+                return false;
+            }
+            else
+            {
+                options.m_Captures.push_back( pArg );
+            }
+        }
+
+        if( options.m_Types.empty() )
+        {
+            for( const RegionTypeInfo& info : g_RegionTypes )
+            {
+                options.m_Types.insert( info.m_Type );
+            }
+        }
+
+        if( (options.m_ConnectPort != 0) || !options.m_SharedMemoryName.empty() )
+        {
+            // Only one live source is allowed
+            return options.m_Captures.empty() && !options.m_Diff &&
+                ((options.m_ConnectPort == 0) || options.m_SharedMemoryName.empty());
+        }
+
+        return options.m_Captures.size() == (options.m_Diff ? 2 : 1);
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        Truncate
+
+    Description:
+        Shorten long region names to keep the table aligned.
+
+    \***********************************************************************************/
+    std::string Truncate( const std::string& name, size_t length )
+    {
+        if( name.length() <= length )
+        {
+            return name;
+        }
+
+        return name.substr( 0, length - 3 ) + "...";
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        PrintSummary
+
+    \***********************************************************************************/
+    void PrintSummary( const ProfilerCapture& capture )
+    {
+        const ProfilerCaptureRegionStats frameStats = ProfilerCapture::GetStats( capture.GetFrameDurations() );
+
+        std::printf( "%s: %u frames\n", capture.GetFilename().string().c_str(), capture.GetFrameCount() );
+        std::printf( "  Frame time (CPU, present to present): mean %.3f ms, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+            frameStats.m_Mean, frameStats.m_P50, frameStats.m_P95, frameStats.m_P99, frameStats.m_Max );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        PrintReport
+
+    Description:
+        Print the most expensive regions of each type.
+
+    \***********************************************************************************/
+    void PrintReport( const ProfilerCapture& capture, const Options& options )
+    {
+        PrintSummary( capture );
+
+        for( const RegionTypeInfo& info : g_RegionTypes )
+        {
+            if( !options.m_Types.count( info.m_Type ) )
+            {
+                continue;
+            }
+
+            const std::vector<ProfilerCaptureRegionStats> stats = capture.GetRegionStats( info.m_Type );
+
+            if( stats.empty() )
+            {
+                continue;
+            }
+
+            std::printf( "\n%s (by mean GPU time per frame)\n", info.m_pTitle );
+            std::printf( "  %-48s %8s %10s %10s %10s %10s %10s\n",
+                "Name", "Frames", "Mean [ms]", "P50 [ms]", "P95 [ms]", "P99 [ms]", "Max [ms]" );
+
+            const size_t count = (options.m_Top != 0) ? std::min( options.m_Top, stats.size() ) : stats.size();
+
+            for( size_t i = 0; i < count; ++i )
+            {
+                const ProfilerCaptureRegionStats& region = stats[ i ];
+                std::printf( "  %-48s %8u %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+                    Truncate( region.m_Name, 48 ).c_str(),
+                    region.m_FrameCount,
+                    region.m_Mean, region.m_P50, region.m_P95, region.m_P99, region.m_Max );
+            }
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        PrintDiff
+
+    Description:
+        Print regions with the largest change of the mean GPU time per frame.
+        Regions present in only one of the captures are reported as added or removed.
+
+    \***********************************************************************************/
+    void PrintDiff( const ProfilerCapture& baseline, const ProfilerCapture& capture, const Options& options )
+    {
+        PrintSummary( baseline );
+        PrintSummary( capture );
+
+        struct RegionDiff
+        {
+            std::string m_Name;
+            float m_BaselineMean = 0;
+            float m_Mean = 0;
+            bool m_InBaseline = false;
+            bool m_InCapture = false;
+        };
+
+        for( const RegionTypeInfo& info : g_RegionTypes )
+        {
+            if( !options.m_Types.count( info.m_Type ) )
+            {
+                continue;
+            }
+
+            std::unordered_map<std::string, RegionDiff> diffs;
+
+            for( const ProfilerCaptureRegionStats& stats : baseline.GetRegionStats( info.m_Type ) )
+            {
+                RegionDiff& diff = diffs[ stats.m_Key ];
+                diff.m_Name = stats.m_Name;
+                diff.m_BaselineMean = stats.m_Mean;
+                diff.m_InBaseline = true;
+            }
+
+            for( const ProfilerCaptureRegionStats& stats : capture.GetRegionStats( info.m_Type ) )
+            {
+                RegionDiff& diff = diffs[ stats.m_Key ];
+                diff.m_Name = stats.m_Name;
+                diff.m_Mean = stats.m_Mean;
+                diff.m_InCapture = true;
+            }
+
+            if( diffs.empty() )
+            {
+                continue;
+            }
+
+            std::vector<RegionDiff> sortedDiffs;
+            sortedDiffs.reserve( diffs.size() );
+
+            for( auto& [key, diff] : diffs )
+            {
+                sortedDiffs.push_back( std::move( diff ) );
+            }
+
+            std::sort( sortedDiffs.begin(), sortedDiffs.end(),
+                []( const RegionDiff& a, const RegionDiff& b )
+                {
+                    return std::abs( a.m_Mean - a.m_BaselineMean ) > std::abs( b.m_Mean - b.m_BaselineMean );
+                } );
+
+            std::printf( "\n%s (by change of mean GPU time per frame)\n", info.m_pTitle );
+            std::printf( "  %-48s %13s %10s %10s %9s\n",
+                "Name", "Baseline [ms]", "Mean [ms]", "Delta [ms]", "Delta [%]" );
+
+            const size_t count = (options.m_Top != 0) ? std::min( options.m_Top, sortedDiffs.size() ) : sortedDiffs.size();
+
+            for( size_t i = 0; i < count; ++i )
+            {
+                const RegionDiff& diff = sortedDiffs[ i ];
+                const float delta = diff.m_Mean - diff.m_BaselineMean;
+
+                char percentage[ 16 ] = "removed";
+
+                if( !diff.m_InBaseline )
+                {
+                    std::strcpy( percentage, "added" );
+                }
+                else if( diff.m_InCapture && (diff.m_BaselineMean > 0) )
+                {
+                    std::snprintf( percentage, sizeof( percentage ), "%+.1f", 100.f * delta / diff.m_BaselineMean );
+                }
+
+                std::printf( "  %-48s %13.3f %10.3f %+10.3f %9s\n",
+                    Truncate( diff.m_Name, 48 ).c_str(),
+                    diff.m_BaselineMean, diff.m_Mean, delta, percentage );
+            }
+        }
+    }
+}
+
+/***************************************************************************************\
+
+Function:
+    main
+
+Description:
+    Entry point of the offline capture analysis tool.
+
+\***************************************************************************************/
+int main( int argc, char** argv )
+{
+    Options options;
+
+    if( !ParseOptions( argc, argv, options ) )
+    {
+        PrintUsage( argv[ 0 ] );
+        return EXIT_FAILURE;
+    }
+
+    // Print all pipelines if the limit is not set
+    const size_t livePipelineCount = (options.m_Top != 0) ? options.m_Top : SIZE_MAX;
+
+    if( options.m_ConnectPort != 0 )
+    {
+        // Live mode
+        return RunStreamClient( options.m_ConnectPort, options.m_FrameCount, livePipelineCount );
+    }
+
+    if( !options.m_SharedMemoryName.empty() )
+    {
+        // Live mode
+        return RunSharedMemoryReader( options.m_SharedMemoryName, options.m_FrameCount, livePipelineCount );
+    }
+
+    // Load the captures in parallel
+    std::vector<ProfilerCapture> captures( options.m_Captures.size() );
+    std::vector<std::future<bool>> results;
+
+    for( size_t i = 0; i < captures.size(); ++i )
+    {
+        results.push_back( std::async( std::launch::async,
+            &ProfilerCapture::Load, &captures[ i ], options.m_Captures[ i ] ) );
+    }
+
+    bool succeeded = true;
+
+    for( size_t i = 0; i < captures.size(); ++i )
+    {
+        if( !results[ i ].get() )
+        {
+            std::fprintf( stderr, "%s: %s\n",
+                options.m_Captures[ i ].string().c_str(),
+                captures[ i ].GetErrorMessage().c_str() );
+
+            succeeded = false;
+        }
+    }
+
+    if( !succeeded )
+    {
+        return EXIT_FAILURE;
+    }
+
+    if( options.m_Diff )
+    {
+        PrintDiff( captures[ 0 ], captures[ 1 ], options );
+    }
+    else
+    {
+        PrintReport( captures[ 0 ], options );
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,322 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "profiler_shared_memory_reader.h"
+#include "profiler_ext/VkProfilerSharedMemoryRing.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Profiler
+{
+    /***********************************************************************************\
+
+    Class:
+        SharedMemoryMapping
+
+    Description:
+        Read-only mapping of the shared memory object.
+
+    \***********************************************************************************/
+    class SharedMemoryMapping
+    {
+    public:
+        ~SharedMemoryMapping()
+        {
+            Unmap();
+
+        #ifdef WIN32
+            if( m_Handle ) CloseHandle( m_Handle );
+        #else
+            if( m_Fd != -1 ) close( m_Fd );
+        #endif
+        }
+
+        bool Open( std::string name )
+        {
+        #ifdef WIN32
+            m_Handle = OpenFileMappingA( FILE_MAP_READ, FALSE, name.c_str() );
+            return m_Handle != nullptr;
+        #else
+            if( name.front() != '/' )
+            {
+                name.insert( name.begin(), '/' );
+            }
+
+            m_Fd = shm_open( name.c_str(), O_RDONLY, 0 );
+            return m_Fd != -1;
+        #endif
+        }
+
+        const uint8_t* Map( size_t size )
+        {
+            Unmap();
+
+        #ifdef WIN32
+            m_pMemory = MapViewOfFile( m_Handle, FILE_MAP_READ, 0, 0, size );
+        #else
+            m_pMemory = mmap( nullptr, size, PROT_READ, MAP_SHARED, m_Fd, 0 );
+            if( m_pMemory == MAP_FAILED ) m_pMemory = nullptr;
+        #endif
+
+            m_Size = size;
+            return static_cast<const uint8_t*>( m_pMemory );
+        }
+
+        void Unmap()
+        {
+            if( m_pMemory )
+            {
+            #ifdef WIN32
+                UnmapViewOfFile( m_pMemory );
+            #else
+                munmap( m_pMemory, m_Size );
+            #endif
+                m_pMemory = nullptr;
+            }
+        }
+
+    private:
+    #ifdef WIN32
+        HANDLE m_Handle = nullptr;
+    #else
+        int    m_Fd = -1;
+    #endif
+        void*  m_pMemory = nullptr;
+        size_t m_Size = 0;
+    };
+
+    /***********************************************************************************\
+
+    Function:
+        AtomicLoad
+
+    Description:
+        Load a field of the shared memory atomically.
+
+    \***********************************************************************************/
+    static uint64_t AtomicLoad( const uint64_t& value, std::memory_order order )
+    {
+        static_assert( sizeof( std::atomic<uint64_t> ) == sizeof( uint64_t ) );
+        return reinterpret_cast<const std::atomic<uint64_t>&>( value ).load( order );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        IsWriterRunning
+
+    Description:
+        Check if the process publishing the frames is still running.
+        A crashed process never clears the magic of the ring.
+
+    \***********************************************************************************/
+    static bool IsWriterRunning( const VkProfilerSharedMemoryRingHeader& header )
+    {
+        const uint64_t processId = header.writerProcessId;
+
+        if( processId == 0 )
+        {
+            // Unknown writer
+            return true;
+        }
+
+    #ifdef WIN32
+        HANDLE hProcess = OpenProcess( SYNCHRONIZE, FALSE, static_cast<DWORD>( processId ) );
+
+        if( hProcess == nullptr )
+        {
+            return GetLastError() != ERROR_INVALID_PARAMETER;
+        }
+
+        const bool running = (WaitForSingleObject( hProcess, 0 ) == WAIT_TIMEOUT);
+        CloseHandle( hProcess );
+        return running;
+    #else
+        return (kill( static_cast<pid_t>( processId ), 0 ) == 0) || (errno != ESRCH);
+    #endif
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        ReadSlot
+
+    Description:
+        Copy the slot, following the sequence lock protocol.
+        Returns false if the slot was modified during the copy.
+
+    \***********************************************************************************/
+    static bool ReadSlot( const uint8_t* pSlot, std::vector<uint8_t>& slotCopy )
+    {
+        const auto& slotHeader = *reinterpret_cast<const VkProfilerSharedMemoryRingSlotHeader*>( pSlot );
+
+        const uint64_t sequence = AtomicLoad( slotHeader.sequence, std::memory_order_acquire );
+
+        if( sequence & 1 )
+        {
+            // Slot is being written
+            return false;
+        }
+
+        std::memcpy( slotCopy.data(), pSlot, slotCopy.size() );
+
+        std::atomic_thread_fence( std::memory_order_acquire );
+        return AtomicLoad( slotHeader.sequence, std::memory_order_relaxed ) == sequence;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        RunSharedMemoryReader
+
+    Description:
+        Read and print the frames published by the layer.
+
+    \***********************************************************************************/
+    int RunSharedMemoryReader( const std::string& name, uint32_t frameCount, size_t pipelineCount )
+    {
+        SharedMemoryMapping mapping;
+
+        if( !mapping.Open( name ) )
+        {
+            std::fprintf( stderr, "Failed to open shared memory %s\n", name.c_str() );
+            return EXIT_FAILURE;
+        }
+
+        // Read the header to get size of the ring
+        const uint8_t* pMemory = mapping.Map( sizeof( VkProfilerSharedMemoryRingHeader ) );
+
+        if( !pMemory ||
+            (reinterpret_cast<const VkProfilerSharedMemoryRingHeader*>( pMemory )->magic != VK_PROFILER_SHARED_MEMORY_RING_MAGIC) ||
+            (reinterpret_cast<const VkProfilerSharedMemoryRingHeader*>( pMemory )->version != VK_PROFILER_SHARED_MEMORY_RING_VERSION) )
+        {
+            std::fprintf( stderr, "%s is not a profiler frame ring\n", name.c_str() );
+            return EXIT_FAILURE;
+        }
+
+        std::atomic_thread_fence( std::memory_order_acquire );
+
+        const VkProfilerSharedMemoryRingHeader header = *reinterpret_cast<const VkProfilerSharedMemoryRingHeader*>( pMemory );
+        pMemory = mapping.Map( header.headerSize + static_cast<size_t>( header.slotSize ) * header.slotCount );
+
+        if( !pMemory )
+        {
+            std::fprintf( stderr, "Failed to map shared memory %s\n", name.c_str() );
+            return EXIT_FAILURE;
+        }
+
+        const auto& sharedHeader = *reinterpret_cast<const VkProfilerSharedMemoryRingHeader*>( pMemory );
+
+        // Number of 1ms waits between the checks of the writer process
+        static constexpr uint32_t WriterCheckInterval = 1000;
+
+        std::vector<uint8_t> slotCopy( header.slotSize );
+        uint32_t readFrameCount = 0;
+        uint32_t waitCount = 0;
+        uint64_t nextFrameIndex = AtomicLoad( sharedHeader.publishedFrameCount, std::memory_order_acquire );
+
+        while( (frameCount == 0) || (readFrameCount < frameCount) )
+        {
+            const uint64_t publishedFrameCount = AtomicLoad( sharedHeader.publishedFrameCount, std::memory_order_acquire );
+
+            if( publishedFrameCount <= nextFrameIndex )
+            {
+                if( sharedHeader.magic != VK_PROFILER_SHARED_MEMORY_RING_MAGIC )
+                {
+                    // Ring has been destroyed
+                    break;
+                }
+
+                if( (waitCount++ % WriterCheckInterval == 0) && !IsWriterRunning( header ) )
+                {
+                    std::fprintf( stderr, "Process %llu publishing %s is no longer running\n",
+                        static_cast<unsigned long long>( header.writerProcessId ),
+                        name.c_str() );
+
+                    return EXIT_FAILURE;
+                }
+
+                // Wait for the next frame
+                std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+                continue;
+            }
+
+            if( publishedFrameCount - nextFrameIndex > header.slotCount )
+            {
+                // Reader is too slow, skip the overwritten frames
+                std::printf( "(%llu frames overwritten)\n",
+                    static_cast<unsigned long long>( publishedFrameCount - header.slotCount - nextFrameIndex ) );
+
+                nextFrameIndex = publishedFrameCount - header.slotCount;
+            }
+
+            const uint8_t* pSlot = pMemory + header.headerSize +
+                static_cast<size_t>( nextFrameIndex % header.slotCount ) * header.slotSize;
+
+            const auto& slotHeader = *reinterpret_cast<const VkProfilerSharedMemoryRingSlotHeader*>( slotCopy.data() );
+
+            if( !ReadSlot( pSlot, slotCopy ) || (slotHeader.frameIndex != nextFrameIndex) )
+            {
+                // Torn read or the slot has been overwritten in the meantime, check the counter again
+                continue;
+            }
+
+            const auto& frame = *reinterpret_cast<const VkProfilerSharedMemoryFrame*>( &slotHeader + 1 );
+            const auto* pPipelines = reinterpret_cast<const VkProfilerSharedMemoryPipeline*>( &frame + 1 );
+
+            std::printf( "Frame %llu: CPU %.3f ms, GPU %.3f ms, %.1f FPS, memory %.1f MB in %llu allocations\n",
+                static_cast<unsigned long long>( slotHeader.frameIndex ),
+                frame.cpuTimeMs,
+                frame.gpuTimeMs,
+                frame.framesPerSec,
+                frame.memoryAllocationSize / 1048576.f,
+                static_cast<unsigned long long>( frame.memoryAllocationCount ) );
+
+            for( uint32_t i = 0; (i < frame.pipelineCount) && (i < header.maxPipelineCount) && (i < pipelineCount); ++i )
+            {
+                std::printf( "  %-48.*s %8.3f ms\n",
+                    VK_PROFILER_SHARED_MEMORY_MAX_NAME_SIZE,
+                    pPipelines[ i ].name,
+                    pPipelines[ i ].gpuTimeMs );
+            }
+
+            nextFrameIndex++;
+            readFrameCount++;
+        }
+
+        return EXIT_SUCCESS;
+    }
+}
@@ -0,0 +1,46 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Profiler
+{
+    /***********************************************************************************\
+
+    Function:
+        RunSharedMemoryReader
+
+    Description:
+        Reference reader of the shared-memory frame ring.
+
+        Opens the ring published by the layer running in another process and prints
+        a summary of each frame. Frames overwritten before they were read and torn
+        reads are reported.
+
+        Reads frameCount frames or runs until the layer destroys the ring if frameCount is 0.
+        Fails if the process publishing the frames exits without destroying the ring.
+        Returns the exit code of the tool.
+
+    \***********************************************************************************/
+    int RunSharedMemoryReader( const std::string& name, uint32_t frameCount, size_t pipelineCount );
+}
@@ -0,0 +1,189 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Winsock must be included before windows.h
+#ifdef WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+using SOCKET = int;
+#define INVALID_SOCKET (-1)
+#define closesocket close
+#endif
+
+#include "profiler_stream_client.h"
+#include <nlohmann/json.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace Profiler
+{
+    /***********************************************************************************\
+
+    Function:
+        PrintSnapshot
+
+    Description:
+        Print frame times and the most expensive pipelines of the snapshot.
+
+    \***********************************************************************************/
+    static void PrintSnapshot( const nlohmann::json& snapshot, uint64_t skippedFrameCount, size_t pipelineCount )
+    {
+        const nlohmann::json memory = snapshot.value( "memory", nlohmann::json::object() );
+        const nlohmann::json pipelines = snapshot.value( "pipelines", nlohmann::json::array() );
+
+        std::printf( "Frame %llu: CPU %.3f ms, GPU %.3f ms, %.1f FPS, memory %.1f MB in %llu allocations",
+            snapshot.value( "frame", 0ULL ),
+            snapshot.value( "cpu_time_ms", 0.f ),
+            snapshot.value( "gpu_time_ms", 0.f ),
+            snapshot.value( "fps", 0.f ),
+            memory.value( "allocation_size", 0ULL ) / 1048576.f,
+            memory.value( "allocation_count", 0ULL ) );
+
+        if( skippedFrameCount > 0 )
+        {
+            std::printf( " (%llu frames skipped)", static_cast<unsigned long long>( skippedFrameCount ) );
+        }
+
+        std::printf( "\n" );
+
+        for( size_t i = 0; (i < pipelineCount) && (i < pipelines.size()); ++i )
+        {
+            std::printf( "  %-48s %8.3f ms\n",
+                pipelines[ i ].value( "name", std::string() ).c_str(),
+                pipelines[ i ].value( "gpu_time_ms", 0.f ) );
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        RunStreamClient
+
+    Description:
+        Receive and print the snapshots streamed by the layer.
+
+    \***********************************************************************************/
+    int RunStreamClient( uint16_t port, uint32_t frameCount, size_t pipelineCount )
+    {
+    #ifdef WIN32
+        WSADATA wsaData;
+        if( WSAStartup( MAKEWORD( 2, 2 ), &wsaData ) != 0 )
+        {
+            std::fprintf( stderr, "Failed to initialize Winsock\n" );
+            return EXIT_FAILURE;
+        }
+    #endif
+
+        SOCKET s = socket( AF_INET, SOCK_STREAM, IPPROTO_TCP );
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons( port );
+        address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+
+        if( (s == INVALID_SOCKET) ||
+            (connect( s, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) != 0) )
+        {
+            std::fprintf( stderr, "Failed to connect to the profiler on port %u\n", port );
+
+            if( s != INVALID_SOCKET )
+            {
+                closesocket( s );
+            }
+
+        #ifdef WIN32
+            WSACleanup();
+        #endif
+            return EXIT_FAILURE;
+        }
+
+        int exitCode = EXIT_SUCCESS;
+        uint32_t receivedFrameCount = 0;
+        uint64_t expectedFrameIndex = UINT64_MAX;
+
+        std::string data;
+        char buffer[ 4096 ];
+
+        while( (frameCount == 0) || (receivedFrameCount < frameCount) )
+        {
+            const auto receivedSize = recv( s, buffer, sizeof( buffer ), 0 );
+
+            if( receivedSize <= 0 )
+            {
+                // Connection closed by the server
+                break;
+            }
+
+            data.append( buffer, static_cast<size_t>( receivedSize ) );
+
+            // Each snapshot is sent in a separate line
+            size_t lineBegin = 0;
+            size_t lineEnd = 0;
+
+            while( ((lineEnd = data.find( '\n', lineBegin )) != std::string::npos) &&
+                   ((frameCount == 0) || (receivedFrameCount < frameCount)) )
+            {
+                const nlohmann::json snapshot = nlohmann::json::parse(
+                    data.begin() + lineBegin, data.begin() + lineEnd, nullptr, false );
+
+                lineBegin = lineEnd + 1;
+
+                if( snapshot.is_discarded() )
+                {
+                    std::fprintf( stderr, "Received invalid snapshot\n" );
+                    exitCode = EXIT_FAILURE;
+                    break;
+                }
+
+                const uint64_t frameIndex = snapshot.value( "frame", 0ULL );
+                const uint64_t skippedFrameCount =
+                    ((expectedFrameIndex != UINT64_MAX) && (frameIndex > expectedFrameIndex))
+                        ? (frameIndex - expectedFrameIndex)
+                        : 0;
+
+                PrintSnapshot( snapshot, skippedFrameCount, pipelineCount );
+
+                expectedFrameIndex = frameIndex + 1;
+                receivedFrameCount++;
+            }
+
+            data.erase( 0, lineBegin );
+
+            if( exitCode != EXIT_SUCCESS )
+            {
+                break;
+            }
+        }
+
+        closesocket( s );
+
+    #ifdef WIN32
+        WSACleanup();
+    #endif
+
+        return exitCode;
+    }
+}
@@ -0,0 +1,44 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace Profiler
+{
+    /***********************************************************************************\
+
+    Function:
+        RunStreamClient
+
+    Description:
+        Reference client of DeviceProfilerStreamServer.
+
+        Connects to the layer running in another process on the same machine and
+        prints a summary of each received frame snapshot. Frames skipped by the
+        server because the client was too slow are reported.
+
+        Receives frameCount snapshots or runs until the server closes the
+        connection if frameCount is 0. Returns the exit code of the tool.
+
+    \***********************************************************************************/
+    int RunStreamClient( uint16_t port, uint32_t frameCount, size_t pipelineCount );
+}
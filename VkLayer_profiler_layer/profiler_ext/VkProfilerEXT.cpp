@@ -20,6 +20,7 @@
 
 #include "VkProfilerEXT.h"
 #include "VkDevice_functions.h"
+#include "profiler/profiler_region_builder.h"
 
 using namespace Profiler;
 
@@ -88,40 +89,6 @@ private:
         return result;
     }
 
-    inline VkProfilerCommandTypeEXT DrawcallTypeToCommandType( DeviceProfilerDrawcallType type ) const
-    {
-        static const std::unordered_map<DeviceProfilerDrawcallType, VkProfilerCommandTypeEXT> commandTypes =
-        {
-            { DeviceProfilerDrawcallType::eDraw,                        VK_PROFILER_COMMAND_DRAW_EXT },
-            { DeviceProfilerDrawcallType::eDrawIndexed,                 VK_PROFILER_COMMAND_DRAW_INDEXED_EXT },
-            { DeviceProfilerDrawcallType::eDrawIndirect,                VK_PROFILER_COMMAND_DRAW_INDIRECT_EXT },
-            { DeviceProfilerDrawcallType::eDrawIndexedIndirect,         VK_PROFILER_COMMAND_DRAW_INDEXED_INDIRECT_EXT },
-            { DeviceProfilerDrawcallType::eDrawIndirectCount,           VK_PROFILER_COMMAND_DRAW_INDIRECT_COUNT_EXT },
-            { DeviceProfilerDrawcallType::eDrawIndexedIndirectCount,    VK_PROFILER_COMMAND_DRAW_INDEXED_INDIRECT_COUNT_EXT },
-            { DeviceProfilerDrawcallType::eDispatch,                    VK_PROFILER_COMMAND_DISPATCH_EXT },
-            { DeviceProfilerDrawcallType::eDispatchIndirect,            VK_PROFILER_COMMAND_DISPATCH_INDIRECT_EXT },
-            { DeviceProfilerDrawcallType::eCopyBuffer,                  VK_PROFILER_COMMAND_COPY_BUFFER_EXT },
-            { DeviceProfilerDrawcallType::eCopyBufferToImage,           VK_PROFILER_COMMAND_COPY_BUFFER_TO_IMAGE_EXT },
-            { DeviceProfilerDrawcallType::eCopyImage,                   VK_PROFILER_COMMAND_COPY_IMAGE_EXT },
-            { DeviceProfilerDrawcallType::eCopyImageToBuffer,           VK_PROFILER_COMMAND_COPY_IMAGE_TO_BUFFER_EXT },
-            { DeviceProfilerDrawcallType::eClearAttachments,            VK_PROFILER_COMMAND_CLEAR_ATTACHMENTS_EXT },
-            { DeviceProfilerDrawcallType::eClearColorImage,             VK_PROFILER_COMMAND_CLEAR_COLOR_IMAGE_EXT },
-            { DeviceProfilerDrawcallType::eClearDepthStencilImage,      VK_PROFILER_COMMAND_CLEAR_DEPTH_STENCIL_IMAGE_EXT },
-            { DeviceProfilerDrawcallType::eResolveImage,                VK_PROFILER_COMMAND_RESOLVE_IMAGE_EXT },
-            { DeviceProfilerDrawcallType::eBlitImage,                   VK_PROFILER_COMMAND_BLIT_IMAGE_EXT },
-            { DeviceProfilerDrawcallType::eFillBuffer,                  VK_PROFILER_COMMAND_FILL_BUFFER_EXT },
-            { DeviceProfilerDrawcallType::eUpdateBuffer,                VK_PROFILER_COMMAND_UPDATE_BUFFER_EXT }
-        };
-
-        auto it = commandTypes.find( type );
-        if( it != commandTypes.end() )
-        {
-            return it->second;
-        }
-
-        return VK_PROFILER_COMMAND_UNKNOWN_EXT;
-    }
-
 private:
     const float m_TimestampPeriodMs;
 
@@ -364,6 +331,244 @@ VKAPI_ATTR void VKAPI_CALL vkFreeProfilerFrameDataEXT(
 
 /***************************************************************************************\
 
+Function:
+    vkGetProfilerFrameRegionsEXT
+
+Description:
+    Fill provided array with regions of the previous frame.
+    If pRegions is null, the number of regions is returned in pRegionCount.
+    Otherwise pRegionCount must contain the size of the pRegions array. The regions are
+    written without any internal allocations, with the frame region at index 0 and
+    subregions referenced by index.
+    Result values:
+     VK_SUCCESS - function succeeded
+     VK_INCOMPLETE - provided array is too small, no regions have been written and
+       pRegionCount has been updated with the required size
+     VK_NOT_READY - function called before first call to vkQueuePresentKHR
+       or no profiling data available
+
+\***************************************************************************************/
+VKAPI_ATTR VkResult VKAPI_CALL vkGetProfilerFrameRegionsEXT(
+    VkDevice device,
+    uint32_t* pRegionCount,
+    VkProfilerFlatRegionDataEXT* pRegions )
+{
+    auto& dd = VkDevice_Functions::DeviceDispatch.Get( device );
+
+    const float timestampPeriod = dd.Device.pPhysicalDevice->Properties.limits.timestampPeriod;
+
+    // Serialize directly from the profiler's data to avoid copying the whole frame
+    std::scoped_lock lk( dd.Profiler.m_DataMutex );
+
+    const DeviceProfilerFrameData& data = dd.Profiler.m_Data;
+
+    if( data.m_Submits.empty() )
+    {
+        // Data not ready yet
+        //  Check if application called vkQueuePresentKHR or vkFlushProfilerEXT
+        return VK_NOT_READY;
+    }
+
+    // Count the regions first, the frame may have changed since the previous call
+    FlatRegionBuilder counter( timestampPeriod, nullptr );
+    counter.SerializeFrame( data );
+
+    const uint32_t regionCount = counter.GetRegionCount();
+
+    if( !pRegions )
+    {
+        (*pRegionCount) = regionCount;
+        return VK_SUCCESS;
+    }
+
+    if( (*pRegionCount) < regionCount )
+    {
+        (*pRegionCount) = regionCount;
+        return VK_INCOMPLETE;
+    }
+
+    FlatRegionBuilder builder( timestampPeriod, pRegions );
+    builder.SerializeFrame( data );
+
+    assert( builder.GetRegionCount() == regionCount );
+    (*pRegionCount) = regionCount;
+
+    return VK_SUCCESS;
+}
+
+/***************************************************************************************\
+
+Function:
+    vkGetProfilerFrameHistoryEXT
+
+Description:
+    Fill provided array with summaries of frames completed since firstSequenceNumber,
+    oldest first. If pFrames is null, the number of available frames is returned in
+    pFrameCount. Frames that are no longer available in the bounded history are
+    counted in pDroppedFrameCount (optional).
+    Result values:
+     VK_SUCCESS - function succeeded
+     VK_INCOMPLETE - provided array is too small, the oldest frames have been written
+       and the remaining ones can be queried starting from the next sequence number
+
+\***************************************************************************************/
+VKAPI_ATTR VkResult VKAPI_CALL vkGetProfilerFrameHistoryEXT(
+    VkDevice device,
+    uint64_t firstSequenceNumber,
+    uint32_t* pFrameCount,
+    VkProfilerFrameSummaryEXT* pFrames,
+    uint64_t* pDroppedFrameCount )
+{
+    auto& dd = VkDevice_Functions::DeviceDispatch.Get( device );
+    return dd.Profiler.GetFrameHistory( firstSequenceNumber, pFrameCount, pFrames, pDroppedFrameCount );
+}
+
+/***************************************************************************************\
+
+Function:
+    vkGetProfilerRollingStatisticsEXT
+
+Description:
+    Fill provided array with distribution of per-frame GPU time of pipelines, render
+    passes and debug labels used in the last frames (see rolling_statistics_window_size).
+    The statistics are sorted by type and mean duration descending.
+    If pStatistics is null, the number of available statistics is returned in
+    pStatisticsCount.
+    Result values:
+     VK_SUCCESS - function succeeded
+     VK_INCOMPLETE - provided array is too small, only pStatisticsCount statistics
+       have been written
+
+\***************************************************************************************/
+VKAPI_ATTR VkResult VKAPI_CALL vkGetProfilerRollingStatisticsEXT(
+    VkDevice device,
+    uint32_t* pStatisticsCount,
+    VkProfilerRollingStatisticsEXT* pStatistics )
+{
+    auto& dd = VkDevice_Functions::DeviceDispatch.Get( device );
+
+    // Convert ticks to milliseconds
+    const double tickPeriod = dd.Device.pPhysicalDevice->Properties.limits.timestampPeriod / 1000000.0;
+
+    ContainerType<DeviceProfilerRollingStatisticsData> statistics;
+    dd.Profiler.GetRollingStatistics( statistics );
+
+    if( !pStatistics )
+    {
+        (*pStatisticsCount) = static_cast<uint32_t>( statistics.size() );
+        return VK_SUCCESS;
+    }
+
+    const uint32_t count = std::min( (*pStatisticsCount), static_cast<uint32_t>( statistics.size() ) );
+
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        const DeviceProfilerRollingStatisticsData& data = statistics[ i ];
+        VkProfilerRollingStatisticsEXT& out = pStatistics[ i ];
+
+        out = {};
+        out.key = data.m_Key;
+        out.sampleCount = data.m_SampleCount;
+        out.minDuration = static_cast<float>( data.m_MinTicks * tickPeriod );
+        out.maxDuration = static_cast<float>( data.m_MaxTicks * tickPeriod );
+        out.meanDuration = static_cast<float>( data.m_MeanTicks * tickPeriod );
+        out.stdDevDuration = static_cast<float>( data.m_StdDevTicks * tickPeriod );
+        out.p50Duration = static_cast<float>( data.m_P50Ticks * tickPeriod );
+        out.p95Duration = static_cast<float>( data.m_P95Ticks * tickPeriod );
+        out.p99Duration = static_cast<float>( data.m_P99Ticks * tickPeriod );
+
+        switch( data.m_Type )
+        {
+        case DeviceProfilerRollingStatisticsType::ePipeline:
+            out.type = VK_PROFILER_ROLLING_STATISTICS_TYPE_PIPELINE_EXT;
+            out.properties.pipeline.handle = data.m_Pipeline.m_Handle;
+            break;
+
+        case DeviceProfilerRollingStatisticsType::eRenderPass:
+            out.type = VK_PROFILER_ROLLING_STATISTICS_TYPE_RENDER_PASS_EXT;
+            out.properties.renderPass.handle = data.m_RenderPass.m_Handle;
+            break;
+
+        case DeviceProfilerRollingStatisticsType::eDebugLabel:
+            out.type = VK_PROFILER_ROLLING_STATISTICS_TYPE_DEBUG_LABEL_EXT;
+            ProfilerStringFunctions::CopyString( out.debugLabelPath,
+                data.m_DebugLabelPath.c_str(), data.m_DebugLabelPath.length() );
+            break;
+        }
+    }
+
+    const bool complete = (count == statistics.size());
+    (*pStatisticsCount) = count;
+
+    return complete ? VK_SUCCESS : VK_INCOMPLETE;
+}
+
+/***************************************************************************************\
+
+Function:
+    vkSetProfilerFrameCallbackEXT
+
+Description:
+    Register function called whenever data of a frame is fully resolved.
+    The callback receives a read-only view of the frame, valid only for the duration
+    of the call. It is called from the thread that finishes the frame (presents or
+    flushes the profiler) and must not call vkFlushProfilerEXT nor
+    vkSetProfilerFrameCallbackEXT. Pass null pfnCallback to unregister the callback.
+    After this function returns, the previous callback is not called anymore.
+
+    The callback is called after the profiler releases the locks taken by the submits,
+    so it doesn't block other threads recording and submitting the command buffers.
+    It delays the thread finishing the frame and the callbacks of the frames finished
+    by other threads, which may be called in a different order than the frames ended.
+
+\***************************************************************************************/
+VKAPI_ATTR VkResult VKAPI_CALL vkSetProfilerFrameCallbackEXT(
+    VkDevice device,
+    PFN_vkProfilerFrameCallbackEXT pfnCallback,
+    void* pUserData )
+{
+    auto& dd = VkDevice_Functions::DeviceDispatch.Get( device );
+    return dd.Profiler.SetFrameCallback( pfnCallback, pUserData );
+}
+
+/***************************************************************************************\
+
+Function:
+    vkBeginProfilerCpuRegionEXT
+
+Description:
+    Mark beginning of the application's CPU region in the calling thread.
+    The region is reported with the frame in which it ends, on the same timeline as
+    the CPU timestamps of the frame. Regions may be nested, but must begin and end
+    in the same thread.
+
+\***************************************************************************************/
+VKAPI_ATTR void VKAPI_CALL vkBeginProfilerCpuRegionEXT(
+    VkDevice device,
+    const VkDebugUtilsLabelEXT* pLabelInfo )
+{
+    auto& dd = VkDevice_Functions::DeviceDispatch.Get( device );
+    dd.Profiler.BeginCpuRegion( pLabelInfo->pLabelName, pLabelInfo->color );
+}
+
+/***************************************************************************************\
+
+Function:
+    vkEndProfilerCpuRegionEXT
+
+Description:
+    Mark end of the last CPU region began in the calling thread.
+
+\***************************************************************************************/
+VKAPI_ATTR void VKAPI_CALL vkEndProfilerCpuRegionEXT(
+    VkDevice device )
+{
+    auto& dd = VkDevice_Functions::DeviceDispatch.Get( device );
+    dd.Profiler.EndCpuRegion();
+}
+
+/***************************************************************************************\
+
 Function:
     vkFlushProfilerEXT
 
@@ -375,7 +580,7 @@ Description:
 VKAPI_ATTR VkResult VKAPI_CALL vkFlushProfilerEXT(
     VkDevice device )
 {
-    VkDevice_Functions::DeviceDispatch.Get( device ).Profiler.FinishFrame();
+    VkDevice_Functions::FinishFrameBase( VkDevice_Functions::DeviceDispatch.Get( device ) );
     return VK_SUCCESS;
 }
 
@@ -25,6 +25,7 @@
 #define VK_EXT_profiler 1
 #define VK_EXT_PROFILER_SPEC_VERSION 1
 #define VK_EXT_PROFILER_EXTENSION_NAME "VK_EXT_profiler"
+#define VK_PROFILER_REGION_INDEX_NONE_EXT (~0U)
 
 enum VkProfilerResultEXT
 {
@@ -36,6 +37,8 @@ enum VkProfilerStructureTypeEXT
     VK_STRUCTURE_TYPE_PROFILER_DATA_EXT = 1000999001,
     VK_STRUCTURE_TYPE_PROFILER_REGION_DATA_EXT = 1000999002,
     VK_STRUCTURE_TYPE_PROFILER_RENDER_PASS_DATA_EXT = 1000999003,
+    VK_STRUCTURE_TYPE_PROFILER_FRAME_CALLBACK_CREATE_INFO_EXT = 1000999004,
+    VK_STRUCTURE_TYPE_PROFILER_FRAME_CALLBACK_DATA_EXT = 1000999005,
     VK_PROFILER_STRUCTURE_TYPE_MAX_ENUM_EXT = 0x7FFFFFFF
 };
 
@@ -133,6 +136,14 @@ enum VkProfilerPerformanceCounterStorageEXT
     VK_PROFILER_PERFORMANCE_COUNTER_STORAGE_MAX_ENUM_EXT = 0x7FFFFFFF
 };
 
+enum VkProfilerRollingStatisticsTypeEXT
+{
+    VK_PROFILER_ROLLING_STATISTICS_TYPE_PIPELINE_EXT,
+    VK_PROFILER_ROLLING_STATISTICS_TYPE_RENDER_PASS_EXT,
+    VK_PROFILER_ROLLING_STATISTICS_TYPE_DEBUG_LABEL_EXT,
+    VK_PROFILER_ROLLING_STATISTICS_TYPE_MAX_ENUM_EXT = 0x7FFFFFFF
+};
+
 typedef struct VkProfilerCreateInfoEXT
 {
     VkProfilerStructureTypeEXT sType;
@@ -220,6 +231,66 @@ typedef struct VkProfilerDataEXT
     VkProfilerRegionDataEXT frame;
 } VkProfilerDataEXT;
 
+typedef struct VkProfilerFlatRegionDataEXT
+{
+    VkProfilerRegionTypeEXT regionType;
+    VkProfilerRegionPropertiesEXT properties;
+    float duration;
+    float beginDuration;
+    float endDuration;
+    uint32_t parentIndex;
+    uint32_t firstSubregionIndex;
+    uint32_t subregionCount;
+} VkProfilerFlatRegionDataEXT;
+
+typedef struct VkProfilerFrameSummaryEXT
+{
+    uint64_t sequenceNumber;
+    float gpuDuration;
+    float cpuDuration;
+    float framesPerSec;
+    uint32_t submitCount;
+    uint32_t drawCount;
+    uint32_t dispatchCount;
+    uint64_t totalAllocationSize;
+    uint64_t totalAllocationCount;
+} VkProfilerFrameSummaryEXT;
+
+typedef struct VkProfilerRollingStatisticsEXT
+{
+    VkProfilerRollingStatisticsTypeEXT type;
+    uint64_t key;
+    VkProfilerRegionPropertiesEXT properties;
+    char debugLabelPath[ 256 ];
+    uint32_t sampleCount;
+    float minDuration;
+    float maxDuration;
+    float meanDuration;
+    float stdDevDuration;
+    float p50Duration;
+    float p95Duration;
+    float p99Duration;
+} VkProfilerRollingStatisticsEXT;
+
+typedef struct VkProfilerFrameCallbackDataEXT
+{
+    VkProfilerStructureTypeEXT sType;
+    const void* pNext;
+    VkProfilerFrameSummaryEXT summary;
+    uint32_t regionCount;
+    const VkProfilerFlatRegionDataEXT* pRegions;
+} VkProfilerFrameCallbackDataEXT;
+
+typedef void( VKAPI_PTR* PFN_vkProfilerFrameCallbackEXT )(VkDevice, const VkProfilerFrameCallbackDataEXT*, void*);
+
+typedef struct VkProfilerFrameCallbackCreateInfoEXT
+{
+    VkProfilerStructureTypeEXT sType;
+    const void* pNext;
+    PFN_vkProfilerFrameCallbackEXT pfnCallback;
+    void* pUserData;
+} VkProfilerFrameCallbackCreateInfoEXT;
+
 typedef struct VkProfilerPerformanceCounterPropertiesEXT
 {
     char shortName[ 64 ];
@@ -248,6 +319,12 @@ typedef VKAPI_ATTR VkResult( VKAPI_CALL* PFN_vkSetProfilerModeEXT )(VkDevice, Vk
 typedef VKAPI_ATTR VkResult( VKAPI_CALL* PFN_vkSetProfilerSyncModeEXT )(VkDevice, VkProfilerSyncModeEXT);
 typedef VKAPI_ATTR VkResult( VKAPI_CALL* PFN_vkGetProfilerFrameDataEXT )(VkDevice, VkProfilerDataEXT*);
 typedef VKAPI_ATTR void( VKAPI_CALL* PFN_vkFreeProfilerFrameDataEXT )(VkDevice, VkProfilerDataEXT*);
+typedef VKAPI_ATTR VkResult( VKAPI_CALL* PFN_vkGetProfilerFrameRegionsEXT )(VkDevice, uint32_t*, VkProfilerFlatRegionDataEXT*);
+typedef VKAPI_ATTR VkResult( VKAPI_CALL* PFN_vkGetProfilerFrameHistoryEXT )(VkDevice, uint64_t, uint32_t*, VkProfilerFrameSummaryEXT*, uint64_t*);
+typedef VKAPI_ATTR VkResult( VKAPI_CALL* PFN_vkGetProfilerRollingStatisticsEXT )(VkDevice, uint32_t*, VkProfilerRollingStatisticsEXT*);
+typedef VKAPI_ATTR VkResult( VKAPI_CALL* PFN_vkSetProfilerFrameCallbackEXT )(VkDevice, PFN_vkProfilerFrameCallbackEXT, void*);
+typedef VKAPI_ATTR void( VKAPI_CALL* PFN_vkBeginProfilerCpuRegionEXT )(VkDevice, const VkDebugUtilsLabelEXT*);
+typedef VKAPI_ATTR void( VKAPI_CALL* PFN_vkEndProfilerCpuRegionEXT )(VkDevice);
 typedef VKAPI_ATTR VkResult( VKAPI_CALL* PFN_vkFlushProfilerEXT )(VkDevice);
 typedef VKAPI_ATTR VkResult( VKAPI_CALL* PFN_vkEnumerateProfilerPerformanceMetricsSetsEXT )(VkDevice, uint32_t*, VkProfilerPerformanceMetricsSetPropertiesEXT*);
 typedef VKAPI_ATTR VkResult( VKAPI_CALL* PFN_vkEnumerateProfilerPerformanceCounterPropertiesEXT )(VkDevice, uint32_t, uint32_t*, VkProfilerPerformanceCounterPropertiesEXT*);
@@ -271,6 +348,35 @@ VKAPI_ATTR void VKAPI_CALL vkFreeProfilerFrameDataEXT(
     VkDevice device,
     VkProfilerDataEXT* pData );
 
+VKAPI_ATTR VkResult VKAPI_CALL vkGetProfilerFrameRegionsEXT(
+    VkDevice device,
+    uint32_t* pRegionCount,
+    VkProfilerFlatRegionDataEXT* pRegions );
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetProfilerFrameHistoryEXT(
+    VkDevice device,
+    uint64_t firstSequenceNumber,
+    uint32_t* pFrameCount,
+    VkProfilerFrameSummaryEXT* pFrames,
+    uint64_t* pDroppedFrameCount );
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetProfilerRollingStatisticsEXT(
+    VkDevice device,
+    uint32_t* pStatisticsCount,
+    VkProfilerRollingStatisticsEXT* pStatistics );
+
+VKAPI_ATTR VkResult VKAPI_CALL vkSetProfilerFrameCallbackEXT(
+    VkDevice device,
+    PFN_vkProfilerFrameCallbackEXT pfnCallback,
+    void* pUserData );
+
+VKAPI_ATTR void VKAPI_CALL vkBeginProfilerCpuRegionEXT(
+    VkDevice device,
+    const VkDebugUtilsLabelEXT* pLabelInfo );
+
+VKAPI_ATTR void VKAPI_CALL vkEndProfilerCpuRegionEXT(
+    VkDevice device );
+
 VKAPI_ATTR VkResult VKAPI_CALL vkFlushProfilerEXT(
     VkDevice device );
 
@@ -0,0 +1,104 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <stdint.h>
+
+/*
+    Layout of the shared-memory frame ring published by the profiling layer
+    when the shared_memory_ring_name option is set.
+
+    The memory object is created with shm_open (Linux) or CreateFileMapping
+    (Windows) with the configured name. It contains:
+
+        VkProfilerSharedMemoryRingHeader
+        slot[ 0 ] ... slot[ slotCount - 1 ]
+
+    Slot i begins at offset headerSize + i * slotSize and contains:
+
+        VkProfilerSharedMemoryRingSlotHeader
+        VkProfilerSharedMemoryFrame
+        VkProfilerSharedMemoryPipeline[ maxPipelineCount ]
+
+    The layer is the only writer. Frame N is written to slot N % slotCount.
+    writerProcessId is the id of the process publishing the frames. Readers
+    should stop when that process is no longer running, because a crashed
+    process never clears the magic.
+
+    Fields marked as atomic must be accessed with 64-bit atomic operations.
+    The header is valid once magic equals VK_PROFILER_SHARED_MEMORY_RING_MAGIC.
+    The magic is cleared when the layer stops publishing the frames.
+
+    Each slot is protected by a sequence lock. The writer increments sequence
+    to an odd value before writing the slot and to the next even value after
+    the slot is complete. To read the latest frame:
+
+        1. count = atomic_load_acquire( header->publishedFrameCount )
+           (no frames have been published if count is 0)
+        2. slot = slots[ (count - 1) % slotCount ]
+        3. s1 = atomic_load_acquire( slot->sequence ), retry if s1 is odd
+        4. copy the slot
+        5. acquire fence, s2 = atomic_load_relaxed( slot->sequence )
+        6. the copy is torn if s1 != s2, retry from step 1
+
+    Readers iterating over consecutive frames can compare frameIndex of the
+    copied slot with the expected index to detect frames overwritten before
+    they were read.
+*/
+
+#define VK_PROFILER_SHARED_MEMORY_RING_MAGIC 0x474E5250u /* 'PRNG' */
+#define VK_PROFILER_SHARED_MEMORY_RING_VERSION 1
+#define VK_PROFILER_SHARED_MEMORY_MAX_NAME_SIZE 56
+
+typedef struct VkProfilerSharedMemoryRingHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t slotSize;
+    uint32_t slotCount;
+    uint32_t maxPipelineCount;
+    uint64_t publishedFrameCount; /* atomic */
+    uint64_t writerProcessId;
+    uint64_t reserved[ 3 ];
+} VkProfilerSharedMemoryRingHeader;
+
+typedef struct VkProfilerSharedMemoryRingSlotHeader
+{
+    uint64_t sequence; /* atomic */
+    uint64_t frameIndex;
+} VkProfilerSharedMemoryRingSlotHeader;
+
+typedef struct VkProfilerSharedMemoryFrame
+{
+    float    cpuTimeMs;
+    float    gpuTimeMs;
+    float    framesPerSec;
+    uint32_t pipelineCount;
+    uint64_t memoryAllocationSize;
+    uint64_t memoryAllocationCount;
+} VkProfilerSharedMemoryFrame;
+
+typedef struct VkProfilerSharedMemoryPipeline
+{
+    uint32_t hash;
+    float    gpuTimeMs;
+    char     name[ VK_PROFILER_SHARED_MEMORY_MAX_NAME_SIZE ];
+} VkProfilerSharedMemoryPipeline;
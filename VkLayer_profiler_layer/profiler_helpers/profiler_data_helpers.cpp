@@ -79,7 +79,10 @@ namespace Profiler
 
         case DeviceProfilerDrawcallType::eInsertDebugLabel:
         case DeviceProfilerDrawcallType::eBeginDebugLabel:
-            return drawcall.m_Payload.m_DebugLabel.m_pName;
+        {
+            const char* pName = drawcall.m_Payload.m_DebugLabel.GetName();
+            return pName ? pName : "";
+        }
 
         case DeviceProfilerDrawcallType::eEndDebugLabel:
             return "";
@@ -252,7 +255,34 @@ namespace Profiler
     \***********************************************************************************/
     std::string DeviceProfilerStringSerializer::GetName( const DeviceProfilerPipelineData& pipeline ) const
     {
-        return GetName( pipeline.m_Handle );
+        std::string pipelineName;
+
+        if( GetCustomName( pipeline.m_Handle, pipelineName ) )
+        {
+            return pipelineName;
+        }
+
+        // Default pipeline name consists of the shader tuple hashes
+        switch( pipeline.m_BindPoint )
+        {
+        case VK_PIPELINE_BIND_POINT_GRAPHICS:
+            return fmt::format( "VS={:08X}, PS={:08X}",
+                pipeline.m_ShaderTuple.m_Stages[ VK_SHADER_STAGE_VERTEX_BIT ],
+                pipeline.m_ShaderTuple.m_Stages[ VK_SHADER_STAGE_FRAGMENT_BIT ] );
+
+        case VK_PIPELINE_BIND_POINT_COMPUTE:
+            return fmt::format( "CS={:08X}",
+                pipeline.m_ShaderTuple.m_Stages[ VK_SHADER_STAGE_COMPUTE_BIT ] );
+
+        case VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR:
+            return fmt::format( "RGEN={:08X}, aHIT={:08X}, cHIT={:08X}",
+                pipeline.m_ShaderTuple.m_Stages[ VK_SHADER_STAGE_RAYGEN_BIT_KHR ],
+                pipeline.m_ShaderTuple.m_Stages[ VK_SHADER_STAGE_ANY_HIT_BIT_KHR ],
+                pipeline.m_ShaderTuple.m_Stages[ VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR ] );
+
+        default:
+            return GetName( pipeline.m_Handle );
+        }
     }
 
     /***********************************************************************************\
@@ -362,7 +392,7 @@ namespace Profiler
     {
         std::string objectName;
 
-        if( m_Device.Debug.ObjectNames.find( object, &objectName ) )
+        if( GetCustomName( object, objectName ) )
         {
             return objectName;
         }
@@ -372,6 +402,34 @@ namespace Profiler
 
     /***********************************************************************************\
 
+    Function:
+        GetCustomName
+
+    Description:
+        Returns name of the Vulkan API object set by the application.
+        Default names are not stored, they are formatted on demand instead.
+
+    \***********************************************************************************/
+    bool DeviceProfilerStringSerializer::GetCustomName( const VkObject& object, std::string& name ) const
+    {
+        uint32_t objectNameId = ProfilerStringTable::InvalidId;
+
+        if( m_Device.Debug.ObjectNames.find( object, &objectNameId ) )
+        {
+            const char* pObjectName = ProfilerStringTable::Get().GetString( objectNameId );
+
+            if( pObjectName )
+            {
+                name = pObjectName;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /***********************************************************************************\
+
     Function:
         GetCommandName
 
@@ -67,5 +67,7 @@ namespace Profiler
 
     private:
         const struct VkDevice_Object& m_Device;
+
+        bool GetCustomName( const struct VkObject& object, std::string& name ) const;
     };
 }
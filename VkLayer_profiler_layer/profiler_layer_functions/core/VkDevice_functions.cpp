@@ -58,6 +58,14 @@ namespace Profiler
         GETPROCADDR( FreeCommandBuffers );
         GETPROCADDR( AllocateMemory );
         GETPROCADDR( FreeMemory );
+        GETPROCADDR( CreateBuffer );
+        GETPROCADDR( DestroyBuffer );
+        GETPROCADDR( CreateImage );
+        GETPROCADDR( DestroyImage );
+        GETPROCADDR( BindBufferMemory );
+        GETPROCADDR( BindImageMemory );
+        GETPROCADDR( BindBufferMemory2 );
+        GETPROCADDR( BindImageMemory2 );
 
         // VkCommandBuffer core functions
         GETPROCADDR( BeginCommandBuffer );
@@ -97,6 +105,10 @@ namespace Profiler
         // VkQueue core functions
         GETPROCADDR( QueueSubmit );
 
+        // VK_KHR_bind_memory2 functions
+        GETPROCADDR( BindBufferMemory2KHR );
+        GETPROCADDR( BindImageMemory2KHR );
+
         // VK_KHR_create_renderpass2 functions
         GETPROCADDR( CreateRenderPass2KHR );
         GETPROCADDR( CmdBeginRenderPass2KHR );
@@ -150,6 +162,12 @@ namespace Profiler
         GETPROCADDR_EXT( vkSetProfilerSyncModeEXT );
         GETPROCADDR_EXT( vkGetProfilerFrameDataEXT );
         GETPROCADDR_EXT( vkFreeProfilerFrameDataEXT );
+        GETPROCADDR_EXT( vkGetProfilerFrameRegionsEXT );
+        GETPROCADDR_EXT( vkGetProfilerFrameHistoryEXT );
+        GETPROCADDR_EXT( vkGetProfilerRollingStatisticsEXT );
+        GETPROCADDR_EXT( vkSetProfilerFrameCallbackEXT );
+        GETPROCADDR_EXT( vkBeginProfilerCpuRegionEXT );
+        GETPROCADDR_EXT( vkEndProfilerCpuRegionEXT );
         GETPROCADDR_EXT( vkFlushProfilerEXT );
 
         if( device )
@@ -560,4 +578,226 @@ namespace Profiler
         // Free the memory
         dd.Device.Callbacks.FreeMemory( device, memory, pAllocator );
     }
+
+    /***********************************************************************************\
+
+    Function:
+        CreateBuffer
+
+    Description:
+
+    \***********************************************************************************/
+    VKAPI_ATTR VkResult VKAPI_CALL VkDevice_Functions::CreateBuffer(
+        VkDevice device,
+        const VkBufferCreateInfo* pCreateInfo,
+        const VkAllocationCallbacks* pAllocator,
+        VkBuffer* pBuffer )
+    {
+        auto& dd = DeviceDispatch.Get( device );
+
+        // Create the buffer
+        VkResult result = dd.Device.Callbacks.CreateBuffer(
+            device, pCreateInfo, pAllocator, pBuffer );
+
+        if( result == VK_SUCCESS )
+        {
+            // Register buffer
+            dd.Profiler.CreateBuffer( *pBuffer, pCreateInfo );
+        }
+
+        return result;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        DestroyBuffer
+
+    Description:
+
+    \***********************************************************************************/
+    VKAPI_ATTR void VKAPI_CALL VkDevice_Functions::DestroyBuffer(
+        VkDevice device,
+        VkBuffer buffer,
+        const VkAllocationCallbacks* pAllocator )
+    {
+        auto& dd = DeviceDispatch.Get( device );
+
+        // Unregister buffer
+        dd.Profiler.DestroyBuffer( buffer );
+
+        // Destroy the buffer
+        dd.Device.Callbacks.DestroyBuffer( device, buffer, pAllocator );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        CreateImage
+
+    Description:
+
+    \***********************************************************************************/
+    VKAPI_ATTR VkResult VKAPI_CALL VkDevice_Functions::CreateImage(
+        VkDevice device,
+        const VkImageCreateInfo* pCreateInfo,
+        const VkAllocationCallbacks* pAllocator,
+        VkImage* pImage )
+    {
+        auto& dd = DeviceDispatch.Get( device );
+
+        // Create the image
+        VkResult result = dd.Device.Callbacks.CreateImage(
+            device, pCreateInfo, pAllocator, pImage );
+
+        if( result == VK_SUCCESS )
+        {
+            // Register image
+            dd.Profiler.CreateImage( *pImage, pCreateInfo );
+        }
+
+        return result;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        DestroyImage
+
+    Description:
+
+    \***********************************************************************************/
+    VKAPI_ATTR void VKAPI_CALL VkDevice_Functions::DestroyImage(
+        VkDevice device,
+        VkImage image,
+        const VkAllocationCallbacks* pAllocator )
+    {
+        auto& dd = DeviceDispatch.Get( device );
+
+        // Unregister image
+        dd.Profiler.DestroyImage( image );
+
+        // Destroy the image
+        dd.Device.Callbacks.DestroyImage( device, image, pAllocator );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        BindBufferMemory
+
+    Description:
+
+    \***********************************************************************************/
+    VKAPI_ATTR VkResult VKAPI_CALL VkDevice_Functions::BindBufferMemory(
+        VkDevice device,
+        VkBuffer buffer,
+        VkDeviceMemory memory,
+        VkDeviceSize memoryOffset )
+    {
+        auto& dd = DeviceDispatch.Get( device );
+
+        // Bind the memory
+        VkResult result = dd.Device.Callbacks.BindBufferMemory(
+            device, buffer, memory, memoryOffset );
+
+        if( result == VK_SUCCESS )
+        {
+            // Register binding
+            dd.Profiler.BindBufferMemory( buffer, memory, memoryOffset );
+        }
+
+        return result;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        BindImageMemory
+
+    Description:
+
+    \***********************************************************************************/
+    VKAPI_ATTR VkResult VKAPI_CALL VkDevice_Functions::BindImageMemory(
+        VkDevice device,
+        VkImage image,
+        VkDeviceMemory memory,
+        VkDeviceSize memoryOffset )
+    {
+        auto& dd = DeviceDispatch.Get( device );
+
+        // Bind the memory
+        VkResult result = dd.Device.Callbacks.BindImageMemory(
+            device, image, memory, memoryOffset );
+
+        if( result == VK_SUCCESS )
+        {
+            // Register binding
+            dd.Profiler.BindImageMemory( image, memory, memoryOffset );
+        }
+
+        return result;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        BindBufferMemory2
+
+    Description:
+
+    \***********************************************************************************/
+    VKAPI_ATTR VkResult VKAPI_CALL VkDevice_Functions::BindBufferMemory2(
+        VkDevice device,
+        uint32_t bindInfoCount,
+        const VkBindBufferMemoryInfo* pBindInfos )
+    {
+        auto& dd = DeviceDispatch.Get( device );
+
+        // Bind the memory
+        VkResult result = dd.Device.Callbacks.BindBufferMemory2(
+            device, bindInfoCount, pBindInfos );
+
+        if( result == VK_SUCCESS )
+        {
+            // Register bindings
+            for( uint32_t i = 0; i < bindInfoCount; ++i )
+            {
+                dd.Profiler.BindBufferMemory( pBindInfos[ i ].buffer, pBindInfos[ i ].memory, pBindInfos[ i ].memoryOffset );
+            }
+        }
+
+        return result;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        BindImageMemory2
+
+    Description:
+
+    \***********************************************************************************/
+    VKAPI_ATTR VkResult VKAPI_CALL VkDevice_Functions::BindImageMemory2(
+        VkDevice device,
+        uint32_t bindInfoCount,
+        const VkBindImageMemoryInfo* pBindInfos )
+    {
+        auto& dd = DeviceDispatch.Get( device );
+
+        // Bind the memory
+        VkResult result = dd.Device.Callbacks.BindImageMemory2(
+            device, bindInfoCount, pBindInfos );
+
+        if( result == VK_SUCCESS )
+        {
+            // Register bindings
+            for( uint32_t i = 0; i < bindInfoCount; ++i )
+            {
+                dd.Profiler.BindImageMemory( pBindInfos[ i ].image, pBindInfos[ i ].memory, pBindInfos[ i ].memoryOffset );
+            }
+        }
+
+        return result;
+    }
 }
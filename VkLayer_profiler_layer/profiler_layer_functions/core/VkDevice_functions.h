@@ -22,6 +22,7 @@
 #include "VkCommandBuffer_functions.h"
 #include "VkQueue_functions.h"
 #include "VkAccelerationStructureKhr_functions.h"
+#include "VkBindMemory2Khr_functions.h"
 #include "VkCreateRenderPass2Khr_functions.h"
 #include "VkDebugMarkerExt_functions.h"
 #include "VkDebugUtilsExt_functions.h"
@@ -46,6 +47,7 @@ namespace Profiler
         : VkCommandBuffer_Functions
         , VkQueue_Functions
         , VkAccelerationStructureKhr_Functions
+        , VkBindMemory2Khr_Functions
         , VkCreateRenderPass2Khr_Functions
         , VkDebugMarkerExt_Functions
         , VkDebugUtilsExt_Functions
@@ -160,5 +162,57 @@ namespace Profiler
             VkDevice device,
             VkDeviceMemory memory,
             const VkAllocationCallbacks* pAllocator );
+
+        // vkCreateBuffer
+        static VKAPI_ATTR VkResult VKAPI_CALL CreateBuffer(
+            VkDevice device,
+            const VkBufferCreateInfo* pCreateInfo,
+            const VkAllocationCallbacks* pAllocator,
+            VkBuffer* pBuffer );
+
+        // vkDestroyBuffer
+        static VKAPI_ATTR void VKAPI_CALL DestroyBuffer(
+            VkDevice device,
+            VkBuffer buffer,
+            const VkAllocationCallbacks* pAllocator );
+
+        // vkCreateImage
+        static VKAPI_ATTR VkResult VKAPI_CALL CreateImage(
+            VkDevice device,
+            const VkImageCreateInfo* pCreateInfo,
+            const VkAllocationCallbacks* pAllocator,
+            VkImage* pImage );
+
+        // vkDestroyImage
+        static VKAPI_ATTR void VKAPI_CALL DestroyImage(
+            VkDevice device,
+            VkImage image,
+            const VkAllocationCallbacks* pAllocator );
+
+        // vkBindBufferMemory
+        static VKAPI_ATTR VkResult VKAPI_CALL BindBufferMemory(
+            VkDevice device,
+            VkBuffer buffer,
+            VkDeviceMemory memory,
+            VkDeviceSize memoryOffset );
+
+        // vkBindImageMemory
+        static VKAPI_ATTR VkResult VKAPI_CALL BindImageMemory(
+            VkDevice device,
+            VkImage image,
+            VkDeviceMemory memory,
+            VkDeviceSize memoryOffset );
+
+        // vkBindBufferMemory2
+        static VKAPI_ATTR VkResult VKAPI_CALL BindBufferMemory2(
+            VkDevice device,
+            uint32_t bindInfoCount,
+            const VkBindBufferMemoryInfo* pBindInfos );
+
+        // vkBindImageMemory2
+        static VKAPI_ATTR VkResult VKAPI_CALL BindImageMemory2(
+            VkDevice device,
+            uint32_t bindInfoCount,
+            const VkBindImageMemoryInfo* pBindInfos );
     };
 }
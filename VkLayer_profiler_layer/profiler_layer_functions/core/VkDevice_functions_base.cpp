@@ -106,6 +106,80 @@ namespace Profiler
         // Initialize the profiler object
         VkResult result = dd.Profiler.Initialize( &dd.Device, pProfilerCreateInfo );
 
+        if( (result == VK_SUCCESS) &&
+            ((!dd.Profiler.m_Config.m_PipelineStatisticsFile.empty()) ||
+             (!dd.Profiler.m_Config.m_StatisticsDumpFile.empty()) ||
+             (dd.Profiler.m_Config.m_StreamServerPort != 0) ||
+             (!dd.Profiler.m_Config.m_SharedMemoryRingName.empty())) )
+        {
+            dd.pStringSerializer = std::make_unique<DeviceProfilerStringSerializer>( dd.Device );
+        }
+
+        if( (result == VK_SUCCESS) &&
+            (!dd.Profiler.m_Config.m_PipelineStatisticsFile.empty()) )
+        {
+            // Export pipeline statistics
+            dd.pCsvSerializer = std::make_unique<DeviceProfilerCsvSerializer>(
+                dd.pStringSerializer.get(),
+                Nanoseconds( dd.Device.pPhysicalDevice->Properties.limits.timestampPeriod ) );
+
+            if( !dd.pCsvSerializer->Open( dd.Profiler.m_Config.m_PipelineStatisticsFile ) )
+            {
+                // Continue without the statistics
+                dd.pCsvSerializer.reset();
+            }
+        }
+
+        if( (result == VK_SUCCESS) &&
+            (!dd.Profiler.m_Config.m_StatisticsDumpFile.empty()) )
+        {
+            // Periodically dump aggregated statistics (headless mode)
+            dd.pStatisticsWriter = std::make_unique<DeviceProfilerStatisticsWriter>(
+                dd.pStringSerializer.get(),
+                Nanoseconds( dd.Device.pPhysicalDevice->Properties.limits.timestampPeriod ) );
+
+            if( !dd.pStatisticsWriter->Open(
+                    dd.Profiler.m_Config.m_StatisticsDumpFile,
+                    dd.Profiler.m_Config.m_StatisticsDumpFrameInterval,
+                    Milliseconds( static_cast<float>( dd.Profiler.m_Config.m_StatisticsDumpTimeInterval ) ) ) )
+            {
+                // Continue without the statistics
+                dd.pStatisticsWriter.reset();
+            }
+        }
+
+        if( (result == VK_SUCCESS) &&
+            (dd.Profiler.m_Config.m_StreamServerPort != 0) )
+        {
+            // Stream the data to external viewers
+            dd.pStreamServer = std::make_unique<DeviceProfilerStreamServer>(
+                dd.pStringSerializer.get(),
+                Nanoseconds( dd.Device.pPhysicalDevice->Properties.limits.timestampPeriod ) );
+
+            if( !dd.pStreamServer->Start( static_cast<uint16_t>( dd.Profiler.m_Config.m_StreamServerPort ) ) )
+            {
+                // Continue without the server
+                dd.pStreamServer.reset();
+            }
+        }
+
+        if( (result == VK_SUCCESS) &&
+            (!dd.Profiler.m_Config.m_SharedMemoryRingName.empty()) )
+        {
+            // Publish the data in the shared memory
+            dd.pSharedMemoryRing = std::make_unique<DeviceProfilerSharedMemoryRing>(
+                dd.pStringSerializer.get(),
+                Nanoseconds( dd.Device.pPhysicalDevice->Properties.limits.timestampPeriod ) );
+
+            if( !dd.pSharedMemoryRing->Create(
+                    dd.Profiler.m_Config.m_SharedMemoryRingName,
+                    dd.Profiler.m_Config.m_SharedMemoryRingSlotCount ) )
+            {
+                // Continue without the shared memory
+                dd.pSharedMemoryRing.reset();
+            }
+        }
+
         if( result != VK_SUCCESS )
         {
             // Profiler initialization failed
@@ -133,6 +207,49 @@ namespace Profiler
         // Destroy the overlay
         dd.Overlay.Destroy();
 
+        // Flush the exported data
+        dd.pCsvSerializer.reset();
+        dd.pStatisticsWriter.reset();
+        dd.pStreamServer.reset();
+        dd.pSharedMemoryRing.reset();
+        dd.pStringSerializer.reset();
+
         DeviceDispatch.Erase( device );
     }
+
+    /***********************************************************************************\
+
+    Function:
+        FinishFrameBase
+
+    Description:
+        Collects data of the current frame and passes it to the enabled outputs.
+
+    \***********************************************************************************/
+    void VkDevice_Functions_Base::FinishFrameBase( Dispatch& dd )
+    {
+        // The data is not copied, the outputs keep only the parts they need
+        dd.Profiler.FinishFrame( [&dd]( const DeviceProfilerFrameData& data )
+            {
+                if( dd.pCsvSerializer )
+                {
+                    dd.pCsvSerializer->AppendFrame( data );
+                }
+
+                if( dd.pStatisticsWriter )
+                {
+                    dd.pStatisticsWriter->AppendFrame( data );
+                }
+
+                if( dd.pStreamServer )
+                {
+                    dd.pStreamServer->AppendFrame( data );
+                }
+
+                if( dd.pSharedMemoryRing )
+                {
+                    dd.pSharedMemoryRing->AppendFrame( data );
+                }
+            } );
+    }
 }
@@ -21,6 +21,11 @@
 #pragma once
 #include "profiler/profiler.h"
 #include "profiler_overlay/profiler_overlay.h"
+#include "profiler_helpers/profiler_data_helpers.h"
+#include "profiler_trace/profiler_csv.h"
+#include "profiler_trace/profiler_shared_memory.h"
+#include "profiler_trace/profiler_statistics.h"
+#include "profiler_trace/profiler_stream_server.h"
 #include "profiler_layer_objects/VkDevice_object.h"
 #include "profiler_layer_functions/Dispatch.h"
 #include <vulkan/vk_layer.h>
@@ -48,6 +53,13 @@ namespace Profiler
             DeviceProfiler Profiler;
 
             ProfilerOverlayOutput Overlay;
+
+            // Outputs used when no overlay is available
+            std::unique_ptr<DeviceProfilerStringSerializer> pStringSerializer;
+            std::unique_ptr<DeviceProfilerCsvSerializer> pCsvSerializer;
+            std::unique_ptr<DeviceProfilerStatisticsWriter> pStatisticsWriter;
+            std::unique_ptr<DeviceProfilerStreamServer> pStreamServer;
+            std::unique_ptr<DeviceProfilerSharedMemoryRing> pSharedMemoryRing;
         };
 
         static DispatchableMap<Dispatch> DeviceDispatch;
@@ -64,5 +76,9 @@ namespace Profiler
         // Invoked on vkDestroyDevice
         static void DestroyDeviceBase( 
             VkDevice device );
+
+        // Invoked on vkQueuePresentKHR and vkFlushProfilerEXT
+        static void FinishFrameBase(
+            Dispatch& dd );
     };
 }
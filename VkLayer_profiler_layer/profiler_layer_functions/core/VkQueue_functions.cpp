@@ -40,11 +40,27 @@ namespace Profiler
 
         const VkSubmitInfo* pOriginalSubmits = pSubmits;
 
+        // Prevent the command buffers from being freed before the profiler registers the submit
+        // Submits to different queues don't block each other unless the optimization is disabled
+        #if PROFILER_DISABLE_CRITICAL_SECTION_OPTIMIZATION
+        std::unique_lock lk( dd.Profiler.m_SubmitMutex );
+        #else
+        std::shared_lock lk( dd.Profiler.m_SubmitMutex );
+        #endif
+
         dd.Profiler.PreSubmitCommandBuffers( queue, submitCount, pSubmits, fence );
 
         // Submit the command buffers
         VkResult result = dd.Device.Callbacks.QueueSubmit( queue, submitCount, pSubmits, fence );
 
+        // Wait for the submitted command buffers to execute without blocking the other threads
+        if( dd.Profiler.m_Config.m_SyncMode == VK_PROFILER_SYNC_MODE_SUBMIT_EXT )
+        {
+            lk.unlock();
+            dd.Profiler.WaitForSubmittedCommandBuffers( queue );
+            lk.lock();
+        }
+
         dd.Profiler.PostSubmitCommandBuffers( queue, submitCount, pSubmits, fence );
 
         // Profiler allocated new pSubmits, release it
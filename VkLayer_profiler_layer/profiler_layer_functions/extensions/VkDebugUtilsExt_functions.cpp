@@ -101,7 +101,7 @@ namespace Profiler
         // Setup debug label drawcall
         DeviceProfilerDrawcall drawcall;
         drawcall.m_Type = DeviceProfilerDrawcallType::eInsertDebugLabel;
-        drawcall.m_Payload.m_DebugLabel.m_pName = ProfilerStringFunctions::DuplicateString( pLabelInfo->pLabelName );
+        drawcall.m_Payload.m_DebugLabel.m_NameId = ProfilerStringTable::Get().Intern( pLabelInfo->pLabelName );
         drawcall.m_Payload.m_DebugLabel.m_Color[ 0 ] = pLabelInfo->color[ 0 ];
         drawcall.m_Payload.m_DebugLabel.m_Color[ 1 ] = pLabelInfo->color[ 1 ];
         drawcall.m_Payload.m_DebugLabel.m_Color[ 2 ] = pLabelInfo->color[ 2 ];
@@ -136,7 +136,7 @@ namespace Profiler
         // Setup debug label drawcall
         DeviceProfilerDrawcall drawcall;
         drawcall.m_Type = DeviceProfilerDrawcallType::eBeginDebugLabel;
-        drawcall.m_Payload.m_DebugLabel.m_pName = ProfilerStringFunctions::DuplicateString( pLabelInfo->pLabelName );
+        drawcall.m_Payload.m_DebugLabel.m_NameId = ProfilerStringTable::Get().Intern( pLabelInfo->pLabelName );
         drawcall.m_Payload.m_DebugLabel.m_Color[ 0 ] = pLabelInfo->color[ 0 ];
         drawcall.m_Payload.m_DebugLabel.m_Color[ 1 ] = pLabelInfo->color[ 1 ];
         drawcall.m_Payload.m_DebugLabel.m_Color[ 2 ] = pLabelInfo->color[ 2 ];
@@ -170,7 +170,7 @@ namespace Profiler
         // Setup debug label drawcall
         DeviceProfilerDrawcall drawcall;
         drawcall.m_Type = DeviceProfilerDrawcallType::eEndDebugLabel;
-        drawcall.m_Payload.m_DebugLabel.m_pName = nullptr;
+        drawcall.m_Payload.m_DebugLabel.m_NameId = ProfilerStringTable::InvalidId;
 
         profiledCommandBuffer.PreCommand( drawcall );
 
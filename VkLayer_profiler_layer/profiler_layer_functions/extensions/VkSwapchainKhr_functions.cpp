@@ -99,10 +99,23 @@ namespace Profiler
                     // Initialize overlay for the first time
                     result = dd.Overlay.Initialize(
                         dd.Device,
+                        dd.Profiler,
                         dd.Device.Queues.at( graphicsQueue ),
                         dd.Device.Swapchains.at( *pSwapchain ),
                         pCreateInfo );
                 }
+
+                if( result == VK_SUCCESS )
+                {
+                    dd.Overlay.SetUpdateRate( dd.Profiler.m_Config.m_OverlayUpdateRate );
+                }
+
+                if( (result == VK_SUCCESS) &&
+                    (dd.Profiler.m_Config.m_TraceCaptureFrameCount > 0) )
+                {
+                    // Capture first frames requested in the configuration
+                    dd.Overlay.BeginTraceCapture( dd.Profiler.m_Config.m_TraceCaptureFrameCount );
+                }
             }
             else
             {
@@ -164,7 +177,7 @@ namespace Profiler
         // Get present queue wrapper
         VkQueue_Object& presentQueue = dd.Device.Queues[ queue ];
 
-        dd.Profiler.FinishFrame();
+        FinishFrameBase( dd );
 
         if( (dd.Overlay.IsAvailable()) &&
             (dd.Overlay.GetSwapchain() == presentInfo.pSwapchains[ 0 ]) )
@@ -34,7 +34,8 @@ namespace Profiler
 {
     struct VkDevice_debug_Object
     {
-        ConcurrentMap<VkObject, std::string> ObjectNames;
+        // Ids of the names in ProfilerStringTable
+        ConcurrentMap<VkObject, uint32_t> ObjectNames;
     };
 
     struct VkDevice_Object
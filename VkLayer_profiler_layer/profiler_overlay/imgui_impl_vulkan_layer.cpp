@@ -309,7 +309,7 @@ void ImGui_ImplVulkan_Context::SetupRenderState( ImDrawData* draw_data, VkComman
 
 // Render function
 // (this used to be set in io.RenderDrawListsFn and called by ImGui::Render(), but you can now call this directly from your main loop)
-void ImGui_ImplVulkan_Context::RenderDrawData( ImDrawData* draw_data, VkCommandBuffer command_buffer )
+void ImGui_ImplVulkan_Context::RenderDrawData( ImDrawData* draw_data, VkCommandBuffer command_buffer, uint32_t frame_index )
 {
     // Avoid rendering when minimized, scale coordinates for retina displays (screen coordinates != framebuffer coordinates)
     int fb_width = (int)(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
@@ -329,7 +329,9 @@ void ImGui_ImplVulkan_Context::RenderDrawData( ImDrawData* draw_data, VkCommandB
         memset( wrb->FrameRenderBuffers, 0, sizeof( ImGui_ImplVulkanH_FrameRenderBuffers ) * wrb->Count );
     }
     IM_ASSERT( wrb->Count == v->ImageCount );
-    wrb->Index = (wrb->Index + 1) % wrb->Count;
+    // Each swapchain image uses its own buffers, so that the command buffer recorded for the image
+    // can be resubmitted until the image is recorded again.
+    wrb->Index = frame_index % wrb->Count;
     ImGui_ImplVulkanH_FrameRenderBuffers* rb = &wrb->FrameRenderBuffers[ wrb->Index ];
 
     VkResult err;
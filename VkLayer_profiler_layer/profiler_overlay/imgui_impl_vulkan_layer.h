@@ -52,7 +52,7 @@ public:
     ~ImGui_ImplVulkan_Context();
 
     void NewFrame();
-    void RenderDrawData( ImDrawData* draw_data, VkCommandBuffer command_buffer );
+    void RenderDrawData( ImDrawData* draw_data, VkCommandBuffer command_buffer, uint32_t frame_index );
     bool CreateFontsTexture( VkCommandBuffer command_buffer );
     void DestroyFontUploadObjects();
     void SetMinImageCount( uint32_t min_image_count );
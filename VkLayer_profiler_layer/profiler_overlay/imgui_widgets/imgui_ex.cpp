@@ -178,4 +178,78 @@ namespace ImGuiX
 
         return selectionChanged;
     }
-}
\ No newline at end of file
+
+    /*************************************************************************\
+
+    Function:
+        ZoomAndPan
+
+    Description:
+        Zoom the visible range of the last item with the mouse wheel and pan
+        it by dragging with the right mouse button. The mouse position is
+        mapped to the range using the plot rect, which may be smaller than
+        the item rect if the item has a label or padding.
+
+    \*************************************************************************/
+    bool ZoomAndPan( const ImVec2& plot_min, const ImVec2& plot_max, ImVec2* view_range, float min_view_size )
+    {
+        ImGuiContext& g = *GImGui;
+        ImGuiWindow* window = ImGui::GetCurrentWindow();
+
+        const ImGuiID id = g.LastItemData.ID;
+        const ImRect bb( plot_min, plot_max );
+        const ImVec2 prev_view_range = *view_range;
+
+        float view_size = view_range->y - view_range->x;
+
+        if( bb.GetWidth() <= 0.0f )
+            return false;
+
+        if( ImGui::IsItemHovered() && bb.Contains( g.IO.MousePos ) )
+        {
+            // Don't scroll the parent window while zooming
+            ImGui::SetItemKeyOwner( ImGuiKey_MouseWheelY );
+
+            if( g.IO.MouseWheel != 0.0f )
+            {
+                // Keep the point under the mouse cursor in place
+                const float mouse_t = ImSaturate( (g.IO.MousePos.x - bb.Min.x) / bb.GetWidth() );
+                const float pivot = view_range->x + (mouse_t * view_size);
+                const float zoom = (g.IO.MouseWheel > 0.0f) ? 0.8f : 1.25f;
+
+                view_size = ImClamp( view_size * zoom, min_view_size, 1.0f );
+                view_range->x = pivot - (mouse_t * view_size);
+                view_range->y = view_range->x + view_size;
+            }
+
+            if( ImGui::IsMouseClicked( ImGuiMouseButton_Right ) )
+                ImGui::SetActiveID( id, window );
+        }
+
+        if( (id != 0) && (g.ActiveId == id) )
+        {
+            if( ImGui::IsMouseDown( ImGuiMouseButton_Right ) )
+            {
+                const float delta = -(g.IO.MouseDelta.x / bb.GetWidth()) * view_size;
+                view_range->x += delta;
+                view_range->y += delta;
+            }
+            else
+                ImGui::ClearActiveID();
+        }
+
+        // Don't move the view outside of the item
+        if( view_range->x < 0.0f )
+        {
+            view_range->x = 0.0f;
+            view_range->y = view_size;
+        }
+        if( view_range->y > 1.0f )
+        {
+            view_range->x = 1.0f - view_size;
+            view_range->y = 1.0f;
+        }
+
+        return (prev_view_range.x != view_range->x) || (prev_view_range.y != view_range->y);
+    }
+}
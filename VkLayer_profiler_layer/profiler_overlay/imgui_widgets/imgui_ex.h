@@ -91,6 +91,20 @@ namespace ImGuiX
 
     /*************************************************************************\
 
+    Function:
+        ZoomAndPan
+
+    Description:
+        Zoom the visible range of the last item with the mouse wheel and pan
+        it by dragging with the right mouse button. The range is normalized
+        to 0-1 and spans the plot rect (plot_min-plot_max) of the item.
+        Returns true if the range has changed.
+
+    \*************************************************************************/
+    bool ZoomAndPan( const ImVec2& plot_min, const ImVec2& plot_max, ImVec2* view_range, float min_view_size = 1.0f / 65536.0f );
+
+    /*************************************************************************\
+
     Function:
         TSelectable
 
@@ -22,6 +22,7 @@
 #define IMGUI_DEFINE_MATH_OPERATORS
 
 #include "imgui_histogram_ex.h"
+#include "imgui_ex.h"
 #include <imgui_internal.h>
 #include <algorithm>
 
@@ -107,7 +108,8 @@ namespace ImGuiX
         float scale_max,
         ImVec2 graph_size,
         std::function<HistogramColumnHoverCallback> hover_cb,
-        std::function<HistogramColumnClickCallback> click_cb )
+        std::function<HistogramColumnClickCallback> click_cb,
+        ImVec2* view_range )
     {
         // Implementation is based on ImGui::PlotEx function (which is called by PlotHistogram).
 
@@ -129,13 +131,17 @@ namespace ImGuiX
         const ImRect inner_bb( frame_bb.Min + style.FramePadding, frame_bb.Max - style.FramePadding );
         const ImRect total_bb( frame_bb.Min, frame_bb.Max + ImVec2( label_size.x > 0.0f ? style.ItemInnerSpacing.x + label_size.x : 0.0f, 0 ) );
         ItemSize( total_bb, style.FramePadding.y );
-        if( !ItemAdd( total_bb, 0, &frame_bb ) )
+        if( !ItemAdd( total_bb, id, &frame_bb ) )
             return;
 
         const bool hovered =
             ItemHoverable( frame_bb, id, 0 ) &&
             inner_bb.Contains( g.IO.MousePos );
 
+        // Zoom and pan the visible range
+        if( view_range )
+            ZoomAndPan( inner_bb.Min, inner_bb.Max, view_range );
+
         // Determine scale from values if not specified
         if( scale_min == FLT_MAX || scale_max == FLT_MAX )
         {
@@ -69,6 +69,10 @@ namespace ImGuiX
         scale_max      Maximal value of the y axis
         graph_size     Size of the histogram
         stride         Element stride
+        view_range     Visible range of the x axis, normalized to 0-1 (optional)
+                       If set, the range can be zoomed with the mouse wheel and
+                       panned by dragging with the right mouse button.
+                       The caller should pass only the columns within the range.
 
     \*************************************************************************/
     void PlotHistogramEx(
@@ -82,5 +86,6 @@ namespace ImGuiX
         float scale_max = FLT_MAX,
         ImVec2 graph_size = ImVec2( 0, 0 ),
         std::function<HistogramColumnHoverCallback> hover_cb = NULL,
-        std::function<HistogramColumnClickCallback> click_cb = NULL );
+        std::function<HistogramColumnClickCallback> click_cb = NULL,
+        ImVec2* view_range = NULL );
 }
@@ -31,10 +31,14 @@ namespace Profiler
         inline static constexpr char Instance[] = "Instance";
         inline static constexpr char Pause[] = "Pause";
         inline static constexpr char Save[] = "Save trace";
+        inline static constexpr char StartCapture[] = "Start capture";
+        inline static constexpr char StopCapture[] = "Stop capture";
+        inline static constexpr char CapturedFramesFmt[] = "Captured frames: %u";
 
         // Tabs
         inline static constexpr char Performance[] = "Performance";
         inline static constexpr char Memory[] = "Memory";
+        inline static constexpr char Timeline[] = "Timeline";
         inline static constexpr char Statistics[] = "Statistics";
         inline static constexpr char Settings[] = "Settings";
 
@@ -47,7 +51,23 @@ namespace Profiler
         inline static constexpr char Drawcalls[] = "Drawcalls";
         inline static constexpr char HistogramGroups[] = "Histogram groups";
         inline static constexpr char GPUCycles[] = "GPU Cycles";
+        inline static constexpr char ResetZoom[] = "Reset zoom";
+        inline static constexpr char MergedColumnsFmt[] = "%u merged columns";
         inline static constexpr char TopPipelines[] = "Top pipelines";
+        inline static constexpr char WatchList[] = "Watch list";
+        inline static constexpr char WatchListEmpty[] = "Pin pipelines in the top pipelines list to watch them over time";
+        inline static constexpr char WatchPipeline[] = "Watch pipeline";
+        inline static constexpr char RollingStatistics[] = "GPU time of last frames";
+        inline static constexpr char DebugLabels[] = "Debug labels";
+        inline static constexpr char Name[] = "Name";
+        inline static constexpr char Frames[] = "Frames";
+        inline static constexpr char Min[] = "Min";
+        inline static constexpr char Mean[] = "Mean";
+        inline static constexpr char Max[] = "Max";
+        inline static constexpr char Inclusive[] = "Inclusive";
+        inline static constexpr char Exclusive[] = "Exclusive";
+        inline static constexpr char CpuRegions[] = "CPU regions";
+        inline static constexpr char Thread[] = "Thread";
         inline static constexpr char PerformanceCounters[] = "Performance counters";
         inline static constexpr char Metric[] = "Metric";
         inline static constexpr char Frame[] = "Frame";
@@ -61,11 +81,31 @@ namespace Profiler
 
         inline static constexpr char ShaderCapabilityTooltipFmt[] = "At least one shader in the pipeline uses '%s' capability.";
 
+        // Timeline tab
+        inline static constexpr char CPU[] = "CPU";
+        inline static constexpr char MergedBlocksFmt[] = "%u merged blocks";
+
         // Memory tab
         inline static constexpr char MemoryHeapUsage[] = "Memory heap usage";
         inline static constexpr char MemoryHeap[] = "Heap";
         inline static constexpr char Allocations[] = "Allocations";
         inline static constexpr char MemoryTypeIndex[] = "Memory type index";
+        inline static constexpr char AllocationChurn[] = "Allocations in last frames";
+        inline static constexpr char Frees[] = "Frees";
+        inline static constexpr char BurstsFmt[] = "%u bursts";
+        inline static constexpr char LargestResources[] = "Largest resources";
+        inline static constexpr char FragmentedAllocations[] = "Fragmented allocations";
+        inline static constexpr char Format[] = "Format";
+        inline static constexpr char Size[] = "Size";
+        inline static constexpr char Usage[] = "Usage";
+        inline static constexpr char Binding[] = "Binding";
+        inline static constexpr char Aliased[] = "Aliased";
+        inline static constexpr char NotBound[] = "Not bound";
+        inline static constexpr char Resources[] = "Resources";
+        inline static constexpr char Occupancy[] = "Occupancy";
+        inline static constexpr char FreeRanges[] = "Free ranges";
+        inline static constexpr char LargestFreeRange[] = "Largest free range";
+        inline static constexpr char Fragmentation[] = "Fragmentation";
 
         // Statistics tab
         inline static constexpr char DrawCalls[] = "Draw calls";
@@ -93,6 +133,10 @@ namespace Profiler
         inline static constexpr char ShowDebugLabels[] = "Show debug labels";
         inline static constexpr char ShowShaderCapabilities[] = "Show shader capabilities";
         inline static constexpr char TimeUnit[] = "Time unit";
+        inline static constexpr char UpdateRate[] = "Update rate (Hz)";
+        inline static constexpr char TraceFormat[] = "Trace format";
+        inline static constexpr char TraceFormatJson[] = "Chrome JSON";
+        inline static constexpr char TraceFormatPerfetto[] = "Perfetto";
 
         inline static constexpr char Milliseconds[] = "ms";
         inline static constexpr char Microseconds[] = "us";
@@ -31,10 +31,14 @@ namespace Profiler
         inline static constexpr char Instance[] = u8"Instancja";
         inline static constexpr char Pause[] = u8"Wstrzymaj";
         inline static constexpr char Save[] = u8"Zapisz dane";
+        inline static constexpr char StartCapture[] = u8"Rozpocznij nagrywanie";
+        inline static constexpr char StopCapture[] = u8"Zakończ nagrywanie";
+        inline static constexpr char CapturedFramesFmt[] = u8"Nagrane klatki: %u";
 
         // Tabs
         inline static constexpr char Performance[] = u8"Wydajność";
         inline static constexpr char Memory[] = u8"Pamięć";
+        inline static constexpr char Timeline[] = u8"Oś czasu";
         inline static constexpr char Statistics[] = u8"Statystyki";
         inline static constexpr char Settings[] = u8"Ustawienia";
 
@@ -46,7 +50,23 @@ namespace Profiler
         inline static constexpr char Drawcalls[] = u8"Komendy";
         inline static constexpr char HistogramGroups[] = u8"Grupowanie histogramu";
         inline static constexpr char GPUCycles[] = u8"Cykle GPU";
+        inline static constexpr char ResetZoom[] = u8"Resetuj powiększenie";
+        inline static constexpr char MergedColumnsFmt[] = u8"Połączone kolumny: %u";
         inline static constexpr char TopPipelines[] = u8"Najdłuższe stany potoku";
+        inline static constexpr char WatchList[] = u8"Obserwowane stany potoku";
+        inline static constexpr char WatchListEmpty[] = u8"Przypnij stany potoku z listy najdłuższych, aby obserwować je w czasie";
+        inline static constexpr char WatchPipeline[] = u8"Obserwuj stan potoku";
+        inline static constexpr char RollingStatistics[] = u8"Czas GPU ostatnich ramek";
+        inline static constexpr char DebugLabels[] = u8"Etykiety debugowania";
+        inline static constexpr char Name[] = u8"Nazwa";
+        inline static constexpr char Frames[] = u8"Ramki";
+        inline static constexpr char Min[] = u8"Min.";
+        inline static constexpr char Mean[] = u8"Średnia";
+        inline static constexpr char Max[] = u8"Maks.";
+        inline static constexpr char Inclusive[] = u8"Łącznie";
+        inline static constexpr char Exclusive[] = u8"Własny";
+        inline static constexpr char CpuRegions[] = u8"Regiony CPU";
+        inline static constexpr char Thread[] = u8"Wątek";
         inline static constexpr char PerformanceCounters[] = u8"Liczniki wydajności";
         inline static constexpr char Metric[] = u8"Metryka";
         inline static constexpr char Frame[] = u8"Ramka";
@@ -60,11 +80,30 @@ namespace Profiler
 
         inline static constexpr char ShaderCapabilityTooltipFmt[] = u8"Co najmniej jeden shader w potoku korzysta z funkcjonalności '%s'.";
 
+        // Timeline tab
+        inline static constexpr char MergedBlocksFmt[] = u8"Połączone bloki: %u";
+
         // Memory tab
         inline static constexpr char MemoryHeapUsage[] = u8"Wykorzystanie stert pamięci";
         inline static constexpr char MemoryHeap[] = u8"Sterta";
         inline static constexpr char Allocations[] = u8"Alokacje";
         inline static constexpr char MemoryTypeIndex[] = u8"Indeks typu pamięci";
+        inline static constexpr char AllocationChurn[] = u8"Alokacje w ostatnich ramkach";
+        inline static constexpr char Frees[] = u8"Zwolnienia";
+        inline static constexpr char BurstsFmt[] = u8"Skoki alokacji: %u";
+        inline static constexpr char LargestResources[] = u8"Największe zasoby";
+        inline static constexpr char FragmentedAllocations[] = u8"Pofragmentowane alokacje";
+        inline static constexpr char Format[] = u8"Format";
+        inline static constexpr char Size[] = u8"Rozmiar";
+        inline static constexpr char Usage[] = u8"Użycie";
+        inline static constexpr char Binding[] = u8"Powiązanie";
+        inline static constexpr char Aliased[] = u8"Współdzielone";
+        inline static constexpr char NotBound[] = u8"Niepowiązany";
+        inline static constexpr char Resources[] = u8"Zasoby";
+        inline static constexpr char Occupancy[] = u8"Zajętość";
+        inline static constexpr char FreeRanges[] = u8"Wolne zakresy";
+        inline static constexpr char LargestFreeRange[] = u8"Największy wolny zakres";
+        inline static constexpr char Fragmentation[] = u8"Fragmentacja";
 
         // Statistics tab
         inline static constexpr char DrawCalls[] = u8"Komendy rysujące";
@@ -92,6 +131,8 @@ namespace Profiler
         inline static constexpr char ShowDebugLabels[] = u8"Pokaż etykiety";
         inline static constexpr char ShowShaderCapabilities[] = u8"Pokaż funkcjonalności shadera";
         inline static constexpr char TimeUnit[] = u8"Jednostka czasu";
+        inline static constexpr char UpdateRate[] = u8"Częstotliwość odświeżania (Hz)";
+        inline static constexpr char TraceFormat[] = u8"Format zapisu";
 
         inline static constexpr char Unknown[] = u8"Nieznany";
     };
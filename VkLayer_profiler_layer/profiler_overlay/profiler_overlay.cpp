@@ -19,6 +19,7 @@
 // SOFTWARE.
 
 #include "profiler_overlay.h"
+#include "profiler/profiler.h"
 #include "profiler_trace/profiler_trace.h"
 #include "profiler_helpers/profiler_data_helpers.h"
 
@@ -78,8 +79,19 @@ namespace Profiler
     {
         HistogramGroupMode groupMode;
         FrameBrowserTreeNodeIndex nodeIndex;
+        uint32_t mergedColumnCount;
     };
 
+    // Minimal width of the performance graph bar, in pixels.
+    // Narrower columns are merged into a single bar.
+    static constexpr float PerformanceGraphMinColumnWidth = 2.0f;
+
+    // Number of frames kept in the history of the watched pipelines.
+    static constexpr uint32_t WatchedPipelineHistorySize = 128;
+
+    // Number of frames kept in the history of allocations and frees.
+    static constexpr size_t MemoryChurnHistorySize = 128;
+
     /***********************************************************************************\
 
     Function:
@@ -91,6 +103,7 @@ namespace Profiler
     \***********************************************************************************/
     ProfilerOverlayOutput::ProfilerOverlayOutput()
         : m_pDevice( nullptr )
+        , m_pProfiler( nullptr )
         , m_pGraphicsQueue( nullptr )
         , m_pSwapchain( nullptr )
         , m_Window()
@@ -108,6 +121,11 @@ namespace Profiler
         , m_CommandBuffers()
         , m_CommandFences()
         , m_CommandSemaphores()
+        , m_UpdateRate( 0 )
+        , m_DrawDataIndex( 0 )
+        , m_CommandBufferDrawDataIndices()
+        , m_LastUpdateTimestamp( std::chrono::high_resolution_clock::duration::zero() )
+        , m_WantCaptureInput( false )
         , m_VendorMetricsSets()
         , m_VendorMetricFilter()
         , m_TimestampPeriod( 0 )
@@ -115,11 +133,20 @@ namespace Profiler
         , m_pTimestampDisplayUnitStr( Lang::Milliseconds )
         , m_FrameBrowserSortMode( FrameBrowserSortMode::eSubmissionOrder )
         , m_HistogramGroupMode( HistogramGroupMode::eRenderPass )
+        , m_RollingStatisticsType( DeviceProfilerRollingStatisticsType::ePipeline )
+        , m_RollingStatistics()
         , m_Pause( false )
         , m_ShowDebugLabels( true )
         , m_ShowShaderCapabilities( true )
         , m_SelectedFrameBrowserNodeIndex( { 0xFFFF } )
         , m_ScrollToSelectedFrameBrowserNode( false )
+        , m_FrameBrowserNodes()
+        , m_FrameBrowserVisibleNodes()
+        , m_FrameBrowserOpenNodes()
+        , m_FrameBrowserNodesDirty( true )
+        , m_FrameBrowserVisibleNodesDirty( true )
+        , m_FrameBrowserNodesSortMode( FrameBrowserSortMode::eSubmissionOrder )
+        , m_FrameBrowserNodesShowDebugLabels( true )
         , m_SelectionUpdateTimestamp( std::chrono::high_resolution_clock::duration::zero() )
         , m_SerializationFinishTimestamp( std::chrono::high_resolution_clock::duration::zero() )
         , m_PerformanceQueryCommandBufferFilter( VK_NULL_HANDLE )
@@ -129,11 +156,34 @@ namespace Profiler
         , m_SerializationOutputWindowSize( { 0, 0 } )
         , m_SerializationOutputWindowDuration( std::chrono::seconds( 4 ) )
         , m_SerializationOutputWindowFadeOutDuration( std::chrono::seconds( 1 ) )
+        , m_pTraceCaptureSerializer( nullptr )
+        , m_TraceFormat( DeviceProfilerTraceFormat::eJson )
         , m_RenderPassColumnColor( 0 )
         , m_GraphicsPipelineColumnColor( 0 )
         , m_ComputePipelineColumnColor( 0 )
         , m_RayTracingPipelineColumnColor( 0 )
         , m_InternalPipelineColumnColor( 0 )
+        , m_PerformanceGraphColumns()
+        , m_PerformanceGraphLodColumns()
+        , m_PerformanceGraphColumnsDirty( true )
+        , m_PerformanceGraphLodColumnsDirty( true )
+        , m_PerformanceGraphColumnsGroupMode( HistogramGroupMode::eRenderPass )
+        , m_PerformanceGraphViewRange{ 0.0f, 1.0f }
+        , m_PerformanceGraphLodViewRange{ 0.0f, 1.0f }
+        , m_PerformanceGraphLodWidth( 0.0f )
+        , m_TimelineLanes()
+        , m_TimelineSubmitMarkers()
+        , m_TimelineOrigin( std::chrono::high_resolution_clock::duration::zero() )
+        , m_TimelineFrameCount( 8 )
+        , m_TimelineGeometry()
+        , m_TimelineSubmitMarkerGeometry()
+        , m_TimelineVisible( false )
+        , m_TimelineGeometryDirty( true )
+        , m_TimelineGeometryWidth( 0.0f )
+        , m_TimelineViewRange{ 0.0f, 1.0f }
+        , m_WatchedPipelines()
+        , m_WatchedPipelineSamples()
+        , m_MemoryChurnHistory()
         , m_pStringSerializer( nullptr )
     {
     }
@@ -149,6 +199,7 @@ namespace Profiler
     \***********************************************************************************/
     VkResult ProfilerOverlayOutput::Initialize(
         VkDevice_Object& device,
+        const DeviceProfiler& profiler,
         VkQueue_Object& graphicsQueue,
         VkSwapchainKhr_Object& swapchain,
         const VkSwapchainCreateInfoKHR* pCreateInfo )
@@ -157,6 +208,7 @@ namespace Profiler
 
         // Setup objects
         m_pDevice = &device;
+        m_pProfiler = &profiler;
         m_pGraphicsQueue = &graphicsQueue;
         m_pSwapchain = &swapchain;
 
@@ -289,6 +341,14 @@ namespace Profiler
                          : VK_ERROR_OUT_OF_HOST_MEMORY;
         }
 
+        // Initialize trace capture serializer
+        if( result == VK_SUCCESS )
+        {
+            result = (m_pTraceCaptureSerializer = new (std::nothrow) DeviceProfilerTraceSerializer( m_pStringSerializer, m_TimestampPeriod, m_TraceFormat ))
+                         ? VK_SUCCESS
+                         : VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+
         // Don't leave object in partly-initialized state if something went wrong
         if( result != VK_SUCCESS )
         {
@@ -314,6 +374,18 @@ namespace Profiler
             m_pDevice->Callbacks.DeviceWaitIdle( m_pDevice->Handle );
         }
 
+        if( m_pTraceCaptureSerializer )
+        {
+            // Save frames captured so far
+            if( m_pTraceCaptureSerializer->IsCapturing() )
+            {
+                m_pTraceCaptureSerializer->EndCapture();
+            }
+
+            delete m_pTraceCaptureSerializer;
+            m_pTraceCaptureSerializer = nullptr;
+        }
+
         if( m_pStringSerializer )
         {
             delete m_pStringSerializer;
@@ -386,8 +458,12 @@ namespace Profiler
 
         m_CommandSemaphores.clear();
 
+        m_CommandBufferDrawDataIndices.clear();
+        m_LastUpdateTimestamp = std::chrono::high_resolution_clock::time_point();
+
         m_Window = OSWindowHandle();
         m_pDevice = nullptr;
+        m_pProfiler = nullptr;
     }
 
     /***********************************************************************************\
@@ -671,6 +747,10 @@ namespace Profiler
         {
             m_pSwapchain = &swapchain;
             m_Images = images;
+
+            // Record all command buffers again with the new framebuffers
+            m_CommandBufferDrawDataIndices.assign( m_CommandBuffers.size(), UINT64_MAX );
+            m_LastUpdateTimestamp = std::chrono::high_resolution_clock::time_point();
         }
 
         // Reinitialize ImGui
@@ -712,8 +792,40 @@ namespace Profiler
         const VkQueue_Object& queue,
         VkPresentInfoKHR* pPresentInfo )
     {
-        // Record interface draw commands
-        Update( data );
+        // Append the frame to the open capture session
+        if( m_pTraceCaptureSerializer->IsCapturing() )
+        {
+            if( !m_pTraceCaptureSerializer->AppendFrame( data ) )
+            {
+                // Frame or event limit reached
+                EndTraceCapture();
+            }
+        }
+
+        // Collect the watched pipelines and the allocations of the last frames
+        if( !m_Pause )
+        {
+            // Timeline is displayed only in its tab, skip collecting it while the tab is hidden
+            if( m_TimelineVisible )
+            {
+                AppendTimelineFrame( data );
+            }
+
+            AppendWatchedPipelinesFrame( data );
+            AppendMemoryChurnFrame( data );
+        }
+
+        const auto now = std::chrono::high_resolution_clock::now();
+
+        // Keep the interface responsive while the user interacts with it
+        if( (m_UpdateRate == 0) ||
+            (m_WantCaptureInput) ||
+            ((now - m_LastUpdateTimestamp) >= std::chrono::duration<double>( 1.0 / m_UpdateRate )) )
+        {
+            // Record interface draw commands
+            Update( data );
+            m_LastUpdateTimestamp = now;
+        }
 
         if( ImGui::GetDrawData() )
         {
@@ -729,28 +841,34 @@ namespace Profiler
             m_pDevice->Callbacks.WaitForFences( m_pDevice->Handle, 1, &fence, VK_TRUE, UINT64_MAX );
             m_pDevice->Callbacks.ResetFences( m_pDevice->Handle, 1, &fence );
 
+            // Reuse the command buffer if the interface hasn't been updated since it was recorded
+            if( m_CommandBufferDrawDataIndices[ imageIndex ] != m_DrawDataIndex )
             {
-                VkCommandBufferBeginInfo info = {};
-                info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-                info.flags |= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-                m_pDevice->Callbacks.BeginCommandBuffer( commandBuffer, &info );
-            }
-            {
-                VkRenderPassBeginInfo info = {};
-                info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-                info.renderPass = m_RenderPass;
-                info.framebuffer = framebuffer;
-                info.renderArea.extent.width = m_RenderArea.width;
-                info.renderArea.extent.height = m_RenderArea.height;
-                m_pDevice->Callbacks.CmdBeginRenderPass( commandBuffer, &info, VK_SUBPASS_CONTENTS_INLINE );
-            }
+                {
+                    VkCommandBufferBeginInfo info = {};
+                    info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+                    m_pDevice->Callbacks.BeginCommandBuffer( commandBuffer, &info );
+                }
+                {
+                    VkRenderPassBeginInfo info = {};
+                    info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+                    info.renderPass = m_RenderPass;
+                    info.framebuffer = framebuffer;
+                    info.renderArea.extent.width = m_RenderArea.width;
+                    info.renderArea.extent.height = m_RenderArea.height;
+                    m_pDevice->Callbacks.CmdBeginRenderPass( commandBuffer, &info, VK_SUBPASS_CONTENTS_INLINE );
+                }
 
-            // Record Imgui Draw Data and draw funcs into command buffer
-            m_pImGuiVulkanContext->RenderDrawData( ImGui::GetDrawData(), commandBuffer );
+                // Record Imgui Draw Data and draw funcs into command buffer
+                m_pImGuiVulkanContext->RenderDrawData( ImGui::GetDrawData(), commandBuffer, imageIndex );
 
-            // Submit command buffer
-            m_pDevice->Callbacks.CmdEndRenderPass( commandBuffer );
+                m_pDevice->Callbacks.CmdEndRenderPass( commandBuffer );
+                m_pDevice->Callbacks.EndCommandBuffer( commandBuffer );
+
+                m_CommandBufferDrawDataIndices[ imageIndex ] = m_DrawDataIndex;
+            }
 
+            // Submit command buffer
             {
                 VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
                 VkSubmitInfo info = {};
@@ -763,7 +881,6 @@ namespace Profiler
                 info.signalSemaphoreCount = 1;
                 info.pSignalSemaphores = &semaphore;
 
-                m_pDevice->Callbacks.EndCommandBuffer( commandBuffer );
                 m_pDevice->Callbacks.QueueSubmit( m_pGraphicsQueue->Handle, 1, &info, fence );
             }
 
@@ -775,6 +892,52 @@ namespace Profiler
 
     /***********************************************************************************\
 
+    Function:
+        BeginTraceCapture
+
+    Description:
+        Start writing the presented frames to a single trace file.
+        If maxFrameCount is 0, the capture continues until EndTraceCapture is called.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::BeginTraceCapture( uint32_t maxFrameCount )
+    {
+        m_pTraceCaptureSerializer->BeginCapture( maxFrameCount );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        EndTraceCapture
+
+    Description:
+        Finish the capture session and save the trace file.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::EndTraceCapture()
+    {
+        if( m_pTraceCaptureSerializer->IsCapturing() )
+        {
+            ShowTraceSerializationResult( m_pTraceCaptureSerializer->EndCapture() );
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        SetUpdateRate
+
+    Description:
+        Limit number of interface updates per second (0 - update on every present).
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::SetUpdateRate( uint32_t updatesPerSecond )
+    {
+        m_UpdateRate = updatesPerSecond;
+    }
+
+    /***********************************************************************************\
+
     Function:
         Update
 
@@ -807,16 +970,30 @@ namespace Profiler
         // Save results to file
         if( ImGui::Button( Lang::Save ) )
         {
-            DeviceProfilerTraceSerializer serializer( m_pStringSerializer, m_TimestampPeriod );
-            DeviceProfilerTraceSerializationResult result = serializer.Serialize( data );
-
-            m_SerializationSucceeded = result.m_Succeeded;
-            m_SerializationMessage = result.m_Message;
+            DeviceProfilerTraceSerializer serializer( m_pStringSerializer, m_TimestampPeriod, m_TraceFormat );
+            ShowTraceSerializationResult( serializer.Serialize( data ) );
+        }
 
-            // Display message box
-            m_SerializationFinishTimestamp = std::chrono::high_resolution_clock::now();
-            m_SerializationOutputWindowSize = { 0, 0 };
-            m_SerializationWindowVisible = false;
+        // Start or stop multi-frame capture
+        ImGui::SameLine();
+        if( !m_pTraceCaptureSerializer->IsCapturing() )
+        {
+            if( ImGui::Button( Lang::StartCapture ) )
+            {
+                BeginTraceCapture();
+            }
+        }
+        else
+        {
+            if( ImGui::Button( Lang::StopCapture ) )
+            {
+                EndTraceCapture();
+            }
+            else
+            {
+                ImGui::SameLine();
+                ImGui::Text( Lang::CapturedFramesFmt, m_pTraceCaptureSerializer->GetCapturedFrameCount() );
+            }
         }
 
         // Keep results
@@ -827,6 +1004,8 @@ namespace Profiler
         {
             // Update data
             m_Data = data;
+            m_FrameBrowserNodesDirty = true;
+            m_PerformanceGraphColumnsDirty = true;
         }
 
         ImGui::BeginTabBar( "##tabs" );
@@ -836,6 +1015,12 @@ namespace Profiler
             UpdatePerformanceTab();
             ImGui::EndTabItem();
         }
+        m_TimelineVisible = ImGui::BeginTabItem( Lang::Timeline );
+        if( m_TimelineVisible )
+        {
+            UpdateTimelineTab();
+            ImGui::EndTabItem();
+        }
         if( ImGui::BeginTabItem( Lang::Memory ) )
         {
             UpdateMemoryTab();
@@ -859,6 +1044,12 @@ namespace Profiler
 
         ImGui::End();
         ImGui::Render();
+
+        // Command buffers recorded with the previous draw data are outdated
+        m_DrawDataIndex++;
+
+        // Don't throttle updates while the mouse is over the overlay
+        m_WantCaptureInput = ImGui::GetIO().WantCaptureMouse || ImGui::GetIO().WantCaptureKeyboard;
     }
 
     /***********************************************************************************\
@@ -1232,9 +1423,28 @@ namespace Profiler
                 }
             }
 
+            // Restore the whole frame view
+            if( (m_PerformanceGraphViewRange[ 0 ] > 0.0f) || (m_PerformanceGraphViewRange[ 1 ] < 1.0f) )
+            {
+                ImGui::SameLine();
+                if( ImGui::SmallButton( Lang::ResetZoom ) )
+                {
+                    m_PerformanceGraphViewRange[ 0 ] = 0.0f;
+                    m_PerformanceGraphViewRange[ 1 ] = 1.0f;
+                }
+            }
+
             // Enumerate columns for selected group mode
-            std::vector<PerformanceGraphColumn> columns;
-            GetPerformanceGraphColumns( columns );
+            if( m_PerformanceGraphColumnsDirty ||
+                (m_PerformanceGraphColumnsGroupMode != m_HistogramGroupMode) )
+            {
+                m_PerformanceGraphColumns.clear();
+                GetPerformanceGraphColumns( m_PerformanceGraphColumns );
+
+                m_PerformanceGraphColumnsGroupMode = m_HistogramGroupMode;
+                m_PerformanceGraphColumnsDirty = false;
+                m_PerformanceGraphLodColumnsDirty = true;
+            }
 
             char pHistogramDescription[ 32 ];
             snprintf( pHistogramDescription, sizeof( pHistogramDescription ),
@@ -1243,15 +1453,36 @@ namespace Profiler
                 selectedOption );
 
             ImGui::PushItemWidth( -1 );
+
+            // Merge columns too narrow to be visible at the current zoom level
+            const float graphWidth = ImGui::CalcItemWidth();
+
+            if( m_PerformanceGraphLodColumnsDirty ||
+                (m_PerformanceGraphLodWidth != graphWidth) ||
+                (m_PerformanceGraphLodViewRange[ 0 ] != m_PerformanceGraphViewRange[ 0 ]) ||
+                (m_PerformanceGraphLodViewRange[ 1 ] != m_PerformanceGraphViewRange[ 1 ]) )
+            {
+                UpdatePerformanceGraphLodColumns( graphWidth );
+            }
+
+            ImVec2 viewRange = {
+                m_PerformanceGraphViewRange[ 0 ],
+                m_PerformanceGraphViewRange[ 1 ] };
+
             ImGuiX::PlotHistogramEx(
                 "",
-                columns.data(),
-                static_cast<int>( columns.size() ),
+                m_PerformanceGraphLodColumns.data(),
+                static_cast<int>( m_PerformanceGraphLodColumns.size() ),
                 0,
-                sizeof( columns.front() ),
+                sizeof( PerformanceGraphColumn ),
                 pHistogramDescription, 0, FLT_MAX, { 0, 100 },
                 std::bind( &ProfilerOverlayOutput::DrawPerformanceGraphLabel, this, std::placeholders::_1 ),
-                std::bind( &ProfilerOverlayOutput::SelectPerformanceGraphColumn, this, std::placeholders::_1 ) );
+                std::bind( &ProfilerOverlayOutput::SelectPerformanceGraphColumn, this, std::placeholders::_1 ),
+                &viewRange );
+
+            // Zoom and pan are applied in the next frame
+            m_PerformanceGraphViewRange[ 0 ] = viewRange.x;
+            m_PerformanceGraphViewRange[ 1 ] = viewRange.y;
         }
 
         // Top pipelines
@@ -1265,6 +1496,21 @@ namespace Profiler
                 {
                     const uint64_t pipelineTicks = (pipeline.m_EndTimestamp.m_Value - pipeline.m_BeginTimestamp.m_Value);
 
+                    // Pin the pipeline to the watch list
+                    bool watched = IsPipelineWatched( pipeline.m_ShaderTuple.m_Hash );
+
+                    ImGui::PushID( i );
+                    if( ImGui::Checkbox( "##Watch", &watched ) )
+                    {
+                        SetPipelineWatched( pipeline, watched );
+                    }
+                    if( ImGui::IsItemHovered() )
+                    {
+                        ImGui::SetTooltip( "%s", Lang::WatchPipeline );
+                    }
+                    ImGui::PopID();
+
+                    ImGui::SameLine();
                     ImGui::Text( "%2u. %s", i + 1, m_pStringSerializer->GetName( pipeline ).c_str() );
                     ImGuiX::TextAlignRight( "(%.1f %%) %.2f ms",
                         pipelineTicks * 100.f / m_Data.m_Ticks,
@@ -1276,6 +1522,179 @@ namespace Profiler
             }
         }
 
+        // History of the pinned pipelines
+        if( ImGui::CollapsingHeader( Lang::WatchList ) )
+        {
+            UpdateWatchList();
+        }
+
+        // Distribution of GPU time over the last frames
+        if( ImGui::CollapsingHeader( Lang::RollingStatistics ) )
+        {
+            // Update is already limited to the overlay refresh rate
+            if( !m_Pause )
+            {
+                m_pProfiler->GetRollingStatistics( m_RollingStatistics );
+            }
+
+            // Select type of the objects
+            {
+                static const char* typeOptions[] = {
+                    Lang::Pipelines,
+                    Lang::RenderPasses,
+                    Lang::DebugLabels };
+
+                const char* selectedOption = typeOptions[ (size_t)m_RollingStatisticsType ];
+
+                if( ImGui::BeginCombo( "##RollingStatisticsType", selectedOption ) )
+                {
+                    for( size_t i = 0; i < std::extent_v<decltype(typeOptions)>; ++i )
+                    {
+                        if( ImGuiX::TSelectable( typeOptions[ i ], selectedOption, typeOptions[ i ] ) )
+                        {
+                            // Selection changed
+                            m_RollingStatisticsType = DeviceProfilerRollingStatisticsType( i );
+                        }
+                    }
+
+                    ImGui::EndCombo();
+                }
+            }
+
+            if( ImGui::BeginTable( "##RollingStatisticsTable",
+                    /* columns_count */ 7,
+                    ImGuiTableFlags_NoClip |
+                    (ImGuiTableFlags_Borders & ~ImGuiTableFlags_BordersInnerV) ) )
+            {
+                // Headers
+                ImGui::TableSetupColumn( Lang::Name, ImGuiTableColumnFlags_WidthStretch );
+                ImGui::TableSetupColumn( Lang::Frames, ImGuiTableColumnFlags_WidthFixed );
+                ImGui::TableSetupColumn( Lang::Mean, ImGuiTableColumnFlags_WidthFixed );
+                ImGui::TableSetupColumn( "p50", ImGuiTableColumnFlags_WidthFixed );
+                ImGui::TableSetupColumn( "p95", ImGuiTableColumnFlags_WidthFixed );
+                ImGui::TableSetupColumn( "p99", ImGuiTableColumnFlags_WidthFixed );
+                ImGui::TableSetupColumn( Lang::Max, ImGuiTableColumnFlags_WidthFixed );
+                ImGui::TableHeadersRow();
+
+                const float tickPeriod = m_TimestampPeriod.count();
+
+                // Statistics are sorted by mean time descending
+                for( const auto& statistics : m_RollingStatistics )
+                {
+                    if( statistics.m_Type != m_RollingStatisticsType )
+                    {
+                        continue;
+                    }
+
+                    ImGui::TableNextColumn();
+                    switch( statistics.m_Type )
+                    {
+                    case DeviceProfilerRollingStatisticsType::ePipeline:
+                        ImGui::TextUnformatted( m_pStringSerializer->GetName( statistics.m_Pipeline ).c_str() );
+                        break;
+
+                    case DeviceProfilerRollingStatisticsType::eRenderPass:
+                        ImGui::TextUnformatted( m_pStringSerializer->GetName( statistics.m_RenderPass ).c_str() );
+                        break;
+
+                    case DeviceProfilerRollingStatisticsType::eDebugLabel:
+                        ImGui::TextUnformatted( statistics.m_DebugLabelPath.c_str() );
+                        break;
+                    }
+
+                    ImGui::TableNextColumn();
+                    ImGuiX::TextAlignRight( ImGuiX::TableGetColumnWidth(), "%u", statistics.m_SampleCount );
+
+                    ImGui::TableNextColumn();
+                    ImGuiX::TextAlignRight( ImGuiX::TableGetColumnWidth(), "%.2f ms", statistics.m_MeanTicks * tickPeriod );
+
+                    if( ImGui::IsItemHovered() )
+                    {
+                        ImGui::SetTooltip( "%.2f ms +/- %.2f ms",
+                            statistics.m_MeanTicks * tickPeriod,
+                            statistics.m_StdDevTicks * tickPeriod );
+                    }
+
+                    ImGui::TableNextColumn();
+                    ImGuiX::TextAlignRight( ImGuiX::TableGetColumnWidth(), "%.2f ms", statistics.m_P50Ticks * tickPeriod );
+
+                    ImGui::TableNextColumn();
+                    ImGuiX::TextAlignRight( ImGuiX::TableGetColumnWidth(), "%.2f ms", statistics.m_P95Ticks * tickPeriod );
+
+                    ImGui::TableNextColumn();
+                    ImGuiX::TextAlignRight( ImGuiX::TableGetColumnWidth(), "%.2f ms", statistics.m_P99Ticks * tickPeriod );
+
+                    ImGui::TableNextColumn();
+                    ImGuiX::TextAlignRight( ImGuiX::TableGetColumnWidth(), "%.2f ms", statistics.m_MaxTicks * tickPeriod );
+                }
+
+                ImGui::EndTable();
+            }
+        }
+
+        // Hierarchy of the debug labels with inclusive and exclusive GPU time
+        if( !m_Data.m_DebugLabels.empty() &&
+            ImGui::CollapsingHeader( Lang::DebugLabels ) )
+        {
+            if( ImGui::BeginTable( "##DebugLabelsTable",
+                    /* columns_count */ 4,
+                    ImGuiTableFlags_NoClip |
+                    (ImGuiTableFlags_Borders & ~ImGuiTableFlags_BordersInnerV) ) )
+            {
+                // Headers
+                ImGui::TableSetupColumn( Lang::Name, ImGuiTableColumnFlags_WidthStretch );
+                ImGui::TableSetupColumn( Lang::Inclusive, ImGuiTableColumnFlags_WidthFixed );
+                ImGui::TableSetupColumn( Lang::Exclusive, ImGuiTableColumnFlags_WidthFixed );
+                ImGui::TableSetupColumn( Lang::DrawCalls, ImGuiTableColumnFlags_WidthFixed );
+                ImGui::TableHeadersRow();
+
+                // Root labels are siblings at depth 0
+                for( uint32_t i = 0; i < m_Data.m_DebugLabels.size();
+                    i += m_Data.m_DebugLabels[ i ].m_DescendantCount + 1 )
+                {
+                    PrintDebugLabelTree( i );
+                }
+
+                ImGui::EndTable();
+            }
+        }
+
+        // Regions marked by the application with vkBeginProfilerCpuRegionEXT
+        if( !m_Data.m_CpuRegions.empty() &&
+            ImGui::CollapsingHeader( Lang::CpuRegions ) )
+        {
+            const float indentSpacing = ImGui::GetStyle().IndentSpacing;
+
+            for( const auto& region : m_Data.m_CpuRegions )
+            {
+                // Offset of the region relative to the beginning of the frame
+                const Milliseconds regionOffset = region.m_BeginTimestamp - m_Data.m_CPU.m_BeginTimestamp;
+                const Milliseconds regionDuration = region.m_EndTimestamp - region.m_BeginTimestamp;
+
+                ImVec2 cursorPosition = ImGui::GetCursorScreenPos();
+                cursorPosition.x += region.m_Depth * indentSpacing;
+
+                const ImVec2 rectSize(
+                    cursorPosition.x + 8,
+                    cursorPosition.y + ImGui::GetTextLineHeight() );
+
+                ImDrawList* pDrawList = ImGui::GetWindowDrawList();
+                pDrawList->AddRectFilled( cursorPosition, rectSize,
+                    ImGui::GetColorU32( *reinterpret_cast<const ImVec4*>(region.m_Color) ) );
+                pDrawList->AddRect( cursorPosition, rectSize, ImGui::GetColorU32( ImGuiCol_Border ) );
+
+                cursorPosition.x += 12;
+                ImGui::SetCursorScreenPos( cursorPosition );
+
+                ImGui::TextUnformatted( region.m_Name.c_str() );
+                ImGuiX::TextAlignRight( "%s %u, +%.2f ms, %.2f ms",
+                    Lang::Thread,
+                    region.m_ThreadId,
+                    regionOffset.count(),
+                    regionDuration.count() );
+            }
+        }
+
         // Vendor-specific
         if( !m_Data.m_VendorMetrics.empty() &&
             ImGui::CollapsingHeader( Lang::PerformanceCounters ) )
@@ -1533,88 +1952,50 @@ namespace Profiler
                 }
             }
 
-            FrameBrowserTreeNodeIndex index = {
-                0x0,
-                0xFFFF,
-                0xFFFF,
-                0xFFFF,
-                0xFFFF,
-                0xFFFF,
-                0xFFFF,
-                0xFFFF };
-
-            // Enumerate submits in frame
-            for( const auto& submitBatch : m_Data.m_Submits )
+            // Rebuild the tree only when the displayed data changes
+            if( m_FrameBrowserNodesDirty ||
+                (m_FrameBrowserNodesSortMode != m_FrameBrowserSortMode) )
             {
-                const std::string queueName = m_pStringSerializer->GetName( submitBatch.m_Handle );
+                UpdateFrameBrowserNodes();
+            }
 
-                index.SubmitIndex = 0;
-                index.PrimaryCommandBufferIndex = 0;
+            if( m_ScrollToSelectedFrameBrowserNode )
+            {
+                OpenSelectedFrameBrowserNode();
+            }
 
-                char indexStr[ 2 * sizeof( index ) + 1 ] = {};
-                structtohex( indexStr, index );
+            if( m_FrameBrowserVisibleNodesDirty ||
+                (m_FrameBrowserNodesShowDebugLabels != m_ShowDebugLabels) )
+            {
+                UpdateFrameBrowserVisibleNodes();
+            }
 
-                if( m_ScrollToSelectedFrameBrowserNode &&
-                    (m_SelectedFrameBrowserNodeIndex.SubmitBatchIndex == index.SubmitBatchIndex) )
-                {
-                    ImGui::SetNextItemOpen( true );
-                }
+            const float rowsBeginY = ImGui::GetCursorPosY();
+            const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
 
-                if( ImGui::TreeNode( indexStr, "vkQueueSubmit(%s, %u)",
-                        queueName.c_str(),
-                        static_cast<uint32_t>(submitBatch.m_Submits.size()) ) )
+            if( m_ScrollToSelectedFrameBrowserNode )
+            {
+                for( size_t i = 0; i < m_FrameBrowserVisibleNodes.size(); ++i )
                 {
-                    for( const auto& submit : submitBatch.m_Submits )
+                    if( m_FrameBrowserNodes[ m_FrameBrowserVisibleNodes[ i ] ].m_Index == m_SelectedFrameBrowserNodeIndex )
                     {
-                        structtohex( indexStr, index );
-
-                        if( m_ScrollToSelectedFrameBrowserNode &&
-                            (m_SelectedFrameBrowserNodeIndex.SubmitBatchIndex == index.SubmitBatchIndex) &&
-                            (m_SelectedFrameBrowserNodeIndex.SubmitIndex == index.SubmitIndex) )
-                        {
-                            ImGui::SetNextItemOpen( true );
-                        }
-
-                        const bool inSubmitSubtree =
-                            (submitBatch.m_Submits.size() > 1) &&
-                            (ImGui::TreeNode( indexStr, "VkSubmitInfo #%u", index.SubmitIndex ));
-
-                        if( (inSubmitSubtree) || (submitBatch.m_Submits.size() == 1) )
-                        {
-                            index.PrimaryCommandBufferIndex = 0;
-
-                            // Sort frame browser data
-                            std::list<const DeviceProfilerCommandBufferData*> pCommandBuffers =
-                                SortFrameBrowserData( submit.m_CommandBuffers );
-
-                            // Enumerate command buffers in submit
-                            for( const auto* pCommandBuffer : pCommandBuffers )
-                            {
-                                PrintCommandBuffer( *pCommandBuffer, index );
-                                index.PrimaryCommandBufferIndex++;
-                            }
-
-                            // Invalidate command buffer index
-                            index.PrimaryCommandBufferIndex = 0xFFFF;
-                        }
-
-                        if( inSubmitSubtree )
-                        {
-                            // Finish submit subtree
-                            ImGui::TreePop();
-                        }
-
-                        index.SubmitIndex++;
+                        // Center the selected row in the window
+                        ImGui::SetScrollY( rowsBeginY + i * rowHeight - 0.5f * ImGui::GetWindowHeight() );
+                        break;
                     }
+                }
+            }
 
-                    // Finish submit batch subtree
-                    ImGui::TreePop();
+            // Draw only rows scrolled into view
+            ImGuiListClipper clipper;
+            clipper.Begin( static_cast<int>( m_FrameBrowserVisibleNodes.size() ), rowHeight );
 
-                    // Invalidate submit index
-                    index.SubmitIndex = 0xFFFF;
+            while( clipper.Step() )
+            {
+                for( int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i )
+                {
+                    PrintFrameBrowserNode( m_FrameBrowserVisibleNodes[ i ] );
                 }
-
-                index.SubmitBatchIndex++;
             }
         }
 
@@ -1750,29 +2131,336 @@ namespace Profiler
                     memoryTypeDescriptorPointers.data() );
             }
         }
-    }
 
-    /***********************************************************************************\
-
-    Function:
-        UpdateStatisticsTab
-
-    Description:
-        Updates "Statistics" tab.
+        // Allocations and frees of the last frames
+        if( ImGui::CollapsingHeader( Lang::AllocationChurn ) )
+        {
+            UpdateMemoryChurn();
+        }
 
-    \***********************************************************************************/
-    void ProfilerOverlayOutput::UpdateStatisticsTab()
-    {
-        // Draw count statistics
+        // Buffers and images with the largest memory requirements
+        if( ImGui::CollapsingHeader( Lang::LargestResources ) )
         {
-            ImGui::TextUnformatted( Lang::DrawCalls );
-            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_DrawCount );
+            if( ImGui::BeginTable( "##LargestResourcesTable",
+                    /* columns_count */ 4,
+                    ImGuiTableFlags_NoClip |
+                    (ImGuiTableFlags_Borders & ~ImGuiTableFlags_BordersInnerV) ) )
+            {
+                ImGui::TableSetupColumn( Lang::Name, ImGuiTableColumnFlags_WidthStretch );
+                ImGui::TableSetupColumn( Lang::Format, ImGuiTableColumnFlags_WidthFixed );
+                ImGui::TableSetupColumn( Lang::Size, ImGuiTableColumnFlags_WidthFixed );
+                ImGui::TableSetupColumn( Lang::Binding, ImGuiTableColumnFlags_WidthStretch );
+                ImGui::TableHeadersRow();
 
-            ImGui::TextUnformatted( Lang::DrawCallsIndirect );
-            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_DrawIndirectCount );
+                for( const auto& resource : m_Data.m_Memory.m_LargestResources )
+                {
+                    const VkObject object = (resource.m_Buffer != VK_NULL_HANDLE)
+                        ? VkObject( resource.m_Buffer )
+                        : VkObject( resource.m_Image );
 
-            ImGui::TextUnformatted( Lang::DispatchCalls );
-            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_DispatchCount );
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted( m_pStringSerializer->GetName( object ).c_str() );
+
+                    if( ImGui::IsItemHovered() )
+                    {
+                        ImGui::BeginTooltip();
+                        ImGui::Text( "%s: 0x%08x", Lang::Usage, resource.m_Usage );
+
+                        if( resource.m_Image != VK_NULL_HANDLE )
+                        {
+                            ImGui::Text( "%u x %u x %u",
+                                resource.m_Extent.width,
+                                resource.m_Extent.height,
+                                resource.m_Extent.depth );
+                        }
+
+                        ImGui::EndTooltip();
+                    }
+
+                    ImGui::TableNextColumn();
+                    if( resource.m_Image != VK_NULL_HANDLE )
+                    {
+                        ImGui::TextUnformatted( m_pStringSerializer->GetFormatName( resource.m_Format ).c_str() );
+                    }
+
+                    ImGui::TableNextColumn();
+                    ImGuiX::TextAlignRight( "%.2f MB", resource.m_Size / 1048576.f );
+
+                    ImGui::TableNextColumn();
+                    if( resource.m_Memory != VK_NULL_HANDLE )
+                    {
+                        ImGui::Text( "%s + %llu",
+                            m_pStringSerializer->GetName( VkObject( resource.m_Memory ) ).c_str(),
+                            static_cast<unsigned long long>( resource.m_MemoryOffset ) );
+
+                        if( resource.m_Aliased )
+                        {
+                            ImGui::SameLine();
+                            ImGui::TextColored( ImVec4( 1.0f, 0.75f, 0.0f, 1.0f ), "(%s)", Lang::Aliased );
+                        }
+                    }
+                    else
+                    {
+                        ImGui::TextUnformatted( Lang::NotBound );
+                    }
+                }
+
+                ImGui::EndTable();
+            }
+        }
+
+        // Allocations with the most fragmented free space
+        if( ImGui::CollapsingHeader( Lang::FragmentedAllocations ) )
+        {
+            if( ImGui::BeginTable( "##FragmentedAllocationsTable",
+                    /* columns_count */ 5,
+                    ImGuiTableFlags_NoClip |
+                    (ImGuiTableFlags_Borders & ~ImGuiTableFlags_BordersInnerV) ) )
+            {
+                ImGui::TableSetupColumn( Lang::Name, ImGuiTableColumnFlags_WidthStretch );
+                ImGui::TableSetupColumn( Lang::Occupancy, ImGuiTableColumnFlags_WidthStretch );
+                ImGui::TableSetupColumn( Lang::FreeRanges, ImGuiTableColumnFlags_WidthFixed );
+                ImGui::TableSetupColumn( Lang::LargestFreeRange, ImGuiTableColumnFlags_WidthFixed );
+                ImGui::TableSetupColumn( Lang::Fragmentation, ImGuiTableColumnFlags_WidthFixed );
+                ImGui::TableHeadersRow();
+
+                for( const auto& allocation : m_Data.m_Memory.m_FragmentedAllocations )
+                {
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted( m_pStringSerializer->GetName( VkObject( allocation.m_Memory ) ).c_str() );
+
+                    if( ImGui::IsItemHovered() )
+                    {
+                        ImGui::BeginTooltip();
+                        ImGui::Text( "%s %u", Lang::MemoryTypeIndex, allocation.m_MemoryTypeIndex );
+                        ImGui::Text( "%s: %u", Lang::Resources, allocation.m_ResourceCount );
+                        ImGui::Text( "%s: %.2f MB", Lang::Aliased, allocation.m_AliasedSize / 1048576.f );
+                        ImGui::EndTooltip();
+                    }
+
+                    ImGui::TableNextColumn();
+                    {
+                        const float occupancy = (allocation.m_Size != 0)
+                            ? static_cast<float>( allocation.m_BoundSize ) / allocation.m_Size
+                            : 0.0f;
+
+                        char occupancyStr[ 64 ] = {};
+                        snprintf( occupancyStr, sizeof( occupancyStr ),
+                            "%.2f/%.2f MB (%.1f%%)",
+                            allocation.m_BoundSize / 1048576.f,
+                            allocation.m_Size / 1048576.f,
+                            occupancy * 100.f );
+
+                        ImGui::ProgressBar( occupancy, { -1, 0 }, occupancyStr );
+                    }
+
+                    ImGui::TableNextColumn();
+                    ImGuiX::TextAlignRight( "%u", allocation.m_FreeRangeCount );
+
+                    ImGui::TableNextColumn();
+                    ImGuiX::TextAlignRight( "%.2f MB", allocation.m_LargestFreeRangeSize / 1048576.f );
+
+                    ImGui::TableNextColumn();
+                    ImGuiX::TextAlignRight( "%.1f %%", allocation.m_Fragmentation * 100.f );
+                }
+
+                ImGui::EndTable();
+            }
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        UpdateMemoryChurn
+
+    Description:
+        Draw the number of allocations in the last frames, highlighting the bursts,
+        and the sizes of the allocations and frees on each heap in these frames.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::UpdateMemoryChurn()
+    {
+        const DeviceProfilerMemoryChurnData& churn = m_Data.m_Memory.m_Churn;
+
+        ImGui::Text( "%s: %u (%.2f MB)", Lang::Allocations, churn.m_AllocationCount, churn.m_AllocationSize / 1048576.f );
+        ImGui::Text( "%s: %u (%.2f MB)", Lang::Frees, churn.m_FreeCount, churn.m_FreeSize / 1048576.f );
+
+        if( m_MemoryChurnHistory.empty() )
+        {
+            return;
+        }
+
+        const size_t heapCount = m_MemoryChurnHistory.back().m_Heaps.size();
+
+        // Accumulate the history
+        std::vector<float> allocationCounts;
+        allocationCounts.reserve( m_MemoryChurnHistory.size() );
+
+        std::vector<float> burstAllocationCounts;
+        burstAllocationCounts.reserve( m_MemoryChurnHistory.size() );
+
+        DeviceProfilerMemoryChurnData totalChurn;
+        totalChurn.m_Heaps.resize( heapCount );
+
+        uint32_t burstCount = 0;
+
+        for( const DeviceProfilerMemoryChurnData& frameChurn : m_MemoryChurnHistory )
+        {
+            allocationCounts.push_back( static_cast<float>( frameChurn.m_AllocationCount ) );
+            burstAllocationCounts.push_back( frameChurn.m_Burst ? static_cast<float>( frameChurn.m_AllocationCount ) : 0.0f );
+
+            if( frameChurn.m_Burst )
+            {
+                burstCount++;
+            }
+
+            for( uint32_t i = 0; i < DeviceProfilerMemoryChurnData::SizeHistogramBucketCount; ++i )
+            {
+                totalChurn.m_AllocationSizeHistogram[ i ] += frameChurn.m_AllocationSizeHistogram[ i ];
+            }
+
+            for( size_t i = 0; i < std::min( heapCount, frameChurn.m_Heaps.size() ); ++i )
+            {
+                totalChurn.m_Heaps[ i ].m_AllocationCount += frameChurn.m_Heaps[ i ].m_AllocationCount;
+                totalChurn.m_Heaps[ i ].m_AllocationSize += frameChurn.m_Heaps[ i ].m_AllocationSize;
+                totalChurn.m_Heaps[ i ].m_FreeCount += frameChurn.m_Heaps[ i ].m_FreeCount;
+                totalChurn.m_Heaps[ i ].m_FreeSize += frameChurn.m_Heaps[ i ].m_FreeSize;
+            }
+        }
+
+        // Allocations per frame, bursts are drawn on top of the other frames in a different color
+        char burstCountStr[ 64 ] = {};
+        snprintf( burstCountStr, sizeof( burstCountStr ), Lang::BurstsFmt, burstCount );
+
+        const float maxAllocationCount = std::max( 1.0f,
+            *std::max_element( allocationCounts.begin(), allocationCounts.end() ) );
+
+        const ImVec2 plotPosition = ImGui::GetCursorScreenPos();
+        const ImVec2 plotSize( ImGui::GetContentRegionAvail().x, ImGui::GetTextLineHeight() * 4.0f );
+
+        ImGui::PlotHistogram( "##AllocationCounts",
+            allocationCounts.data(),
+            static_cast<int>( allocationCounts.size() ),
+            0, burstCountStr, 0.0f, maxAllocationCount, plotSize );
+
+        ImGui::SetCursorScreenPos( plotPosition );
+        ImGui::PushStyleColor( ImGuiCol_FrameBg, IM_COL32( 0, 0, 0, 0 ) );
+        ImGui::PushStyleColor( ImGuiCol_PlotHistogram, IM_COL32( 255, 64, 64, 255 ) );
+        ImGui::PlotHistogram( "##BurstAllocationCounts",
+            burstAllocationCounts.data(),
+            static_cast<int>( burstAllocationCounts.size() ),
+            0, nullptr, 0.0f, maxAllocationCount, plotSize );
+        ImGui::PopStyleColor( 2 );
+
+        // Sizes of the allocations in the last frames
+        if( ImGui::BeginTable( "##AllocationSizesTable",
+                /* columns_count */ 2,
+                ImGuiTableFlags_NoClip |
+                (ImGuiTableFlags_Borders & ~ImGuiTableFlags_BordersInnerV) ) )
+        {
+            ImGui::TableSetupColumn( Lang::Size, ImGuiTableColumnFlags_WidthStretch );
+            ImGui::TableSetupColumn( Lang::Allocations, ImGuiTableColumnFlags_WidthFixed );
+            ImGui::TableHeadersRow();
+
+            for( uint32_t i = 0; i < DeviceProfilerMemoryChurnData::SizeHistogramBucketCount; ++i )
+            {
+                if( totalChurn.m_AllocationSizeHistogram[ i ] == 0 )
+                {
+                    continue;
+                }
+
+                // Buckets cover power-of-2 ranges of sizes, starting at 8 kB
+                const unsigned long long bucketBegin = 1ULL << (DeviceProfilerMemoryChurnData::SizeHistogramFirstBucketBits + i - 1);
+
+                ImGui::TableNextColumn();
+                if( i == 0 )
+                {
+                    ImGui::Text( "< %llu kB", (bucketBegin << 1) / 1024 );
+                }
+                else if( i == DeviceProfilerMemoryChurnData::SizeHistogramBucketCount - 1 )
+                {
+                    ImGui::Text( ">= %llu kB", bucketBegin / 1024 );
+                }
+                else
+                {
+                    ImGui::Text( "%llu - %llu kB", bucketBegin / 1024, (bucketBegin << 1) / 1024 );
+                }
+
+                ImGui::TableNextColumn();
+                ImGuiX::TextAlignRight( "%u", totalChurn.m_AllocationSizeHistogram[ i ] );
+            }
+
+            ImGui::EndTable();
+        }
+
+        // Allocations and frees on each heap in the last frames
+        if( ImGui::BeginTable( "##HeapChurnTable",
+                /* columns_count */ 3,
+                ImGuiTableFlags_NoClip |
+                (ImGuiTableFlags_Borders & ~ImGuiTableFlags_BordersInnerV) ) )
+        {
+            ImGui::TableSetupColumn( Lang::MemoryHeap, ImGuiTableColumnFlags_WidthStretch );
+            ImGui::TableSetupColumn( Lang::Allocations, ImGuiTableColumnFlags_WidthFixed );
+            ImGui::TableSetupColumn( Lang::Frees, ImGuiTableColumnFlags_WidthFixed );
+            ImGui::TableHeadersRow();
+
+            for( size_t i = 0; i < heapCount; ++i )
+            {
+                const DeviceProfilerMemoryHeapChurnData& heapChurn = totalChurn.m_Heaps[ i ];
+
+                ImGui::TableNextColumn();
+                ImGui::Text( "%s %zu", Lang::MemoryHeap, i );
+                ImGui::TableNextColumn();
+                ImGuiX::TextAlignRight( "%u (%.2f MB)", heapChurn.m_AllocationCount, heapChurn.m_AllocationSize / 1048576.f );
+                ImGui::TableNextColumn();
+                ImGuiX::TextAlignRight( "%u (%.2f MB)", heapChurn.m_FreeCount, heapChurn.m_FreeSize / 1048576.f );
+            }
+
+            ImGui::EndTable();
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        AppendMemoryChurnFrame
+
+    Description:
+        Append allocations and frees of the frame to the history.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::AppendMemoryChurnFrame( const DeviceProfilerFrameData& data )
+    {
+        m_MemoryChurnHistory.push_back( data.m_Memory.m_Churn );
+
+        while( m_MemoryChurnHistory.size() > MemoryChurnHistorySize )
+        {
+            m_MemoryChurnHistory.pop_front();
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        UpdateStatisticsTab
+
+    Description:
+        Updates "Statistics" tab.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::UpdateStatisticsTab()
+    {
+        // Draw count statistics
+        {
+            ImGui::TextUnformatted( Lang::DrawCalls );
+            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_DrawCount );
+
+            ImGui::TextUnformatted( Lang::DrawCallsIndirect );
+            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_DrawIndirectCount );
+
+            ImGui::TextUnformatted( Lang::DispatchCalls );
+            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_DispatchCount );
 
             ImGui::TextUnformatted( Lang::DispatchCallsIndirect );
             ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_DispatchIndirectCount );
@@ -1780,109 +2468,910 @@ namespace Profiler
             ImGui::TextUnformatted( Lang::TraceRaysCalls );
             ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_TraceRaysCount );
 
-            ImGui::TextUnformatted( Lang::TraceRaysIndirectCalls );
-            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_TraceRaysIndirectCount );
+            ImGui::TextUnformatted( Lang::TraceRaysIndirectCalls );
+            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_TraceRaysIndirectCount );
+
+            ImGui::TextUnformatted( Lang::CopyBufferCalls );
+            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_CopyBufferCount );
+
+            ImGui::TextUnformatted( Lang::CopyBufferToImageCalls );
+            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_CopyBufferToImageCount );
+
+            ImGui::TextUnformatted( Lang::CopyImageCalls );
+            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_CopyImageCount );
+
+            ImGui::TextUnformatted( Lang::CopyImageToBufferCalls );
+            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_CopyImageToBufferCount );
+
+            ImGui::TextUnformatted( Lang::PipelineBarriers );
+            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_PipelineBarrierCount );
+
+            ImGui::TextUnformatted( Lang::ColorClearCalls );
+            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_ClearColorCount );
+
+            ImGui::TextUnformatted( Lang::DepthStencilClearCalls );
+            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_ClearDepthStencilCount );
+
+            ImGui::TextUnformatted( Lang::ResolveCalls );
+            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_ResolveCount );
+
+            ImGui::TextUnformatted( Lang::BlitCalls );
+            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_BlitImageCount );
+
+            ImGui::TextUnformatted( Lang::FillBufferCalls );
+            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_FillBufferCount );
+
+            ImGui::TextUnformatted( Lang::UpdateBufferCalls );
+            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_UpdateBufferCount );
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        UpdateSettingsTab
+
+    Description:
+        Updates "Settings" tab.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::UpdateSettingsTab()
+    {
+        // Set interface scaling.
+        float interfaceScale = ImGui::GetIO().FontGlobalScale;
+        if( ImGui::InputFloat( "Interface scale", &interfaceScale ) )
+        {
+            ImGui::GetIO().FontGlobalScale = std::clamp( interfaceScale, 0.25f, 4.0f );
+        }
+
+        // Limit number of interface updates per second.
+        int updateRate = static_cast<int>( m_UpdateRate );
+        if( ImGui::InputInt( Lang::UpdateRate, &updateRate ) )
+        {
+            m_UpdateRate = static_cast<uint32_t>( std::max( 0, updateRate ) );
+        }
+
+        // Select synchronization mode
+        {
+            static const char* syncGroupOptions[] = {
+                Lang::Present,
+                Lang::Submit };
+
+            static int syncModeSelectedOption = 0;
+            int previousSyncModeSelectedOption = syncModeSelectedOption;
+
+            ImGui::Combo( Lang::SyncMode, &syncModeSelectedOption, syncGroupOptions, 2 );
+
+            if( syncModeSelectedOption != previousSyncModeSelectedOption )
+            {
+                vkSetProfilerSyncModeEXT( m_pDevice->Handle, (VkProfilerSyncModeEXT)syncModeSelectedOption );
+            }
+        }
+
+        // Select time display unit.
+        {
+            static const char* timeUnitGroupOptions[] = {
+                Lang::Milliseconds,
+                Lang::Microseconds,
+                Lang::Nanoseconds };
+
+            static int timeUnitSelectedOption = 0;
+            int previousTimeUnitSelectedOption = timeUnitSelectedOption;
+
+            ImGui::Combo( Lang::TimeUnit, &timeUnitSelectedOption, timeUnitGroupOptions, 3 );
+
+            if( timeUnitSelectedOption != previousTimeUnitSelectedOption )
+            {
+                static float timeUnitFactors[] = {
+                    1.0f,
+                    1'000.0f,
+                    1'000'000.0f
+                };
+
+                m_TimestampDisplayUnit = timeUnitFactors[ timeUnitSelectedOption ];
+                m_pTimestampDisplayUnitStr = timeUnitGroupOptions[ timeUnitSelectedOption ];
+            }
+        }
+
+        // Select format of the saved traces.
+        {
+            static const char* traceFormatOptions[] = {
+                Lang::TraceFormatJson,
+                Lang::TraceFormatPerfetto };
+
+            int traceFormatSelectedOption = static_cast<int>( m_TraceFormat );
+
+            if( ImGui::Combo( Lang::TraceFormat, &traceFormatSelectedOption, traceFormatOptions, 2 ) )
+            {
+                m_TraceFormat = static_cast<DeviceProfilerTraceFormat>( traceFormatSelectedOption );
+                m_pTraceCaptureSerializer->SetFormat( m_TraceFormat );
+            }
+        }
+
+        // Display debug labels in frame browser.
+        ImGui::Checkbox( Lang::ShowDebugLabels, &m_ShowDebugLabels );
+
+        // Display shader capability badges in frame browser.
+        ImGui::Checkbox( Lang::ShowShaderCapabilities, &m_ShowShaderCapabilities );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        UpdateTimelineTab
+
+    Description:
+        Draw the last frames on the timeline, with one lane per queue.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::UpdateTimelineTab()
+    {
+        // Select number of displayed frames
+        int frameCount = static_cast<int>( m_TimelineFrameCount );
+        if( ImGui::SliderInt( Lang::Frames, &frameCount, 1, 64 ) )
+        {
+            m_TimelineFrameCount = static_cast<uint32_t>( frameCount );
+        }
+
+        // Restore the whole timeline view
+        if( (m_TimelineViewRange[ 0 ] > 0.0f) || (m_TimelineViewRange[ 1 ] < 1.0f) )
+        {
+            ImGui::SameLine();
+            if( ImGui::SmallButton( Lang::ResetZoom ) )
+            {
+                m_TimelineViewRange[ 0 ] = 0.0f;
+                m_TimelineViewRange[ 1 ] = 1.0f;
+                m_TimelineGeometryDirty = true;
+            }
+        }
+
+        if( m_TimelineLanes.empty() )
+        {
+            return;
+        }
+
+        const ImGuiStyle& style = ImGui::GetStyle();
+        const float laneHeight = ImGui::GetFrameHeightWithSpacing();
+        const float width = std::max( 1.0f, ImGui::GetContentRegionAvail().x );
+        const float height = laneHeight * m_TimelineLanes.size();
+
+        ImGui::InvisibleButton( "##Timeline", { width, height } );
+
+        ImVec2 viewRange = {
+            m_TimelineViewRange[ 0 ],
+            m_TimelineViewRange[ 1 ] };
+
+        if( ImGuiX::ZoomAndPan( ImGui::GetItemRectMin(), ImGui::GetItemRectMax(), &viewRange ) )
+        {
+            m_TimelineViewRange[ 0 ] = viewRange.x;
+            m_TimelineViewRange[ 1 ] = viewRange.y;
+            m_TimelineGeometryDirty = true;
+        }
+
+        if( m_TimelineGeometryDirty || (m_TimelineGeometryWidth != width) )
+        {
+            UpdateTimelineGeometry( width );
+        }
+
+        ImDrawList* pDrawList = ImGui::GetWindowDrawList();
+        const ImVec2 origin = ImGui::GetItemRectMin();
+        const ImVec2 mousePos = ImGui::GetIO().MousePos;
+        const bool hovered = ImGui::IsItemHovered();
+
+        for( size_t laneIndex = 0; laneIndex < m_TimelineLanes.size(); ++laneIndex )
+        {
+            const TimelineLane& lane = m_TimelineLanes[ laneIndex ];
+            const float laneTop = origin.y + (laneIndex * laneHeight);
+            const float laneBottom = laneTop + laneHeight - style.ItemSpacing.y;
+
+            pDrawList->AddRectFilled(
+                { origin.x, laneTop },
+                { origin.x + width, laneBottom },
+                ImGui::GetColorU32( ImGuiCol_FrameBg ) );
+
+            const uint32_t laneColor = (laneIndex == 0)
+                ? m_InternalPipelineColumnColor
+                : m_RenderPassColumnColor;
+
+            for( const TimelineRect& rect : m_TimelineGeometry[ laneIndex ] )
+            {
+                const TimelineBlock& block = lane.m_Blocks[ rect.m_BlockIndex ];
+                const ImVec2 rectMin = { origin.x + rect.m_Begin, laneTop };
+                const ImVec2 rectMax = { origin.x + std::max( rect.m_End, rect.m_Begin + 1.0f ), laneBottom };
+
+                // Alternate shades of the consecutive frames
+                uint32_t color = (block.m_FrameIndex & 1)
+                    ? ImGuiX::ColorLerp( laneColor, IM_COL32_BLACK, 0.25f )
+                    : laneColor;
+
+                if( hovered &&
+                    (mousePos.x >= rectMin.x) && (mousePos.x < rectMax.x) &&
+                    (mousePos.y >= rectMin.y) && (mousePos.y < rectMax.y) )
+                {
+                    color = ImGuiX::ColorLerp( color, IM_COL32_WHITE, 0.3f );
+                    DrawTimelineTooltip( lane, rect );
+                }
+
+                pDrawList->AddRectFilled( rectMin, rectMax, color );
+            }
+
+            if( laneIndex == 0 )
+            {
+                // Mark vkQueueSubmit calls on the CPU lane
+                const uint32_t markerColor = ImGui::GetColorU32( ImGuiCol_Text );
+
+                for( float x : m_TimelineSubmitMarkerGeometry )
+                {
+                    pDrawList->AddLine(
+                        { origin.x + x, laneTop },
+                        { origin.x + x, laneBottom },
+                        markerColor );
+                }
+            }
+
+            const std::string laneName = (laneIndex == 0)
+                ? Lang::CPU
+                : m_pStringSerializer->GetName( lane.m_Queue );
+
+            pDrawList->AddText(
+                { origin.x + style.FramePadding.x, laneTop + style.FramePadding.y },
+                ImGui::GetColorU32( ImGuiCol_Text ),
+                laneName.c_str() );
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        UpdateWatchList
+
+    Description:
+        Draw the history of GPU time and draw count of the pipelines pinned to the
+        watch list.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::UpdateWatchList()
+    {
+        if( m_WatchedPipelines.empty() )
+        {
+            ImGui::TextUnformatted( Lang::WatchListEmpty );
+            return;
+        }
+
+        if( ImGui::BeginTable( "##WatchListTable",
+                /* columns_count */ 6,
+                ImGuiTableFlags_NoClip |
+                (ImGuiTableFlags_Borders & ~ImGuiTableFlags_BordersInnerV) ) )
+        {
+            const float sparklineHeight = ImGui::GetTextLineHeight() * 2.0f;
+
+            // Headers
+            ImGui::TableSetupColumn( Lang::Name, ImGuiTableColumnFlags_WidthStretch );
+            ImGui::TableSetupColumn( Lang::GPUTime, ImGuiTableColumnFlags_WidthStretch );
+            ImGui::TableSetupColumn( Lang::Min, ImGuiTableColumnFlags_WidthFixed );
+            ImGui::TableSetupColumn( Lang::Mean, ImGuiTableColumnFlags_WidthFixed );
+            ImGui::TableSetupColumn( Lang::Max, ImGuiTableColumnFlags_WidthFixed );
+            ImGui::TableSetupColumn( Lang::Drawcalls, ImGuiTableColumnFlags_WidthStretch );
+            ImGui::TableHeadersRow();
+
+            // Entries are removed after the table is drawn
+            uint32_t unwatchedPipelineIndex = UINT32_MAX;
+
+            for( uint32_t i = 0; i < m_WatchedPipelines.size(); ++i )
+            {
+                const WatchedPipeline& watchedPipeline = m_WatchedPipelines[ i ];
+
+                // The ring buffer is filled from the beginning until it is full
+                const int sampleCount = static_cast<int>( watchedPipeline.m_HistorySize );
+                const int sampleOffset = (watchedPipeline.m_HistorySize < WatchedPipelineHistorySize)
+                    ? 0
+                    : static_cast<int>( watchedPipeline.m_HistoryOffset );
+
+                float minGpuTime = 0.0f;
+                float maxGpuTime = 0.0f;
+                float sumGpuTime = 0.0f;
+
+                if( sampleCount > 0 )
+                {
+                    minGpuTime = FLT_MAX;
+
+                    for( int sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex )
+                    {
+                        const float gpuTime = watchedPipeline.m_GpuTime[ sampleIndex ];
+                        minGpuTime = std::min( minGpuTime, gpuTime );
+                        maxGpuTime = std::max( maxGpuTime, gpuTime );
+                        sumGpuTime += gpuTime;
+                    }
+                }
+
+                ImGui::PushID( static_cast<int>( i ) );
+
+                ImGui::TableNextColumn();
+                bool watched = true;
+                if( ImGui::Checkbox( "##Watch", &watched ) )
+                {
+                    unwatchedPipelineIndex = i;
+                }
+                ImGui::SameLine();
+                ImGui::TextUnformatted( watchedPipeline.m_Name.c_str() );
+
+                ImGui::TableNextColumn();
+                ImGui::PlotLines( "##GpuTime",
+                    watchedPipeline.m_GpuTime.data(),
+                    sampleCount,
+                    sampleOffset,
+                    nullptr,
+                    0.0f,
+                    FLT_MAX,
+                    ImVec2( ImGui::GetContentRegionAvail().x, sparklineHeight ) );
+
+                ImGui::TableNextColumn();
+                ImGuiX::TextAlignRight( "%.2f %s", m_TimestampDisplayUnit * minGpuTime, m_pTimestampDisplayUnitStr );
+                ImGui::TableNextColumn();
+                ImGuiX::TextAlignRight( "%.2f %s", m_TimestampDisplayUnit * (sumGpuTime / std::max( sampleCount, 1 )), m_pTimestampDisplayUnitStr );
+                ImGui::TableNextColumn();
+                ImGuiX::TextAlignRight( "%.2f %s", m_TimestampDisplayUnit * maxGpuTime, m_pTimestampDisplayUnitStr );
+
+                // Overlay the draw count of the last frame
+                char drawCountStr[ 16 ] = {};
+                if( sampleCount > 0 )
+                {
+                    const uint32_t lastSampleIndex =
+                        (watchedPipeline.m_HistoryOffset + WatchedPipelineHistorySize - 1) % WatchedPipelineHistorySize;
+
+                    snprintf( drawCountStr, sizeof( drawCountStr ), "%.0f",
+                        watchedPipeline.m_DrawCount[ lastSampleIndex ] );
+                }
+
+                ImGui::TableNextColumn();
+                ImGui::PlotLines( "##DrawCount",
+                    watchedPipeline.m_DrawCount.data(),
+                    sampleCount,
+                    sampleOffset,
+                    drawCountStr,
+                    0.0f,
+                    FLT_MAX,
+                    ImVec2( ImGui::GetContentRegionAvail().x, sparklineHeight ) );
+
+                ImGui::PopID();
+            }
+
+            ImGui::EndTable();
+
+            if( unwatchedPipelineIndex != UINT32_MAX )
+            {
+                m_WatchedPipelines.erase( m_WatchedPipelines.begin() + unwatchedPipelineIndex );
+            }
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        AppendWatchedPipelinesFrame
+
+    Description:
+        Append GPU time and draw count of the watched pipelines in the frame to their
+        history. Pipelines not used in the frame get an empty sample.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::AppendWatchedPipelinesFrame( const DeviceProfilerFrameData& data )
+    {
+        if( m_WatchedPipelines.empty() )
+        {
+            return;
+        }
+
+        // Only the watched pipelines are collected
+        m_WatchedPipelineSamples.clear();
+
+        for( const WatchedPipeline& watchedPipeline : m_WatchedPipelines )
+        {
+            m_WatchedPipelineSamples.emplace( watchedPipeline.m_Hash, WatchedPipelineSample{ 0, 0 } );
+        }
+
+        for( const auto& submitBatch : data.m_Submits )
+        {
+            for( const auto& submit : submitBatch.m_Submits )
+            {
+                for( const auto& commandBuffer : submit.m_CommandBuffers )
+                {
+                    CollectWatchedPipelines( commandBuffer );
+                }
+            }
+        }
+
+        for( WatchedPipeline& watchedPipeline : m_WatchedPipelines )
+        {
+            const WatchedPipelineSample& sample = m_WatchedPipelineSamples.at( watchedPipeline.m_Hash );
+
+            watchedPipeline.m_GpuTime[ watchedPipeline.m_HistoryOffset ] = (sample.m_Ticks * m_TimestampPeriod).count();
+            watchedPipeline.m_DrawCount[ watchedPipeline.m_HistoryOffset ] = static_cast<float>( sample.m_DrawCount );
+
+            watchedPipeline.m_HistoryOffset = (watchedPipeline.m_HistoryOffset + 1) % WatchedPipelineHistorySize;
+            watchedPipeline.m_HistorySize = std::min( watchedPipeline.m_HistorySize + 1, WatchedPipelineHistorySize );
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        CollectWatchedPipelines
+
+    Description:
+        Accumulate statistics of the watched pipelines used in the command buffer.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::CollectWatchedPipelines( const DeviceProfilerCommandBufferData& commandBuffer )
+    {
+        for( const auto& renderPass : commandBuffer.m_RenderPasses )
+        {
+            for( const auto& subpass : renderPass.m_Subpasses )
+            {
+                if( subpass.m_Contents == VK_SUBPASS_CONTENTS_INLINE )
+                {
+                    for( const auto& pipeline : subpass.m_Pipelines )
+                    {
+                        CollectWatchedPipeline( pipeline );
+                    }
+                }
+
+                else if( subpass.m_Contents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS )
+                {
+                    for( const auto& secondaryCommandBuffer : subpass.m_SecondaryCommandBuffers )
+                    {
+                        CollectWatchedPipelines( secondaryCommandBuffer );
+                    }
+                }
+            }
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        CollectWatchedPipeline
+
+    Description:
+        Accumulate statistics of the pipeline if it is on the watch list.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::CollectWatchedPipeline( const DeviceProfilerPipelineData& pipeline )
+    {
+        auto it = m_WatchedPipelineSamples.find( pipeline.m_ShaderTuple.m_Hash );
+        if( it == m_WatchedPipelineSamples.end() )
+        {
+            return;
+        }
+
+        WatchedPipelineSample& sample = it->second;
+
+        // Timestamps are not collected in less detailed sampling modes
+        if( (pipeline.m_BeginTimestamp.m_Value != UINT64_MAX) &&
+            (pipeline.m_EndTimestamp.m_Value != UINT64_MAX) )
+        {
+            sample.m_Ticks += (pipeline.m_EndTimestamp.m_Value - pipeline.m_BeginTimestamp.m_Value);
+        }
+
+        for( const auto& drawcall : pipeline.m_Drawcalls )
+        {
+            // Count only commands executed by the pipeline, skip debug labels, copies, clears, etc.
+            switch( drawcall.GetPipelineType() )
+            {
+            case DeviceProfilerPipelineType::eGraphics:
+            case DeviceProfilerPipelineType::eCompute:
+            case DeviceProfilerPipelineType::eRayTracingKHR:
+                sample.m_DrawCount++;
+                break;
+
+            default:
+                break;
+            }
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        IsPipelineWatched
+
+    Description:
+        Check if the pipeline with the shader tuple hash is pinned to the watch list.
+
+    \***********************************************************************************/
+    bool ProfilerOverlayOutput::IsPipelineWatched( uint32_t hash ) const
+    {
+        return std::any_of( m_WatchedPipelines.begin(), m_WatchedPipelines.end(),
+            [hash]( const WatchedPipeline& watchedPipeline ) { return watchedPipeline.m_Hash == hash; } );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        SetPipelineWatched
+
+    Description:
+        Pin the pipeline to the watch list or remove it from the list.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::SetPipelineWatched( const DeviceProfilerPipelineData& pipeline, bool watched )
+    {
+        const uint32_t hash = pipeline.m_ShaderTuple.m_Hash;
+
+        if( !watched )
+        {
+            m_WatchedPipelines.erase(
+                std::remove_if( m_WatchedPipelines.begin(), m_WatchedPipelines.end(),
+                    [hash]( const WatchedPipeline& watchedPipeline ) { return watchedPipeline.m_Hash == hash; } ),
+                m_WatchedPipelines.end() );
+            return;
+        }
+
+        if( !IsPipelineWatched( hash ) )
+        {
+            WatchedPipeline watchedPipeline = {};
+            watchedPipeline.m_Hash = hash;
+            watchedPipeline.m_Name = m_pStringSerializer->GetName( pipeline );
+            watchedPipeline.m_GpuTime.resize( WatchedPipelineHistorySize );
+            watchedPipeline.m_DrawCount.resize( WatchedPipelineHistorySize );
+            m_WatchedPipelines.push_back( std::move( watchedPipeline ) );
+        }
+    }
+
+    /***********************************************************************************\
 
-            ImGui::TextUnformatted( Lang::CopyBufferCalls );
-            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_CopyBufferCount );
+    Function:
+        AppendTimelineFrame
 
-            ImGui::TextUnformatted( Lang::CopyBufferToImageCalls );
-            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_CopyBufferToImageCount );
+    Description:
+        Append CPU frame and GPU command buffers of the frame to the timeline.
+        GPU timestamps are aligned to the first vkQueueSubmit on each queue using
+        the synchronization timestamps.
 
-            ImGui::TextUnformatted( Lang::CopyImageCalls );
-            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_CopyImageCount );
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::AppendTimelineFrame( const DeviceProfilerFrameData& data )
+    {
+        if( m_TimelineOrigin == std::chrono::high_resolution_clock::time_point() )
+        {
+            m_TimelineOrigin = data.m_CPU.m_BeginTimestamp;
+        }
 
-            ImGui::TextUnformatted( Lang::CopyImageToBufferCalls );
-            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_CopyImageToBufferCount );
+        auto GetTimelineTimestamp = [this]( std::chrono::high_resolution_clock::time_point timestamp )
+        {
+            return std::chrono::duration<double, std::milli>( timestamp - m_TimelineOrigin ).count();
+        };
 
-            ImGui::TextUnformatted( Lang::PipelineBarriers );
-            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_PipelineBarrierCount );
+        if( m_TimelineLanes.empty() )
+        {
+            // CPU lane
+            m_TimelineLanes.push_back( TimelineLane{ VK_NULL_HANDLE } );
+        }
 
-            ImGui::TextUnformatted( Lang::ColorClearCalls );
-            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_ClearColorCount );
+        m_TimelineLanes.front().m_Blocks.push_back( {
+            GetTimelineTimestamp( data.m_CPU.m_BeginTimestamp ),
+            GetTimelineTimestamp( data.m_CPU.m_EndTimestamp ),
+            data.m_SequenceNumber,
+            VK_NULL_HANDLE } );
 
-            ImGui::TextUnformatted( Lang::DepthStencilClearCalls );
-            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_ClearDepthStencilCount );
+        // Timestamps of the first submit on each queue in the frame
+        std::unordered_map<VkQueue, std::pair<double, uint64_t>> queueTimestampOffsets;
 
-            ImGui::TextUnformatted( Lang::ResolveCalls );
-            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_ResolveCount );
+        for( const auto& submitBatch : data.m_Submits )
+        {
+            const double submitTimestamp = GetTimelineTimestamp( submitBatch.m_Timestamp );
 
-            ImGui::TextUnformatted( Lang::BlitCalls );
-            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_BlitImageCount );
+            m_TimelineSubmitMarkers.push_back( { submitTimestamp, data.m_SequenceNumber } );
 
-            ImGui::TextUnformatted( Lang::FillBufferCalls );
-            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_FillBufferCount );
+            auto lane = std::find_if( m_TimelineLanes.begin() + 1, m_TimelineLanes.end(),
+                [&submitBatch]( const TimelineLane& other ) { return other.m_Queue == submitBatch.m_Handle; } );
 
-            ImGui::TextUnformatted( Lang::UpdateBufferCalls );
-            ImGuiX::TextAlignRight( "%u", m_Data.m_Stats.m_UpdateBufferCount );
+            if( lane == m_TimelineLanes.end() )
+            {
+                lane = m_TimelineLanes.insert( m_TimelineLanes.end(), TimelineLane{ submitBatch.m_Handle } );
+            }
+
+            auto offsets = queueTimestampOffsets.find( submitBatch.m_Handle );
+
+            if( offsets == queueTimestampOffsets.end() )
+            {
+                uint64_t gpuTimestampOffset = 0;
+
+                auto syncTimestamp = data.m_SyncTimestamps.find( submitBatch.m_Handle );
+                if( syncTimestamp != data.m_SyncTimestamps.end() )
+                {
+                    gpuTimestampOffset = syncTimestamp->second;
+                }
+
+                // Use first submitted packet's begin timestamp as a reference if synchronization timestamps were not sent
+                if( (gpuTimestampOffset == 0) && !submitBatch.m_Submits.empty() )
+                {
+                    gpuTimestampOffset = submitBatch.m_Submits.front().m_BeginTimestamp.m_Value;
+                }
+
+                offsets = queueTimestampOffsets.emplace( submitBatch.m_Handle,
+                    std::make_pair( submitTimestamp, gpuTimestampOffset ) ).first;
+            }
+
+            const double cpuTimestampOffset = offsets->second.first;
+            const uint64_t gpuTimestampOffset = offsets->second.second;
+
+            auto GetAlignedGpuTimestamp = [&]( uint64_t timestamp )
+            {
+                const int64_t ticks = static_cast<int64_t>( timestamp - gpuTimestampOffset );
+                return cpuTimestampOffset + (ticks * static_cast<double>( m_TimestampPeriod.count() ));
+            };
+
+            for( const auto& submit : submitBatch.m_Submits )
+            {
+                for( const auto& commandBuffer : submit.m_CommandBuffers )
+                {
+                    // Timestamps are not collected in less detailed sampling modes
+                    if( (commandBuffer.m_BeginTimestamp.m_Value == UINT64_MAX) ||
+                        (commandBuffer.m_EndTimestamp.m_Value == UINT64_MAX) ||
+                        (commandBuffer.m_EndTimestamp.m_Value < commandBuffer.m_BeginTimestamp.m_Value) )
+                    {
+                        continue;
+                    }
+
+                    lane->m_Blocks.push_back( {
+                        GetAlignedGpuTimestamp( commandBuffer.m_BeginTimestamp.m_Value ),
+                        GetAlignedGpuTimestamp( commandBuffer.m_EndTimestamp.m_Value ),
+                        data.m_SequenceNumber,
+                        commandBuffer.m_Handle } );
+                }
+            }
+        }
+
+        // Remove frames that are no longer displayed
+        const uint64_t firstFrameIndex = (data.m_SequenceNumber >= m_TimelineFrameCount)
+            ? (data.m_SequenceNumber - m_TimelineFrameCount + 1)
+            : 0;
+
+        for( TimelineLane& lane : m_TimelineLanes )
+        {
+            while( !lane.m_Blocks.empty() && (lane.m_Blocks.front().m_FrameIndex < firstFrameIndex) )
+            {
+                lane.m_Blocks.pop_front();
+            }
         }
+
+        while( !m_TimelineSubmitMarkers.empty() && (m_TimelineSubmitMarkers.front().m_FrameIndex < firstFrameIndex) )
+        {
+            m_TimelineSubmitMarkers.pop_front();
+        }
+
+        // Remove lanes of the queues that have not been used recently
+        m_TimelineLanes.erase(
+            std::remove_if( m_TimelineLanes.begin() + 1, m_TimelineLanes.end(),
+                []( const TimelineLane& other ) { return other.m_Blocks.empty(); } ),
+            m_TimelineLanes.end() );
+
+        m_TimelineGeometryDirty = true;
     }
 
     /***********************************************************************************\
 
     Function:
-        UpdateSettingsTab
+        UpdateTimelineGeometry
 
     Description:
-        Updates "Settings" tab.
+        Convert timeline blocks within the visible range to rectangles, merging
+        blocks narrower than a pixel with their neighbors.
 
     \***********************************************************************************/
-    void ProfilerOverlayOutput::UpdateSettingsTab()
+    void ProfilerOverlayOutput::UpdateTimelineGeometry( float width )
     {
-        // Set interface scaling.
-        float interfaceScale = ImGui::GetIO().FontGlobalScale;
-        if( ImGui::InputFloat( "Interface scale", &interfaceScale ) )
+        m_TimelineGeometry.resize( m_TimelineLanes.size() );
+        m_TimelineSubmitMarkerGeometry.clear();
+
+        for( auto& rects : m_TimelineGeometry )
         {
-            ImGui::GetIO().FontGlobalScale = std::clamp( interfaceScale, 0.25f, 4.0f );
+            rects.clear();
         }
 
-        // Select synchronization mode
+        m_TimelineGeometryWidth = width;
+        m_TimelineGeometryDirty = false;
+
+        // Time range covered by the collected frames
+        double timelineBegin = DBL_MAX;
+        double timelineEnd = -DBL_MAX;
+
+        for( const TimelineLane& lane : m_TimelineLanes )
         {
-            static const char* syncGroupOptions[] = {
-                Lang::Present,
-                Lang::Submit };
+            for( const TimelineBlock& block : lane.m_Blocks )
+            {
+                timelineBegin = std::min( timelineBegin, block.m_Begin );
+                timelineEnd = std::max( timelineEnd, block.m_End );
+            }
+        }
 
-            static int syncModeSelectedOption = 0;
-            int previousSyncModeSelectedOption = syncModeSelectedOption;
+        if( timelineBegin >= timelineEnd )
+        {
+            return;
+        }
 
-            ImGui::Combo( Lang::SyncMode, &syncModeSelectedOption, syncGroupOptions, 2 );
+        const double timelineDuration = timelineEnd - timelineBegin;
+        const double viewBegin = timelineBegin + (timelineDuration * m_TimelineViewRange[ 0 ]);
+        const double viewEnd = timelineBegin + (timelineDuration * m_TimelineViewRange[ 1 ]);
+        const double scale = width / std::max( viewEnd - viewBegin, DBL_EPSILON );
 
-            if( syncModeSelectedOption != previousSyncModeSelectedOption )
+        for( size_t laneIndex = 0; laneIndex < m_TimelineLanes.size(); ++laneIndex )
+        {
+            const std::deque<TimelineBlock>& blocks = m_TimelineLanes[ laneIndex ].m_Blocks;
+            std::vector<TimelineRect>& rects = m_TimelineGeometry[ laneIndex ];
+
+            for( uint32_t blockIndex = 0; blockIndex < blocks.size(); ++blockIndex )
             {
-                vkSetProfilerSyncModeEXT( m_pDevice->Handle, (VkProfilerSyncModeEXT)syncModeSelectedOption );
+                const TimelineBlock& block = blocks[ blockIndex ];
+
+                if( (block.m_End < viewBegin) || (block.m_Begin > viewEnd) )
+                {
+                    continue;
+                }
+
+                const float x0 = static_cast<float>( (std::max( block.m_Begin, viewBegin ) - viewBegin) * scale );
+                const float x1 = static_cast<float>( (std::min( block.m_End, viewEnd ) - viewBegin) * scale );
+
+                if( !rects.empty() )
+                {
+                    TimelineRect& last = rects.back();
+
+                    // Merge blocks narrower than a pixel with the previous rectangle
+                    if( ((x0 - last.m_End) < 1.0f) &&
+                        (((x1 - x0) < 1.0f) || ((last.m_End - last.m_Begin) < 1.0f)) )
+                    {
+                        const TimelineBlock& representative = blocks[ last.m_BlockIndex ];
+
+                        if( (block.m_End - block.m_Begin) > (representative.m_End - representative.m_Begin) )
+                        {
+                            last.m_BlockIndex = blockIndex;
+                        }
+
+                        last.m_End = std::max( last.m_End, x1 );
+                        last.m_BlockCount++;
+                        continue;
+                    }
+                }
+
+                rects.push_back( { x0, x1, blockIndex, 1 } );
             }
         }
 
-        // Select time display unit.
+        for( const TimelineMarker& marker : m_TimelineSubmitMarkers )
         {
-            static const char* timeUnitGroupOptions[] = {
-                Lang::Milliseconds,
-                Lang::Microseconds,
-                Lang::Nanoseconds };
+            if( (marker.m_Timestamp < viewBegin) || (marker.m_Timestamp > viewEnd) )
+            {
+                continue;
+            }
 
-            static int timeUnitSelectedOption = 0;
-            int previousTimeUnitSelectedOption = timeUnitSelectedOption;
+            // Draw at most one marker per pixel
+            const float x = static_cast<float>( (marker.m_Timestamp - viewBegin) * scale );
 
-            ImGui::Combo( Lang::TimeUnit, &timeUnitSelectedOption, timeUnitGroupOptions, 3 );
+            if( m_TimelineSubmitMarkerGeometry.empty() ||
+                ((x - m_TimelineSubmitMarkerGeometry.back()) >= 1.0f) )
+            {
+                m_TimelineSubmitMarkerGeometry.push_back( x );
+            }
+        }
+    }
 
-            if( timeUnitSelectedOption != previousTimeUnitSelectedOption )
+    /***********************************************************************************\
+
+    Function:
+        DrawTimelineTooltip
+
+    Description:
+        Draw tooltip for hovered timeline rectangle.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::DrawTimelineTooltip( const TimelineLane& lane, const TimelineRect& rect )
+    {
+        const TimelineBlock& block = lane.m_Blocks[ rect.m_BlockIndex ];
+
+        ImGui::BeginTooltip();
+
+        if( block.m_CommandBuffer != VK_NULL_HANDLE )
+        {
+            ImGui::TextUnformatted( m_pStringSerializer->GetName( block.m_CommandBuffer ).c_str() );
+        }
+        else
+        {
+            ImGui::Text( "%s #%llu", Lang::Frame, static_cast<unsigned long long>( block.m_FrameIndex ) );
+        }
+
+        ImGui::Text( "%.2f %s",
+            m_TimestampDisplayUnit * (block.m_End - block.m_Begin),
+            m_pTimestampDisplayUnitStr );
+
+        // Rectangle represents more than one block at the current zoom level
+        if( rect.m_BlockCount > 1 )
+        {
+            ImGui::TextDisabled( Lang::MergedBlocksFmt, rect.m_BlockCount );
+        }
+
+        ImGui::EndTooltip();
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        UpdatePerformanceGraphLodColumns
+
+    Description:
+        Merge performance graph columns within the visible range into bars at least
+        PerformanceGraphMinColumnWidth pixels wide. Each merged bar is represented by
+        its longest column, so short spikes remain visible when the graph is zoomed out.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::UpdatePerformanceGraphLodColumns( float graphWidth )
+    {
+        m_PerformanceGraphLodColumns.clear();
+
+        // Total width of the graph in GPU cycles
+        float totalWidth = 0.0f;
+        for( const PerformanceGraphColumn& column : m_PerformanceGraphColumns )
+        {
+            totalWidth += std::max( 1.0f, column.x );
+        }
+
+        const float viewBegin = m_PerformanceGraphViewRange[ 0 ] * totalWidth;
+        const float viewEnd = m_PerformanceGraphViewRange[ 1 ] * totalWidth;
+
+        // Width of the narrowest bar in GPU cycles
+        const float minColumnWidth =
+            (viewEnd - viewBegin) * PerformanceGraphMinColumnWidth / std::max( 1.0f, graphWidth );
+
+        PerformanceGraphColumn bar = {};
+        float columnBegin = 0.0f;
+
+        for( const PerformanceGraphColumn& column : m_PerformanceGraphColumns )
+        {
+            const float columnEnd = columnBegin + std::max( 1.0f, column.x );
+            const float visibleBegin = std::max( columnBegin, viewBegin );
+            const float visibleEnd = std::min( columnEnd, viewEnd );
+
+            if( columnBegin >= viewEnd )
             {
-                static float timeUnitFactors[] = {
-                    1.0f,
-                    1'000.0f,
-                    1'000'000.0f
-                };
+                // Remaining columns are outside of the visible range
+                break;
+            }
 
-                m_TimestampDisplayUnit = timeUnitFactors[ timeUnitSelectedOption ];
-                m_pTimestampDisplayUnitStr = timeUnitGroupOptions[ timeUnitSelectedOption ];
+            columnBegin = columnEnd;
+
+            if( visibleEnd <= visibleBegin )
+            {
+                continue;
+            }
+
+            if( (bar.mergedColumnCount == 0) || (column.y > bar.y) )
+            {
+                const float barWidth = bar.x;
+                const uint32_t mergedColumnCount = bar.mergedColumnCount;
+
+                bar = column;
+                bar.x = barWidth;
+                bar.mergedColumnCount = mergedColumnCount;
+            }
+
+            bar.x += (visibleEnd - visibleBegin);
+            bar.mergedColumnCount++;
+
+            if( bar.x >= minColumnWidth )
+            {
+                m_PerformanceGraphLodColumns.push_back( bar );
+                bar = {};
             }
         }
 
-        // Display debug labels in frame browser.
-        ImGui::Checkbox( Lang::ShowDebugLabels, &m_ShowDebugLabels );
+        if( bar.mergedColumnCount > 0 )
+        {
+            m_PerformanceGraphLodColumns.push_back( bar );
+        }
 
-        // Display shader capability badges in frame browser.
-        ImGui::Checkbox( Lang::ShowShaderCapabilities, &m_ShowShaderCapabilities );
+        m_PerformanceGraphLodViewRange[ 0 ] = m_PerformanceGraphViewRange[ 0 ];
+        m_PerformanceGraphLodViewRange[ 1 ] = m_PerformanceGraphViewRange[ 1 ];
+        m_PerformanceGraphLodWidth = graphWidth;
+        m_PerformanceGraphLodColumnsDirty = false;
     }
 
     /***********************************************************************************\
@@ -2191,9 +3680,17 @@ namespace Profiler
         }
         }
 
-        ImGui::SetTooltip( "%s\n%.2f ms",
-            regionName.c_str(),
-            regionCycleCount * m_TimestampPeriod.count() );
+        ImGui::BeginTooltip();
+        ImGui::TextUnformatted( regionName.c_str() );
+        ImGui::Text( "%.2f ms", regionCycleCount * m_TimestampPeriod.count() );
+
+        // Bar represents more than one column at the current zoom level
+        if( data.mergedColumnCount > 1 )
+        {
+            ImGui::TextDisabled( Lang::MergedColumnsFmt, data.mergedColumnCount );
+        }
+
+        ImGui::EndTooltip();
     }
 
     /***********************************************************************************\
@@ -2276,408 +3773,616 @@ namespace Profiler
                 ImGui::PopStyleColor();
             }
 
-            m_SerializationWindowVisible = true;
+            m_SerializationWindowVisible = true;
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        ShowTraceSerializationResult
+
+    Description:
+        Display the serialization output window with the result message.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::ShowTraceSerializationResult( const DeviceProfilerTraceSerializationResult& result )
+    {
+        m_SerializationSucceeded = result.m_Succeeded;
+        m_SerializationMessage = result.m_Message;
+
+        // Display message box
+        m_SerializationFinishTimestamp = std::chrono::high_resolution_clock::now();
+        m_SerializationOutputWindowSize = { 0, 0 };
+        m_SerializationWindowVisible = false;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        UpdateFrameBrowserNodes
+
+    Description:
+        Flatten the frame data into the frame browser tree, sorted in the selected order.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::UpdateFrameBrowserNodes()
+    {
+        m_FrameBrowserNodes.clear();
+        m_FrameBrowserNodesDirty = false;
+        m_FrameBrowserNodesSortMode = m_FrameBrowserSortMode;
+        m_FrameBrowserVisibleNodesDirty = true;
+
+        FrameBrowserTreeNodeIndex index = {
+            0x0,
+            0xFFFF,
+            0xFFFF,
+            0xFFFF,
+            0xFFFF,
+            0xFFFF,
+            0xFFFF,
+            0xFFFF };
+
+        // Enumerate submits in frame
+        for( const auto& submitBatch : m_Data.m_Submits )
+        {
+            index.SubmitIndex = 0xFFFF;
+            index.PrimaryCommandBufferIndex = 0xFFFF;
+
+            const uint32_t submitBatchNodeIndex = AppendFrameBrowserNode(
+                FrameBrowserNodeType::eSubmitBatch, &submitBatch, index, UINT32_MAX );
+
+            index.SubmitIndex = 0;
+
+            for( const auto& submit : submitBatch.m_Submits )
+            {
+                uint32_t submitNodeIndex = submitBatchNodeIndex;
+
+                if( submitBatch.m_Submits.size() > 1 )
+                {
+                    // Single submits are printed inline
+                    submitNodeIndex = AppendFrameBrowserNode(
+                        FrameBrowserNodeType::eSubmit, &submit, index, submitBatchNodeIndex );
+                }
+
+                // Enumerate command buffers in submit
+                for( const auto& [pCommandBuffer, commandBufferIndex] : SortFrameBrowserData( submit.m_CommandBuffers ) )
+                {
+                    index.PrimaryCommandBufferIndex = commandBufferIndex;
+                    AppendFrameBrowserCommandBuffer( *pCommandBuffer, index, submitNodeIndex );
+                }
+
+                // Invalidate command buffer index
+                index.PrimaryCommandBufferIndex = 0xFFFF;
+
+                if( submitNodeIndex != submitBatchNodeIndex )
+                {
+                    m_FrameBrowserNodes[ submitNodeIndex ].m_DescendantCount =
+                        static_cast<uint32_t>( m_FrameBrowserNodes.size() ) - submitNodeIndex - 1;
+                }
+
+                index.SubmitIndex++;
+            }
+
+            m_FrameBrowserNodes[ submitBatchNodeIndex ].m_DescendantCount =
+                static_cast<uint32_t>( m_FrameBrowserNodes.size() ) - submitBatchNodeIndex - 1;
+
+            index.SubmitBatchIndex++;
         }
     }
 
     /***********************************************************************************\
 
     Function:
-        PrintCommandBuffer
+        UpdateFrameBrowserVisibleNodes
 
     Description:
-        Writes command buffer data to the overlay.
+        Collect rows of the frame browser which are not hidden in collapsed subtrees.
 
     \***********************************************************************************/
-    void ProfilerOverlayOutput::PrintCommandBuffer( const DeviceProfilerCommandBufferData& cmdBuffer, FrameBrowserTreeNodeIndex index )
+    void ProfilerOverlayOutput::UpdateFrameBrowserVisibleNodes()
     {
-        const uint64_t commandBufferTicks = (cmdBuffer.m_EndTimestamp.m_Value - cmdBuffer.m_BeginTimestamp.m_Value);
-
-        // Mark hotspots with color
-        DrawSignificanceRect( (float)commandBufferTicks / m_Data.m_Ticks, index );
-
-        char indexStr[ 2 * sizeof( index ) + 1 ] = {};
-        structtohex( indexStr, index );
-
-        if( (m_ScrollToSelectedFrameBrowserNode) &&
-            (m_SelectedFrameBrowserNodeIndex.SubmitBatchIndex == index.SubmitBatchIndex) &&
-            (m_SelectedFrameBrowserNodeIndex.SubmitIndex == index.SubmitIndex) &&
-            (((cmdBuffer.m_Level == VK_COMMAND_BUFFER_LEVEL_PRIMARY) &&
-                  (m_SelectedFrameBrowserNodeIndex.PrimaryCommandBufferIndex == index.PrimaryCommandBufferIndex)) ||
-                ((cmdBuffer.m_Level == VK_COMMAND_BUFFER_LEVEL_SECONDARY) &&
-                    (m_SelectedFrameBrowserNodeIndex.PrimaryCommandBufferIndex == index.PrimaryCommandBufferIndex) &&
-                    (m_SelectedFrameBrowserNodeIndex.RenderPassIndex == index.RenderPassIndex) &&
-                    (m_SelectedFrameBrowserNodeIndex.SubpassIndex == index.SubpassIndex) &&
-                    (m_SelectedFrameBrowserNodeIndex.SecondaryCommandBufferIndex == index.SecondaryCommandBufferIndex))) )
-        {
-            // Tree contains selected node
-            ImGui::SetNextItemOpen( true );
-            ImGui::SetScrollHereY();
-        }
-
-        if( ImGui::TreeNode( indexStr, "%s", m_pStringSerializer->GetName( cmdBuffer.m_Handle ).c_str() ) )
-        {
-            // Command buffer opened
-            PrintDuration( cmdBuffer );
+        m_FrameBrowserVisibleNodes.clear();
+        m_FrameBrowserVisibleNodesDirty = false;
+        m_FrameBrowserNodesShowDebugLabels = m_ShowDebugLabels;
 
-            // Sort frame browser data
-            std::list<const DeviceProfilerRenderPassData*> pRenderPasses =
-                SortFrameBrowserData( cmdBuffer.m_RenderPasses );
+        const uint32_t nodeCount = static_cast<uint32_t>( m_FrameBrowserNodes.size() );
 
-            // RenderPassIndex may be already set if we're processing secondary command buffer with RENDER_PASS_CONTINUE_BIT set.
-            const bool renderPassContinue = (index.RenderPassIndex != 0xFFFF);
+        for( uint32_t i = 0; i < nodeCount; )
+        {
+            const FrameBrowserNode& node = m_FrameBrowserNodes[ i ];
 
-            if( !renderPassContinue )
+            if( IsFrameBrowserNodeVisible( node ) )
             {
-                index.RenderPassIndex = 0;
+                m_FrameBrowserVisibleNodes.push_back( i );
             }
 
-            // Enumerate render passes in command buffer
-            for( const DeviceProfilerRenderPassData* pRenderPass : pRenderPasses )
+            if( (node.m_Type != FrameBrowserNodeType::eDrawcall) &&
+                (m_FrameBrowserOpenNodes.count( GetFrameBrowserNodeKey( node ) ) == 0) )
             {
-                PrintRenderPass( *pRenderPass, index );
-                index.RenderPassIndex++;
+                // Skip the collapsed subtree
+                i += node.m_DescendantCount + 1;
+            }
+            else
+            {
+                i++;
             }
-
-            ImGui::TreePop();
         }
-        else
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        OpenSelectedFrameBrowserNode
+
+    Description:
+        Expand all nodes on the path to the selected node.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::OpenSelectedFrameBrowserNode()
+    {
+        for( const FrameBrowserNode& node : m_FrameBrowserNodes )
         {
-            // Command buffer collapsed
-            PrintDuration( cmdBuffer );
+            if( node.m_Index == m_SelectedFrameBrowserNodeIndex )
+            {
+                for( uint32_t parentIndex = node.m_ParentIndex; parentIndex != UINT32_MAX; )
+                {
+                    const FrameBrowserNode& parent = m_FrameBrowserNodes[ parentIndex ];
+                    m_FrameBrowserOpenNodes.insert( GetFrameBrowserNodeKey( parent ) );
+                    parentIndex = parent.m_ParentIndex;
+                }
+
+                m_FrameBrowserVisibleNodesDirty = true;
+                break;
+            }
         }
     }
 
     /***********************************************************************************\
 
     Function:
-        PrintRenderPassCommand
+        AppendFrameBrowserNode
 
     Description:
-        Writes render pass command data to the overlay.
-        Render pass commands include vkCmdBeginRenderPass, vkCmdEndRenderPass, as well as
-        dynamic rendering counterparts: vkCmdBeginRendering, etc.
+        Add node to the frame browser tree. Returns index of the new node.
 
     \***********************************************************************************/
-    template<typename Data>
-    void ProfilerOverlayOutput::PrintRenderPassCommand( const Data& data, bool dynamic, FrameBrowserTreeNodeIndex& index, uint32_t drawcallIndex )
+    uint32_t ProfilerOverlayOutput::AppendFrameBrowserNode(
+        FrameBrowserNodeType type,
+        const void* pData,
+        const FrameBrowserTreeNodeIndex& index,
+        uint32_t parentIndex )
     {
-        const uint64_t commandTicks = (data.m_EndTimestamp.m_Value - data.m_BeginTimestamp.m_Value);
-
-        index.DrawcallIndex = drawcallIndex;
+        FrameBrowserNode node = {};
+        node.m_Type = type;
+        node.m_ParentIndex = parentIndex;
+        node.m_pData = pData;
+        node.m_Index = index;
 
-        if( (m_ScrollToSelectedFrameBrowserNode) &&
-            (m_SelectedFrameBrowserNodeIndex == index) )
+        if( parentIndex != UINT32_MAX )
         {
-            ImGui::SetScrollHereY();
+            node.m_Depth = m_FrameBrowserNodes[ parentIndex ].m_Depth + 1;
         }
 
-        // Mark hotspots with color
-        DrawSignificanceRect( (float)commandTicks / m_Data.m_Ticks, index );
+        m_FrameBrowserNodes.push_back( node );
+        return static_cast<uint32_t>( m_FrameBrowserNodes.size() - 1 );
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        AppendFrameBrowserCommandBuffer
+
+    Description:
+        Add command buffer subtree to the frame browser.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::AppendFrameBrowserCommandBuffer( const DeviceProfilerCommandBufferData& cmdBuffer, FrameBrowserTreeNodeIndex index, uint32_t parentIndex )
+    {
+        const uint32_t nodeIndex = AppendFrameBrowserNode(
+            FrameBrowserNodeType::eCommandBuffer, &cmdBuffer, index, parentIndex );
 
-        index.DrawcallIndex = 0xFFFF;
+        // RenderPassIndex may be already set if we're processing secondary command buffer with RENDER_PASS_CONTINUE_BIT set.
+        const bool renderPassContinue = (index.RenderPassIndex != 0xFFFF);
+        const uint16_t firstRenderPassIndex = renderPassContinue ? index.RenderPassIndex : 0;
 
-        // Print command's name
-        ImGui::TextUnformatted( m_pStringSerializer->GetName( data, dynamic ).c_str() );
+        // Enumerate render passes in command buffer
+        for( const auto& [pRenderPass, renderPassIndex] : SortFrameBrowserData( cmdBuffer.m_RenderPasses ) )
+        {
+            index.RenderPassIndex = static_cast<uint16_t>( firstRenderPassIndex + renderPassIndex );
+            AppendFrameBrowserRenderPass( *pRenderPass, index, nodeIndex );
+        }
 
-        PrintDuration( data );
+        m_FrameBrowserNodes[ nodeIndex ].m_DescendantCount =
+            static_cast<uint32_t>( m_FrameBrowserNodes.size() ) - nodeIndex - 1;
     }
 
     /***********************************************************************************\
 
     Function:
-        PrintRenderPass
+        AppendFrameBrowserRenderPass
 
     Description:
-        Writes render pass data to the overlay.
+        Add render pass subtree to the frame browser.
 
     \***********************************************************************************/
-    void ProfilerOverlayOutput::PrintRenderPass( const DeviceProfilerRenderPassData& renderPass, FrameBrowserTreeNodeIndex index )
+    void ProfilerOverlayOutput::AppendFrameBrowserRenderPass( const DeviceProfilerRenderPassData& renderPass, FrameBrowserTreeNodeIndex index, uint32_t parentIndex )
     {
         const bool isValidRenderPass = (renderPass.m_Type != DeviceProfilerRenderPassType::eNone);
 
+        // At least one subpass must be present
+        assert( !renderPass.m_Subpasses.empty() );
+
+        uint32_t nodeIndex = parentIndex;
+
         if( isValidRenderPass )
         {
-            const uint64_t renderPassTicks = (renderPass.m_EndTimestamp.m_Value - renderPass.m_BeginTimestamp.m_Value);
+            nodeIndex = AppendFrameBrowserNode(
+                FrameBrowserNodeType::eRenderPass, &renderPass, index, parentIndex );
 
-            // Mark hotspots with color
-            DrawSignificanceRect( (float)renderPassTicks / m_Data.m_Ticks, index );
+            if( renderPass.HasBeginCommand() )
+            {
+                FrameBrowserTreeNodeIndex commandIndex = index;
+                commandIndex.DrawcallIndex = 0;
+
+                AppendFrameBrowserNode(
+                    FrameBrowserNodeType::eRenderPassBegin, &renderPass, commandIndex, nodeIndex );
+            }
         }
 
-        char indexStr[ 2 * sizeof( index ) + 1 ] = {};
-        structtohex( indexStr, index );
+        // SubpassIndex may be already set if we're processing secondary command buffer with RENDER_PASS_CONTINUE_BIT set.
+        const bool renderPassContinue = (index.SubpassIndex != 0xFFFF);
+        const uint16_t firstSubpassIndex = renderPassContinue ? index.SubpassIndex : 0;
 
-        // At least one subpass must be present
-        assert( !renderPass.m_Subpasses.empty() );
+        // Enumerate subpasses
+        FrameBrowserTreeNodeIndex subpassIndex = index;
 
-        if( (m_ScrollToSelectedFrameBrowserNode) &&
-            (m_SelectedFrameBrowserNodeIndex.SubmitBatchIndex == index.SubmitBatchIndex) &&
-            (m_SelectedFrameBrowserNodeIndex.SubmitIndex == index.SubmitIndex) &&
-            (m_SelectedFrameBrowserNodeIndex.PrimaryCommandBufferIndex == index.PrimaryCommandBufferIndex) &&
-            (m_SelectedFrameBrowserNodeIndex.RenderPassIndex == index.RenderPassIndex) &&
-            ((index.SecondaryCommandBufferIndex == 0xFFFF) ||
-                (m_SelectedFrameBrowserNodeIndex.SecondaryCommandBufferIndex == index.SecondaryCommandBufferIndex)) )
+        for( const auto& [pSubpass, i] : SortFrameBrowserData( renderPass.m_Subpasses ) )
         {
-            // Tree contains selected node
-            ImGui::SetNextItemOpen( true );
-            ImGui::SetScrollHereY();
+            subpassIndex.SubpassIndex = static_cast<uint16_t>( firstSubpassIndex + i );
+            AppendFrameBrowserSubpass( *pSubpass, subpassIndex, nodeIndex, (renderPass.m_Subpasses.size() == 1) );
         }
 
-        bool inRenderPassSubtree;
         if( isValidRenderPass )
         {
-            inRenderPassSubtree = ImGui::TreeNode( indexStr, "%s",
-                m_pStringSerializer->GetName( renderPass ).c_str() );
-        }
-        else
-        {
-            // Print render pass inline.
-            inRenderPassSubtree = true;
-        }
-
-        if( inRenderPassSubtree )
-        {
-            // Render pass subtree opened
-            if( isValidRenderPass )
+            if( renderPass.HasEndCommand() )
             {
-                PrintDuration( renderPass );
+                FrameBrowserTreeNodeIndex commandIndex = index;
+                commandIndex.DrawcallIndex = 1;
 
-                if( renderPass.HasBeginCommand() )
-                {
-                    PrintRenderPassCommand( renderPass.m_Begin, renderPass.m_Dynamic, index, 0 );
-                }
+                AppendFrameBrowserNode(
+                    FrameBrowserNodeType::eRenderPassEnd, &renderPass, commandIndex, nodeIndex );
             }
 
-            // Sort frame browser data
-            std::list<const DeviceProfilerSubpassData*> pSubpasses =
-                SortFrameBrowserData( renderPass.m_Subpasses );
+            m_FrameBrowserNodes[ nodeIndex ].m_DescendantCount =
+                static_cast<uint32_t>( m_FrameBrowserNodes.size() ) - nodeIndex - 1;
+        }
+    }
 
-            // SubpassIndex may be already set if we're processing secondary command buffer with RENDER_PASS_CONTINUE_BIT set.
-            const bool renderPassContinue = (index.SubpassIndex != 0xFFFF);
+    /***********************************************************************************\
 
-            if( !renderPassContinue )
-            {
-                index.SubpassIndex = 0;
-            }
+    Function:
+        AppendFrameBrowserSubpass
 
-            // Enumerate subpasses
-            for( const DeviceProfilerSubpassData* pSubpass : pSubpasses )
-            {
-                PrintSubpass( *pSubpass, index, (pSubpasses.size() == 1) );
-                index.SubpassIndex++;
-            }
+    Description:
+        Add subpass subtree to the frame browser.
 
-            if( !renderPassContinue )
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::AppendFrameBrowserSubpass( const DeviceProfilerSubpassData& subpass, FrameBrowserTreeNodeIndex index, uint32_t parentIndex, bool isOnlySubpass )
+    {
+        // Only subpasses and implicit subpasses are printed inline
+        const bool printSubpassInline = isOnlySubpass || (subpass.m_Index == -1);
+
+        uint32_t nodeIndex = parentIndex;
+
+        if( !printSubpassInline )
+        {
+            nodeIndex = AppendFrameBrowserNode(
+                FrameBrowserNodeType::eSubpass, &subpass, index, parentIndex );
+        }
+
+        if( subpass.m_Contents == VK_SUBPASS_CONTENTS_INLINE )
+        {
+            // Enumerate pipelines in subpass
+            for( const auto& [pPipeline, pipelineIndex] : SortFrameBrowserData( subpass.m_Pipelines ) )
             {
-                index.SubpassIndex = 0xFFFF;
+                index.PipelineIndex = pipelineIndex;
+                AppendFrameBrowserPipeline( *pPipeline, index, nodeIndex );
             }
+        }
 
-            if( isValidRenderPass )
+        else if( subpass.m_Contents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS )
+        {
+            // Enumerate command buffers in subpass
+            for( const auto& [pCommandBuffer, commandBufferIndex] : SortFrameBrowserData( subpass.m_SecondaryCommandBuffers ) )
             {
-                if( renderPass.HasEndCommand() )
-                {
-                    PrintRenderPassCommand( renderPass.m_End, renderPass.m_Dynamic, index, 1 );
-                }
-
-                ImGui::TreePop();
+                index.SecondaryCommandBufferIndex = commandBufferIndex;
+                AppendFrameBrowserCommandBuffer( *pCommandBuffer, index, nodeIndex );
             }
         }
 
-        if( isValidRenderPass && !inRenderPassSubtree )
+        if( !printSubpassInline )
         {
-            // Render pass collapsed
-            PrintDuration( renderPass );
+            m_FrameBrowserNodes[ nodeIndex ].m_DescendantCount =
+                static_cast<uint32_t>( m_FrameBrowserNodes.size() ) - nodeIndex - 1;
         }
     }
 
     /***********************************************************************************\
 
     Function:
-        PrintSubpass
+        AppendFrameBrowserPipeline
 
     Description:
-        Writes subpass data to the overlay.
+        Add pipeline subtree to the frame browser.
 
     \***********************************************************************************/
-    void ProfilerOverlayOutput::PrintSubpass( const DeviceProfilerSubpassData& subpass, FrameBrowserTreeNodeIndex index, bool isOnlySubpass )
+    void ProfilerOverlayOutput::AppendFrameBrowserPipeline( const DeviceProfilerPipelineData& pipeline, FrameBrowserTreeNodeIndex index, uint32_t parentIndex )
     {
-        const uint64_t subpassTicks = (subpass.m_EndTimestamp.m_Value - subpass.m_BeginTimestamp.m_Value);
-        bool inSubpassSubtree = false;
-
-        if( !isOnlySubpass )
-        {
-            // Mark hotspots with color
-            DrawSignificanceRect( (float)subpassTicks / m_Data.m_Ticks, index );
-
-            char indexStr[ 2 * sizeof( index ) + 1 ] = {};
-            structtohex( indexStr, index );
+        // Internal pipelines are printed inline
+        const bool printPipelineInline =
+            (pipeline.m_Handle == VK_NULL_HANDLE) ||
+            ((pipeline.m_ShaderTuple.m_Hash & 0xFFFF) == 0);
 
-            if( (m_ScrollToSelectedFrameBrowserNode) &&
-                (m_SelectedFrameBrowserNodeIndex.SubmitBatchIndex == index.SubmitBatchIndex) &&
-                (m_SelectedFrameBrowserNodeIndex.SubmitIndex == index.SubmitIndex) &&
-                (m_SelectedFrameBrowserNodeIndex.PrimaryCommandBufferIndex == index.PrimaryCommandBufferIndex) &&
-                (m_SelectedFrameBrowserNodeIndex.SecondaryCommandBufferIndex == index.SecondaryCommandBufferIndex) &&
-                (m_SelectedFrameBrowserNodeIndex.RenderPassIndex == index.RenderPassIndex) &&
-                (m_SelectedFrameBrowserNodeIndex.SubpassIndex == index.SubpassIndex) )
-            {
-                // Tree contains selected node
-                ImGui::SetNextItemOpen( true );
-                ImGui::SetScrollHereY();
-            }
+        uint32_t nodeIndex = parentIndex;
 
-            inSubpassSubtree =
-                (subpass.m_Index != -1) &&
-                (ImGui::TreeNode( indexStr, "Subpass #%u", subpass.m_Index ));
+        if( !printPipelineInline )
+        {
+            nodeIndex = AppendFrameBrowserNode(
+                FrameBrowserNodeType::ePipeline, &pipeline, index, parentIndex );
         }
 
-        if( inSubpassSubtree )
+        // Enumerate drawcalls in pipeline
+        for( const auto& [pDrawcall, drawcallIndex] : SortFrameBrowserData( pipeline.m_Drawcalls ) )
         {
-            // Subpass subtree opened
-            PrintDuration( subpass );
+            index.DrawcallIndex = drawcallIndex;
+            AppendFrameBrowserNode( FrameBrowserNodeType::eDrawcall, pDrawcall, index, nodeIndex );
         }
 
-        if( inSubpassSubtree ||
-            isOnlySubpass ||
-            (subpass.m_Index == -1) )
+        if( !printPipelineInline )
         {
-            if( subpass.m_Contents == VK_SUBPASS_CONTENTS_INLINE )
-            {
-                // Sort frame browser data
-                std::list<const DeviceProfilerPipelineData*> pPipelines =
-                    SortFrameBrowserData( subpass.m_Pipelines );
-
-                index.PipelineIndex = 0;
+            m_FrameBrowserNodes[ nodeIndex ].m_DescendantCount =
+                static_cast<uint32_t>( m_FrameBrowserNodes.size() ) - nodeIndex - 1;
+        }
+    }
 
-                // Enumerate pipelines in subpass
-                for( const DeviceProfilerPipelineData* pPipeline : pPipelines )
-                {
-                    PrintPipeline( *pPipeline, index );
-                    index.PipelineIndex++;
-                }
-            }
+    /***********************************************************************************\
 
-            else if( subpass.m_Contents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS )
-            {
-                // Sort command buffers
-                std::list<const DeviceProfilerCommandBufferData*> pCommandBuffers =
-                    SortFrameBrowserData( subpass.m_SecondaryCommandBuffers );
+    Function:
+        GetFrameBrowserNodeKey
 
-                index.SecondaryCommandBufferIndex = 0;
+    Description:
+        Returns key identifying the node in m_FrameBrowserOpenNodes.
+        Keys are preserved between frames, so the tree keeps its expanded nodes.
 
-                // Enumerate command buffers in subpass
-                for( const DeviceProfilerCommandBufferData* pCommandBuffer : pCommandBuffers )
-                {
-                    PrintCommandBuffer( *pCommandBuffer, index );
-                    index.SecondaryCommandBufferIndex++;
-                }
-            }
-        }
+    \***********************************************************************************/
+    uint64_t ProfilerOverlayOutput::GetFrameBrowserNodeKey( const FrameBrowserNode& node )
+    {
+        // FNV-1a hash of the node type and index
+        uint64_t key = (0xcbf29ce484222325ULL ^ static_cast<uint8_t>( node.m_Type )) * 0x100000001b3ULL;
 
-        if( inSubpassSubtree )
+        const uint8_t* pIndexBytes = reinterpret_cast<const uint8_t*>( &node.m_Index );
+        for( size_t i = 0; i < sizeof( node.m_Index ); ++i )
         {
-            // Finish subpass tree
-            ImGui::TreePop();
+            key = (key ^ pIndexBytes[ i ]) * 0x100000001b3ULL;
         }
 
-        if( !inSubpassSubtree && !isOnlySubpass && (subpass.m_Index != -1) )
+        return key;
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        IsFrameBrowserNodeVisible
+
+    Description:
+        Check if the node produces a row in the frame browser.
+
+    \***********************************************************************************/
+    bool ProfilerOverlayOutput::IsFrameBrowserNodeVisible( const FrameBrowserNode& node ) const
+    {
+        if( node.m_Type == FrameBrowserNodeType::eDrawcall )
         {
-            // Subpass collapsed
-            PrintDuration( subpass );
+            const DeviceProfilerDrawcall& drawcall = *static_cast<const DeviceProfilerDrawcall*>( node.m_pData );
+
+            if( drawcall.GetPipelineType() == DeviceProfilerPipelineType::eDebug )
+            {
+                // Debug labels are not printed if frame browser is sorted out of submission order
+                return (m_ShowDebugLabels) &&
+                    (m_FrameBrowserSortMode == FrameBrowserSortMode::eSubmissionOrder) &&
+                    (drawcall.m_Payload.m_DebugLabel.GetName() != nullptr);
+            }
         }
+
+        return true;
     }
 
     /***********************************************************************************\
 
     Function:
-        PrintPipeline
+        PrintFrameBrowserNode
 
     Description:
-        Writes pipeline data to the overlay.
+        Writes single row of the frame browser to the overlay.
 
     \***********************************************************************************/
-    void ProfilerOverlayOutput::PrintPipeline( const DeviceProfilerPipelineData& pipeline, FrameBrowserTreeNodeIndex index )
+    void ProfilerOverlayOutput::PrintFrameBrowserNode( uint32_t nodeIndex )
     {
-        const uint64_t pipelineTicks = (pipeline.m_EndTimestamp.m_Value - pipeline.m_BeginTimestamp.m_Value);
+        const FrameBrowserNode& node = m_FrameBrowserNodes[ nodeIndex ];
 
-        const bool printPipelineInline =
-            (pipeline.m_Handle == VK_NULL_HANDLE) ||
-            ((pipeline.m_ShaderTuple.m_Hash & 0xFFFF) == 0);
+        ImGui::PushID( static_cast<int>( nodeIndex ) );
+
+        switch( node.m_Type )
+        {
+        case FrameBrowserNodeType::eSubmitBatch:
+        {
+            const DeviceProfilerSubmitBatchData& submitBatch = *static_cast<const DeviceProfilerSubmitBatchData*>( node.m_pData );
+            const std::string queueName = m_pStringSerializer->GetName( submitBatch.m_Handle );
 
-        bool inPipelineSubtree = false;
+            char label[ 256 ] = {};
+            ProfilerStringFunctions::Format( label, "vkQueueSubmit(%s, %u)",
+                queueName.c_str(),
+                static_cast<uint32_t>( submitBatch.m_Submits.size() ) );
 
-        if( !printPipelineInline )
+            PrintFrameBrowserTreeNode( node, label );
+            break;
+        }
+
+        case FrameBrowserNodeType::eSubmit:
+        {
+            char label[ 32 ] = {};
+            ProfilerStringFunctions::Format( label, "VkSubmitInfo #%u", node.m_Index.SubmitIndex );
+
+            PrintFrameBrowserTreeNode( node, label );
+            break;
+        }
+
+        case FrameBrowserNodeType::eCommandBuffer:
         {
+            const DeviceProfilerCommandBufferData& cmdBuffer = *static_cast<const DeviceProfilerCommandBufferData*>( node.m_pData );
+            const uint64_t commandBufferTicks = (cmdBuffer.m_EndTimestamp.m_Value - cmdBuffer.m_BeginTimestamp.m_Value);
+
             // Mark hotspots with color
-            DrawSignificanceRect( (float)pipelineTicks / m_Data.m_Ticks, index );
+            DrawSignificanceRect( (float)commandBufferTicks / m_Data.m_Ticks, node.m_Index );
+
+            PrintFrameBrowserTreeNode( node, m_pStringSerializer->GetName( cmdBuffer.m_Handle ).c_str() );
+            PrintDuration( cmdBuffer );
+            break;
+        }
 
-            char indexStr[ 2 * sizeof( index ) + 1 ] = {};
-            structtohex( indexStr, index );
+        case FrameBrowserNodeType::eRenderPass:
+        {
+            const DeviceProfilerRenderPassData& renderPass = *static_cast<const DeviceProfilerRenderPassData*>( node.m_pData );
+            const uint64_t renderPassTicks = (renderPass.m_EndTimestamp.m_Value - renderPass.m_BeginTimestamp.m_Value);
 
-            if( (m_ScrollToSelectedFrameBrowserNode) &&
-                (m_SelectedFrameBrowserNodeIndex.SubmitBatchIndex == index.SubmitBatchIndex) &&
-                (m_SelectedFrameBrowserNodeIndex.SubmitIndex == index.SubmitIndex) &&
-                (m_SelectedFrameBrowserNodeIndex.PrimaryCommandBufferIndex == index.PrimaryCommandBufferIndex) &&
-                (m_SelectedFrameBrowserNodeIndex.SecondaryCommandBufferIndex == index.SecondaryCommandBufferIndex) &&
-                (m_SelectedFrameBrowserNodeIndex.RenderPassIndex == index.RenderPassIndex) &&
-                (m_SelectedFrameBrowserNodeIndex.SubpassIndex == index.SubpassIndex) &&
-                (m_SelectedFrameBrowserNodeIndex.PipelineIndex == index.PipelineIndex) )
-            {
-                // Tree contains selected node
-                ImGui::SetNextItemOpen( true );
-                ImGui::SetScrollHereY();
-            }
+            // Mark hotspots with color
+            DrawSignificanceRect( (float)renderPassTicks / m_Data.m_Ticks, node.m_Index );
 
-            inPipelineSubtree =
-                (ImGui::TreeNode( indexStr, "%s", m_pStringSerializer->GetName( pipeline ).c_str() ));
+            PrintFrameBrowserTreeNode( node, m_pStringSerializer->GetName( renderPass ).c_str() );
+            PrintDuration( renderPass );
+            break;
         }
 
-        if( m_ShowShaderCapabilities )
+        case FrameBrowserNodeType::eRenderPassBegin:
+        case FrameBrowserNodeType::eRenderPassEnd:
         {
-            if( pipeline.m_UsesRayQuery )
+            // Render pass commands include vkCmdBeginRenderPass, vkCmdEndRenderPass, as well as
+            // dynamic rendering counterparts: vkCmdBeginRendering, etc.
+            const DeviceProfilerRenderPassData& renderPass = *static_cast<const DeviceProfilerRenderPassData*>( node.m_pData );
+
+            if( node.m_Type == FrameBrowserNodeType::eRenderPassBegin )
             {
-                static ImU32 rayQueryCapabilityColor = ImGui::GetColorU32({ 0.52f, 0.32f, 0.1f, 1.f });
-                DrawShaderCapabilityBadge( rayQueryCapabilityColor, "RQ", "Ray Query" );
+                const uint64_t commandTicks = (renderPass.m_Begin.m_EndTimestamp.m_Value - renderPass.m_Begin.m_BeginTimestamp.m_Value);
+                DrawSignificanceRect( (float)commandTicks / m_Data.m_Ticks, node.m_Index );
+
+                ImGui::SetCursorPosX( ImGui::GetCursorPosX() + node.m_Depth * ImGui::GetStyle().IndentSpacing );
+                ImGui::TextUnformatted( m_pStringSerializer->GetName( renderPass.m_Begin, renderPass.m_Dynamic ).c_str() );
+                PrintDuration( renderPass.m_Begin );
             }
-            if( pipeline.m_UsesRayTracing )
+            else
             {
-                static ImU32 rayTracingCapabilityColor = ImGui::GetColorU32({ 0.1f, 0.43f, 0.52f, 1.0f });
-                DrawShaderCapabilityBadge( rayTracingCapabilityColor, "RT", "Ray Tracing" );
+                const uint64_t commandTicks = (renderPass.m_End.m_EndTimestamp.m_Value - renderPass.m_End.m_BeginTimestamp.m_Value);
+                DrawSignificanceRect( (float)commandTicks / m_Data.m_Ticks, node.m_Index );
+
+                ImGui::SetCursorPosX( ImGui::GetCursorPosX() + node.m_Depth * ImGui::GetStyle().IndentSpacing );
+                ImGui::TextUnformatted( m_pStringSerializer->GetName( renderPass.m_End, renderPass.m_Dynamic ).c_str() );
+                PrintDuration( renderPass.m_End );
             }
+            break;
         }
 
-        if( inPipelineSubtree )
+        case FrameBrowserNodeType::eSubpass:
         {
-            // Pipeline subtree opened
-            PrintDuration( pipeline );
+            const DeviceProfilerSubpassData& subpass = *static_cast<const DeviceProfilerSubpassData*>( node.m_pData );
+            const uint64_t subpassTicks = (subpass.m_EndTimestamp.m_Value - subpass.m_BeginTimestamp.m_Value);
+
+            // Mark hotspots with color
+            DrawSignificanceRect( (float)subpassTicks / m_Data.m_Ticks, node.m_Index );
+
+            char label[ 32 ] = {};
+            ProfilerStringFunctions::Format( label, "Subpass #%u", subpass.m_Index );
+
+            PrintFrameBrowserTreeNode( node, label );
+            PrintDuration( subpass );
+            break;
         }
 
-        if( inPipelineSubtree || printPipelineInline )
+        case FrameBrowserNodeType::ePipeline:
         {
-            // Sort frame browser data
-            std::list<const DeviceProfilerDrawcall*> pDrawcalls =
-                SortFrameBrowserData( pipeline.m_Drawcalls );
+            const DeviceProfilerPipelineData& pipeline = *static_cast<const DeviceProfilerPipelineData*>( node.m_pData );
+            const uint64_t pipelineTicks = (pipeline.m_EndTimestamp.m_Value - pipeline.m_BeginTimestamp.m_Value);
 
-            index.DrawcallIndex = 0;
+            // Mark hotspots with color
+            DrawSignificanceRect( (float)pipelineTicks / m_Data.m_Ticks, node.m_Index );
 
-            // Enumerate drawcalls in pipeline
-            for( const DeviceProfilerDrawcall* pDrawcall : pDrawcalls )
+            PrintFrameBrowserTreeNode( node, m_pStringSerializer->GetName( pipeline ).c_str() );
+
+            if( m_ShowShaderCapabilities )
             {
-                PrintDrawcall( *pDrawcall, index );
-                index.DrawcallIndex++;
+                if( pipeline.m_UsesRayQuery )
+                {
+                    static ImU32 rayQueryCapabilityColor = ImGui::GetColorU32({ 0.52f, 0.32f, 0.1f, 1.f });
+                    DrawShaderCapabilityBadge( rayQueryCapabilityColor, "RQ", "Ray Query" );
+                }
+                if( pipeline.m_UsesRayTracing )
+                {
+                    static ImU32 rayTracingCapabilityColor = ImGui::GetColorU32({ 0.1f, 0.43f, 0.52f, 1.0f });
+                    DrawShaderCapabilityBadge( rayTracingCapabilityColor, "RT", "Ray Tracing" );
+                }
             }
+
+            PrintDuration( pipeline );
+            break;
         }
 
-        if( inPipelineSubtree )
+        case FrameBrowserNodeType::eDrawcall:
         {
-            // Finish pipeline subtree
-            ImGui::TreePop();
+            ImGui::SetCursorPosX( ImGui::GetCursorPosX() + node.m_Depth * ImGui::GetStyle().IndentSpacing );
+            PrintDrawcall( *static_cast<const DeviceProfilerDrawcall*>( node.m_pData ), node.m_Index );
+            break;
+        }
         }
 
-        if( !inPipelineSubtree && !printPipelineInline )
+        ImGui::PopID();
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        PrintFrameBrowserTreeNode
+
+    Description:
+        Writes expandable row of the frame browser. Expanded state of the rows is kept
+        in m_FrameBrowserOpenNodes instead of ImGui storage, so the rows which are not
+        drawn can be skipped.
+
+    \***********************************************************************************/
+    bool ProfilerOverlayOutput::PrintFrameBrowserTreeNode( const FrameBrowserNode& node, const char* pLabel )
+    {
+        const uint64_t key = GetFrameBrowserNodeKey( node );
+        const bool isOpen = (m_FrameBrowserOpenNodes.count( key ) != 0);
+
+        ImGui::SetCursorPosX( ImGui::GetCursorPosX() + node.m_Depth * ImGui::GetStyle().IndentSpacing );
+        ImGui::SetNextItemOpen( isOpen );
+
+        const bool open = ImGui::TreeNodeEx( "##FrameBrowserNode", ImGuiTreeNodeFlags_NoTreePushOnOpen, "%s", pLabel );
+
+        if( open != isOpen )
         {
-            // Pipeline collapsed
-            PrintDuration( pipeline );
+            // Node toggled
+            if( open )
+            {
+                m_FrameBrowserOpenNodes.insert( key );
+            }
+            else
+            {
+                m_FrameBrowserOpenNodes.erase( key );
+            }
+
+            m_FrameBrowserVisibleNodesDirty = true;
         }
+
+        return open;
     }
 
     /***********************************************************************************\
@@ -2689,18 +4394,12 @@ namespace Profiler
         Writes drawcall data to the overlay.
 
     \***********************************************************************************/
-    void ProfilerOverlayOutput::PrintDrawcall( const DeviceProfilerDrawcall& drawcall, FrameBrowserTreeNodeIndex index )
+    void ProfilerOverlayOutput::PrintDrawcall( const DeviceProfilerDrawcall& drawcall, const FrameBrowserTreeNodeIndex& index )
     {
         if( drawcall.GetPipelineType() != DeviceProfilerPipelineType::eDebug )
         {
             const uint64_t drawcallTicks = (drawcall.m_EndTimestamp.m_Value - drawcall.m_BeginTimestamp.m_Value);
 
-            if( (m_ScrollToSelectedFrameBrowserNode) &&
-                (m_SelectedFrameBrowserNodeIndex == index) )
-            {
-                ImGui::SetScrollHereY();
-            }
-
             // Mark hotspots with color
             DrawSignificanceRect( (float)drawcallTicks / m_Data.m_Ticks, index );
 
@@ -2712,7 +4411,81 @@ namespace Profiler
         else
         {
             // Draw debug label
-            PrintDebugLabel( drawcall.m_Payload.m_DebugLabel.m_pName, drawcall.m_Payload.m_DebugLabel.m_Color );
+            PrintDebugLabel( drawcall.m_Payload.m_DebugLabel.GetName(), drawcall.m_Payload.m_DebugLabel.m_Color );
+        }
+    }
+
+    /***********************************************************************************\
+
+    Function:
+        PrintDebugLabelTree
+
+    Description:
+        Print the debug label node and its children. Nodes are stored in depth-first
+        order, so children of the node immediately follow it.
+
+    \***********************************************************************************/
+    void ProfilerOverlayOutput::PrintDebugLabelTree( uint32_t index )
+    {
+        const DeviceProfilerDebugLabelData& debugLabel = m_Data.m_DebugLabels[ index ];
+        const float tickPeriod = m_TimestampPeriod.count();
+
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+
+        ImVec2 cursorPosition = ImGui::GetCursorScreenPos();
+        const ImVec2 rectSize(
+            cursorPosition.x + 8,
+            cursorPosition.y + ImGui::GetTextLineHeight() );
+
+        ImDrawList* pDrawList = ImGui::GetWindowDrawList();
+        pDrawList->AddRectFilled( cursorPosition, rectSize,
+            ImGui::GetColorU32( *reinterpret_cast<const ImVec4*>(debugLabel.m_Color) ) );
+        pDrawList->AddRect( cursorPosition, rectSize, ImGui::GetColorU32( ImGuiCol_Border ) );
+
+        cursorPosition.x += 12;
+        ImGui::SetCursorScreenPos( cursorPosition );
+
+        ImGuiTreeNodeFlags treeNodeFlags = ImGuiTreeNodeFlags_SpanFullWidth;
+        if( debugLabel.m_ChildCount == 0 )
+        {
+            treeNodeFlags |= ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+        }
+
+        // Path id is stable across frames, so the node state is preserved
+        const bool open = ImGui::TreeNodeEx( (const void*)(uintptr_t)debugLabel.m_PathId, treeNodeFlags,
+            "%s", debugLabel.m_Name.c_str() );
+
+        if( ImGui::IsItemHovered() )
+        {
+            ImGui::SetTooltip( "%u x\n%s: %u (%s: %u)",
+                debugLabel.m_InstanceCount,
+                Lang::DrawCalls,
+                debugLabel.m_InclusiveDrawCount,
+                Lang::Exclusive,
+                debugLabel.m_ExclusiveDrawCount );
+        }
+
+        ImGui::TableNextColumn();
+        ImGuiX::TextAlignRight( ImGuiX::TableGetColumnWidth(), "%.2f ms", debugLabel.m_InclusiveTicks * tickPeriod );
+
+        ImGui::TableNextColumn();
+        ImGuiX::TextAlignRight( ImGuiX::TableGetColumnWidth(), "%.2f ms", debugLabel.m_ExclusiveTicks * tickPeriod );
+
+        ImGui::TableNextColumn();
+        ImGuiX::TextAlignRight( ImGuiX::TableGetColumnWidth(), "%u", debugLabel.m_InclusiveDrawCount );
+
+        if( open && (debugLabel.m_ChildCount > 0) )
+        {
+            uint32_t childIndex = index + 1;
+
+            for( uint32_t i = 0; i < debugLabel.m_ChildCount; ++i )
+            {
+                PrintDebugLabelTree( childIndex );
+                childIndex += m_Data.m_DebugLabels[ childIndex ].m_DescendantCount + 1;
+            }
+
+            ImGui::TreePop();
         }
     }
 
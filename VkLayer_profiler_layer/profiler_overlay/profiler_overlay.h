@@ -27,10 +27,14 @@
 #include "profiler_layer_objects/VkSwapchainKhr_object.h"
 #include "profiler_helpers/profiler_time_helpers.h"
 #include <vulkan/vk_layer.h>
+#include <algorithm>
+#include <deque>
 #include <list>
 #include <vector>
 #include <stack>
 #include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 // Public interface
 #include "profiler_ext/VkProfilerEXT.h"
@@ -48,6 +52,7 @@ namespace Profiler
 {
     class DeviceProfiler;
     struct ProfilerSubmitData;
+    enum class DeviceProfilerTraceFormat;
 
     /***********************************************************************************\
 
@@ -65,6 +70,7 @@ namespace Profiler
 
         VkResult Initialize(
             VkDevice_Object& device,
+            const DeviceProfiler& profiler,
             VkQueue_Object& graphicsQueue,
             VkSwapchainKhr_Object& swapchain,
             const VkSwapchainCreateInfoKHR* pCreateInfo );
@@ -84,8 +90,14 @@ namespace Profiler
             const VkQueue_Object& presentQueue,
             VkPresentInfoKHR* pPresentInfo );
 
+        void BeginTraceCapture( uint32_t maxFrameCount = 0 );
+        void EndTraceCapture();
+
+        void SetUpdateRate( uint32_t updatesPerSecond );
+
     private:
         VkDevice_Object* m_pDevice;
+        const DeviceProfiler* m_pProfiler;
         VkQueue_Object* m_pGraphicsQueue;
         VkSwapchainKhr_Object* m_pSwapchain;
 
@@ -110,6 +122,14 @@ namespace Profiler
         std::vector<VkFence> m_CommandFences;
         std::vector<VkSemaphore> m_CommandSemaphores;
 
+        // Interface is updated at most m_UpdateRate times per second (0 - on every present).
+        // Command buffers recorded for the swapchain images are resubmitted until the next update.
+        uint32_t m_UpdateRate;
+        uint64_t m_DrawDataIndex;
+        std::vector<uint64_t> m_CommandBufferDrawDataIndices;
+        std::chrono::high_resolution_clock::time_point m_LastUpdateTimestamp;
+        bool m_WantCaptureInput;
+
         uint32_t m_ActiveMetricsSetIndex;
 
         struct VendorMetricsSet
@@ -145,6 +165,11 @@ namespace Profiler
 
         HistogramGroupMode m_HistogramGroupMode;
 
+        DeviceProfilerRollingStatisticsType m_RollingStatisticsType;
+
+        // Computed only when the rolling statistics are displayed
+        ContainerType<DeviceProfilerRollingStatisticsData> m_RollingStatistics;
+
         struct FrameBrowserTreeNodeIndex
         {
             uint16_t SubmitBatchIndex;
@@ -182,6 +207,41 @@ namespace Profiler
         FrameBrowserTreeNodeIndex m_SelectedFrameBrowserNodeIndex;
         bool m_ScrollToSelectedFrameBrowserNode;
 
+        enum class FrameBrowserNodeType : uint8_t
+        {
+            eSubmitBatch,
+            eSubmit,
+            eCommandBuffer,
+            eRenderPass,
+            eRenderPassBegin,
+            eRenderPassEnd,
+            eSubpass,
+            ePipeline,
+            eDrawcall
+        };
+
+        // Node of the flattened frame browser tree.
+        // Nodes are stored in depth-first order, so descendants of the node immediately follow it.
+        struct FrameBrowserNode
+        {
+            FrameBrowserNodeType m_Type;
+            uint16_t m_Depth;
+            uint32_t m_ParentIndex;
+            uint32_t m_DescendantCount;
+            const void* m_pData;
+            FrameBrowserTreeNodeIndex m_Index;
+        };
+
+        // Frame browser tree is rebuilt only when the data or the sort mode changes,
+        // and only the rows scrolled into view are drawn.
+        std::vector<FrameBrowserNode> m_FrameBrowserNodes;
+        std::vector<uint32_t> m_FrameBrowserVisibleNodes;
+        std::unordered_set<uint64_t> m_FrameBrowserOpenNodes;
+        bool m_FrameBrowserNodesDirty;
+        bool m_FrameBrowserVisibleNodesDirty;
+        FrameBrowserSortMode m_FrameBrowserNodesSortMode;
+        bool m_FrameBrowserNodesShowDebugLabels;
+
         std::chrono::high_resolution_clock::time_point m_SelectionUpdateTimestamp;
         std::chrono::high_resolution_clock::time_point m_SerializationFinishTimestamp;
 
@@ -199,6 +259,12 @@ namespace Profiler
         std::chrono::milliseconds m_SerializationOutputWindowDuration;
         std::chrono::milliseconds m_SerializationOutputWindowFadeOutDuration;
 
+        // Multi-frame trace capture session
+        class DeviceProfilerTraceSerializer* m_pTraceCaptureSerializer;
+
+        // Format of the saved trace files
+        DeviceProfilerTraceFormat m_TraceFormat;
+
         // Performance graph colors
         uint32_t m_RenderPassColumnColor;
         uint32_t m_GraphicsPipelineColumnColor;
@@ -206,6 +272,92 @@ namespace Profiler
         uint32_t m_RayTracingPipelineColumnColor;
         uint32_t m_InternalPipelineColumnColor;
 
+        // Performance graph columns are enumerated once per snapshot, and merged into bars
+        // wide enough to be visible only when the zoom level or the graph width changes.
+        struct PerformanceGraphColumn;
+        std::vector<PerformanceGraphColumn> m_PerformanceGraphColumns;
+        std::vector<PerformanceGraphColumn> m_PerformanceGraphLodColumns;
+        bool m_PerformanceGraphColumnsDirty;
+        bool m_PerformanceGraphLodColumnsDirty;
+        HistogramGroupMode m_PerformanceGraphColumnsGroupMode;
+        float m_PerformanceGraphViewRange[ 2 ];
+        float m_PerformanceGraphLodViewRange[ 2 ];
+        float m_PerformanceGraphLodWidth;
+
+        // Span of the CPU frame or the GPU command buffer on the timeline,
+        // in milliseconds since the first frame displayed by the overlay.
+        struct TimelineBlock
+        {
+            double m_Begin;
+            double m_End;
+            uint64_t m_FrameIndex;
+            VkCommandBuffer m_CommandBuffer;
+        };
+
+        // vkQueueSubmit call on the CPU lane.
+        struct TimelineMarker
+        {
+            double m_Timestamp;
+            uint64_t m_FrameIndex;
+        };
+
+        // Lane 0 displays CPU frames, other lanes display command buffers executed on the queues.
+        struct TimelineLane
+        {
+            VkQueue m_Queue;
+            std::deque<TimelineBlock> m_Blocks;
+        };
+
+        // Blocks are bucketed into the rectangles at least 1 pixel wide.
+        // Each rectangle is represented by its longest block.
+        struct TimelineRect
+        {
+            float m_Begin;
+            float m_End;
+            uint32_t m_BlockIndex;
+            uint32_t m_BlockCount;
+        };
+
+        // Timeline of the last frames is collected on every present while the timeline tab is
+        // visible, and the geometry is rebuilt only when new frames are added, the view is zoomed
+        // or panned, or the width changes.
+        std::vector<TimelineLane> m_TimelineLanes;
+        std::deque<TimelineMarker> m_TimelineSubmitMarkers;
+        std::chrono::high_resolution_clock::time_point m_TimelineOrigin;
+        uint32_t m_TimelineFrameCount;
+        std::vector<std::vector<TimelineRect>> m_TimelineGeometry;
+        std::vector<float> m_TimelineSubmitMarkerGeometry;
+        bool m_TimelineVisible;
+        bool m_TimelineGeometryDirty;
+        float m_TimelineGeometryWidth;
+        float m_TimelineViewRange[ 2 ];
+
+        // Pipeline pinned to the watch list. Pipelines are identified by the shader tuple
+        // hash, so the entry survives recreation of the pipeline by the application.
+        struct WatchedPipeline
+        {
+            uint32_t m_Hash;
+            std::string m_Name;
+            std::vector<float> m_GpuTime;
+            std::vector<float> m_DrawCount;
+            uint32_t m_HistoryOffset;
+            uint32_t m_HistorySize;
+        };
+
+        // Statistics of the watched pipeline in a single frame.
+        struct WatchedPipelineSample
+        {
+            uint64_t m_Ticks;
+            uint32_t m_DrawCount;
+        };
+
+        // History of the watched pipelines is collected on every present.
+        std::vector<WatchedPipeline> m_WatchedPipelines;
+        std::unordered_map<uint32_t, WatchedPipelineSample> m_WatchedPipelineSamples;
+
+        // Allocations and frees of the last frames.
+        std::deque<DeviceProfilerMemoryChurnData> m_MemoryChurnHistory;
+
         class DeviceProfilerStringSerializer* m_pStringSerializer;
 
         VkResult InitializeImGuiWindowHooks( const VkSwapchainCreateInfoKHR* );
@@ -219,9 +371,10 @@ namespace Profiler
         void UpdateMemoryTab();
         void UpdateStatisticsTab();
         void UpdateSettingsTab();
+        void UpdateTimelineTab();
 
         // Performance graph helpers
-        struct PerformanceGraphColumn;
+        void UpdatePerformanceGraphLodColumns( float );
         void GetPerformanceGraphColumns( std::vector<PerformanceGraphColumn>& ) const;
         void GetPerformanceGraphColumns( const DeviceProfilerCommandBufferData&, FrameBrowserTreeNodeIndex, std::vector<PerformanceGraphColumn>& ) const;
         void GetPerformanceGraphColumns( const DeviceProfilerRenderPassData&, FrameBrowserTreeNodeIndex, std::vector<PerformanceGraphColumn>& ) const;
@@ -230,19 +383,44 @@ namespace Profiler
         void DrawPerformanceGraphLabel( const ImGuiX::HistogramColumnData& );
         void SelectPerformanceGraphColumn( const ImGuiX::HistogramColumnData& );
 
+        // Timeline helpers
+        void AppendTimelineFrame( const DeviceProfilerFrameData& );
+        void UpdateTimelineGeometry( float );
+        void DrawTimelineTooltip( const TimelineLane&, const TimelineRect& );
+
+        // Watch list helpers
+        void UpdateWatchList();
+        void AppendWatchedPipelinesFrame( const DeviceProfilerFrameData& );
+        void CollectWatchedPipelines( const DeviceProfilerCommandBufferData& );
+        void CollectWatchedPipeline( const DeviceProfilerPipelineData& );
+        bool IsPipelineWatched( uint32_t ) const;
+        void SetPipelineWatched( const DeviceProfilerPipelineData&, bool );
+
+        // Memory tab helpers
+        void UpdateMemoryChurn();
+        void AppendMemoryChurnFrame( const DeviceProfilerFrameData& );
+
         // Trace serialization helpers
         void DrawTraceSerializationOutputWindow();
+        void ShowTraceSerializationResult( const struct DeviceProfilerTraceSerializationResult& );
 
         // Frame browser helpers
-        void PrintCommandBuffer( const DeviceProfilerCommandBufferData&, FrameBrowserTreeNodeIndex );
-        void PrintRenderPass( const DeviceProfilerRenderPassData&, FrameBrowserTreeNodeIndex );
-        void PrintSubpass( const DeviceProfilerSubpassData&, FrameBrowserTreeNodeIndex, bool );
-        void PrintPipeline( const DeviceProfilerPipelineData&, FrameBrowserTreeNodeIndex );
-        void PrintDrawcall( const DeviceProfilerDrawcall&, FrameBrowserTreeNodeIndex );
+        void UpdateFrameBrowserNodes();
+        void UpdateFrameBrowserVisibleNodes();
+        void OpenSelectedFrameBrowserNode();
+        uint32_t AppendFrameBrowserNode( FrameBrowserNodeType, const void*, const FrameBrowserTreeNodeIndex&, uint32_t );
+        void AppendFrameBrowserCommandBuffer( const DeviceProfilerCommandBufferData&, FrameBrowserTreeNodeIndex, uint32_t );
+        void AppendFrameBrowserRenderPass( const DeviceProfilerRenderPassData&, FrameBrowserTreeNodeIndex, uint32_t );
+        void AppendFrameBrowserSubpass( const DeviceProfilerSubpassData&, FrameBrowserTreeNodeIndex, uint32_t, bool );
+        void AppendFrameBrowserPipeline( const DeviceProfilerPipelineData&, FrameBrowserTreeNodeIndex, uint32_t );
+        static uint64_t GetFrameBrowserNodeKey( const FrameBrowserNode& );
+        bool IsFrameBrowserNodeVisible( const FrameBrowserNode& ) const;
+
+        void PrintFrameBrowserNode( uint32_t );
+        bool PrintFrameBrowserTreeNode( const FrameBrowserNode&, const char* );
+        void PrintDrawcall( const DeviceProfilerDrawcall&, const FrameBrowserTreeNodeIndex& );
         void PrintDebugLabel( const char*, const float[ 4 ] );
-
-        template<typename Data>
-        void PrintRenderPassCommand( const Data& data, bool dynamic, FrameBrowserTreeNodeIndex& index, uint32_t drawcallIndex );
+        void PrintDebugLabelTree( uint32_t );
 
         void DrawSignificanceRect( float, const FrameBrowserTreeNodeIndex& );
         void DrawShaderCapabilityBadge( uint32_t color, const char* shortName, const char* longName );
@@ -251,14 +429,18 @@ namespace Profiler
         void PrintDuration( const Data& data );
 
         // Sort frame browser data
+        // Returns pointers to the elements paired with their positions in submission order.
         template<typename Data>
         auto SortFrameBrowserData( const Data& data ) const
         {
             using Subdata = typename Data::value_type;
-            std::list<const Subdata*> pSortedData;
+            using SortedSubdata = std::pair<const Subdata*, uint16_t>;
+            std::vector<SortedSubdata> sortedData;
+            sortedData.reserve( data.size() );
 
+            uint16_t index = 0;
             for( const auto& subdata : data )
-                pSortedData.push_back( &subdata );
+                sortedData.push_back( { &subdata, index++ } );
 
             switch( m_FrameBrowserSortMode )
             {
@@ -266,15 +448,15 @@ namespace Profiler
                 break; // No sorting in submission order view
 
             case FrameBrowserSortMode::eDurationDescending:
-                pSortedData.sort( []( const Subdata* a, const Subdata* b )
-                    { return DurationDesc( *a, *b ); } ); break;
+                std::stable_sort( sortedData.begin(), sortedData.end(), []( const SortedSubdata& a, const SortedSubdata& b )
+                    { return DurationDesc( *a.first, *b.first ); } ); break;
 
             case FrameBrowserSortMode::eDurationAscending:
-                pSortedData.sort( []( const Subdata* a, const Subdata* b )
-                    { return DurationAsc( *a, *b ); } ); break;
+                std::stable_sort( sortedData.begin(), sortedData.end(), []( const SortedSubdata& a, const SortedSubdata& b )
+                    { return DurationAsc( *a.first, *b.first ); } ); break;
             }
 
-            return pSortedData;
+            return sortedData;
         }
     };
 }
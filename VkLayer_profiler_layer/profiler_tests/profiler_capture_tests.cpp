@@ -0,0 +1,104 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "profiler_testing_common.h"
+#include "profiler_cli/profiler_capture.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace Profiler
+{
+    class ProfilerCaptureULT : public testing::Test
+    {
+    protected:
+        std::filesystem::path WriteFile( const char* pFilename, const char* pContent )
+        {
+            const std::filesystem::path path = std::filesystem::temp_directory_path() / pFilename;
+
+            std::ofstream file( path, std::ios::out | std::ios::binary | std::ios::trunc );
+            file << pContent;
+            file.close();
+
+            m_Files.push_back( path );
+            return path;
+        }
+
+        void TearDown() override
+        {
+            for( const auto& path : m_Files )
+            {
+                std::error_code ec;
+                std::filesystem::remove( path, ec );
+            }
+        }
+
+    private:
+        std::vector<std::filesystem::path> m_Files;
+    };
+
+    TEST_F( ProfilerCaptureULT, SameUnitsInTraceAndCsv )
+    {
+        // Two frames, 16ms each, with a pipeline taking 2ms and 3ms.
+        // Chrome trace timestamps and durations are in microseconds.
+        const std::filesystem::path traceFile = WriteFile( "profiler_capture_ult.json", R"({
+            "traceEvents": [
+                { "name": "Pipeline", "cat": "Pipelines", "ph": "X", "ts": 1000, "dur": 2000, "pid": 0, "tid": "Queue" },
+                { "name": "vkQueuePresentKHR", "ph": "i", "ts": 16000, "pid": 0, "tid": "Queue" },
+                { "name": "Pipeline", "cat": "Pipelines", "ph": "B", "ts": 17000, "pid": 0, "tid": "Queue" },
+                { "name": "Pipeline", "cat": "Pipelines", "ph": "E", "ts": 20000, "pid": 0, "tid": "Queue" },
+                { "name": "vkQueuePresentKHR", "ph": "i", "ts": 32000, "pid": 0, "tid": "Queue" }
+            ]
+        })" );
+
+        // Same frames saved in the pipeline statistics file, in milliseconds.
+        const std::filesystem::path csvFile = WriteFile( "profiler_capture_ult.csv",
+            "frame,pipeline_hash,pipeline_name,pipeline_gpu_time_ms,draw_count,dispatch_count,frame_gpu_time_ms,frame_cpu_time_ms\n"
+            "0,00000001,\"Pipeline\",2.000,1,0,2.000,16.000\n"
+            "1,00000001,\"Pipeline\",3.000,1,0,3.000,16.000\n" );
+
+        ProfilerCapture trace;
+        ASSERT_TRUE( trace.Load( traceFile ) ) << trace.GetErrorMessage();
+
+        ProfilerCapture csv;
+        ASSERT_TRUE( csv.Load( csvFile ) ) << csv.GetErrorMessage();
+
+        ASSERT_EQ( 2u, trace.GetFrameCount() );
+        ASSERT_EQ( 2u, csv.GetFrameCount() );
+
+        for( uint32_t i = 0; i < 2; ++i )
+        {
+            EXPECT_FLOAT_EQ( 16.f, trace.GetFrameDurations()[ i ] );
+            EXPECT_FLOAT_EQ( csv.GetFrameDurations()[ i ], trace.GetFrameDurations()[ i ] );
+        }
+
+        const auto traceStats = trace.GetRegionStats( ProfilerCaptureRegionType::ePipeline );
+        const auto csvStats = csv.GetRegionStats( ProfilerCaptureRegionType::ePipeline );
+        ASSERT_EQ( 1u, traceStats.size() );
+        ASSERT_EQ( 1u, csvStats.size() );
+
+        EXPECT_EQ( csvStats[ 0 ].m_Name, traceStats[ 0 ].m_Name );
+        EXPECT_FLOAT_EQ( 2.5f, traceStats[ 0 ].m_Mean );
+        EXPECT_FLOAT_EQ( csvStats[ 0 ].m_Mean, traceStats[ 0 ].m_Mean );
+        EXPECT_FLOAT_EQ( csvStats[ 0 ].m_Max, traceStats[ 0 ].m_Max );
+    }
+}
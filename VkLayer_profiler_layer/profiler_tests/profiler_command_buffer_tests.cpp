@@ -21,6 +21,8 @@
 #include "profiler_testing_common.h"
 #include "profiler_vulkan_simple_triangle.h"
 
+#include <functional>
+
 #define VALIDATE_RANGES( parentRange, childRange ) \
     { const auto parentRange##_Time = (parentRange.m_EndTimestamp.m_Value - parentRange.m_BeginTimestamp.m_Value); \
       const auto childRange##_Time = (childRange.m_EndTimestamp.m_Value - childRange.m_BeginTimestamp.m_Value); \
@@ -300,4 +302,122 @@ namespace Profiler
             EXPECT_EQ( 1, cmdBufferData.m_Stats.m_PipelineBarrierCount );
         }
     }
+
+    TEST_F( ProfilerCommandBufferULT, DebugLabelTree )
+    {
+        // Create simple triangle app
+        VulkanSimpleTriangle simpleTriangle( Vk, IDT, DT );
+        VkCommandBuffer commandBuffer = {};
+
+        auto BeginLabel = [&]( const char* pName )
+        {
+            VkDebugUtilsLabelEXT label = {};
+            label.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+            label.pLabelName = pName;
+            DT.CmdBeginDebugUtilsLabelEXT( commandBuffer, &label );
+        };
+
+        auto RecordAndSubmit = [&]( const std::function<void()>& recordLabels )
+        {
+            VkCommandBufferBeginInfo beginInfo = {};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            ASSERT_EQ( VK_SUCCESS, DT.BeginCommandBuffer( commandBuffer, &beginInfo ) );
+
+            VkRenderPassBeginInfo renderPassBeginInfo = {};
+            renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            renderPassBeginInfo.renderPass = simpleTriangle.RenderPass;
+            renderPassBeginInfo.renderArea = simpleTriangle.RenderArea;
+            renderPassBeginInfo.framebuffer = simpleTriangle.Framebuffer;
+            DT.CmdBeginRenderPass( commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE );
+            DT.CmdBindPipeline( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, simpleTriangle.Pipeline );
+
+            recordLabels();
+
+            DT.CmdEndRenderPass( commandBuffer );
+            ASSERT_EQ( VK_SUCCESS, DT.EndCommandBuffer( commandBuffer ) );
+
+            VkSubmitInfo submitInfo = {};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &commandBuffer;
+            ASSERT_EQ( VK_SUCCESS, DT.QueueSubmit( Vk->Queue, 1, &submitInfo, VK_NULL_HANDLE ) );
+            ASSERT_EQ( VK_SUCCESS, DT.QueueWaitIdle( Vk->Queue ) );
+        };
+
+        auto FindLabel = []( const auto& labels, const char* pName, uint32_t depth ) -> const DeviceProfilerDebugLabelData*
+        {
+            for( const auto& label : labels )
+            {
+                if( (label.m_Name == pName) && (label.m_Depth == depth) )
+                    return &label;
+            }
+            return nullptr;
+        };
+
+        { // Allocate command buffer
+            VkCommandBufferAllocateInfo allocateInfo = {};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocateInfo.commandBufferCount = 1;
+            allocateInfo.commandPool = Vk->CommandPool;
+            ASSERT_EQ( VK_SUCCESS, DT.AllocateCommandBuffers( Vk->Device, &allocateInfo, &commandBuffer ) );
+        }
+        { // Flat label "a/b" and label "b" nested in label "a" must not be merged
+            RecordAndSubmit( [&]()
+            {
+                BeginLabel( "a/b" );
+                DT.CmdDraw( commandBuffer, 3, 1, 0, 0 );
+                DT.CmdEndDebugUtilsLabelEXT( commandBuffer );
+
+                BeginLabel( "a" );
+                BeginLabel( "b" );
+                DT.CmdDraw( commandBuffer, 3, 1, 0, 0 );
+                DT.CmdEndDebugUtilsLabelEXT( commandBuffer );
+                DT.CmdEndDebugUtilsLabelEXT( commandBuffer );
+            } );
+
+            Prof->FinishFrame();
+
+            const auto data = Prof->GetData();
+            ASSERT_EQ( 3, data.m_DebugLabels.size() );
+
+            const DeviceProfilerDebugLabelData* pFlatLabel = FindLabel( data.m_DebugLabels, "a/b", 0 );
+            const DeviceProfilerDebugLabelData* pParentLabel = FindLabel( data.m_DebugLabels, "a", 0 );
+            const DeviceProfilerDebugLabelData* pNestedLabel = FindLabel( data.m_DebugLabels, "b", 1 );
+            ASSERT_NE( nullptr, pFlatLabel );
+            ASSERT_NE( nullptr, pParentLabel );
+            ASSERT_NE( nullptr, pNestedLabel );
+
+            EXPECT_NE( pFlatLabel->m_PathId, pNestedLabel->m_PathId );
+            EXPECT_EQ( pParentLabel, &data.m_DebugLabels[ pNestedLabel->m_ParentIndex ] );
+            EXPECT_EQ( 1, pFlatLabel->m_InstanceCount );
+            EXPECT_EQ( 1, pNestedLabel->m_InstanceCount );
+        }
+        { // Leave label "a" open and reset the aggregator
+            RecordAndSubmit( [&]()
+            {
+                BeginLabel( "a" );
+                DT.CmdDraw( commandBuffer, 3, 1, 0, 0 );
+            } );
+
+            Prof->FinishFrame();
+            Prof->m_DataAggregator.Reset();
+        }
+        { // Labels left open before the reset must not be parents of the new labels
+            RecordAndSubmit( [&]()
+            {
+                BeginLabel( "c" );
+                DT.CmdDraw( commandBuffer, 3, 1, 0, 0 );
+                DT.CmdEndDebugUtilsLabelEXT( commandBuffer );
+            } );
+
+            Prof->FinishFrame();
+
+            const auto data = Prof->GetData();
+            ASSERT_EQ( 1, data.m_DebugLabels.size() );
+            EXPECT_EQ( "c", data.m_DebugLabels.front().m_Name );
+            EXPECT_EQ( 0, data.m_DebugLabels.front().m_Depth );
+        }
+    }
 }
@@ -0,0 +1,164 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "profiler_testing_common.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+namespace Profiler
+{
+    class ProfilerCpuMarkersULT : public ProfilerBaseULT
+    {
+    protected:
+        static const DeviceProfilerCpuRegionData* FindRegion( const DeviceProfilerFrameData& data, const char* pName )
+        {
+            auto it = std::find_if( data.m_CpuRegions.begin(), data.m_CpuRegions.end(),
+                [pName]( const DeviceProfilerCpuRegionData& region ) { return region.m_Name == pName; } );
+
+            return (it != data.m_CpuRegions.end()) ? &*it : nullptr;
+        }
+    };
+
+    TEST_F( ProfilerCpuMarkersULT, NestedRegions )
+    {
+        const float color[ 4 ] = { 1.f, 0.5f, 0.25f, 1.f };
+
+        { // Record nested regions
+            Prof->BeginCpuRegion( "A", color );
+            Prof->BeginCpuRegion( "B", nullptr );
+            Prof->EndCpuRegion();
+            Prof->BeginCpuRegion( "C", nullptr );
+            Prof->EndCpuRegion();
+            Prof->EndCpuRegion();
+        }
+        { // Collect data
+            Prof->FinishFrame();
+
+            const auto data = Prof->GetData();
+            ASSERT_EQ( 3, data.m_CpuRegions.size() );
+
+            // Parent regions are returned first
+            EXPECT_EQ( "A", data.m_CpuRegions.front().m_Name );
+
+            const DeviceProfilerCpuRegionData* pRegionA = FindRegion( data, "A" );
+            const DeviceProfilerCpuRegionData* pRegionB = FindRegion( data, "B" );
+            const DeviceProfilerCpuRegionData* pRegionC = FindRegion( data, "C" );
+            ASSERT_NE( nullptr, pRegionA );
+            ASSERT_NE( nullptr, pRegionB );
+            ASSERT_NE( nullptr, pRegionC );
+
+            EXPECT_EQ( 0, pRegionA->m_Depth );
+            EXPECT_EQ( 1, pRegionB->m_Depth );
+            EXPECT_EQ( 1, pRegionC->m_Depth );
+
+            EXPECT_EQ( color[ 1 ], pRegionA->m_Color[ 1 ] );
+            EXPECT_EQ( pRegionA->m_ThreadId, pRegionB->m_ThreadId );
+            EXPECT_EQ( pRegionA->m_ThreadId, pRegionC->m_ThreadId );
+
+            // Children are inside the parent
+            EXPECT_LE( pRegionA->m_BeginTimestamp, pRegionB->m_BeginTimestamp );
+            EXPECT_LE( pRegionB->m_EndTimestamp, pRegionC->m_BeginTimestamp );
+            EXPECT_GE( pRegionA->m_EndTimestamp, pRegionC->m_EndTimestamp );
+        }
+    }
+
+    TEST_F( ProfilerCpuMarkersULT, RegionSpanningFrames )
+    {
+        std::chrono::high_resolution_clock::time_point firstFrameEndTimestamp;
+
+        { // Begin the region in the first frame
+            Prof->BeginCpuRegion( "Outer", nullptr );
+            Prof->BeginCpuRegion( "Inner", nullptr );
+            Prof->EndCpuRegion();
+            Prof->FinishFrame();
+
+            // Only the regions that ended in the frame are returned
+            const auto data = Prof->GetData();
+            ASSERT_EQ( 1, data.m_CpuRegions.size() );
+            EXPECT_EQ( "Inner", data.m_CpuRegions.front().m_Name );
+            EXPECT_EQ( 1, data.m_CpuRegions.front().m_Depth );
+
+            firstFrameEndTimestamp = data.m_CPU.m_EndTimestamp;
+        }
+        { // End the region in the second frame
+            Prof->EndCpuRegion();
+            Prof->FinishFrame();
+
+            const auto data = Prof->GetData();
+            ASSERT_EQ( 1, data.m_CpuRegions.size() );
+
+            const DeviceProfilerCpuRegionData& region = data.m_CpuRegions.front();
+            EXPECT_EQ( "Outer", region.m_Name );
+            EXPECT_EQ( 0, region.m_Depth );
+            EXPECT_LE( region.m_BeginTimestamp, firstFrameEndTimestamp );
+            EXPECT_GE( region.m_EndTimestamp, firstFrameEndTimestamp );
+        }
+        { // The region is not returned again
+            Prof->FinishFrame();
+
+            const auto data = Prof->GetData();
+            EXPECT_TRUE( data.m_CpuRegions.empty() );
+        }
+    }
+
+    TEST_F( ProfilerCpuMarkersULT, UnbalancedEnd )
+    {
+        { // End without begin is ignored
+            Prof->EndCpuRegion();
+            Prof->BeginCpuRegion( "A", nullptr );
+            Prof->EndCpuRegion();
+            Prof->EndCpuRegion();
+            Prof->BeginCpuRegion( "B", nullptr );
+            Prof->EndCpuRegion();
+        }
+        { // Collect data
+            Prof->FinishFrame();
+
+            const auto data = Prof->GetData();
+            ASSERT_EQ( 2, data.m_CpuRegions.size() );
+
+            const DeviceProfilerCpuRegionData* pRegionA = FindRegion( data, "A" );
+            const DeviceProfilerCpuRegionData* pRegionB = FindRegion( data, "B" );
+            ASSERT_NE( nullptr, pRegionA );
+            ASSERT_NE( nullptr, pRegionB );
+
+            // Depth is not affected by the ignored end markers
+            EXPECT_EQ( 0, pRegionA->m_Depth );
+            EXPECT_EQ( 0, pRegionB->m_Depth );
+        }
+        { // Regions recorded after the unbalanced end are still nested correctly
+            Prof->EndCpuRegion();
+            Prof->BeginCpuRegion( "C", nullptr );
+            Prof->BeginCpuRegion( "D", nullptr );
+            Prof->EndCpuRegion();
+            Prof->EndCpuRegion();
+            Prof->FinishFrame();
+
+            const auto data = Prof->GetData();
+            ASSERT_EQ( 2, data.m_CpuRegions.size() );
+            EXPECT_EQ( "C", data.m_CpuRegions[ 0 ].m_Name );
+            EXPECT_EQ( 0, data.m_CpuRegions[ 0 ].m_Depth );
+            EXPECT_EQ( "D", data.m_CpuRegions[ 1 ].m_Name );
+            EXPECT_EQ( 1, data.m_CpuRegions[ 1 ].m_Depth );
+        }
+    }
+}
@@ -23,6 +23,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 namespace Profiler
 {
@@ -367,4 +368,302 @@ namespace Profiler
             freeProfilerFrameDataEXT( Vk.Device, &data );
         }
     }
+
+    TEST_F( ProfilerExtensionsULT, vkGetProfilerFrameRegionsEXT )
+    {
+        // Create vulkan instance with profiler layer enabled externally
+        VulkanState Vk;
+
+        // Load entry points to loader
+        VkLayerInstanceDispatchTable IDT;
+        VkLayerDeviceDispatchTable DT;
+
+        init_layer_instance_dispatch_table( Vk.Instance, vkGetInstanceProcAddr, IDT );
+        init_layer_device_dispatch_table( Vk.Device, vkGetDeviceProcAddr, DT );
+
+        // Initialize simple triangle app
+        VulkanSimpleTriangle simpleTriangle( &Vk, IDT, DT );
+
+        VkCommandBuffer commandBuffer;
+
+        { // Allocate command buffer
+            VkCommandBufferAllocateInfo allocateInfo = {};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocateInfo.commandPool = Vk.CommandPool;
+            allocateInfo.commandBufferCount = 1;
+            ASSERT_EQ( VK_SUCCESS, DT.AllocateCommandBuffers( Vk.Device, &allocateInfo, &commandBuffer ) );
+        }
+        { // Begin command buffer
+            VkCommandBufferBeginInfo beginInfo = {};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            ASSERT_EQ( VK_SUCCESS, DT.BeginCommandBuffer( commandBuffer, &beginInfo ) );
+        }
+        { // Image layout transitions
+            VkImageMemoryBarrier barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            barrier.srcQueueFamilyIndex = Vk.QueueFamilyIndex;
+            barrier.dstQueueFamilyIndex = Vk.QueueFamilyIndex;
+            barrier.image = simpleTriangle.FramebufferImage;
+            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+            barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+
+            DT.CmdPipelineBarrier( commandBuffer,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                VK_DEPENDENCY_BY_REGION_BIT,
+                0, nullptr,
+                0, nullptr,
+                1, &barrier );
+        }
+        { // Begin render pass
+            VkRenderPassBeginInfo beginInfo = {};
+            beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            beginInfo.renderPass = simpleTriangle.RenderPass;
+            beginInfo.framebuffer = simpleTriangle.Framebuffer;
+            beginInfo.renderArea = simpleTriangle.RenderArea;
+            DT.CmdBeginRenderPass( commandBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE );
+        }
+        { // Draw triangles
+            DT.CmdBindPipeline( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, simpleTriangle.Pipeline );
+            DT.CmdDraw( commandBuffer, 3, 1, 0, 0 );
+            DT.CmdDraw( commandBuffer, 3, 1, 0, 0 );
+        }
+        { // End render pass
+            DT.CmdEndRenderPass( commandBuffer );
+        }
+        { // End command buffer
+            ASSERT_EQ( VK_SUCCESS, DT.EndCommandBuffer( commandBuffer ) );
+        }
+        { // Submit command buffer
+            VkSubmitInfo submitInfo = {};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &commandBuffer;
+            ASSERT_EQ( VK_SUCCESS, DT.QueueSubmit( Vk.Queue, 1, &submitInfo, VK_NULL_HANDLE ) );
+        }
+
+        PFN_vkFlushProfilerEXT flushProfilerEXT = (PFN_vkFlushProfilerEXT)DT.GetDeviceProcAddr( Vk.Device, "vkFlushProfilerEXT" );
+        PFN_vkGetProfilerFrameRegionsEXT getProfilerFrameRegionsEXT = (PFN_vkGetProfilerFrameRegionsEXT)DT.GetDeviceProcAddr( Vk.Device, "vkGetProfilerFrameRegionsEXT" );
+
+        ASSERT_NE( nullptr, flushProfilerEXT );
+        ASSERT_NE( nullptr, getProfilerFrameRegionsEXT );
+
+        uint32_t regionCount = 0;
+        std::vector<VkProfilerFlatRegionDataEXT> regions;
+
+        { // Collect data
+            ASSERT_EQ( VK_SUCCESS, flushProfilerEXT( Vk.Device ) );
+            ASSERT_EQ( VK_SUCCESS, getProfilerFrameRegionsEXT( Vk.Device, &regionCount, nullptr ) );
+
+            // Frame, submit, submit info, command buffer, render pass, subpass, pipeline and 2 drawcalls
+            ASSERT_EQ( 9, regionCount );
+
+            regions.resize( regionCount );
+
+            uint32_t insufficientRegionCount = regionCount - 1;
+            EXPECT_EQ( VK_INCOMPLETE, getProfilerFrameRegionsEXT( Vk.Device, &insufficientRegionCount, regions.data() ) );
+            EXPECT_EQ( regionCount, insufficientRegionCount );
+
+            ASSERT_EQ( VK_SUCCESS, getProfilerFrameRegionsEXT( Vk.Device, &regionCount, regions.data() ) );
+            ASSERT_EQ( 9, regionCount );
+        }
+        { // Validate data
+            const VkProfilerFlatRegionDataEXT& frameData = regions[ 0 ];
+            EXPECT_EQ( VK_PROFILER_REGION_TYPE_FRAME_EXT, frameData.regionType );
+            EXPECT_EQ( VK_PROFILER_REGION_INDEX_NONE_EXT, frameData.parentIndex );
+            EXPECT_EQ( 1, frameData.subregionCount );
+            EXPECT_LT( 0, frameData.duration );
+
+            // Walk down the hierarchy
+            const VkProfilerRegionTypeEXT expectedRegionTypes[] = {
+                VK_PROFILER_REGION_TYPE_SUBMIT_EXT,
+                VK_PROFILER_REGION_TYPE_SUBMIT_INFO_EXT,
+                VK_PROFILER_REGION_TYPE_COMMAND_BUFFER_EXT,
+                VK_PROFILER_REGION_TYPE_RENDER_PASS_EXT,
+                VK_PROFILER_REGION_TYPE_SUBPASS_EXT,
+                VK_PROFILER_REGION_TYPE_PIPELINE_EXT };
+
+            uint32_t parentIndex = 0;
+
+            for( VkProfilerRegionTypeEXT expectedRegionType : expectedRegionTypes )
+            {
+                ASSERT_EQ( 1, regions[ parentIndex ].subregionCount );
+
+                const uint32_t index = regions[ parentIndex ].firstSubregionIndex;
+                ASSERT_LT( index, regionCount );
+                EXPECT_EQ( expectedRegionType, regions[ index ].regionType );
+                EXPECT_EQ( parentIndex, regions[ index ].parentIndex );
+
+                parentIndex = index;
+            }
+
+            const VkProfilerFlatRegionDataEXT& pipelineData = regions[ parentIndex ];
+            EXPECT_EQ( simpleTriangle.Pipeline, pipelineData.properties.pipeline.handle );
+            ASSERT_EQ( 2, pipelineData.subregionCount );
+            ASSERT_LE( pipelineData.firstSubregionIndex + 2, regionCount );
+
+            for( uint32_t i = 0; i < 2; ++i )
+            {
+                const VkProfilerFlatRegionDataEXT& drawcall = regions[ pipelineData.firstSubregionIndex + i ];
+                EXPECT_EQ( VK_PROFILER_REGION_TYPE_COMMAND_EXT, drawcall.regionType );
+                EXPECT_EQ( VK_PROFILER_COMMAND_DRAW_EXT, drawcall.properties.command.type );
+                EXPECT_EQ( parentIndex, drawcall.parentIndex );
+                EXPECT_EQ( 0, drawcall.subregionCount );
+                EXPECT_LT( 0, drawcall.duration );
+            }
+        }
+    }
+
+    TEST_F( ProfilerExtensionsULT, vkGetProfilerFrameHistoryEXT )
+    {
+        // Create vulkan instance with profiler layer enabled externally
+        VulkanState Vk;
+
+        // Load entry points to loader
+        VkLayerDeviceDispatchTable DT;
+        init_layer_device_dispatch_table( Vk.Device, vkGetDeviceProcAddr, DT );
+
+        PFN_vkFlushProfilerEXT flushProfilerEXT = (PFN_vkFlushProfilerEXT)DT.GetDeviceProcAddr( Vk.Device, "vkFlushProfilerEXT" );
+        PFN_vkGetProfilerFrameHistoryEXT getProfilerFrameHistoryEXT = (PFN_vkGetProfilerFrameHistoryEXT)DT.GetDeviceProcAddr( Vk.Device, "vkGetProfilerFrameHistoryEXT" );
+
+        ASSERT_NE( nullptr, flushProfilerEXT );
+        ASSERT_NE( nullptr, getProfilerFrameHistoryEXT );
+
+        { // Finish 3 frames
+            ASSERT_EQ( VK_SUCCESS, flushProfilerEXT( Vk.Device ) );
+            ASSERT_EQ( VK_SUCCESS, flushProfilerEXT( Vk.Device ) );
+            ASSERT_EQ( VK_SUCCESS, flushProfilerEXT( Vk.Device ) );
+        }
+
+        uint32_t frameCount = 0;
+        uint64_t droppedFrameCount = 0;
+
+        { // Query number of frames
+            ASSERT_EQ( VK_SUCCESS, getProfilerFrameHistoryEXT( Vk.Device, 0, &frameCount, nullptr, &droppedFrameCount ) );
+            EXPECT_EQ( 3, frameCount );
+            EXPECT_EQ( 0, droppedFrameCount );
+        }
+
+        std::vector<VkProfilerFrameSummaryEXT> frames( 3 );
+
+        { // Query the oldest 2 frames
+            frameCount = 2;
+            ASSERT_EQ( VK_INCOMPLETE, getProfilerFrameHistoryEXT( Vk.Device, 0, &frameCount, frames.data(), nullptr ) );
+            ASSERT_EQ( 2, frameCount );
+            EXPECT_EQ( 0, frames[ 0 ].sequenceNumber );
+            EXPECT_EQ( 1, frames[ 1 ].sequenceNumber );
+        }
+        { // Continue from the next sequence number
+            frameCount = 3;
+            ASSERT_EQ( VK_SUCCESS, getProfilerFrameHistoryEXT( Vk.Device, frames[ 1 ].sequenceNumber + 1, &frameCount, frames.data(), nullptr ) );
+            ASSERT_EQ( 1, frameCount );
+            EXPECT_EQ( 2, frames[ 0 ].sequenceNumber );
+        }
+    }
+
+    TEST_F( ProfilerExtensionsULT, vkSetProfilerFrameCallbackEXT )
+    {
+        // Create vulkan instance with profiler layer enabled externally
+        VulkanState Vk;
+
+        // Load entry points to loader
+        VkLayerDeviceDispatchTable DT;
+        init_layer_device_dispatch_table( Vk.Device, vkGetDeviceProcAddr, DT );
+
+        PFN_vkFlushProfilerEXT flushProfilerEXT = (PFN_vkFlushProfilerEXT)DT.GetDeviceProcAddr( Vk.Device, "vkFlushProfilerEXT" );
+        PFN_vkSetProfilerFrameCallbackEXT setProfilerFrameCallbackEXT = (PFN_vkSetProfilerFrameCallbackEXT)DT.GetDeviceProcAddr( Vk.Device, "vkSetProfilerFrameCallbackEXT" );
+
+        ASSERT_NE( nullptr, flushProfilerEXT );
+        ASSERT_NE( nullptr, setProfilerFrameCallbackEXT );
+
+        std::vector<uint64_t> sequenceNumbers;
+
+        auto callback = []( VkDevice, const VkProfilerFrameCallbackDataEXT* pData, void* pUserData )
+        {
+            EXPECT_EQ( VK_STRUCTURE_TYPE_PROFILER_FRAME_CALLBACK_DATA_EXT, pData->sType );
+            EXPECT_LE( 1, pData->regionCount );
+            EXPECT_EQ( VK_PROFILER_REGION_TYPE_FRAME_EXT, pData->pRegions[ 0 ].regionType );
+            static_cast<std::vector<uint64_t>*>( pUserData )->push_back( pData->summary.sequenceNumber );
+        };
+
+        { // Register the callback and finish 2 frames
+            ASSERT_EQ( VK_SUCCESS, setProfilerFrameCallbackEXT( Vk.Device, callback, &sequenceNumbers ) );
+            ASSERT_EQ( VK_SUCCESS, flushProfilerEXT( Vk.Device ) );
+            ASSERT_EQ( VK_SUCCESS, flushProfilerEXT( Vk.Device ) );
+        }
+        { // Unregister the callback
+            ASSERT_EQ( VK_SUCCESS, setProfilerFrameCallbackEXT( Vk.Device, nullptr, nullptr ) );
+            ASSERT_EQ( VK_SUCCESS, flushProfilerEXT( Vk.Device ) );
+        }
+
+        ASSERT_EQ( 2, sequenceNumbers.size() );
+        EXPECT_EQ( sequenceNumbers[ 0 ] + 1, sequenceNumbers[ 1 ] );
+    }
+
+    TEST_F( ProfilerExtensionsULT, vkBeginProfilerCpuRegionEXT )
+    {
+        // Create vulkan instance with profiler layer enabled externally
+        VulkanState Vk;
+
+        // Load entry points to loader
+        VkLayerDeviceDispatchTable DT;
+        init_layer_device_dispatch_table( Vk.Device, vkGetDeviceProcAddr, DT );
+
+        PFN_vkFlushProfilerEXT flushProfilerEXT = (PFN_vkFlushProfilerEXT)DT.GetDeviceProcAddr( Vk.Device, "vkFlushProfilerEXT" );
+        PFN_vkBeginProfilerCpuRegionEXT beginProfilerCpuRegionEXT = (PFN_vkBeginProfilerCpuRegionEXT)DT.GetDeviceProcAddr( Vk.Device, "vkBeginProfilerCpuRegionEXT" );
+        PFN_vkEndProfilerCpuRegionEXT endProfilerCpuRegionEXT = (PFN_vkEndProfilerCpuRegionEXT)DT.GetDeviceProcAddr( Vk.Device, "vkEndProfilerCpuRegionEXT" );
+
+        ASSERT_NE( nullptr, flushProfilerEXT );
+        ASSERT_NE( nullptr, beginProfilerCpuRegionEXT );
+        ASSERT_NE( nullptr, endProfilerCpuRegionEXT );
+
+        VkDebugUtilsLabelEXT label = {};
+        label.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+        label.pLabelName = "Region";
+
+        { // Regions may span across frames
+            beginProfilerCpuRegionEXT( Vk.Device, &label );
+            beginProfilerCpuRegionEXT( Vk.Device, &label );
+            endProfilerCpuRegionEXT( Vk.Device );
+            ASSERT_EQ( VK_SUCCESS, flushProfilerEXT( Vk.Device ) );
+            endProfilerCpuRegionEXT( Vk.Device );
+            ASSERT_EQ( VK_SUCCESS, flushProfilerEXT( Vk.Device ) );
+        }
+    }
+
+    TEST_F( ProfilerExtensionsULT, vkGetProfilerRollingStatisticsEXT )
+    {
+        // Create vulkan instance with profiler layer enabled externally
+        VulkanState Vk;
+
+        // Load entry points to loader
+        VkLayerDeviceDispatchTable DT;
+        init_layer_device_dispatch_table( Vk.Device, vkGetDeviceProcAddr, DT );
+
+        PFN_vkFlushProfilerEXT flushProfilerEXT = (PFN_vkFlushProfilerEXT)DT.GetDeviceProcAddr( Vk.Device, "vkFlushProfilerEXT" );
+        PFN_vkGetProfilerRollingStatisticsEXT getProfilerRollingStatisticsEXT = (PFN_vkGetProfilerRollingStatisticsEXT)DT.GetDeviceProcAddr( Vk.Device, "vkGetProfilerRollingStatisticsEXT" );
+
+        ASSERT_NE( nullptr, flushProfilerEXT );
+        ASSERT_NE( nullptr, getProfilerRollingStatisticsEXT );
+
+        { // No GPU work submitted
+            ASSERT_EQ( VK_SUCCESS, flushProfilerEXT( Vk.Device ) );
+
+            uint32_t statisticsCount = UINT32_MAX;
+            ASSERT_EQ( VK_SUCCESS, getProfilerRollingStatisticsEXT( Vk.Device, &statisticsCount, nullptr ) );
+            EXPECT_EQ( 0, statisticsCount );
+
+            VkProfilerRollingStatisticsEXT statistics = {};
+            statisticsCount = 1;
+            ASSERT_EQ( VK_SUCCESS, getProfilerRollingStatisticsEXT( Vk.Device, &statisticsCount, &statistics ) );
+            EXPECT_EQ( 0, statisticsCount );
+        }
+    }
 }
@@ -20,6 +20,12 @@
 
 #include "profiler_testing_common.h"
 
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <set>
+#include <vector>
+
 namespace Profiler
 {
     class DeviceProfilerMemoryULT : public ProfilerBaseULT
@@ -268,6 +274,54 @@ namespace Profiler
         }
     }
 
+    TEST_F( DeviceProfilerMemoryULT, AllocationChurn )
+    {
+        static constexpr size_t TEST_ALLOCATION_SIZE = 4096; // 4kB
+
+        VkDeviceMemory deviceMemory[ 2 ] = {};
+
+        uint32_t deviceLocalMemoryTypeIndex = FindMemoryType( VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT );
+        uint32_t deviceLocalMemoryHeapIndex = GetMemoryTypeHeapIndex( deviceLocalMemoryTypeIndex );
+
+        { // Allocate 2 blocks and free 1 in the same frame
+            VkMemoryAllocateInfo allocateInfo = {};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocateInfo.memoryTypeIndex = deviceLocalMemoryTypeIndex;
+            allocateInfo.allocationSize = TEST_ALLOCATION_SIZE;
+            Prof->FinishFrame();
+            ASSERT_EQ( VK_SUCCESS, DT.AllocateMemory( Vk->Device, &allocateInfo, nullptr, &deviceMemory[ 0 ] ) );
+            ASSERT_EQ( VK_SUCCESS, DT.AllocateMemory( Vk->Device, &allocateInfo, nullptr, &deviceMemory[ 1 ] ) );
+            DT.FreeMemory( Vk->Device, deviceMemory[ 1 ], nullptr );
+        }
+
+        { // Verify that the events have been recorded in the frame
+            Prof->FinishFrame();
+
+            const auto data = Prof->GetData();
+            const auto& churn = data.m_Memory.m_Churn;
+            ASSERT_EQ( MemoryProperties.memoryHeapCount, churn.m_Heaps.size() );
+
+            EXPECT_EQ( 2, churn.m_AllocationCount );
+            EXPECT_EQ( 2 * TEST_ALLOCATION_SIZE, churn.m_AllocationSize );
+            EXPECT_EQ( 1, churn.m_FreeCount );
+            EXPECT_EQ( TEST_ALLOCATION_SIZE, churn.m_FreeSize );
+            EXPECT_EQ( 2, churn.m_AllocationSizeHistogram[ 0 ] );
+            EXPECT_EQ( 2, churn.m_Heaps[ deviceLocalMemoryHeapIndex ].m_AllocationCount );
+            EXPECT_EQ( 1, churn.m_Heaps[ deviceLocalMemoryHeapIndex ].m_FreeCount );
+        }
+
+        { // Verify that the events are not carried over to the next frame
+            Prof->FinishFrame();
+
+            const auto data = Prof->GetData();
+            EXPECT_EQ( 0, data.m_Memory.m_Churn.m_AllocationCount );
+            EXPECT_EQ( 0, data.m_Memory.m_Churn.m_FreeCount );
+            EXPECT_EQ( TEST_ALLOCATION_SIZE, data.m_Memory.m_TotalAllocationSize );
+        }
+
+        DT.FreeMemory( Vk->Device, deviceMemory[ 0 ], nullptr );
+    }
+
     TEST_F( DeviceProfilerMemoryULT, MultipleFramePersistence )
     {
         static constexpr size_t TEST_ALLOCATION_SIZE = 4096; // 4kB
@@ -329,4 +383,288 @@ namespace Profiler
             }
         }
     }
+
+    TEST_F( DeviceProfilerMemoryULT, BindBufferMemory )
+    {
+        static constexpr size_t TEST_BUFFER_SIZE = 4096; // 4kB
+
+        VkBuffer buffers[ 3 ] = {};
+        VkDeviceMemory deviceMemory = {};
+        VkMemoryRequirements memoryRequirements = {};
+
+        { // Create buffers
+            VkBufferCreateInfo createInfo = {};
+            createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+            createInfo.size = TEST_BUFFER_SIZE;
+            createInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+            createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+            for( VkBuffer& buffer : buffers )
+            {
+                ASSERT_EQ( VK_SUCCESS, DT.CreateBuffer( Vk->Device, &createInfo, nullptr, &buffer ) );
+            }
+
+            DT.GetBufferMemoryRequirements( Vk->Device, buffers[ 0 ], &memoryRequirements );
+        }
+
+        // Distance between the buffers aligned to the required alignment
+        const VkDeviceSize stride =
+            (memoryRequirements.size + memoryRequirements.alignment - 1) & ~(memoryRequirements.alignment - 1);
+
+        { // Allocate memory for 4 buffers
+            uint32_t memoryTypeIndex = 0;
+            while( !(memoryRequirements.memoryTypeBits & (1U << memoryTypeIndex)) )
+                memoryTypeIndex++;
+
+            VkMemoryAllocateInfo allocateInfo = {};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocateInfo.memoryTypeIndex = memoryTypeIndex;
+            allocateInfo.allocationSize = 4 * stride;
+            ASSERT_EQ( VK_SUCCESS, DT.AllocateMemory( Vk->Device, &allocateInfo, nullptr, &deviceMemory ) );
+        }
+
+        { // Bind 2 aliased buffers at the beginning and 1 buffer in the middle of the allocation
+            ASSERT_EQ( VK_SUCCESS, DT.BindBufferMemory( Vk->Device, buffers[ 0 ], deviceMemory, 0 ) );
+            ASSERT_EQ( VK_SUCCESS, DT.BindBufferMemory( Vk->Device, buffers[ 1 ], deviceMemory, 0 ) );
+            ASSERT_EQ( VK_SUCCESS, DT.BindBufferMemory( Vk->Device, buffers[ 2 ], deviceMemory, 2 * stride ) );
+        }
+
+        { // Collect and post-process data
+            Prof->FinishFrame();
+
+            const auto data = Prof->GetData();
+            ASSERT_EQ( 3, data.m_Memory.m_LargestResources.size() );
+
+            for( const auto& resource : data.m_Memory.m_LargestResources )
+            {
+                EXPECT_EQ( deviceMemory, resource.m_Memory );
+                EXPECT_EQ( memoryRequirements.size, resource.m_Size );
+                EXPECT_EQ( VK_BUFFER_USAGE_TRANSFER_DST_BIT, resource.m_Usage );
+
+                // Only the buffers bound at the beginning overlap
+                EXPECT_EQ( resource.m_Buffer != buffers[ 2 ], resource.m_Aliased );
+            }
+
+            // Free space is split into 2 ranges of the same size
+            ASSERT_EQ( 1, data.m_Memory.m_FragmentedAllocations.size() );
+
+            const auto& allocation = data.m_Memory.m_FragmentedAllocations.front();
+            EXPECT_EQ( deviceMemory, allocation.m_Memory );
+            EXPECT_EQ( 3, allocation.m_ResourceCount );
+            EXPECT_EQ( 2 * memoryRequirements.size, allocation.m_BoundSize );
+            EXPECT_EQ( memoryRequirements.size, allocation.m_AliasedSize );
+            EXPECT_EQ( 2, allocation.m_FreeRangeCount );
+            EXPECT_EQ( 2 * stride - memoryRequirements.size, allocation.m_LargestFreeRangeSize );
+            EXPECT_FLOAT_EQ( 0.5f, allocation.m_Fragmentation );
+        }
+
+        { // Destroy buffers and free memory
+            for( VkBuffer buffer : buffers )
+            {
+                DT.DestroyBuffer( Vk->Device, buffer, nullptr );
+            }
+
+            DT.FreeMemory( Vk->Device, deviceMemory, nullptr );
+        }
+
+        { // Verify that the resources have been unregistered
+            Prof->FinishFrame();
+
+            const auto data = Prof->GetData();
+            EXPECT_TRUE( data.m_Memory.m_LargestResources.empty() );
+            EXPECT_TRUE( data.m_Memory.m_FragmentedAllocations.empty() );
+        }
+    }
+
+    TEST_F( DeviceProfilerMemoryULT, MemoryManagerSuballocation )
+    {
+        static constexpr VkDeviceSize TEST_ALLOCATION_SIZE = 4096; // 4kB
+        static constexpr VkDeviceSize TEST_ALIGNMENT = 65536; // 64kB
+
+        // Use a separate manager to start with fresh pools
+        DeviceProfilerMemoryManager memoryManager;
+        ASSERT_EQ( VK_SUCCESS, memoryManager.Initialize( Prof->m_pDevice ) );
+
+        DeviceProfilerMemoryAllocation allocations[ 3 ] = {};
+
+        { // Suballocate 2 small ranges and 1 range with large alignment
+            VkMemoryRequirements memoryRequirements = {};
+            memoryRequirements.size = TEST_ALLOCATION_SIZE;
+            memoryRequirements.alignment = 1;
+            memoryRequirements.memoryTypeBits = UINT32_MAX;
+            ASSERT_EQ( VK_SUCCESS, memoryManager.AllocateMemory( memoryRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, &allocations[ 0 ] ) );
+            ASSERT_EQ( VK_SUCCESS, memoryManager.AllocateMemory( memoryRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, &allocations[ 1 ] ) );
+
+            memoryRequirements.alignment = TEST_ALIGNMENT;
+            ASSERT_EQ( VK_SUCCESS, memoryManager.AllocateMemory( memoryRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, &allocations[ 2 ] ) );
+        }
+
+        { // Verify that the ranges are valid and don't overlap
+            for( const auto& allocation : allocations )
+            {
+                ASSERT_NE( nullptr, allocation.m_pPool );
+                EXPECT_GE( allocation.m_Size, TEST_ALLOCATION_SIZE );
+                EXPECT_LE( allocation.m_Offset + allocation.m_Size, allocation.m_pPool->m_Size );
+                EXPECT_EQ( static_cast<std::byte*>( allocation.m_pPool->m_pMappedMemory ) + allocation.m_Offset, allocation.m_pMappedMemory );
+            }
+
+            EXPECT_EQ( 0, allocations[ 2 ].m_Offset % TEST_ALIGNMENT );
+
+            // All ranges fit in the first pool
+            EXPECT_EQ( allocations[ 0 ].m_pPool, allocations[ 1 ].m_pPool );
+            EXPECT_EQ( allocations[ 0 ].m_pPool, allocations[ 2 ].m_pPool );
+
+            for( uint32_t i = 0; i < 3; ++i )
+            {
+                for( uint32_t j = i + 1; j < 3; ++j )
+                {
+                    EXPECT_TRUE(
+                        (allocations[ i ].m_Offset + allocations[ i ].m_Size <= allocations[ j ].m_Offset) ||
+                        (allocations[ j ].m_Offset + allocations[ j ].m_Size <= allocations[ i ].m_Offset) )
+                        << "Allocations " << i << " and " << j << " overlap";
+                }
+            }
+        }
+
+        { // Free the ranges and verify that the pool is coalesced back into a single free range
+            DeviceProfilerMemoryPool* pPool = allocations[ 0 ].m_pPool;
+
+            for( auto& allocation : allocations )
+            {
+                memoryManager.FreeMemory( &allocation );
+            }
+
+            EXPECT_EQ( pPool->m_Size, pPool->m_FreeSize );
+            EXPECT_EQ( 1u << pPool->m_MaxOrder, pPool->m_FreeOrderMask );
+        }
+
+        memoryManager.Destroy();
+    }
+
+    TEST_F( DeviceProfilerMemoryULT, MemoryManagerFragmentation )
+    {
+        static constexpr uint32_t TEST_ITERATION_COUNT = 100000;
+        static constexpr uint32_t TEST_MAX_ALLOCATION_COUNT = 256;
+        static constexpr VkDeviceSize TEST_MAX_ALLOCATION_SIZE = 65536; // 64kB
+
+        DeviceProfilerMemoryManager memoryManager;
+        ASSERT_EQ( VK_SUCCESS, memoryManager.Initialize( Prof->m_pDevice ) );
+
+        // Fixed seed to make the sequence reproducible
+        std::mt19937 random( 1234 );
+        std::uniform_int_distribution<VkDeviceSize> sizeDistribution( 1, TEST_MAX_ALLOCATION_SIZE );
+        std::uniform_int_distribution<uint32_t> alignmentDistribution( 0, 16 );
+
+        std::vector<DeviceProfilerMemoryAllocation> allocations;
+        std::vector<VkDeviceSize> requestedSizes;
+        std::set<DeviceProfilerMemoryPool*> pools;
+
+        VkDeviceSize requestedSize = 0;
+        VkDeviceSize allocatedSize = 0;
+        double fragmentationSum = 0;
+
+        // Only the allocator calls are timed, without the checks and fragmentation scans
+        std::chrono::high_resolution_clock::duration operationsDuration = {};
+
+        for( uint32_t i = 0; i < TEST_ITERATION_COUNT; ++i )
+        {
+            // Keep the number of live allocations around half of the maximum
+            const bool allocate = allocations.empty() ||
+                ((allocations.size() < TEST_MAX_ALLOCATION_COUNT) && (random() % 2 == 0));
+
+            if( allocate )
+            {
+                VkMemoryRequirements memoryRequirements = {};
+                memoryRequirements.size = sizeDistribution( random );
+                memoryRequirements.alignment = VkDeviceSize( 1 ) << alignmentDistribution( random );
+                memoryRequirements.memoryTypeBits = UINT32_MAX;
+
+                DeviceProfilerMemoryAllocation& allocation = allocations.emplace_back();
+
+                const auto beginTimestamp = std::chrono::high_resolution_clock::now();
+                const VkResult result = memoryManager.AllocateMemory( memoryRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, &allocation );
+                operationsDuration += std::chrono::high_resolution_clock::now() - beginTimestamp;
+
+                ASSERT_EQ( VK_SUCCESS, result );
+                ASSERT_EQ( 0, allocation.m_Offset % memoryRequirements.alignment );
+
+                // Smallest range of 4kB blocks that satisfies the requirements
+                const VkDeviceSize minSize = std::max( (memoryRequirements.size + 4095) & ~VkDeviceSize( 4095 ), memoryRequirements.alignment );
+
+                requestedSizes.push_back( minSize );
+                requestedSize += minSize;
+                allocatedSize += allocation.m_Size;
+                pools.insert( allocation.m_pPool );
+            }
+            else
+            {
+                // Free a random allocation
+                const size_t index = random() % allocations.size();
+                std::swap( allocations[ index ], allocations.back() );
+                std::swap( requestedSizes[ index ], requestedSizes.back() );
+
+                requestedSize -= requestedSizes.back();
+                allocatedSize -= allocations.back().m_Size;
+
+                const auto beginTimestamp = std::chrono::high_resolution_clock::now();
+                memoryManager.FreeMemory( &allocations.back() );
+                operationsDuration += std::chrono::high_resolution_clock::now() - beginTimestamp;
+
+                allocations.pop_back();
+                requestedSizes.pop_back();
+            }
+
+            // Ranges are rounded up to the power of 2, so less than half of the allocated memory is wasted
+            ASSERT_LE( requestedSize, allocatedSize );
+            ASSERT_LE( allocatedSize, 2 * requestedSize );
+
+            // External fragmentation: part of the free memory not available in the largest free range
+            VkDeviceSize freeSize = 0;
+            VkDeviceSize largestFreeRangeSize = 0;
+
+            for( const DeviceProfilerMemoryPool* pPool : pools )
+            {
+                if( pPool->m_FreeOrderMask != 0 )
+                {
+                    uint32_t largestFreeOrder = 0;
+                    while( (pPool->m_FreeOrderMask >> largestFreeOrder) > 1 )
+                        ++largestFreeOrder;
+
+                    largestFreeRangeSize = std::max( largestFreeRangeSize, pPool->m_Size >> (pPool->m_MaxOrder - largestFreeOrder) );
+                }
+
+                freeSize += pPool->m_FreeSize;
+            }
+
+            if( freeSize > 0 )
+            {
+                fragmentationSum += 1.0 - static_cast<double>( largestFreeRangeSize ) / freeSize;
+            }
+        }
+
+        // Report the results in the test output
+        const double fragmentation = fragmentationSum / TEST_ITERATION_COUNT;
+        const double duration = std::chrono::duration<double>( operationsDuration ).count();
+        RecordProperty( "MeanExternalFragmentationPercent", static_cast<int>( fragmentation * 100 ) );
+        RecordProperty( "OperationsPerSecond", static_cast<int>( TEST_ITERATION_COUNT / duration ) );
+        RecordProperty( "PoolCount", static_cast<int>( pools.size() ) );
+
+        // At most 256 ranges of up to 64kB are live at once, which fits in a single 16MB pool.
+        // One more pool is allowed for the fragmentation, the freed blocks must be reused.
+        EXPECT_LE( pools.size(), 2u );
+
+        // All pools are coalesced back into single free ranges when all allocations are freed
+        for( auto& allocation : allocations )
+        {
+            memoryManager.FreeMemory( &allocation );
+        }
+
+        for( const DeviceProfilerMemoryPool* pPool : pools )
+        {
+            EXPECT_EQ( pPool->m_Size, pPool->m_FreeSize );
+            EXPECT_EQ( 1u << pPool->m_MaxOrder, pPool->m_FreeOrderMask );
+        }
+
+        memoryManager.Destroy();
+    }
 }
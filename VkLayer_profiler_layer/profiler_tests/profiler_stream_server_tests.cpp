@@ -0,0 +1,171 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Winsock must be included before windows.h
+#ifdef WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#define poll WSAPoll
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+using SOCKET = int;
+#define INVALID_SOCKET (-1)
+#define closesocket close
+#endif
+
+#include "profiler_testing_common.h"
+#include "profiler_trace/profiler_stream_server.h"
+#include "profiler_helpers/profiler_data_helpers.h"
+
+#include <nlohmann/json.hpp>
+#include <string>
+
+namespace Profiler
+{
+    class ProfilerStreamServerULT : public ProfilerBaseULT
+    {
+    protected:
+        SOCKET ClientSocket = INVALID_SOCKET;
+
+        inline void SetUp() override
+        {
+            ProfilerBaseULT::SetUp();
+
+            #ifdef WIN32
+            WSADATA wsaData;
+            WSAStartup( MAKEWORD( 2, 2 ), &wsaData );
+            #endif
+        }
+
+        inline void TearDown() override
+        {
+            if( ClientSocket != INVALID_SOCKET )
+            {
+                closesocket( ClientSocket );
+            }
+
+            #ifdef WIN32
+            WSACleanup();
+            #endif
+
+            ProfilerBaseULT::TearDown();
+        }
+
+        inline bool Connect( uint16_t port )
+        {
+            ClientSocket = socket( AF_INET, SOCK_STREAM, IPPROTO_TCP );
+
+            sockaddr_in address = {};
+            address.sin_family = AF_INET;
+            address.sin_port = htons( port );
+            address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+
+            return (ClientSocket != INVALID_SOCKET) &&
+                (connect( ClientSocket, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) == 0);
+        }
+
+        // Append received data to the buffer, waiting at most timeoutMs for the data
+        inline void Receive( std::string& buffer, int timeoutMs )
+        {
+            pollfd descriptor = { ClientSocket, POLLIN, 0 };
+
+            if( poll( &descriptor, 1, timeoutMs ) > 0 )
+            {
+                char data[ 1024 ];
+                const auto receivedSize = recv( ClientSocket, data, sizeof( data ), 0 );
+
+                if( receivedSize > 0 )
+                {
+                    buffer.append( data, static_cast<size_t>( receivedSize ) );
+                }
+            }
+        }
+
+        // Append frames until a complete line is received
+        inline std::string ReceiveLine( DeviceProfilerStreamServer& server, const DeviceProfilerFrameData& data, std::string& buffer )
+        {
+            for( uint32_t i = 0; (i < 200) && (buffer.find( '\n' ) == std::string::npos); ++i )
+            {
+                server.AppendFrame( data );
+                Receive( buffer, 10 );
+            }
+
+            const size_t lineEnd = buffer.find( '\n' );
+
+            if( lineEnd == std::string::npos )
+            {
+                return {};
+            }
+
+            std::string line = buffer.substr( 0, lineEnd );
+            buffer.erase( 0, lineEnd + 1 );
+            return line;
+        }
+    };
+
+    TEST_F( ProfilerStreamServerULT, StreamFrames )
+    {
+        auto& dd = VkDevice_Functions::DeviceDispatch.Get( Vk->Device );
+
+        DeviceProfilerStringSerializer stringSerializer( dd.Device );
+        DeviceProfilerStreamServer server( &stringSerializer, Milliseconds( 0.001f ) );
+
+        // Let the system select a free port
+        ASSERT_TRUE( server.Start( 0 ) );
+        ASSERT_NE( 0, server.GetPort() );
+        ASSERT_TRUE( Connect( server.GetPort() ) );
+
+        DeviceProfilerFrameData data;
+        data.m_Ticks = 2000;
+        data.m_CPU.m_BeginTimestamp = std::chrono::high_resolution_clock::now();
+        data.m_CPU.m_EndTimestamp = data.m_CPU.m_BeginTimestamp + std::chrono::milliseconds( 16 );
+        data.m_CPU.m_FramesPerSec = 60.f;
+        data.m_Memory.m_TotalAllocationSize = 4096;
+        data.m_Memory.m_TotalAllocationCount = 2;
+
+        // The client is accepted asynchronously, so the first frames may not be sent
+        std::string buffer;
+        const std::string firstLine = ReceiveLine( server, data, buffer );
+        ASSERT_FALSE( firstLine.empty() );
+
+        // Each snapshot is a single line of JSON
+        const nlohmann::json first = nlohmann::json::parse( firstLine );
+        EXPECT_NEAR( 2.f, first[ "gpu_time_ms" ].get<float>(), 0.001f );
+        EXPECT_NEAR( 16.f, first[ "cpu_time_ms" ].get<float>(), 0.001f );
+        EXPECT_EQ( 60.f, first[ "fps" ].get<float>() );
+        EXPECT_EQ( 4096u, first[ "memory" ][ "allocation_size" ].get<uint64_t>() );
+        EXPECT_EQ( 2u, first[ "memory" ][ "allocation_count" ].get<uint64_t>() );
+        EXPECT_TRUE( first[ "pipelines" ].empty() );
+
+        // Next snapshots follow on the next lines
+        const std::string secondLine = ReceiveLine( server, data, buffer );
+        ASSERT_FALSE( secondLine.empty() );
+
+        const nlohmann::json second = nlohmann::json::parse( secondLine );
+        EXPECT_GT( second[ "frame" ].get<uint64_t>(), first[ "frame" ].get<uint64_t>() );
+
+        server.Stop();
+        EXPECT_FALSE( server.IsRunning() );
+    }
+}
@@ -0,0 +1,148 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "profiler_testing_common.h"
+#include "profiler/profiler_string_table.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Profiler
+{
+    TEST( ProfilerStringTableULT, Intern )
+    {
+        ProfilerStringTable table;
+
+        const uint32_t idA = table.Intern( "a" );
+        const uint32_t idB = table.Intern( "b" );
+
+        EXPECT_NE( ProfilerStringTable::InvalidId, idA );
+        EXPECT_NE( ProfilerStringTable::InvalidId, idB );
+        EXPECT_NE( idA, idB );
+
+        // Same string must get the same id, even if it is stored at different address
+        const std::string a = "a";
+        EXPECT_EQ( idA, table.Intern( a.c_str() ) );
+        EXPECT_EQ( idB, table.Intern( "b" ) );
+
+        EXPECT_EQ( ProfilerStringTable::InvalidId, table.Intern( nullptr ) );
+    }
+
+    TEST( ProfilerStringTableULT, GetString )
+    {
+        ProfilerStringTable table;
+
+        // Long strings are stored in separate blocks
+        const std::string longString( 128 * 1024, 'x' );
+
+        const uint32_t id = table.Intern( "test" );
+        const uint32_t emptyId = table.Intern( "" );
+        const uint32_t longId = table.Intern( longString.c_str() );
+
+        EXPECT_STREQ( "test", table.GetString( id ) );
+        EXPECT_STREQ( "", table.GetString( emptyId ) );
+        EXPECT_EQ( longString, table.GetString( longId ) );
+
+        // Returned strings don't move when other strings are added
+        const char* pString = table.GetString( id );
+        for( uint32_t i = 0; i < 10000; ++i )
+        {
+            table.Intern( std::to_string( i ).c_str() );
+        }
+
+        EXPECT_EQ( pString, table.GetString( id ) );
+        EXPECT_STREQ( "9999", table.GetString( table.Intern( "9999" ) ) );
+
+        EXPECT_EQ( nullptr, table.GetString( ProfilerStringTable::InvalidId ) );
+        EXPECT_EQ( nullptr, table.GetString( 0xFFFFFFFF ) );
+    }
+
+    TEST( ProfilerStringTableULT, InternConcurrent )
+    {
+        static constexpr uint32_t ThreadCount = 8;
+        static constexpr uint32_t StringCount = 10000;
+
+        ProfilerStringTable table;
+
+        // Each thread interns the same strings in a different order
+        std::vector<std::vector<uint32_t>> ids( ThreadCount, std::vector<uint32_t>( StringCount ) );
+        std::vector<std::thread> threads;
+
+        for( uint32_t t = 0; t < ThreadCount; ++t )
+        {
+            threads.emplace_back( [&, t]()
+                {
+                    for( uint32_t i = 0; i < StringCount; ++i )
+                    {
+                        const uint32_t index = (i * 7919 + t * 1231) % StringCount;
+                        ids[ t ][ index ] = table.Intern( std::to_string( index ).c_str() );
+                    }
+                } );
+        }
+
+        for( auto& thread : threads )
+        {
+            thread.join();
+        }
+
+        for( uint32_t i = 0; i < StringCount; ++i )
+        {
+            ASSERT_NE( ProfilerStringTable::InvalidId, ids[ 0 ][ i ] );
+            ASSERT_STREQ( std::to_string( i ).c_str(), table.GetString( ids[ 0 ][ i ] ) );
+
+            for( uint32_t t = 1; t < ThreadCount; ++t )
+            {
+                ASSERT_EQ( ids[ 0 ][ i ], ids[ t ][ i ] );
+            }
+        }
+    }
+
+    TEST( ProfilerStringTableULT, InternFull )
+    {
+        // Room for 2 strings
+        ProfilerStringTable table( 3 );
+
+        const uint32_t idA = table.Intern( "a" );
+        const uint32_t idB = table.Intern( "b" );
+
+        EXPECT_NE( ProfilerStringTable::InvalidId, idA );
+        EXPECT_NE( ProfilerStringTable::InvalidId, idB );
+        EXPECT_FALSE( table.IsFull() );
+
+        EXPECT_EQ( ProfilerStringTable::InvalidId, table.Intern( "c" ) );
+        EXPECT_TRUE( table.IsFull() );
+
+        // Strings already in the table are still found
+        EXPECT_EQ( idA, table.Intern( "a" ) );
+        EXPECT_STREQ( "b", table.GetString( idB ) );
+    }
+
+    TEST( ProfilerStringTableULT, InternFullStorage )
+    {
+        // Room for 8 bytes including the terminators
+        ProfilerStringTable table( 1024, 8 );
+
+        EXPECT_NE( ProfilerStringTable::InvalidId, table.Intern( "abc" ) );
+        EXPECT_NE( ProfilerStringTable::InvalidId, table.Intern( "def" ) );
+        EXPECT_EQ( ProfilerStringTable::InvalidId, table.Intern( "g" ) );
+        EXPECT_TRUE( table.IsFull() );
+    }
+}
@@ -0,0 +1,263 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "profiler_csv.h"
+#include "profiler/profiler_data.h"
+#include "profiler/profiler_helpers.h"
+#include "profiler_helpers/profiler_data_helpers.h"
+
+#include "VkLayer_profiler_layer.generated.h"
+
+namespace Profiler
+{
+    /*************************************************************************\
+
+    Function:
+        DeviceProfilerCsvSerializer
+
+    Description:
+        Constructor.
+
+    \*************************************************************************/
+    DeviceProfilerCsvSerializer::DeviceProfilerCsvSerializer( const DeviceProfilerStringSerializer* pStringSerializer, Milliseconds gpuTimestampPeriod )
+        : m_pStringSerializer( pStringSerializer )
+        , m_File()
+        , m_FrameIndex( 0 )
+        , m_GpuTimestampPeriod( gpuTimestampPeriod )
+        , m_PipelineStats()
+    {
+    }
+
+    /*************************************************************************\
+
+    Function:
+        Open
+
+    Description:
+        Create the output file and write the header row.
+
+    \*************************************************************************/
+    bool DeviceProfilerCsvSerializer::Open( const std::filesystem::path& filename )
+    {
+        Close();
+
+        m_File.open( filename, std::ios::out | std::ios::trunc );
+
+        if( !m_File.is_open() )
+        {
+            ProfilerPlatformFunctions::WriteDebug( "Failed to open %s for writing\n", filename.string().c_str() );
+            return false;
+        }
+
+        m_File << "frame,pipeline_hash,pipeline_name,pipeline_gpu_time_ms,draw_count,dispatch_count,frame_gpu_time_ms,frame_cpu_time_ms\n";
+        m_FrameIndex = 0;
+
+        return true;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        Close
+
+    Description:
+        Flush and close the output file.
+
+    \*************************************************************************/
+    void DeviceProfilerCsvSerializer::Close()
+    {
+        if( m_File.is_open() )
+        {
+            m_File.flush();
+            m_File.close();
+        }
+    }
+
+    /*************************************************************************\
+
+    Function:
+        IsOpen
+
+    \*************************************************************************/
+    bool DeviceProfilerCsvSerializer::IsOpen() const
+    {
+        return m_File.is_open();
+    }
+
+    /*************************************************************************\
+
+    Function:
+        AppendFrame
+
+    Description:
+        Write statistics of all pipelines used in the frame.
+
+    \*************************************************************************/
+    void DeviceProfilerCsvSerializer::AppendFrame( const DeviceProfilerFrameData& data )
+    {
+        if( !m_File.is_open() )
+        {
+            return;
+        }
+
+        m_PipelineStats.clear();
+
+        for( const auto& submitBatch : data.m_Submits )
+        {
+            for( const auto& submit : submitBatch.m_Submits )
+            {
+                for( const auto& commandBuffer : submit.m_CommandBuffers )
+                {
+                    CollectPipelines( commandBuffer );
+                }
+            }
+        }
+
+        const Milliseconds frameGpuTime = data.m_Ticks * m_GpuTimestampPeriod;
+        const Milliseconds frameCpuTime = data.m_CPU.m_EndTimestamp - data.m_CPU.m_BeginTimestamp;
+
+        for( const auto& [hash, stats] : m_PipelineStats )
+        {
+            char hashStr[ 9 ] = {};
+            u32tohex( hashStr, hash );
+
+            m_File << m_FrameIndex << ","
+                   << hashStr << ","
+                   << EscapeCsvString( m_pStringSerializer->GetName( *stats.m_pPipeline ) ) << ","
+                   << (stats.m_Ticks * m_GpuTimestampPeriod).count() << ","
+                   << stats.m_DrawCount << ","
+                   << stats.m_DispatchCount << ","
+                   << frameGpuTime.count() << ","
+                   << frameCpuTime.count() << "\n";
+        }
+
+        m_FrameIndex++;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        CollectPipelines
+
+    Description:
+        Aggregate statistics of all pipelines used in the command buffer.
+
+    \*************************************************************************/
+    void DeviceProfilerCsvSerializer::CollectPipelines( const DeviceProfilerCommandBufferData& commandBuffer )
+    {
+        for( const auto& renderPass : commandBuffer.m_RenderPasses )
+        {
+            for( const auto& subpass : renderPass.m_Subpasses )
+            {
+                if( subpass.m_Contents == VK_SUBPASS_CONTENTS_INLINE )
+                {
+                    for( const auto& pipeline : subpass.m_Pipelines )
+                    {
+                        CollectPipeline( pipeline );
+                    }
+                }
+
+                else if( subpass.m_Contents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS )
+                {
+                    for( const auto& secondaryCommandBuffer : subpass.m_SecondaryCommandBuffers )
+                    {
+                        CollectPipelines( secondaryCommandBuffer );
+                    }
+                }
+            }
+        }
+    }
+
+    /*************************************************************************\
+
+    Function:
+        CollectPipeline
+
+    Description:
+        Aggregate pipeline statistics by shader tuple hash.
+
+    \*************************************************************************/
+    void DeviceProfilerCsvSerializer::CollectPipeline( const DeviceProfilerPipelineData& pipeline )
+    {
+        PipelineStats& stats = m_PipelineStats[ pipeline.m_ShaderTuple.m_Hash ];
+
+        if( !stats.m_pPipeline )
+        {
+            stats.m_pPipeline = &pipeline;
+        }
+
+        // Timestamps are not collected in less detailed sampling modes
+        if( (pipeline.m_BeginTimestamp.m_Value != UINT64_MAX) &&
+            (pipeline.m_EndTimestamp.m_Value != UINT64_MAX) )
+        {
+            stats.m_Ticks += (pipeline.m_EndTimestamp.m_Value - pipeline.m_BeginTimestamp.m_Value);
+        }
+
+        for( const auto& drawcall : pipeline.m_Drawcalls )
+        {
+            switch( drawcall.GetPipelineType() )
+            {
+            case DeviceProfilerPipelineType::eGraphics:
+                stats.m_DrawCount++;
+                break;
+
+            case DeviceProfilerPipelineType::eCompute:
+                stats.m_DispatchCount++;
+                break;
+
+            default:
+                break;
+            }
+        }
+    }
+
+    /*************************************************************************\
+
+    Function:
+        EscapeCsvString
+
+    Description:
+        Quote the string if it contains characters reserved by the CSV format.
+
+    \*************************************************************************/
+    std::string DeviceProfilerCsvSerializer::EscapeCsvString( const std::string& value )
+    {
+        if( value.find_first_of( ",\"\n" ) == std::string::npos )
+        {
+            return value;
+        }
+
+        std::string escaped = "\"";
+
+        for( char c : value )
+        {
+            // Quotes are escaped by doubling them
+            if( c == '"' )
+            {
+                escaped.push_back( '"' );
+            }
+
+            escaped.push_back( c );
+        }
+
+        escaped.push_back( '"' );
+        return escaped;
+    }
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "profiler_helpers/profiler_time_helpers.h"
+#include <vulkan/vulkan.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <map>
+
+namespace Profiler
+{
+    /*************************************************************************\
+
+    Class:
+        DeviceProfilerCsvSerializer
+
+    Description:
+        Writes per-frame, per-pipeline statistics to a CSV file.
+
+        Each row contains GPU time, draw and dispatch counts of one pipeline
+        in one frame, identified by the shader tuple hash and name, followed
+        by the frame totals. Rows are appended after each frame, so the file
+        can grow over thousands of frames without keeping the data in memory.
+        Rows of each frame are sorted by the pipeline hash.
+
+        Columns:
+            frame, pipeline_hash, pipeline_name, pipeline_gpu_time_ms,
+            draw_count, dispatch_count, frame_gpu_time_ms, frame_cpu_time_ms
+
+    \*************************************************************************/
+    class DeviceProfilerCsvSerializer
+    {
+    public:
+        template<typename GpuDurationType>
+        inline DeviceProfilerCsvSerializer( const class DeviceProfilerStringSerializer* pStringSerializer, GpuDurationType gpuTimestampPeriod )
+            : DeviceProfilerCsvSerializer(
+                pStringSerializer,
+                std::chrono::duration_cast<Milliseconds>(gpuTimestampPeriod) )
+        {
+        }
+
+        DeviceProfilerCsvSerializer( const class DeviceProfilerStringSerializer* pStringSerializer, Milliseconds gpuTimestampPeriod );
+
+        bool Open( const std::filesystem::path& filename );
+        void Close();
+        bool IsOpen() const;
+
+        void AppendFrame( const struct DeviceProfilerFrameData& data );
+
+    private:
+        const class DeviceProfilerStringSerializer* m_pStringSerializer;
+
+        std::ofstream m_File;
+        uint64_t      m_FrameIndex;
+        Milliseconds  m_GpuTimestampPeriod;
+
+        struct PipelineStats
+        {
+            const struct DeviceProfilerPipelineData* m_pPipeline = nullptr;
+            uint64_t m_Ticks = 0;
+            uint32_t m_DrawCount = 0;
+            uint32_t m_DispatchCount = 0;
+        };
+
+        // Per-frame aggregation, ordered by hash to write the rows in a stable order
+        std::map<uint32_t, PipelineStats> m_PipelineStats;
+
+        void CollectPipelines( const struct DeviceProfilerCommandBufferData& );
+        void CollectPipeline( const struct DeviceProfilerPipelineData& );
+
+        static std::string EscapeCsvString( const std::string& );
+    };
+}
@@ -0,0 +1,528 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "profiler_perfetto.h"
+#include "profiler_trace_event.h"
+#include "profiler/profiler_helpers.h"
+#include "profiler_layer_objects/VkObject.h"
+#include "profiler_helpers/profiler_data_helpers.h"
+
+#include <cstring>
+
+namespace Profiler
+{
+    // Protobuf wire types
+    static constexpr uint32_t WireTypeVarint = 0;
+    static constexpr uint32_t WireTypeFixed64 = 1;
+    static constexpr uint32_t WireTypeLengthDelimited = 2;
+
+    // Field numbers of the messages defined in perfetto/protos/perfetto/trace
+    namespace PerfettoProto
+    {
+        static constexpr uint32_t Trace_Packet = 1;
+
+        static constexpr uint32_t TracePacket_Timestamp = 8;
+        static constexpr uint32_t TracePacket_TrustedPacketSequenceId = 10;
+        static constexpr uint32_t TracePacket_TrackEvent = 11;
+        static constexpr uint32_t TracePacket_InternedData = 12;
+        static constexpr uint32_t TracePacket_SequenceFlags = 13;
+        static constexpr uint32_t TracePacket_TrackDescriptor = 60;
+
+        static constexpr uint32_t SequenceFlags_IncrementalStateCleared = 1;
+        static constexpr uint32_t SequenceFlags_NeedsIncrementalState = 2;
+
+        static constexpr uint32_t TrackDescriptor_Uuid = 1;
+        static constexpr uint32_t TrackDescriptor_Name = 2;
+        static constexpr uint32_t TrackDescriptor_Process = 3;
+        static constexpr uint32_t TrackDescriptor_Thread = 4;
+        static constexpr uint32_t TrackDescriptor_ParentUuid = 5;
+
+        static constexpr uint32_t ProcessDescriptor_Pid = 1;
+        static constexpr uint32_t ProcessDescriptor_ProcessName = 6;
+
+        static constexpr uint32_t ThreadDescriptor_Pid = 1;
+        static constexpr uint32_t ThreadDescriptor_Tid = 2;
+        static constexpr uint32_t ThreadDescriptor_ThreadName = 5;
+
+        static constexpr uint32_t TrackEvent_CategoryIids = 3;
+        static constexpr uint32_t TrackEvent_DebugAnnotations = 4;
+        static constexpr uint32_t TrackEvent_Type = 9;
+        static constexpr uint32_t TrackEvent_NameIid = 10;
+        static constexpr uint32_t TrackEvent_TrackUuid = 11;
+
+        static constexpr uint32_t TrackEventType_SliceBegin = 1;
+        static constexpr uint32_t TrackEventType_SliceEnd = 2;
+        static constexpr uint32_t TrackEventType_Instant = 3;
+
+        static constexpr uint32_t InternedData_EventCategories = 1;
+        static constexpr uint32_t InternedData_EventNames = 2;
+        static constexpr uint32_t InternedData_DebugAnnotationNames = 3;
+
+        // EventCategory, EventName and DebugAnnotationName share the layout
+        static constexpr uint32_t InternedString_Iid = 1;
+        static constexpr uint32_t InternedString_Name = 2;
+
+        static constexpr uint32_t DebugAnnotation_NameIid = 1;
+        static constexpr uint32_t DebugAnnotation_BoolValue = 2;
+        static constexpr uint32_t DebugAnnotation_UintValue = 3;
+        static constexpr uint32_t DebugAnnotation_IntValue = 4;
+        static constexpr uint32_t DebugAnnotation_DoubleValue = 5;
+        static constexpr uint32_t DebugAnnotation_StringValue = 6;
+    }
+
+    // All packets are written by a single producer
+    static constexpr uint32_t TrustedPacketSequenceId = 1;
+
+    // Fixed track identifiers, VkQueue tracks use queue handles and thread tracks have the top bit set
+    static constexpr uint64_t ProcessTrackUuid = 1;
+    static constexpr uint64_t DebugLabelsTrackUuid = 2;
+    static constexpr uint64_t ThreadTrackUuidBit = 0x8000000000000000ULL;
+
+    /*************************************************************************\
+
+    Function:
+        AppendVarint
+
+    Description:
+        Append integer field encoded as varint.
+
+    \*************************************************************************/
+    void ProtobufMessage::AppendVarint( uint32_t field, uint64_t value )
+    {
+        AppendTag( field, WireTypeVarint );
+        AppendRawVarint( value );
+    }
+
+    /*************************************************************************\
+
+    Function:
+        AppendDouble
+
+    Description:
+        Append 64-bit floating-point field.
+
+    \*************************************************************************/
+    void ProtobufMessage::AppendDouble( uint32_t field, double value )
+    {
+        static_assert( sizeof( double ) == sizeof( uint64_t ) );
+
+        uint64_t bits = 0;
+        std::memcpy( &bits, &value, sizeof( bits ) );
+
+        AppendTag( field, WireTypeFixed64 );
+
+        // Fixed-size fields are little-endian
+        for( uint32_t i = 0; i < sizeof( bits ); ++i )
+        {
+            m_Data.push_back( static_cast<char>( (bits >> (8 * i)) & 0xFF ) );
+        }
+    }
+
+    /*************************************************************************\
+
+    Function:
+        AppendString
+
+    Description:
+        Append length-delimited string field.
+
+    \*************************************************************************/
+    void ProtobufMessage::AppendString( uint32_t field, std::string_view value )
+    {
+        AppendTag( field, WireTypeLengthDelimited );
+        AppendRawVarint( value.size() );
+        m_Data.append( value.data(), value.size() );
+    }
+
+    /*************************************************************************\
+
+    Function:
+        AppendMessage
+
+    Description:
+        Append embedded message field.
+
+    \*************************************************************************/
+    void ProtobufMessage::AppendMessage( uint32_t field, const ProtobufMessage& message )
+    {
+        AppendString( field, message.m_Data );
+    }
+
+    /*************************************************************************\
+
+    Function:
+        AppendTag
+
+    \*************************************************************************/
+    void ProtobufMessage::AppendTag( uint32_t field, uint32_t wireType )
+    {
+        AppendRawVarint( (static_cast<uint64_t>( field ) << 3) | wireType );
+    }
+
+    /*************************************************************************\
+
+    Function:
+        AppendRawVarint
+
+    \*************************************************************************/
+    void ProtobufMessage::AppendRawVarint( uint64_t value )
+    {
+        // 7 bits per byte, MSB set if more bytes follow
+        while( value >= 0x80 )
+        {
+            m_Data.push_back( static_cast<char>( (value & 0x7F) | 0x80 ) );
+            value >>= 7;
+        }
+
+        m_Data.push_back( static_cast<char>( value ) );
+    }
+
+    /*************************************************************************\
+
+    Function:
+        DeviceProfilerPerfettoSerializer
+
+    Description:
+        Constructor.
+
+    \*************************************************************************/
+    DeviceProfilerPerfettoSerializer::DeviceProfilerPerfettoSerializer( const DeviceProfilerStringSerializer* pStringSerializer )
+        : m_pStringSerializer( pStringSerializer )
+        , m_EventNameIds()
+        , m_CategoryIds()
+        , m_AnnotationNameIds()
+        , m_Tracks()
+        , m_FirstEventPacket( true )
+    {
+    }
+
+    /*************************************************************************\
+
+    Function:
+        Serialize
+
+    Description:
+        Write the trace events to the output stream.
+
+    \*************************************************************************/
+    bool DeviceProfilerPerfettoSerializer::Serialize( const std::vector<TraceEvent*>& events, std::ostream& out )
+    {
+        using namespace PerfettoProto;
+
+        // Interned strings are valid only in the current file
+        m_EventNameIds.clear();
+        m_CategoryIds.clear();
+        m_AnnotationNameIds.clear();
+        m_Tracks.clear();
+        m_FirstEventPacket = true;
+
+        WriteProcessDescriptor( out );
+
+        for( const TraceEvent* pEvent : events )
+        {
+            const uint64_t trackUuid = GetTrackUuid( *pEvent, out );
+            const uint64_t timestamp = static_cast<uint64_t>( Nanoseconds( pEvent->m_Timestamp ).count() );
+
+            switch( pEvent->m_Phase )
+            {
+            case TraceEvent::Phase::eDurationBegin:
+                WriteTrackEvent( *pEvent, TrackEventType_SliceBegin, timestamp, trackUuid, out );
+                break;
+
+            case TraceEvent::Phase::eDurationEnd:
+                WriteTrackEvent( *pEvent, TrackEventType_SliceEnd, timestamp, trackUuid, out );
+                break;
+
+            case TraceEvent::Phase::eInstant:
+                WriteTrackEvent( *pEvent, TrackEventType_Instant, timestamp, trackUuid, out );
+                break;
+
+            case TraceEvent::Phase::eComplete:
+            {
+                // Complete events are split into begin and end slice events
+                const TraceCompleteEvent& completeEvent = static_cast<const TraceCompleteEvent&>( *pEvent );
+                const uint64_t duration = static_cast<uint64_t>( Nanoseconds( completeEvent.m_Duration ).count() );
+
+                WriteTrackEvent( *pEvent, TrackEventType_SliceBegin, timestamp, trackUuid, out );
+                WriteTrackEvent( *pEvent, TrackEventType_SliceEnd, timestamp + duration, trackUuid, out );
+                break;
+            }
+
+            default:
+                // Other phases (flow, async, metadata) are not emitted by the trace serializer
+                break;
+            }
+        }
+
+        return !out.bad();
+    }
+
+    /*************************************************************************\
+
+    Function:
+        WritePacket
+
+    Description:
+        Write TracePacket as a field of the top-level Trace message.
+
+    \*************************************************************************/
+    void DeviceProfilerPerfettoSerializer::WritePacket( const ProtobufMessage& packet, std::ostream& out ) const
+    {
+        // The file is a Trace message, but only the packets are written to avoid
+        // keeping the whole trace in the memory.
+        ProtobufMessage trace;
+        trace.AppendMessage( PerfettoProto::Trace_Packet, packet );
+
+        const std::string& data = trace.GetData();
+        out.write( data.data(), data.size() );
+    }
+
+    /*************************************************************************\
+
+    Function:
+        WriteProcessDescriptor
+
+    Description:
+        Write descriptor of the parent track for all tracks in the trace.
+
+    \*************************************************************************/
+    void DeviceProfilerPerfettoSerializer::WriteProcessDescriptor( std::ostream& out )
+    {
+        using namespace PerfettoProto;
+
+        ProtobufMessage process;
+        process.AppendVarint( ProcessDescriptor_Pid, ProfilerPlatformFunctions::GetCurrentProcessId() );
+        process.AppendString( ProcessDescriptor_ProcessName, ProfilerPlatformFunctions::GetProcessName() );
+
+        ProtobufMessage track;
+        track.AppendVarint( TrackDescriptor_Uuid, ProcessTrackUuid );
+        track.AppendMessage( TrackDescriptor_Process, process );
+
+        ProtobufMessage packet;
+        packet.AppendMessage( TracePacket_TrackDescriptor, track );
+        WritePacket( packet, out );
+
+        m_Tracks.insert( ProcessTrackUuid );
+    }
+
+    /*************************************************************************\
+
+    Function:
+        GetTrackUuid
+
+    Description:
+        Get identifier of the track the event belongs to.
+        Writes track descriptor when the track is referenced for the first time.
+
+    \*************************************************************************/
+    uint64_t DeviceProfilerPerfettoSerializer::GetTrackUuid( const TraceEvent& event, std::ostream& out )
+    {
+        using namespace PerfettoProto;
+
+        uint64_t trackUuid = reinterpret_cast<uint64_t>( event.m_Queue );
+
+        const DebugTraceEvent* pDebugEvent = dynamic_cast<const DebugTraceEvent*>( &event );
+        const ApiTraceEvent* pApiEvent = dynamic_cast<const ApiTraceEvent*>( &event );
+        const CpuTraceEvent* pCpuEvent = dynamic_cast<const CpuTraceEvent*>( &event );
+
+        // API calls and application's CPU regions share the thread tracks
+        const bool isThreadEvent = (pApiEvent || pCpuEvent);
+        const uint32_t threadId = pApiEvent ? pApiEvent->m_ThreadId : pCpuEvent ? pCpuEvent->m_ThreadId : 0;
+
+        if( pDebugEvent )
+        {
+            trackUuid = DebugLabelsTrackUuid;
+        }
+
+        if( isThreadEvent )
+        {
+            trackUuid = ThreadTrackUuidBit | threadId;
+        }
+
+        if( m_Tracks.insert( trackUuid ).second )
+        {
+            ProtobufMessage track;
+            track.AppendVarint( TrackDescriptor_Uuid, trackUuid );
+            track.AppendVarint( TrackDescriptor_ParentUuid, ProcessTrackUuid );
+
+            if( isThreadEvent )
+            {
+                // CPU thread
+                ProtobufMessage thread;
+                thread.AppendVarint( ThreadDescriptor_Pid, ProfilerPlatformFunctions::GetCurrentProcessId() );
+                thread.AppendVarint( ThreadDescriptor_Tid, threadId );
+                thread.AppendString( ThreadDescriptor_ThreadName, "Thread " + std::to_string( threadId ) );
+                track.AppendMessage( TrackDescriptor_Thread, thread );
+            }
+            else if( pDebugEvent )
+            {
+                track.AppendString( TrackDescriptor_Name, "Debug labels" );
+            }
+            else
+            {
+                // VkQueue
+                track.AppendString( TrackDescriptor_Name, m_pStringSerializer->GetName( event.m_Queue ) );
+            }
+
+            ProtobufMessage packet;
+            packet.AppendMessage( TracePacket_TrackDescriptor, track );
+            WritePacket( packet, out );
+        }
+
+        return trackUuid;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        GetInternedId
+
+    Description:
+        Get interned id of the string.
+        New strings are added to the interned data of the current packet.
+
+    \*************************************************************************/
+    uint64_t DeviceProfilerPerfettoSerializer::GetInternedId( std::unordered_map<std::string, uint64_t>& ids, const std::string& value, uint32_t field, ProtobufMessage& internedData ) const
+    {
+        using namespace PerfettoProto;
+
+        auto it = ids.find( value );
+        if( it != ids.end() )
+        {
+            return it->second;
+        }
+
+        // Interned ids must be non-zero
+        const uint64_t iid = ids.size() + 1;
+        ids.emplace( value, iid );
+
+        ProtobufMessage entry;
+        entry.AppendVarint( InternedString_Iid, iid );
+        entry.AppendString( InternedString_Name, value );
+        internedData.AppendMessage( field, entry );
+
+        return iid;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        WriteTrackEvent
+
+    Description:
+        Write TrackEvent packet.
+
+    \*************************************************************************/
+    void DeviceProfilerPerfettoSerializer::WriteTrackEvent( const TraceEvent& event, uint32_t type, uint64_t timestamp, uint64_t trackUuid, std::ostream& out )
+    {
+        using namespace PerfettoProto;
+
+        ProtobufMessage internedData;
+        ProtobufMessage trackEvent;
+        trackEvent.AppendVarint( TrackEvent_Type, type );
+        trackEvent.AppendVarint( TrackEvent_TrackUuid, trackUuid );
+
+        // End events are matched with the last begin event on the track
+        if( type != TrackEventType_SliceEnd )
+        {
+            if( !event.m_Category.empty() )
+            {
+                trackEvent.AppendVarint( TrackEvent_CategoryIids,
+                    GetInternedId( m_CategoryIds, event.m_Category, InternedData_EventCategories, internedData ) );
+            }
+
+            trackEvent.AppendVarint( TrackEvent_NameIid,
+                GetInternedId( m_EventNameIds, event.m_Name, InternedData_EventNames, internedData ) );
+
+            if( !event.m_Args.empty() )
+            {
+                AppendDebugAnnotations( event.m_Args, trackEvent, internedData );
+            }
+        }
+
+        ProtobufMessage packet;
+        packet.AppendVarint( TracePacket_Timestamp, timestamp );
+        packet.AppendVarint( TracePacket_TrustedPacketSequenceId, TrustedPacketSequenceId );
+        packet.AppendVarint( TracePacket_SequenceFlags, m_FirstEventPacket
+            ? SequenceFlags_IncrementalStateCleared
+            : SequenceFlags_NeedsIncrementalState );
+
+        if( !internedData.IsEmpty() )
+        {
+            packet.AppendMessage( TracePacket_InternedData, internedData );
+        }
+
+        packet.AppendMessage( TracePacket_TrackEvent, trackEvent );
+        WritePacket( packet, out );
+
+        m_FirstEventPacket = false;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        AppendDebugAnnotations
+
+    Description:
+        Convert JSON event arguments to TrackEvent debug annotations.
+
+    \*************************************************************************/
+    void DeviceProfilerPerfettoSerializer::AppendDebugAnnotations( const nlohmann::json& args, ProtobufMessage& trackEvent, ProtobufMessage& internedData )
+    {
+        using namespace PerfettoProto;
+
+        for( auto it = args.begin(); it != args.end(); ++it )
+        {
+            const nlohmann::json& value = it.value();
+
+            ProtobufMessage annotation;
+            annotation.AppendVarint( DebugAnnotation_NameIid,
+                GetInternedId( m_AnnotationNameIds, it.key(), InternedData_DebugAnnotationNames, internedData ) );
+
+            if( value.is_boolean() )
+            {
+                annotation.AppendVarint( DebugAnnotation_BoolValue, value.get<bool>() );
+            }
+            else if( value.is_number_unsigned() )
+            {
+                annotation.AppendVarint( DebugAnnotation_UintValue, value.get<uint64_t>() );
+            }
+            else if( value.is_number_integer() )
+            {
+                annotation.AppendVarint( DebugAnnotation_IntValue, static_cast<uint64_t>( value.get<int64_t>() ) );
+            }
+            else if( value.is_number_float() )
+            {
+                annotation.AppendDouble( DebugAnnotation_DoubleValue, value.get<double>() );
+            }
+            else if( value.is_string() )
+            {
+                annotation.AppendString( DebugAnnotation_StringValue, value.get<std::string>() );
+            }
+            else
+            {
+                // Arrays and objects are stored as JSON strings
+                annotation.AppendString( DebugAnnotation_StringValue, value.dump() );
+            }
+
+            trackEvent.AppendMessage( TrackEvent_DebugAnnotations, annotation );
+        }
+    }
+}
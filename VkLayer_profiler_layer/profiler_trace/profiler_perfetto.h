@@ -0,0 +1,109 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <vulkan/vulkan.h>
+#include <nlohmann/json.hpp>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Profiler
+{
+    /*************************************************************************\
+
+    Class:
+        ProtobufMessage
+
+    Description:
+        Minimal protocol buffers encoder.
+        Fields are appended to the message in the wire format, no schema is
+        required.
+
+    See:
+        https://protobuf.dev/programming-guides/encoding
+
+    \*************************************************************************/
+    class ProtobufMessage
+    {
+    public:
+        void AppendVarint( uint32_t field, uint64_t value );
+        void AppendDouble( uint32_t field, double value );
+        void AppendString( uint32_t field, std::string_view value );
+        void AppendMessage( uint32_t field, const ProtobufMessage& message );
+
+        bool IsEmpty() const { return m_Data.empty(); }
+        const std::string& GetData() const { return m_Data; }
+
+    private:
+        std::string m_Data;
+
+        void AppendTag( uint32_t field, uint32_t wireType );
+        void AppendRawVarint( uint64_t value );
+    };
+
+    /*************************************************************************\
+
+    Class:
+        DeviceProfilerPerfettoSerializer
+
+    Description:
+        Writes trace events in Perfetto's protobuf format (TrackEvent).
+
+        Event names, categories and argument names are interned, so each
+        string is written to the file only once. Each VkQueue, each CPU thread
+        and debug labels get a separate track.
+
+        The output can be opened directly in ui.perfetto.dev.
+
+    See:
+        https://perfetto.dev/docs/reference/trace-packet-proto
+
+    \*************************************************************************/
+    class DeviceProfilerPerfettoSerializer
+    {
+    public:
+        DeviceProfilerPerfettoSerializer( const class DeviceProfilerStringSerializer* pStringSerializer );
+
+        bool Serialize( const std::vector<struct TraceEvent*>& events, std::ostream& out );
+
+    private:
+        const class DeviceProfilerStringSerializer* m_pStringSerializer;
+
+        std::unordered_map<std::string, uint64_t> m_EventNameIds;
+        std::unordered_map<std::string, uint64_t> m_CategoryIds;
+        std::unordered_map<std::string, uint64_t> m_AnnotationNameIds;
+        std::unordered_set<uint64_t> m_Tracks;
+
+        bool m_FirstEventPacket;
+
+        void WritePacket( const ProtobufMessage& packet, std::ostream& out ) const;
+        void WriteProcessDescriptor( std::ostream& out );
+
+        uint64_t GetTrackUuid( const struct TraceEvent& event, std::ostream& out );
+        uint64_t GetInternedId( std::unordered_map<std::string, uint64_t>& ids, const std::string& value, uint32_t field, ProtobufMessage& internedData ) const;
+
+        void WriteTrackEvent( const struct TraceEvent& event, uint32_t type, uint64_t timestamp, uint64_t trackUuid, std::ostream& out );
+        void AppendDebugAnnotations( const nlohmann::json& args, ProtobufMessage& trackEvent, ProtobufMessage& internedData );
+    };
+}
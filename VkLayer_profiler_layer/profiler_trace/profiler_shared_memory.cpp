@@ -0,0 +1,498 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "profiler_shared_memory.h"
+#include "profiler_helpers/profiler_data_helpers.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "VkLayer_profiler_layer.generated.h"
+
+namespace Profiler
+{
+    /*************************************************************************\
+
+    Function:
+        AsAtomic
+
+    Description:
+        Access a field of the shared memory atomically.
+
+    \*************************************************************************/
+    static std::atomic<uint64_t>& AsAtomic( uint64_t& value )
+    {
+        static_assert( sizeof( std::atomic<uint64_t> ) == sizeof( uint64_t ) );
+        static_assert( std::atomic<uint64_t>::is_always_lock_free );
+        return *reinterpret_cast<std::atomic<uint64_t>*>( &value );
+    }
+
+    /*************************************************************************\
+
+    Function:
+        IsStaleRing
+
+    Description:
+        Check if the ring has been left by a process that is no longer running.
+        Rings without the process id are never considered stale.
+
+    \*************************************************************************/
+    static bool IsStaleRing( const VkProfilerSharedMemoryRingHeader* pHeader )
+    {
+        const uint64_t processId = pHeader->writerProcessId;
+
+        if( (processId == 0) || ProfilerPlatformFunctions::IsProcessRunning( static_cast<uint32_t>( processId ) ) )
+        {
+            return false;
+        }
+
+        ProfilerPlatformFunctions::WriteDebug( "Replacing shared memory left by process %llu\n",
+            static_cast<unsigned long long>( processId ) );
+
+        return true;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        DeviceProfilerSharedMemoryRing
+
+    Description:
+        Constructor.
+
+    \*************************************************************************/
+    DeviceProfilerSharedMemoryRing::DeviceProfilerSharedMemoryRing( const DeviceProfilerStringSerializer* pStringSerializer, Milliseconds gpuTimestampPeriod )
+        : m_pStringSerializer( pStringSerializer )
+        , m_GpuTimestampPeriod( gpuTimestampPeriod )
+        , m_Name()
+        , m_pMemory( nullptr )
+        , m_MemorySize( 0 )
+        , m_Handle( -1 )
+        , m_pHeader( nullptr )
+        , m_FrameIndex( 0 )
+        , m_PipelineNames()
+    {
+    }
+
+    /*************************************************************************\
+
+    Function:
+        ~DeviceProfilerSharedMemoryRing
+
+    Description:
+        Destructor.
+
+    \*************************************************************************/
+    DeviceProfilerSharedMemoryRing::~DeviceProfilerSharedMemoryRing()
+    {
+        Destroy();
+    }
+
+    /*************************************************************************\
+
+    Function:
+        Create
+
+    Description:
+        Create the shared memory object and initialize the ring header.
+
+        The memory object is never opened if it already exists, to not clobber
+        the ring of another process or device. In such case the name is suffixed
+        with the process id and a sequence number, and the actual name is written
+        to the debug output. Rings left by the processes that are no longer
+        running are replaced.
+
+    \*************************************************************************/
+    bool DeviceProfilerSharedMemoryRing::Create( const std::string& name, uint32_t slotCount )
+    {
+        Destroy();
+
+        if( name.empty() || (slotCount == 0) )
+        {
+            return false;
+        }
+
+        const uint32_t slotSize =
+            sizeof( VkProfilerSharedMemoryRingSlotHeader ) +
+            sizeof( VkProfilerSharedMemoryFrame ) +
+            sizeof( VkProfilerSharedMemoryPipeline ) * MaxPipelineCount;
+
+        m_Name = name;
+        m_MemorySize = sizeof( VkProfilerSharedMemoryRingHeader ) + static_cast<size_t>( slotSize ) * slotCount;
+
+        uint32_t uniqueNameIndex = 0;
+        bool alreadyExists = false;
+
+        while( !CreatePlatformMemory( alreadyExists ) )
+        {
+            DestroyPlatformMemory();
+
+            if( !alreadyExists || (uniqueNameIndex == MaxUniqueNameCount) )
+            {
+                ProfilerPlatformFunctions::WriteDebug( "Failed to create shared memory %s\n", m_Name.c_str() );
+                m_Name.clear();
+                return false;
+            }
+
+            m_Name = name + "." +
+                std::to_string( ProfilerPlatformFunctions::GetCurrentProcessId() ) + "." +
+                std::to_string( uniqueNameIndex++ );
+        }
+
+        if( uniqueNameIndex > 0 )
+        {
+            ProfilerPlatformFunctions::WriteDebug( "Shared memory %s already exists, using %s\n", name.c_str(), m_Name.c_str() );
+        }
+
+        std::memset( m_pMemory, 0, m_MemorySize );
+
+        m_pHeader = static_cast<VkProfilerSharedMemoryRingHeader*>( m_pMemory );
+        m_pHeader->version = VK_PROFILER_SHARED_MEMORY_RING_VERSION;
+        m_pHeader->headerSize = sizeof( VkProfilerSharedMemoryRingHeader );
+        m_pHeader->slotSize = slotSize;
+        m_pHeader->slotCount = slotCount;
+        m_pHeader->maxPipelineCount = MaxPipelineCount;
+        m_pHeader->writerProcessId = ProfilerPlatformFunctions::GetCurrentProcessId();
+
+        // Readers may access the header once the magic is set
+        std::atomic_thread_fence( std::memory_order_release );
+        m_pHeader->magic = VK_PROFILER_SHARED_MEMORY_RING_MAGIC;
+
+        m_FrameIndex = 0;
+        m_PipelineNames.clear();
+
+        return true;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        Destroy
+
+    Description:
+        Unmap and remove the shared memory object.
+
+    \*************************************************************************/
+    void DeviceProfilerSharedMemoryRing::Destroy()
+    {
+        if( m_pHeader )
+        {
+            // Notify the readers that no more frames will be published
+            m_pHeader->magic = 0;
+            std::atomic_thread_fence( std::memory_order_release );
+        }
+
+        DestroyPlatformMemory();
+
+        m_pHeader = nullptr;
+        m_Name.clear();
+    }
+
+    /*************************************************************************\
+
+    Function:
+        IsCreated
+
+    \*************************************************************************/
+    bool DeviceProfilerSharedMemoryRing::IsCreated() const
+    {
+        return m_pHeader != nullptr;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        AppendFrame
+
+    Description:
+        Write the frame snapshot into the next slot of the ring.
+
+    \*************************************************************************/
+    void DeviceProfilerSharedMemoryRing::AppendFrame( const DeviceProfilerFrameData& data )
+    {
+        if( !IsCreated() )
+        {
+            return;
+        }
+
+        const uint64_t frameIndex = m_FrameIndex++;
+
+        uint8_t* pSlot = static_cast<uint8_t*>( m_pMemory ) +
+            m_pHeader->headerSize +
+            static_cast<size_t>( frameIndex % m_pHeader->slotCount ) * m_pHeader->slotSize;
+
+        auto* pSlotHeader = reinterpret_cast<VkProfilerSharedMemoryRingSlotHeader*>( pSlot );
+        auto* pFrame = reinterpret_cast<VkProfilerSharedMemoryFrame*>( pSlotHeader + 1 );
+        auto* pPipelines = reinterpret_cast<VkProfilerSharedMemoryPipeline*>( pFrame + 1 );
+
+        // Odd sequence marks the slot as being written
+        std::atomic<uint64_t>& sequence = AsAtomic( pSlotHeader->sequence );
+        const uint64_t slotSequence = sequence.load( std::memory_order_relaxed );
+        sequence.store( slotSequence + 1, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+
+        pSlotHeader->frameIndex = frameIndex;
+
+        pFrame->cpuTimeMs = Milliseconds( data.m_CPU.m_EndTimestamp - data.m_CPU.m_BeginTimestamp ).count();
+        pFrame->gpuTimeMs = (data.m_Ticks * m_GpuTimestampPeriod).count();
+        pFrame->framesPerSec = data.m_CPU.m_FramesPerSec;
+        pFrame->memoryAllocationSize = data.m_Memory.m_TotalAllocationSize;
+        pFrame->memoryAllocationCount = data.m_Memory.m_TotalAllocationCount;
+
+        // Top pipelines are already sorted by duration
+        uint32_t pipelineCount = 0;
+
+        for( const auto& pipeline : data.m_TopPipelines )
+        {
+            if( pipelineCount == MaxPipelineCount )
+            {
+                break;
+            }
+
+            if( pipeline.m_Handle != VK_NULL_HANDLE )
+            {
+                const uint32_t hash = pipeline.m_ShaderTuple.m_Hash;
+                const uint64_t pipelineTicks = (pipeline.m_EndTimestamp.m_Value - pipeline.m_BeginTimestamp.m_Value);
+
+                auto it = m_PipelineNames.find( hash );
+                if( it == m_PipelineNames.end() )
+                {
+                    it = m_PipelineNames.emplace( hash, m_pStringSerializer->GetName( pipeline ) ).first;
+                }
+
+                VkProfilerSharedMemoryPipeline& sharedPipeline = pPipelines[ pipelineCount++ ];
+                sharedPipeline.hash = hash;
+                sharedPipeline.gpuTimeMs = (pipelineTicks * m_GpuTimestampPeriod).count();
+
+                const size_t nameLength = std::min<size_t>( it->second.length(), VK_PROFILER_SHARED_MEMORY_MAX_NAME_SIZE - 1 );
+                std::memcpy( sharedPipeline.name, it->second.data(), nameLength );
+                sharedPipeline.name[ nameLength ] = '\0';
+            }
+        }
+
+        pFrame->pipelineCount = pipelineCount;
+
+        // Publish the slot
+        sequence.store( slotSequence + 2, std::memory_order_release );
+        AsAtomic( m_pHeader->publishedFrameCount ).store( frameIndex + 1, std::memory_order_release );
+    }
+
+#ifdef WIN32
+    /*************************************************************************\
+
+    Function:
+        CreatePlatformMemory
+
+    Description:
+        Create named file mapping backed by the paging file.
+
+    \*************************************************************************/
+    bool DeviceProfilerSharedMemoryRing::CreatePlatformMemory( bool& alreadyExists )
+    {
+        const uint64_t size = m_MemorySize;
+        alreadyExists = false;
+
+        HANDLE hFileMapping = CreateFileMappingA(
+            INVALID_HANDLE_VALUE,
+            nullptr,
+            PAGE_READWRITE,
+            static_cast<DWORD>( size >> 32 ),
+            static_cast<DWORD>( size ),
+            m_Name.c_str() );
+
+        if( hFileMapping == nullptr )
+        {
+            return false;
+        }
+
+        if( GetLastError() == ERROR_ALREADY_EXISTS )
+        {
+            // Handle to the existing mapping has been returned.
+            // The mapping outlives its creator only while the readers keep it open,
+            // reuse it if the creator is no longer running and it is large enough.
+            void* pMemory = MapViewOfFile( hFileMapping, FILE_MAP_ALL_ACCESS, 0, 0, m_MemorySize );
+
+            if( pMemory && IsStaleRing( static_cast<const VkProfilerSharedMemoryRingHeader*>( pMemory ) ) )
+            {
+                m_Handle = reinterpret_cast<intptr_t>( hFileMapping );
+                m_pMemory = pMemory;
+                return true;
+            }
+
+            if( pMemory )
+            {
+                UnmapViewOfFile( pMemory );
+            }
+
+            CloseHandle( hFileMapping );
+            alreadyExists = true;
+            return false;
+        }
+
+        m_Handle = reinterpret_cast<intptr_t>( hFileMapping );
+        m_pMemory = MapViewOfFile( hFileMapping, FILE_MAP_ALL_ACCESS, 0, 0, m_MemorySize );
+
+        return m_pMemory != nullptr;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        DestroyPlatformMemory
+
+    \*************************************************************************/
+    void DeviceProfilerSharedMemoryRing::DestroyPlatformMemory()
+    {
+        if( m_pMemory )
+        {
+            UnmapViewOfFile( m_pMemory );
+            m_pMemory = nullptr;
+        }
+
+        if( m_Handle != -1 )
+        {
+            CloseHandle( reinterpret_cast<HANDLE>( m_Handle ) );
+            m_Handle = -1;
+        }
+    }
+#else
+    /*************************************************************************\
+
+    Function:
+        RemoveStaleSharedMemory
+
+    Description:
+        Remove POSIX shared memory object left by a process that is no longer
+        running. The memory is freed when the readers unmap it.
+
+    \*************************************************************************/
+    static bool RemoveStaleSharedMemory( const char* pName )
+    {
+        const int fd = shm_open( pName, O_RDONLY, 0 );
+
+        if( fd == -1 )
+        {
+            return false;
+        }
+
+        bool stale = false;
+        struct stat fileStat = {};
+
+        if( (fstat( fd, &fileStat ) == 0) &&
+            (static_cast<size_t>( fileStat.st_size ) >= sizeof( VkProfilerSharedMemoryRingHeader )) )
+        {
+            void* pMemory = mmap( nullptr, sizeof( VkProfilerSharedMemoryRingHeader ), PROT_READ, MAP_SHARED, fd, 0 );
+
+            if( pMemory != MAP_FAILED )
+            {
+                stale = IsStaleRing( static_cast<const VkProfilerSharedMemoryRingHeader*>( pMemory ) );
+                munmap( pMemory, sizeof( VkProfilerSharedMemoryRingHeader ) );
+            }
+        }
+
+        close( fd );
+
+        return stale && (shm_unlink( pName ) == 0);
+    }
+
+    /*************************************************************************\
+
+    Function:
+        CreatePlatformMemory
+
+    Description:
+        Create POSIX shared memory object.
+
+    \*************************************************************************/
+    bool DeviceProfilerSharedMemoryRing::CreatePlatformMemory( bool& alreadyExists )
+    {
+        alreadyExists = false;
+
+        // POSIX shared memory object names begin with a slash
+        if( m_Name.front() != '/' )
+        {
+            m_Name.insert( m_Name.begin(), '/' );
+        }
+
+        int fd = shm_open( m_Name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR );
+
+        if( (fd == -1) && (errno == EEXIST) && RemoveStaleSharedMemory( m_Name.c_str() ) )
+        {
+            // Create the ring again with the name of the removed one
+            fd = shm_open( m_Name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR );
+        }
+
+        if( fd == -1 )
+        {
+            alreadyExists = (errno == EEXIST);
+            return false;
+        }
+
+        m_Handle = fd;
+
+        if( ftruncate( fd, static_cast<off_t>( m_MemorySize ) ) != 0 )
+        {
+            return false;
+        }
+
+        void* pMemory = mmap( nullptr, m_MemorySize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+
+        if( pMemory == MAP_FAILED )
+        {
+            return false;
+        }
+
+        m_pMemory = pMemory;
+        return true;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        DestroyPlatformMemory
+
+    \*************************************************************************/
+    void DeviceProfilerSharedMemoryRing::DestroyPlatformMemory()
+    {
+        if( m_pMemory )
+        {
+            munmap( m_pMemory, m_MemorySize );
+            m_pMemory = nullptr;
+        }
+
+        if( m_Handle != -1 )
+        {
+            close( static_cast<int>( m_Handle ) );
+            shm_unlink( m_Name.c_str() );
+            m_Handle = -1;
+        }
+    }
+#endif
+}
@@ -0,0 +1,88 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "profiler/profiler_data.h"
+#include "profiler_ext/VkProfilerSharedMemoryRing.h"
+#include "profiler_helpers/profiler_time_helpers.h"
+#include <string>
+#include <unordered_map>
+
+namespace Profiler
+{
+    /*************************************************************************\
+
+    Class:
+        DeviceProfilerSharedMemoryRing
+
+    Description:
+        Publishes frame snapshots in a named shared-memory ring.
+
+        The layout of the memory is described in VkProfilerSharedMemoryRing.h.
+        The snapshot is written directly into the mapped slot on the
+        application thread, with no intermediate copies, locks or system
+        calls. Readers detect torn reads with the per-slot sequence counters.
+
+    \*************************************************************************/
+    class DeviceProfilerSharedMemoryRing
+    {
+    public:
+        template<typename GpuDurationType>
+        inline DeviceProfilerSharedMemoryRing( const class DeviceProfilerStringSerializer* pStringSerializer, GpuDurationType gpuTimestampPeriod )
+            : DeviceProfilerSharedMemoryRing(
+                pStringSerializer,
+                std::chrono::duration_cast<Milliseconds>(gpuTimestampPeriod) )
+        {
+        }
+
+        DeviceProfilerSharedMemoryRing( const class DeviceProfilerStringSerializer* pStringSerializer, Milliseconds gpuTimestampPeriod );
+        ~DeviceProfilerSharedMemoryRing();
+
+        bool Create( const std::string& name, uint32_t slotCount );
+        void Destroy();
+        bool IsCreated() const;
+
+        void AppendFrame( const DeviceProfilerFrameData& data );
+
+    private:
+        // Maximum number of pipelines included in each snapshot
+        static constexpr uint32_t MaxPipelineCount = 32;
+
+        // Maximum number of unique names tried when the requested one is already used
+        static constexpr uint32_t MaxUniqueNameCount = 16;
+
+        const class DeviceProfilerStringSerializer* m_pStringSerializer;
+        Milliseconds  m_GpuTimestampPeriod;
+
+        std::string   m_Name;
+        void*         m_pMemory;
+        size_t        m_MemorySize;
+        intptr_t      m_Handle;
+
+        VkProfilerSharedMemoryRingHeader* m_pHeader;
+        uint64_t      m_FrameIndex;
+
+        // Names are resolved once per pipeline
+        std::unordered_map<uint32_t, std::string> m_PipelineNames;
+
+        bool CreatePlatformMemory( bool& alreadyExists );
+        void DestroyPlatformMemory();
+    };
+}
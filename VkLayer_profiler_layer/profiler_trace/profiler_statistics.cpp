@@ -0,0 +1,401 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "profiler_statistics.h"
+#include "profiler/profiler_helpers.h"
+#include "profiler_helpers/profiler_data_helpers.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+
+#include "VkLayer_profiler_layer.generated.h"
+
+namespace Profiler
+{
+    /*************************************************************************\
+
+    Function:
+        GetSampleStatistics
+
+    Description:
+        Compute min, max, mean and nearest-rank percentiles of the samples.
+        The samples are reordered.
+
+    \*************************************************************************/
+    static nlohmann::json GetSampleStatistics( std::vector<float>& samples )
+    {
+        if( samples.empty() )
+        {
+            return nlohmann::json::object();
+        }
+
+        double sum = 0;
+        for( const float sample : samples )
+        {
+            sum += sample;
+        }
+
+        auto percentile = [&samples]( float p )
+        {
+            const size_t rank = static_cast<size_t>( std::ceil( p * samples.size() ) );
+            const auto it = samples.begin() + std::min( std::max<size_t>( rank, 1 ), samples.size() ) - 1;
+            std::nth_element( samples.begin(), it, samples.end() );
+            return *it;
+        };
+
+        const auto [min, max] = std::minmax_element( samples.begin(), samples.end() );
+
+        return {
+            { "min", *min },
+            { "max", *max },
+            { "mean", sum / samples.size() },
+            { "p50", percentile( 0.50f ) },
+            { "p95", percentile( 0.95f ) },
+            { "p99", percentile( 0.99f ) } };
+    }
+
+    /*************************************************************************\
+
+    Function:
+        DeviceProfilerStatisticsWriter
+
+    Description:
+        Constructor.
+
+    \*************************************************************************/
+    DeviceProfilerStatisticsWriter::DeviceProfilerStatisticsWriter( const DeviceProfilerStringSerializer* pStringSerializer, Milliseconds gpuTimestampPeriod )
+        : m_pStringSerializer( pStringSerializer )
+        , m_GpuTimestampPeriod( gpuTimestampPeriod )
+        , m_FrameInterval( 0 )
+        , m_TimeInterval( 0 )
+        , m_CurrentInterval()
+        , m_FrameIndex( 0 )
+        , m_IntervalBeginTimestamp()
+        , m_Mutex()
+        , m_ConditionVariable()
+        , m_PendingIntervals()
+        , m_DroppedIntervalCount( 0 )
+        , m_Exit( false )
+        , m_File()
+        , m_WorkerThread()
+    {
+    }
+
+    /*************************************************************************\
+
+    Function:
+        ~DeviceProfilerStatisticsWriter
+
+    Description:
+        Destructor.
+
+    \*************************************************************************/
+    DeviceProfilerStatisticsWriter::~DeviceProfilerStatisticsWriter()
+    {
+        Close();
+    }
+
+    /*************************************************************************\
+
+    Function:
+        Open
+
+    Description:
+        Open the output file and start the background thread.
+
+    \*************************************************************************/
+    bool DeviceProfilerStatisticsWriter::Open( const std::filesystem::path& filename, uint32_t frameInterval, Milliseconds timeInterval )
+    {
+        Close();
+
+        if( (frameInterval == 0) && (timeInterval.count() <= 0) )
+        {
+            ProfilerPlatformFunctions::WriteDebug( "Statistics dump interval not set\n" );
+            return false;
+        }
+
+        m_File.open( filename, std::ios::out | std::ios::trunc );
+
+        if( !m_File.is_open() )
+        {
+            ProfilerPlatformFunctions::WriteDebug( "Failed to open %s for writing\n", filename.string().c_str() );
+            return false;
+        }
+
+        m_FrameInterval = frameInterval;
+        m_TimeInterval = timeInterval;
+        m_CurrentInterval = {};
+        m_FrameIndex = 0;
+        m_DroppedIntervalCount = 0;
+        m_Exit = false;
+
+        m_WorkerThread = std::thread( &DeviceProfilerStatisticsWriter::WorkerThreadProc, this );
+
+        return true;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        Close
+
+    Description:
+        Write the remaining data and stop the background thread.
+
+    \*************************************************************************/
+    void DeviceProfilerStatisticsWriter::Close()
+    {
+        if( m_WorkerThread.joinable() )
+        {
+            // Write the incomplete interval
+            if( !m_CurrentInterval.m_FrameGpuTimes.empty() )
+            {
+                SubmitCurrentInterval();
+            }
+
+            {
+                std::scoped_lock lk( m_Mutex );
+                m_Exit = true;
+            }
+
+            m_ConditionVariable.notify_one();
+            m_WorkerThread.join();
+        }
+
+        if( m_File.is_open() )
+        {
+            m_File.close();
+        }
+    }
+
+    /*************************************************************************\
+
+    Function:
+        IsOpen
+
+    \*************************************************************************/
+    bool DeviceProfilerStatisticsWriter::IsOpen() const
+    {
+        return m_WorkerThread.joinable();
+    }
+
+    /*************************************************************************\
+
+    Function:
+        AppendFrame
+
+    Description:
+        Add samples of the frame to the current interval.
+        Cost is proportional to the number of unique pipelines in the frame.
+
+    \*************************************************************************/
+    void DeviceProfilerStatisticsWriter::AppendFrame( const DeviceProfilerFrameData& data )
+    {
+        if( !IsOpen() )
+        {
+            return;
+        }
+
+        if( m_CurrentInterval.m_FrameGpuTimes.empty() )
+        {
+            m_CurrentInterval.m_FirstFrameIndex = m_FrameIndex;
+            m_IntervalBeginTimestamp = data.m_CPU.m_BeginTimestamp;
+        }
+
+        const Milliseconds frameGpuTime = data.m_Ticks * m_GpuTimestampPeriod;
+        const Milliseconds frameCpuTime = data.m_CPU.m_EndTimestamp - data.m_CPU.m_BeginTimestamp;
+
+        m_CurrentInterval.m_FrameGpuTimes.push_back( frameGpuTime.count() );
+        m_CurrentInterval.m_FrameCpuTimes.push_back( frameCpuTime.count() );
+
+        // Top pipelines are already aggregated by the shader tuple hash
+        for( const auto& pipeline : data.m_TopPipelines )
+        {
+            const uint64_t pipelineTicks = (pipeline.m_EndTimestamp.m_Value - pipeline.m_BeginTimestamp.m_Value);
+
+            if( (pipeline.m_Handle == VK_NULL_HANDLE) || (pipelineTicks == 0) )
+            {
+                continue;
+            }
+
+            PipelineSamples& samples = m_CurrentInterval.m_Pipelines[ pipeline.m_ShaderTuple.m_Hash ];
+
+            if( samples.m_Name.empty() )
+            {
+                // Object names must be read on the application thread
+                samples.m_Name = m_pStringSerializer->GetName( pipeline );
+            }
+
+            samples.m_GpuTimes.push_back( (pipelineTicks * m_GpuTimestampPeriod).count() );
+        }
+
+        m_FrameIndex++;
+
+        // Check if the interval is complete
+        m_CurrentInterval.m_Duration = data.m_CPU.m_EndTimestamp - m_IntervalBeginTimestamp;
+
+        const bool frameIntervalElapsed =
+            (m_FrameInterval > 0) &&
+            (m_CurrentInterval.m_FrameGpuTimes.size() >= m_FrameInterval);
+
+        const bool timeIntervalElapsed =
+            (m_TimeInterval.count() > 0) &&
+            (m_CurrentInterval.m_Duration >= m_TimeInterval);
+
+        // Memory usage at the end of the interval
+        m_CurrentInterval.m_Memory = data.m_Memory;
+
+        if( frameIntervalElapsed || timeIntervalElapsed )
+        {
+            SubmitCurrentInterval();
+        }
+    }
+
+    /*************************************************************************\
+
+    Function:
+        SubmitCurrentInterval
+
+    Description:
+        Pass the current interval to the background thread.
+
+    \*************************************************************************/
+    void DeviceProfilerStatisticsWriter::SubmitCurrentInterval()
+    {
+        {
+            std::scoped_lock lk( m_Mutex );
+
+            if( m_PendingIntervals.size() >= MaxPendingIntervalCount )
+            {
+                // Background thread can't keep up with the application
+                m_PendingIntervals.pop_front();
+                m_DroppedIntervalCount++;
+            }
+
+            m_PendingIntervals.push_back( std::move( m_CurrentInterval ) );
+        }
+
+        m_ConditionVariable.notify_one();
+        m_CurrentInterval = {};
+    }
+
+    /*************************************************************************\
+
+    Function:
+        WorkerThreadProc
+
+    Description:
+        Write the pending intervals until the writer is closed.
+
+    \*************************************************************************/
+    void DeviceProfilerStatisticsWriter::WorkerThreadProc()
+    {
+        std::unique_lock lk( m_Mutex );
+
+        while( true )
+        {
+            m_ConditionVariable.wait( lk, [this] { return m_Exit || !m_PendingIntervals.empty(); } );
+
+            if( m_PendingIntervals.empty() )
+            {
+                // Exit requested and all intervals have been written
+                break;
+            }
+
+            Interval interval = std::move( m_PendingIntervals.front() );
+            m_PendingIntervals.pop_front();
+
+            interval.m_DroppedIntervalCount = m_DroppedIntervalCount;
+            m_DroppedIntervalCount = 0;
+
+            lk.unlock();
+            WriteInterval( interval );
+            lk.lock();
+        }
+    }
+
+    /*************************************************************************\
+
+    Function:
+        WriteInterval
+
+    Description:
+        Write statistics of the interval as a single line of JSON.
+        Samples are reordered when computing the percentiles.
+
+    \*************************************************************************/
+    void DeviceProfilerStatisticsWriter::WriteInterval( Interval& interval )
+    {
+        using json = nlohmann::json;
+
+        json pipelines = json::array();
+
+        for( auto& [hash, samples] : interval.m_Pipelines )
+        {
+            char hashStr[ 9 ] = {};
+            u32tohex( hashStr, hash );
+
+            double totalGpuTime = 0;
+            for( const float gpuTime : samples.m_GpuTimes )
+            {
+                totalGpuTime += gpuTime;
+            }
+
+            pipelines.push_back( {
+                { "hash", hashStr },
+                { "name", samples.m_Name },
+                { "frame_count", samples.m_GpuTimes.size() },
+                { "total_gpu_time_ms", totalGpuTime },
+                { "gpu_time_ms", GetSampleStatistics( samples.m_GpuTimes ) } } );
+        }
+
+        // Most expensive pipelines first
+        std::sort( pipelines.begin(), pipelines.end(),
+            []( const json& a, const json& b )
+            {
+                return a[ "total_gpu_time_ms" ].get<double>() > b[ "total_gpu_time_ms" ].get<double>();
+            } );
+
+        json heaps = json::array();
+
+        for( const auto& heap : interval.m_Memory.m_Heaps )
+        {
+            heaps.push_back( {
+                { "allocation_size", heap.m_AllocationSize },
+                { "allocation_count", heap.m_AllocationCount } } );
+        }
+
+        const json intervalJson = {
+            { "first_frame", interval.m_FirstFrameIndex },
+            { "frame_count", interval.m_FrameGpuTimes.size() },
+            { "duration_ms", interval.m_Duration.count() },
+            { "dropped_intervals", interval.m_DroppedIntervalCount },
+            { "frame_gpu_time_ms", GetSampleStatistics( interval.m_FrameGpuTimes ) },
+            { "frame_cpu_time_ms", GetSampleStatistics( interval.m_FrameCpuTimes ) },
+            { "memory", {
+                { "total_allocation_size", interval.m_Memory.m_TotalAllocationSize },
+                { "total_allocation_count", interval.m_Memory.m_TotalAllocationCount },
+                { "heaps", std::move( heaps ) } } },
+            { "pipelines", std::move( pipelines ) } };
+
+        m_File << intervalJson << "\n";
+        m_File.flush();
+    }
+}
@@ -0,0 +1,125 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "profiler/profiler_data.h"
+#include "profiler_helpers/profiler_time_helpers.h"
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Profiler
+{
+    /*************************************************************************\
+
+    Class:
+        DeviceProfilerStatisticsWriter
+
+    Description:
+        Periodically writes aggregated statistics to a file.
+
+        Frames are accumulated into intervals of N frames and/or T milliseconds.
+        Each completed interval is written as a single line of JSON with
+        frame time and per-pipeline percentiles and the memory usage at the
+        end of the interval.
+
+        The application thread only appends samples of the top pipelines
+        to the current interval. Sorting, serialization and file I/O are done
+        on a background thread. If the background thread falls behind,
+        the oldest pending intervals are dropped and reported in the next
+        written line.
+
+    \*************************************************************************/
+    class DeviceProfilerStatisticsWriter
+    {
+    public:
+        template<typename GpuDurationType>
+        inline DeviceProfilerStatisticsWriter( const class DeviceProfilerStringSerializer* pStringSerializer, GpuDurationType gpuTimestampPeriod )
+            : DeviceProfilerStatisticsWriter(
+                pStringSerializer,
+                std::chrono::duration_cast<Milliseconds>(gpuTimestampPeriod) )
+        {
+        }
+
+        DeviceProfilerStatisticsWriter( const class DeviceProfilerStringSerializer* pStringSerializer, Milliseconds gpuTimestampPeriod );
+        ~DeviceProfilerStatisticsWriter();
+
+        bool Open( const std::filesystem::path& filename, uint32_t frameInterval, Milliseconds timeInterval );
+        void Close();
+        bool IsOpen() const;
+
+        void AppendFrame( const DeviceProfilerFrameData& data );
+
+    private:
+        struct PipelineSamples
+        {
+            std::string        m_Name;
+            std::vector<float> m_GpuTimes;
+        };
+
+        struct Interval
+        {
+            uint64_t                 m_FirstFrameIndex = 0;
+            Milliseconds             m_Duration = {};
+            std::vector<float>       m_FrameGpuTimes;
+            std::vector<float>       m_FrameCpuTimes;
+            DeviceProfilerMemoryData m_Memory;
+            uint32_t                 m_DroppedIntervalCount = 0;
+
+            std::unordered_map<uint32_t, PipelineSamples> m_Pipelines;
+        };
+
+        // Maximum number of intervals waiting for the background thread
+        static constexpr size_t MaxPendingIntervalCount = 4;
+
+        const class DeviceProfilerStringSerializer* m_pStringSerializer;
+        Milliseconds  m_GpuTimestampPeriod;
+
+        uint32_t      m_FrameInterval;
+        Milliseconds  m_TimeInterval;
+
+        // Accessed only by the application thread
+        Interval      m_CurrentInterval;
+        uint64_t      m_FrameIndex;
+        std::chrono::high_resolution_clock::time_point m_IntervalBeginTimestamp;
+
+        // Shared with the background thread
+        std::mutex    m_Mutex;
+        std::condition_variable m_ConditionVariable;
+        std::deque<Interval> m_PendingIntervals;
+        uint32_t      m_DroppedIntervalCount;
+        bool          m_Exit;
+
+        // Accessed only by the background thread
+        std::ofstream m_File;
+        std::thread   m_WorkerThread;
+
+        void SubmitCurrentInterval();
+
+        void WorkerThreadProc();
+        void WriteInterval( Interval& interval );
+    };
+}
@@ -0,0 +1,645 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Winsock must be included before windows.h
+#ifdef WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#define poll WSAPoll
+#define MSG_NOSIGNAL 0
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+using SOCKET = int;
+#define INVALID_SOCKET (-1)
+#define closesocket close
+#endif
+
+#include "profiler_stream_server.h"
+#include "profiler/profiler_helpers.h"
+#include "profiler_helpers/profiler_data_helpers.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cerrno>
+
+#include "VkLayer_profiler_layer.generated.h"
+
+namespace Profiler
+{
+    /*************************************************************************\
+
+    Function:
+        SetNonBlocking
+
+    Description:
+        Don't block the server thread on slow clients.
+
+    \*************************************************************************/
+    static bool SetNonBlocking( SOCKET s )
+    {
+    #ifdef WIN32
+        u_long mode = 1;
+        return ioctlsocket( s, FIONBIO, &mode ) == 0;
+    #else
+        const int flags = fcntl( s, F_GETFL, 0 );
+        return (flags != -1) && (fcntl( s, F_SETFL, flags | O_NONBLOCK ) != -1);
+    #endif
+    }
+
+    /*************************************************************************\
+
+    Function:
+        WouldBlock
+
+    \*************************************************************************/
+    static bool WouldBlock()
+    {
+    #ifdef WIN32
+        return WSAGetLastError() == WSAEWOULDBLOCK;
+    #else
+        return (errno == EAGAIN) || (errno == EWOULDBLOCK);
+    #endif
+    }
+
+    /*************************************************************************\
+
+    Function:
+        CreateWakeUpSocket
+
+    Description:
+        Create a datagram socket connected to itself. Data sent to the socket
+        makes it readable, which interrupts poll on the server thread.
+
+    \*************************************************************************/
+    static SOCKET CreateWakeUpSocket()
+    {
+        SOCKET wakeUpSocket = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+
+        if( wakeUpSocket == INVALID_SOCKET )
+        {
+            return INVALID_SOCKET;
+        }
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = 0;
+        address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+
+        socklen_t addressSize = sizeof( address );
+
+        if( (bind( wakeUpSocket, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) != 0) ||
+            (getsockname( wakeUpSocket, reinterpret_cast<sockaddr*>( &address ), &addressSize ) != 0) ||
+            (connect( wakeUpSocket, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) != 0) ||
+            (!SetNonBlocking( wakeUpSocket )) )
+        {
+            closesocket( wakeUpSocket );
+            return INVALID_SOCKET;
+        }
+
+        return wakeUpSocket;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        DeviceProfilerStreamServer
+
+    Description:
+        Constructor.
+
+    \*************************************************************************/
+    DeviceProfilerStreamServer::DeviceProfilerStreamServer( const DeviceProfilerStringSerializer* pStringSerializer, Milliseconds gpuTimestampPeriod )
+        : m_pStringSerializer( pStringSerializer )
+        , m_GpuTimestampPeriod( gpuTimestampPeriod )
+        , m_FrameIndex( 0 )
+        , m_KnownPipelines()
+        , m_Mutex()
+        , m_LatestSnapshot()
+        , m_Exit( false )
+        , m_ClientCount( 0 )
+        , m_WakeUpSocket( static_cast<uintptr_t>( INVALID_SOCKET ) )
+        , m_Port( 0 )
+        , m_ListenSocket( static_cast<uintptr_t>( INVALID_SOCKET ) )
+        , m_Clients()
+        , m_PipelineNames()
+        , m_ServerThread()
+    {
+    }
+
+    /*************************************************************************\
+
+    Function:
+        ~DeviceProfilerStreamServer
+
+    Description:
+        Destructor.
+
+    \*************************************************************************/
+    DeviceProfilerStreamServer::~DeviceProfilerStreamServer()
+    {
+        Stop();
+    }
+
+    /*************************************************************************\
+
+    Function:
+        Start
+
+    Description:
+        Start listening for connections on the loopback interface.
+        If port is 0, the system selects a free port (see GetPort).
+
+    \*************************************************************************/
+    bool DeviceProfilerStreamServer::Start( uint16_t port )
+    {
+        Stop();
+
+    #ifdef WIN32
+        WSADATA wsaData;
+        if( WSAStartup( MAKEWORD( 2, 2 ), &wsaData ) != 0 )
+        {
+            ProfilerPlatformFunctions::WriteDebug( "Failed to initialize Winsock\n" );
+            return false;
+        }
+    #endif
+
+        SOCKET listenSocket = socket( AF_INET, SOCK_STREAM, IPPROTO_TCP );
+
+        if( listenSocket == INVALID_SOCKET )
+        {
+            ProfilerPlatformFunctions::WriteDebug( "Failed to create stream server socket\n" );
+        #ifdef WIN32
+            WSACleanup();
+        #endif
+            return false;
+        }
+
+        // Allow restarting the application while the previous socket is in TIME_WAIT
+        const int reuseAddress = 1;
+        setsockopt( listenSocket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>( &reuseAddress ), sizeof( reuseAddress ) );
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons( port );
+        address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+
+        socklen_t addressSize = sizeof( address );
+
+        if( (bind( listenSocket, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) != 0) ||
+            (getsockname( listenSocket, reinterpret_cast<sockaddr*>( &address ), &addressSize ) != 0) ||
+            (listen( listenSocket, static_cast<int>( MaxClientCount ) ) != 0) ||
+            (!SetNonBlocking( listenSocket )) )
+        {
+            ProfilerPlatformFunctions::WriteDebug( "Failed to listen on port %u\n", port );
+            closesocket( listenSocket );
+        #ifdef WIN32
+            WSACleanup();
+        #endif
+            return false;
+        }
+
+        SOCKET wakeUpSocket = CreateWakeUpSocket();
+
+        if( wakeUpSocket == INVALID_SOCKET )
+        {
+            ProfilerPlatformFunctions::WriteDebug( "Failed to create stream server wake-up socket\n" );
+            closesocket( listenSocket );
+        #ifdef WIN32
+            WSACleanup();
+        #endif
+            return false;
+        }
+
+        m_ListenSocket = static_cast<uintptr_t>( listenSocket );
+        m_WakeUpSocket = static_cast<uintptr_t>( wakeUpSocket );
+        m_Port = ntohs( address.sin_port );
+        m_ClientCount = 0;
+        m_FrameIndex = 0;
+        m_KnownPipelines.clear();
+        m_LatestSnapshot.reset();
+        m_Exit = false;
+
+        m_ServerThread = std::thread( &DeviceProfilerStreamServer::ServerThreadProc, this );
+
+        return true;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        Stop
+
+    Description:
+        Disconnect all clients and stop the server thread.
+
+    \*************************************************************************/
+    void DeviceProfilerStreamServer::Stop()
+    {
+        if( m_ServerThread.joinable() )
+        {
+            m_Exit = true;
+            WakeUp();
+            m_ServerThread.join();
+
+            for( Client& client : m_Clients )
+            {
+                CloseClient( client );
+            }
+
+            m_Clients.clear();
+            m_PipelineNames.clear();
+
+            closesocket( static_cast<SOCKET>( m_ListenSocket ) );
+            m_ListenSocket = static_cast<uintptr_t>( INVALID_SOCKET );
+
+            closesocket( static_cast<SOCKET>( m_WakeUpSocket ) );
+            m_WakeUpSocket = static_cast<uintptr_t>( INVALID_SOCKET );
+            m_Port = 0;
+
+        #ifdef WIN32
+            WSACleanup();
+        #endif
+        }
+    }
+
+    /*************************************************************************\
+
+    Function:
+        IsRunning
+
+    \*************************************************************************/
+    bool DeviceProfilerStreamServer::IsRunning() const
+    {
+        return m_ServerThread.joinable();
+    }
+
+    /*************************************************************************\
+
+    Function:
+        GetPort
+
+    Description:
+        Get the port on which the server listens for connections.
+
+    \*************************************************************************/
+    uint16_t DeviceProfilerStreamServer::GetPort() const
+    {
+        return m_Port;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        AppendFrame
+
+    Description:
+        Replace the latest snapshot with the data of the frame.
+        Cost is bounded by the number of pipelines included in the snapshot.
+
+    \*************************************************************************/
+    void DeviceProfilerStreamServer::AppendFrame( const DeviceProfilerFrameData& data )
+    {
+        if( !IsRunning() )
+        {
+            return;
+        }
+
+        FrameSnapshot snapshot;
+        snapshot.m_FrameIndex = m_FrameIndex++;
+        snapshot.m_CpuTime = Milliseconds( data.m_CPU.m_EndTimestamp - data.m_CPU.m_BeginTimestamp ).count();
+        snapshot.m_GpuTime = (data.m_Ticks * m_GpuTimestampPeriod).count();
+        snapshot.m_FramesPerSec = data.m_CPU.m_FramesPerSec;
+        snapshot.m_MemoryAllocationSize = data.m_Memory.m_TotalAllocationSize;
+        snapshot.m_MemoryAllocationCount = data.m_Memory.m_TotalAllocationCount;
+
+        // Top pipelines are already sorted by duration
+        for( const auto& pipeline : data.m_TopPipelines )
+        {
+            if( snapshot.m_Pipelines.size() == MaxPipelineCount )
+            {
+                break;
+            }
+
+            if( pipeline.m_Handle != VK_NULL_HANDLE )
+            {
+                const uint32_t hash = pipeline.m_ShaderTuple.m_Hash;
+                const uint64_t pipelineTicks = (pipeline.m_EndTimestamp.m_Value - pipeline.m_BeginTimestamp.m_Value);
+
+                snapshot.m_Pipelines.emplace_back( hash, (pipelineTicks * m_GpuTimestampPeriod).count() );
+
+                if( m_KnownPipelines.insert( hash ).second )
+                {
+                    // Object names must be read on the application thread
+                    snapshot.m_NewPipelineNames.emplace_back( hash, m_pStringSerializer->GetName( pipeline ) );
+                }
+            }
+        }
+
+        bool wakeUp = true;
+        {
+            std::scoped_lock lk( m_Mutex );
+
+            if( m_LatestSnapshot.has_value() )
+            {
+                // Previous snapshot has not been consumed yet, keep the names it introduced
+                for( auto& newPipelineName : m_LatestSnapshot->m_NewPipelineNames )
+                {
+                    snapshot.m_NewPipelineNames.push_back( std::move( newPipelineName ) );
+                }
+
+                // The server thread has already been woken up for the previous snapshot
+                wakeUp = false;
+            }
+
+            m_LatestSnapshot = std::move( snapshot );
+        }
+
+        // Snapshots are only kept for the clients that connect later, don't wake up the server for them
+        if( wakeUp && (m_ClientCount > 0) )
+        {
+            WakeUp();
+        }
+    }
+
+    /*************************************************************************\
+
+    Function:
+        ServerThreadProc
+
+    Description:
+        Accept connections and send the latest snapshots to the clients.
+
+    \*************************************************************************/
+    void DeviceProfilerStreamServer::ServerThreadProc()
+    {
+        // Clients are polled after the listen and wake-up sockets
+        constexpr size_t FirstClientDescriptorIndex = 2;
+
+        std::vector<pollfd> pollDescriptors;
+
+        while( !m_Exit )
+        {
+            std::optional<FrameSnapshot> snapshot;
+            {
+                std::scoped_lock lk( m_Mutex );
+                snapshot.swap( m_LatestSnapshot );
+            }
+
+            if( snapshot.has_value() )
+            {
+                for( auto& [hash, name] : snapshot->m_NewPipelineNames )
+                {
+                    m_PipelineNames[ hash ] = std::move( name );
+                }
+
+                if( !m_Clients.empty() )
+                {
+                    const std::string message = Serialize( *snapshot );
+
+                    for( Client& client : m_Clients )
+                    {
+                        // Skip the frame if the client is still receiving the previous one
+                        if( client.m_PendingData.empty() )
+                        {
+                            client.m_PendingData = message;
+                            client.m_SentSize = 0;
+                        }
+                    }
+                }
+            }
+
+            pollDescriptors.clear();
+            pollDescriptors.push_back( { static_cast<SOCKET>( m_ListenSocket ), POLLIN, 0 } );
+            pollDescriptors.push_back( { static_cast<SOCKET>( m_WakeUpSocket ), POLLIN, 0 } );
+
+            for( const Client& client : m_Clients )
+            {
+                const short events = client.m_PendingData.empty() ? POLLIN : (POLLIN | POLLOUT);
+                pollDescriptors.push_back( { static_cast<SOCKET>( client.m_Socket ), events, 0 } );
+            }
+
+            if( poll( pollDescriptors.data(), static_cast<unsigned>( pollDescriptors.size() ), PollTimeoutMs ) <= 0 )
+            {
+                continue;
+            }
+
+            if( pollDescriptors[ 1 ].revents & POLLIN )
+            {
+                // Discard the wake-up messages, the snapshot is picked up in the next iteration
+                char buffer[ 64 ];
+                while( recv( static_cast<SOCKET>( m_WakeUpSocket ), buffer, sizeof( buffer ), 0 ) > 0 )
+                {
+                }
+            }
+
+            // Handle the clients first, the descriptors are invalidated when a client is accepted
+            for( size_t i = 0; i < m_Clients.size(); ++i )
+            {
+                const short revents = pollDescriptors[ i + FirstClientDescriptorIndex ].revents;
+                bool connected = true;
+
+                if( revents & (POLLERR | POLLHUP | POLLNVAL) )
+                {
+                    connected = false;
+                }
+                if( connected && (revents & POLLIN) )
+                {
+                    connected = ReceiveData( m_Clients[ i ] );
+                }
+                if( connected && (revents & POLLOUT) )
+                {
+                    connected = SendPendingData( m_Clients[ i ] );
+                }
+
+                if( !connected )
+                {
+                    CloseClient( m_Clients[ i ] );
+                }
+            }
+
+            m_Clients.erase(
+                std::remove_if( m_Clients.begin(), m_Clients.end(),
+                    []( const Client& client ) { return client.m_Socket == static_cast<uintptr_t>( INVALID_SOCKET ); } ),
+                m_Clients.end() );
+
+            if( pollDescriptors[ 0 ].revents & POLLIN )
+            {
+                AcceptClient();
+            }
+
+            m_ClientCount = static_cast<uint32_t>( m_Clients.size() );
+        }
+    }
+
+    /*************************************************************************\
+
+    Function:
+        WakeUp
+
+    Description:
+        Interrupt poll on the server thread.
+
+    \*************************************************************************/
+    void DeviceProfilerStreamServer::WakeUp()
+    {
+        const char message = 0;
+        send( static_cast<SOCKET>( m_WakeUpSocket ), &message, sizeof( message ), MSG_NOSIGNAL );
+    }
+
+    /*************************************************************************\
+
+    Function:
+        AcceptClient
+
+    \*************************************************************************/
+    void DeviceProfilerStreamServer::AcceptClient()
+    {
+        SOCKET clientSocket = accept( static_cast<SOCKET>( m_ListenSocket ), nullptr, nullptr );
+
+        if( clientSocket == INVALID_SOCKET )
+        {
+            return;
+        }
+
+        if( (m_Clients.size() == MaxClientCount) || !SetNonBlocking( clientSocket ) )
+        {
+            closesocket( clientSocket );
+            return;
+        }
+
+        Client client;
+        client.m_Socket = static_cast<uintptr_t>( clientSocket );
+        m_Clients.push_back( std::move( client ) );
+    }
+
+    /*************************************************************************\
+
+    Function:
+        SendPendingData
+
+    Description:
+        Send as much of the pending snapshot as the socket accepts.
+        Returns false if the client has disconnected.
+
+    \*************************************************************************/
+    bool DeviceProfilerStreamServer::SendPendingData( Client& client )
+    {
+        while( client.m_SentSize < client.m_PendingData.size() )
+        {
+            const auto sentSize = send( static_cast<SOCKET>( client.m_Socket ),
+                client.m_PendingData.data() + client.m_SentSize,
+                static_cast<int>( client.m_PendingData.size() - client.m_SentSize ),
+                MSG_NOSIGNAL );
+
+            if( sentSize < 0 )
+            {
+                return WouldBlock();
+            }
+
+            client.m_SentSize += static_cast<size_t>( sentSize );
+        }
+
+        client.m_PendingData.clear();
+        client.m_SentSize = 0;
+        return true;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        ReceiveData
+
+    Description:
+        Discard data sent by the client. Returns false if the client has
+        disconnected.
+
+    \*************************************************************************/
+    bool DeviceProfilerStreamServer::ReceiveData( Client& client )
+    {
+        char buffer[ 256 ];
+
+        const auto receivedSize = recv( static_cast<SOCKET>( client.m_Socket ), buffer, sizeof( buffer ), 0 );
+
+        if( receivedSize < 0 )
+        {
+            return WouldBlock();
+        }
+
+        return receivedSize > 0;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        CloseClient
+
+    \*************************************************************************/
+    void DeviceProfilerStreamServer::CloseClient( Client& client )
+    {
+        if( client.m_Socket != static_cast<uintptr_t>( INVALID_SOCKET ) )
+        {
+            closesocket( static_cast<SOCKET>( client.m_Socket ) );
+            client.m_Socket = static_cast<uintptr_t>( INVALID_SOCKET );
+        }
+    }
+
+    /*************************************************************************\
+
+    Function:
+        Serialize
+
+    Description:
+        Serialize the snapshot to a single line of JSON.
+
+    \*************************************************************************/
+    std::string DeviceProfilerStreamServer::Serialize( const FrameSnapshot& snapshot )
+    {
+        using json = nlohmann::json;
+
+        json pipelines = json::array();
+
+        for( const auto& [hash, gpuTime] : snapshot.m_Pipelines )
+        {
+            char hashStr[ 9 ] = {};
+            u32tohex( hashStr, hash );
+
+            pipelines.push_back( {
+                { "hash", hashStr },
+                { "name", m_PipelineNames[ hash ] },
+                { "gpu_time_ms", gpuTime } } );
+        }
+
+        const json snapshotJson = {
+            { "frame", snapshot.m_FrameIndex },
+            { "cpu_time_ms", snapshot.m_CpuTime },
+            { "gpu_time_ms", snapshot.m_GpuTime },
+            { "fps", snapshot.m_FramesPerSec },
+            { "memory", {
+                { "allocation_size", snapshot.m_MemoryAllocationSize },
+                { "allocation_count", snapshot.m_MemoryAllocationCount } } },
+            { "pipelines", std::move( pipelines ) } };
+
+        return snapshotJson.dump() + "\n";
+    }
+}
@@ -0,0 +1,145 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "profiler/profiler_data.h"
+#include "profiler_helpers/profiler_time_helpers.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace Profiler
+{
+    /*************************************************************************\
+
+    Class:
+        DeviceProfilerStreamServer
+
+    Description:
+        Streams compact per-frame snapshots to external viewers over TCP.
+
+        The server listens on the loopback interface only. Each snapshot is
+        sent as a single line of JSON:
+            { "frame", "cpu_time_ms", "gpu_time_ms", "fps",
+              "memory": { "allocation_size", "allocation_count" },
+              "pipelines": [ { "hash", "name", "gpu_time_ms" } ] }
+
+        The application thread only copies the frame totals and the top
+        pipelines to a single snapshot slot, and wakes the background thread
+        when any client is connected. Serialization and socket I/O are
+        done on a background thread, which sleeps while there is nothing to send. Frames are coalesced when the background
+        thread or a client can't keep up: a client receives the next snapshot
+        only after the previous one has been fully sent, so slow clients
+        observe gaps in the frame numbers instead of growing latency.
+
+    \*************************************************************************/
+    class DeviceProfilerStreamServer
+    {
+    public:
+        template<typename GpuDurationType>
+        inline DeviceProfilerStreamServer( const class DeviceProfilerStringSerializer* pStringSerializer, GpuDurationType gpuTimestampPeriod )
+            : DeviceProfilerStreamServer(
+                pStringSerializer,
+                std::chrono::duration_cast<Milliseconds>(gpuTimestampPeriod) )
+        {
+        }
+
+        DeviceProfilerStreamServer( const class DeviceProfilerStringSerializer* pStringSerializer, Milliseconds gpuTimestampPeriod );
+        ~DeviceProfilerStreamServer();
+
+        bool Start( uint16_t port );
+        void Stop();
+        bool IsRunning() const;
+        uint16_t GetPort() const;
+
+        void AppendFrame( const DeviceProfilerFrameData& data );
+
+    private:
+        // Maximum number of pipelines included in each snapshot
+        static constexpr size_t MaxPipelineCount = 16;
+
+        // Maximum number of connected clients
+        static constexpr size_t MaxClientCount = 8;
+
+        // The server thread is woken up by the application thread, timeout is only a safety net
+        static constexpr int PollTimeoutMs = 1000;
+
+        struct FrameSnapshot
+        {
+            uint64_t m_FrameIndex = 0;
+            float    m_CpuTime = 0;
+            float    m_GpuTime = 0;
+            float    m_FramesPerSec = 0;
+            uint64_t m_MemoryAllocationSize = 0;
+            uint64_t m_MemoryAllocationCount = 0;
+
+            std::vector<std::pair<uint32_t, float>> m_Pipelines;
+
+            // Names of pipelines not seen in the previous snapshots
+            std::vector<std::pair<uint32_t, std::string>> m_NewPipelineNames;
+        };
+
+        struct Client
+        {
+            uintptr_t   m_Socket = 0;
+            std::string m_PendingData;
+            size_t      m_SentSize = 0;
+        };
+
+        const class DeviceProfilerStringSerializer* m_pStringSerializer;
+        Milliseconds  m_GpuTimestampPeriod;
+
+        // Accessed only by the application thread
+        uint64_t      m_FrameIndex;
+        std::unordered_set<uint32_t> m_KnownPipelines;
+
+        // Shared with the background thread
+        std::mutex    m_Mutex;
+        std::optional<FrameSnapshot> m_LatestSnapshot;
+        std::atomic_bool m_Exit;
+        std::atomic_uint32_t m_ClientCount;
+
+        // Loopback datagram socket connected to itself, used to wake up the server thread
+        uintptr_t     m_WakeUpSocket;
+        uint16_t      m_Port;
+
+        // Accessed only by the background thread
+        uintptr_t     m_ListenSocket;
+        std::vector<Client> m_Clients;
+        std::unordered_map<uint32_t, std::string> m_PipelineNames;
+        std::thread   m_ServerThread;
+
+        void ServerThreadProc();
+        void WakeUp();
+        void AcceptClient();
+        bool SendPendingData( Client& client );
+        bool ReceiveData( Client& client );
+        void CloseClient( Client& client );
+
+        std::string Serialize( const FrameSnapshot& snapshot );
+    };
+}
@@ -21,6 +21,7 @@
 #include "profiler_trace.h"
 #include "profiler_trace_event.h"
 #include "profiler_json.h"
+#include "profiler_perfetto.h"
 #include "profiler/profiler_data.h"
 #include "profiler/profiler_helpers.h"
 #include "profiler_layer_objects/VkObject.h"
@@ -28,6 +29,7 @@
 
 #include "VkLayer_profiler_layer.generated.h"
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <sstream>
@@ -49,12 +51,19 @@ namespace Profiler
         Constructor.
 
     \*************************************************************************/
-    DeviceProfilerTraceSerializer::DeviceProfilerTraceSerializer( const DeviceProfilerStringSerializer* pStringSerializer, Milliseconds gpuTimestampPeriod )
+    DeviceProfilerTraceSerializer::DeviceProfilerTraceSerializer( const DeviceProfilerStringSerializer* pStringSerializer, Milliseconds gpuTimestampPeriod, DeviceProfilerTraceFormat format )
         : m_pStringSerializer( pStringSerializer )
         , m_pJsonSerializer( nullptr )
+        , m_Format( format )
+        , m_CaptureFormat( format )
         , m_pData( nullptr )
         , m_CommandQueue( VK_NULL_HANDLE )
         , m_pEvents()
+        , m_Capturing( false )
+        , m_CapturedFrameCount( 0 )
+        , m_MaxCapturedFrameCount( 0 )
+        , m_CaptureBeginTimestamp()
+        , m_LastFrameEndTimestamp( 0 )
         , m_DebugLabelStackDepth( 0 )
         , m_CpuQueueSubmitTimestampOffset( 0 )
         , m_GpuQueueSubmitTimestampOffset( 0 )
@@ -75,11 +84,39 @@ namespace Profiler
     \*************************************************************************/
     DeviceProfilerTraceSerializer::~DeviceProfilerTraceSerializer()
     {
+        Cleanup();
         delete m_pJsonSerializer;
     }
 
     /*************************************************************************\
 
+    Function:
+        SetFormat
+
+    Description:
+        Select format of the trace files written by the serializer.
+        The format of the capture session is selected when the session begins,
+        so the currently open session is still saved in the previous format.
+
+    \*************************************************************************/
+    void DeviceProfilerTraceSerializer::SetFormat( DeviceProfilerTraceFormat format )
+    {
+        m_Format = format;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        GetFormat
+
+    \*************************************************************************/
+    DeviceProfilerTraceFormat DeviceProfilerTraceSerializer::GetFormat() const
+    {
+        return m_Format;
+    }
+
+    /*************************************************************************\
+
     Function:
         Serialize
 
@@ -89,11 +126,64 @@ namespace Profiler
     \*************************************************************************/
     DeviceProfilerTraceSerializationResult DeviceProfilerTraceSerializer::Serialize( const DeviceProfilerFrameData& data )
     {
+        // Single-frame trace is a capture session with only one frame
+        BeginCapture( 1 );
+        AppendFrame( data );
+        return EndCapture();
+    }
+
+    /*************************************************************************\
+
+    Function:
+        BeginCapture
+
+    Description:
+        Begin a new capture session. All frames appended until EndCapture is
+        called will be written to the same trace file.
+        If maxFrameCount is 0, the number of captured frames is not limited.
+
+    \*************************************************************************/
+    void DeviceProfilerTraceSerializer::BeginCapture( uint32_t maxFrameCount )
+    {
+        // Discard events of the previous, unfinished session
+        Cleanup();
+
+        m_Capturing = true;
+        m_MaxCapturedFrameCount = maxFrameCount;
+        m_CaptureFormat = m_Format;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        AppendFrame
+
+    Description:
+        Serialize the frame into the current capture session.
+        Returns false if the session has reached the frame or event limit and
+        should be closed with EndCapture.
+
+    \*************************************************************************/
+    bool DeviceProfilerTraceSerializer::AppendFrame( const DeviceProfilerFrameData& data )
+    {
+        assert( m_Capturing );
+
+        if( ((m_MaxCapturedFrameCount > 0) &&
+             (m_CapturedFrameCount >= m_MaxCapturedFrameCount)) ||
+            (m_pEvents.size() >= MaxCapturedEventCount) )
+        {
+            // Frame or event limit already reached
+            return false;
+        }
+
         // Setup state for serialization
         m_pData = &data;
 
-        DeviceProfilerTraceSerializationResult result = {};
-        result.m_Succeeded = true;
+        if( m_CapturedFrameCount == 0 )
+        {
+            // All timestamps in the session are relative to the beginning of the first frame
+            m_CaptureBeginTimestamp = data.m_CPU.m_BeginTimestamp;
+        }
 
         // Serialize the data
         for( const auto& submitBatchData : data.m_Submits )
@@ -140,24 +230,111 @@ namespace Profiler
             }
         }
 
+        // Insert regions marked by the application
+        for( const auto& cpuRegionData : data.m_CpuRegions )
+        {
+            // Regions that began before the capture are clipped to the beginning of the capture
+            const auto beginTimestamp = std::max( cpuRegionData.m_BeginTimestamp, m_CaptureBeginTimestamp );
+
+            m_pEvents.push_back( new CpuTraceEvent(
+                cpuRegionData.m_Name,
+                cpuRegionData.m_ThreadId,
+                GetNormalizedCpuTimestamp( beginTimestamp ),
+                cpuRegionData.m_EndTimestamp - beginTimestamp ) );
+        }
+
+        m_LastFrameEndTimestamp = GetNormalizedCpuTimestamp( data.m_CPU.m_EndTimestamp );
+
         // Insert present event
         m_pEvents.push_back( new ApiTraceEvent(
             TraceInstantEvent::Scope::eThread,
             "vkQueuePresentKHR",
             data.m_CPU.m_ThreadId,
-            GetNormalizedCpuTimestamp( data.m_CPU.m_EndTimestamp ) ) );
+            m_LastFrameEndTimestamp ) );
+
+        m_pData = nullptr;
+        m_CapturedFrameCount++;
+
+        // The last frame may exceed the event limit, but the next one is not captured
+        return ((m_MaxCapturedFrameCount == 0) ||
+                (m_CapturedFrameCount < m_MaxCapturedFrameCount)) &&
+               (m_pEvents.size() < MaxCapturedEventCount);
+    }
+
+    /*************************************************************************\
+
+    Function:
+        EndCapture
+
+    Description:
+        Finish the current capture session and write the trace file.
+
+    \*************************************************************************/
+    DeviceProfilerTraceSerializationResult DeviceProfilerTraceSerializer::EndCapture()
+    {
+        DeviceProfilerTraceSerializationResult result = {};
+        result.m_Succeeded = true;
+
+        if( !m_Capturing || (m_CapturedFrameCount == 0) )
+        {
+            // Nothing to save
+            Cleanup();
+
+            result.m_Succeeded = false;
+            result.m_Message = "No frames captured";
+            return result;
+        }
+
+        // Close debug labels that did not end before the end of the session
+        while( m_DebugLabelStackDepth > 0 )
+        {
+            m_pEvents.push_back( new DebugTraceEvent(
+                TraceEvent::Phase::eDurationEnd,
+                "",
+                m_LastFrameEndTimestamp ) );
+
+            m_DebugLabelStackDepth--;
+        }
 
         // Write JSON file
         SaveEventsToFile( result );
 
         // Cleanup serializer state
         Cleanup();
-        
+
         return result;
     }
 
     /*************************************************************************\
 
+    Function:
+        IsCapturing
+
+    Description:
+        Check if the capture session is open.
+
+    \*************************************************************************/
+    bool DeviceProfilerTraceSerializer::IsCapturing() const
+    {
+        return m_Capturing;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        GetCapturedFrameCount
+
+    Description:
+        Get number of frames appended to the current capture session.
+
+    \*************************************************************************/
+    uint32_t DeviceProfilerTraceSerializer::GetCapturedFrameCount() const
+    {
+        return m_CapturedFrameCount;
+    }
+
+    /*************************************************************************\
+
     Function:
         SetupTimestampNormalizationConstants
 
@@ -206,14 +383,15 @@ namespace Profiler
         GetNormalizedCpuTimestamp
 
     Description:
-        Get CPU timestamp aligned to the frame begin CPU timestamp.
+        Get CPU timestamp aligned to the begin CPU timestamp of the first frame
+        in the capture session.
 
     \*************************************************************************/
     Milliseconds DeviceProfilerTraceSerializer::GetNormalizedCpuTimestamp( std::chrono::high_resolution_clock::time_point timestamp ) const
     {
-        assert( timestamp >= m_pData->m_CPU.m_BeginTimestamp );
+        assert( timestamp >= m_CaptureBeginTimestamp );
         assert( timestamp <= m_pData->m_CPU.m_EndTimestamp );
-        return timestamp - m_pData->m_CPU.m_BeginTimestamp;
+        return timestamp - m_CaptureBeginTimestamp;
     }
 
     /*************************************************************************\
@@ -497,7 +675,7 @@ namespace Profiler
                 // Insert debug labels as instant events
                 m_pEvents.push_back( new DebugTraceEvent(
                     TraceEvent::Phase::eInstant,
-                    data.m_Payload.m_DebugLabel.m_pName,
+                    m_pStringSerializer->GetName( data ),
                     GetNormalizedGpuTimestamp( data.m_BeginTimestamp.m_Value ) ) );
             }
 
@@ -505,7 +683,7 @@ namespace Profiler
             {
                 m_pEvents.push_back( new DebugTraceEvent(
                     TraceEvent::Phase::eDurationBegin,
-                    data.m_Payload.m_DebugLabel.m_pName,
+                    m_pStringSerializer->GetName( data ),
                     GetNormalizedGpuTimestamp( data.m_BeginTimestamp.m_Value ) ) );
 
                 m_DebugLabelStackDepth++;
@@ -513,7 +691,7 @@ namespace Profiler
 
             if( data.m_Type == DeviceProfilerDrawcallType::eEndDebugLabel )
             {
-                // End only events that started in current frame
+                // End only events that started in the current capture session
                 if( m_DebugLabelStackDepth > 0 )
                 {
                     m_pEvents.push_back( new DebugTraceEvent(
@@ -552,7 +730,17 @@ namespace Profiler
         stringBuilder << ProfilerPlatformFunctions::GetProcessName() << "_";
         stringBuilder << ProfilerPlatformFunctions::GetCurrentProcessId() << "_";
         stringBuilder << std::put_time( &localTime, "%Y-%m-%d_%H-%M-%S" ) << "_" << ms.count();
-        stringBuilder << ".json";
+
+        switch( m_CaptureFormat )
+        {
+        case DeviceProfilerTraceFormat::eJson:
+            stringBuilder << ".json";
+            break;
+
+        case DeviceProfilerTraceFormat::ePerfetto:
+            stringBuilder << ".pftrace";
+            break;
+        }
 
         return std::filesystem::absolute( stringBuilder.str() );
     }
@@ -567,22 +755,9 @@ namespace Profiler
     {
         if( result.m_Succeeded )
         {
-            json traceJson = {
-                { "traceEvents", json::array() },
-                { "displayTimeUnit", "ns" },
-                { "otherData", json::object() } };
-
-            // Create JSON objects
-            json& traceEvents = traceJson[ "traceEvents" ];
-
-            for( const TraceEvent* pEvent : m_pEvents )
-            {
-                traceEvents.push_back( *pEvent );
-            }
-
             // Open output file
             std::filesystem::path filename = ConstructTraceFileName();
-            std::ofstream out( filename );
+            std::ofstream out( filename, std::ios::binary );
 
             if( !out.is_open() )
             {
@@ -592,8 +767,17 @@ namespace Profiler
                 return;
             }
 
-            // Write JSON to file
-            out << traceJson;
+            switch( m_CaptureFormat )
+            {
+            case DeviceProfilerTraceFormat::eJson:
+                SaveEventsToJsonFile( out );
+                break;
+
+            case DeviceProfilerTraceFormat::ePerfetto:
+                SaveEventsToPerfettoFile( out );
+                break;
+            }
+
             out.flush();
 
             if( out.bad() )
@@ -612,6 +796,49 @@ namespace Profiler
 
     /*************************************************************************\
 
+    Function:
+        SaveEventsToJsonFile
+
+    Description:
+        Write events in Chrome's Trace Event Format.
+
+    \*************************************************************************/
+    void DeviceProfilerTraceSerializer::SaveEventsToJsonFile( std::ofstream& out )
+    {
+        json traceJson = {
+            { "traceEvents", json::array() },
+            { "displayTimeUnit", "ns" },
+            { "otherData", json::object() } };
+
+        // Create JSON objects
+        json& traceEvents = traceJson[ "traceEvents" ];
+
+        for( const TraceEvent* pEvent : m_pEvents )
+        {
+            traceEvents.push_back( *pEvent );
+        }
+
+        // Write JSON to file
+        out << traceJson;
+    }
+
+    /*************************************************************************\
+
+    Function:
+        SaveEventsToPerfettoFile
+
+    Description:
+        Write events in Perfetto's protobuf format.
+
+    \*************************************************************************/
+    void DeviceProfilerTraceSerializer::SaveEventsToPerfettoFile( std::ofstream& out )
+    {
+        DeviceProfilerPerfettoSerializer perfettoSerializer( m_pStringSerializer );
+        perfettoSerializer.Serialize( m_pEvents, out );
+    }
+
+    /*************************************************************************\
+
     Function:
         Cleanup
 
@@ -626,5 +853,11 @@ namespace Profiler
 
         m_pEvents.clear();
         m_pData = nullptr;
+
+        m_Capturing = false;
+        m_CapturedFrameCount = 0;
+        m_MaxCapturedFrameCount = 0;
+        m_LastFrameEndTimestamp = Milliseconds( 0 );
+        m_DebugLabelStackDepth = 0;
     }
 }
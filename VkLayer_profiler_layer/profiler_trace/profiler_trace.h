@@ -22,6 +22,7 @@
 #include "profiler_helpers/profiler_time_helpers.h"
 #include <vulkan/vulkan.h>
 #include <filesystem>
+#include <fstream>
 #include <vector>
 
 namespace Profiler
@@ -43,16 +44,40 @@ namespace Profiler
 
     /*************************************************************************\
 
+    Enumeration:
+        DeviceProfilerTraceFormat
+
+    Description:
+        Output file formats supported by the trace serializer.
+
+    \*************************************************************************/
+    enum class DeviceProfilerTraceFormat
+    {
+        eJson,
+        ePerfetto
+    };
+
+    /*************************************************************************\
+
     Class:
         DeviceProfilerTraceSerializer
 
     Description:
         Serializes data collected by the profiler into Chrome-compatible JSON
-        format (Trace Event Format).
+        format (Trace Event Format) or Perfetto protobuf format.
 
         Serializer is not thread-safe. For multithreaded serialization, use
         more serializers for the best performance.
 
+        Multiple frames can be written to a single trace file by opening
+        a capture session with BeginCapture, appending the frames with
+        AppendFrame and closing the session with EndCapture. Timestamps of all
+        frames in the session are normalized to the beginning of the first
+        frame, so the frames appear on one continuous timeline.
+
+        Events of the session are kept in memory until the session is closed,
+        so the session is limited to MaxCapturedEventCount events.
+
     See:
         https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
 
@@ -61,22 +86,42 @@ namespace Profiler
     {
     public:
         template<typename GpuDurationType>
-        inline DeviceProfilerTraceSerializer( const class DeviceProfilerStringSerializer* pStringSerializer, GpuDurationType gpuTimestampPeriod )
+        inline DeviceProfilerTraceSerializer( const class DeviceProfilerStringSerializer* pStringSerializer, GpuDurationType gpuTimestampPeriod, DeviceProfilerTraceFormat format = DeviceProfilerTraceFormat::eJson )
             : DeviceProfilerTraceSerializer(
                 pStringSerializer,
-                std::chrono::duration_cast<Milliseconds>(gpuTimestampPeriod) )
+                std::chrono::duration_cast<Milliseconds>(gpuTimestampPeriod),
+                format )
         {
         }
 
-        DeviceProfilerTraceSerializer( const class DeviceProfilerStringSerializer* pStringSerializer, Milliseconds gpuTimestampPeriod );
+        DeviceProfilerTraceSerializer( const class DeviceProfilerStringSerializer* pStringSerializer, Milliseconds gpuTimestampPeriod, DeviceProfilerTraceFormat format = DeviceProfilerTraceFormat::eJson );
         ~DeviceProfilerTraceSerializer();
 
+        void SetFormat( DeviceProfilerTraceFormat format );
+        DeviceProfilerTraceFormat GetFormat() const;
+
         DeviceProfilerTraceSerializationResult Serialize( const struct DeviceProfilerFrameData& data );
 
+        // Multi-frame capture session
+        void BeginCapture( uint32_t maxFrameCount = 0 );
+        bool AppendFrame( const struct DeviceProfilerFrameData& data );
+        DeviceProfilerTraceSerializationResult EndCapture();
+
+        bool IsCapturing() const;
+        uint32_t GetCapturedFrameCount() const;
+
     private:
+        // Maximum number of events kept in memory in the capture session
+        static constexpr size_t MaxCapturedEventCount = 1024 * 1024;
+
         const class DeviceProfilerStringSerializer* m_pStringSerializer;
         const class DeviceProfilerJsonSerializer* m_pJsonSerializer;
 
+        DeviceProfilerTraceFormat m_Format;
+
+        // Format of the current capture session, selected in BeginCapture
+        DeviceProfilerTraceFormat m_CaptureFormat;
+
         // Currently serialized frame data
         const struct DeviceProfilerFrameData* m_pData;
 
@@ -85,6 +130,13 @@ namespace Profiler
 
         std::vector<struct TraceEvent*> m_pEvents;
 
+        // Capture session state
+        bool         m_Capturing;
+        uint32_t     m_CapturedFrameCount;
+        uint32_t     m_MaxCapturedFrameCount;
+        std::chrono::high_resolution_clock::time_point m_CaptureBeginTimestamp;
+        Milliseconds m_LastFrameEndTimestamp;
+
         // Debug labels can cross command buffer and frame boundaries
         // Tracking depth of the stack to detect labels which begin in one frame and end in the next
         uint32_t     m_DebugLabelStackDepth;
@@ -113,6 +165,8 @@ namespace Profiler
 
         std::filesystem::path ConstructTraceFileName() const;
         void SaveEventsToFile( DeviceProfilerTraceSerializationResult& );
+        void SaveEventsToJsonFile( std::ofstream& );
+        void SaveEventsToPerfettoFile( std::ofstream& );
 
         void Cleanup();
     };
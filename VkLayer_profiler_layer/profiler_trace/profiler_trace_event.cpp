@@ -150,6 +150,23 @@ namespace Profiler
 
     /*************************************************************************\
 
+    Function:
+        Serialize
+
+    Description:
+        Serialize CpuTraceEvent to JSON object.
+
+    \*************************************************************************/
+    void CpuTraceEvent::Serialize( nlohmann::json& jsonObject ) const
+    {
+        TraceCompleteEvent::Serialize( jsonObject );
+
+        // Set thread id
+        jsonObject[ "tid" ] = "Thread " + std::to_string( m_ThreadId );
+    }
+
+    /*************************************************************************\
+
     Function:
         to_json
 
@@ -273,6 +273,38 @@ namespace Profiler
         void Serialize( nlohmann::json& j ) const override;
     };
 
+    /*************************************************************************\
+
+    Structure:
+        CpuTraceEvent
+
+    Description:
+        CPU trace events are regions marked by the application in its threads
+        with vkBeginProfilerCpuRegionEXT and vkEndProfilerCpuRegionEXT.
+
+    \*************************************************************************/
+    struct CpuTraceEvent : TraceCompleteEvent
+    {
+        uint32_t m_ThreadId;
+
+        CpuTraceEvent() = default;
+
+        template<typename TimestampType, typename DurationType>
+        inline CpuTraceEvent(
+            std::string_view name,
+            uint32_t threadId,
+            TimestampType timestamp,
+            DurationType duration,
+            const nlohmann::json& color = {},
+            const nlohmann::json& args = {} )
+            : TraceCompleteEvent( name, "CPU", timestamp, duration, VK_NULL_HANDLE, color, args )
+            , m_ThreadId( threadId )
+        {
+        }
+
+        void Serialize( nlohmann::json& j ) const override;
+    };
+
     // Conversion functions
     void to_json( nlohmann::json& j, const TraceEvent& event );
 }
@@ -99,6 +99,13 @@ public:
         BaseType::emplace( key, std::move( value ) );
     }
 
+    // Insert new value into map or replace the existing one (thread-safe)
+    void insert_or_assign( const KeyType& key, const ValueType& value )
+    {
+        std::scoped_lock lk( m_Mtx );
+        BaseType::insert_or_assign( key, value );
+    }
+
     // Insert new value into map
     void unsafe_insert( const KeyType& key, const ValueType& value )
     {
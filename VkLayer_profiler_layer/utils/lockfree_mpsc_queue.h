@@ -0,0 +1,122 @@
+// Copyright (c) 2019-2023 Lukasz Stalmirski
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <utility>
+
+/***********************************************************************************\
+
+Class:
+    MpscQueue
+
+Description:
+    Lock-free queue with multiple producers and a single consumer.
+
+    Producers push the values to an intrusive stack with a CAS loop. The consumer
+    detaches the whole stack with a single exchange and reverses it, so the values
+    are consumed in the order of insertion. Nodes are never reused while they are
+    reachable from the head, so the queue is not prone to the ABA problem.
+
+\***********************************************************************************/
+template<typename ValueType>
+class MpscQueue
+{
+private:
+    struct Node
+    {
+        ValueType m_Value;
+        Node* m_pNext;
+    };
+
+    std::atomic<Node*> m_pHead;
+
+    void push_node( Node* pNode )
+    {
+        pNode->m_pNext = m_pHead.load( std::memory_order_relaxed );
+
+        while( !m_pHead.compare_exchange_weak(
+            pNode->m_pNext, pNode,
+            std::memory_order_release,
+            std::memory_order_relaxed ) );
+    }
+
+public:
+    MpscQueue()
+        : m_pHead( nullptr )
+    {
+    }
+
+    MpscQueue( const MpscQueue& ) = delete;
+    MpscQueue& operator=( const MpscQueue& ) = delete;
+
+    ~MpscQueue()
+    {
+        clear();
+    }
+
+    // Append value to the queue (thread-safe)
+    void push( const ValueType& value )
+    {
+        push_node( new Node{ value, nullptr } );
+    }
+
+    // Append value to the queue (thread-safe)
+    void push( ValueType&& value )
+    {
+        push_node( new Node{ std::move( value ), nullptr } );
+    }
+
+    // Remove all values from the queue and pass them to the function in the order of insertion
+    template<typename FunctionType>
+    void consume_all( FunctionType&& function )
+    {
+        Node* pNode = m_pHead.exchange( nullptr, std::memory_order_acquire );
+        Node* pReversed = nullptr;
+
+        while( pNode != nullptr )
+        {
+            Node* pNext = pNode->m_pNext;
+            pNode->m_pNext = pReversed;
+            pReversed = pNode;
+            pNode = pNext;
+        }
+
+        while( pReversed != nullptr )
+        {
+            std::unique_ptr<Node> pCurrent( pReversed );
+            pReversed = pReversed->m_pNext;
+            function( std::move( pCurrent->m_Value ) );
+        }
+    }
+
+    // Remove all values from the queue
+    void clear()
+    {
+        consume_all( []( ValueType&& ) {} );
+    }
+
+    // Check if the queue contains any values
+    bool empty() const
+    {
+        return m_pHead.load( std::memory_order_relaxed ) == nullptr;
+    }
+};